@@ -616,6 +616,7 @@ function(SETUP_BLENDER_SORTED_LIBS)
 		ge_logic_network
 		ge_logic_ngnetwork
 		ge_logic_loopbacknetwork
+		ge_logic_udpnetwork
 		bf_intern_moto
 		extern_openjpeg
 		extern_redcode
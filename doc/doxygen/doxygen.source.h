@@ -65,6 +65,9 @@
 /** \defgroup bgenetlb Loopback Network
  *  \ingroup bgenet
  */
+/** \defgroup bgenetudp UDP Network
+ *  \ingroup bgenet
+ */
 /** \defgroup phys Physics
  *  \ingroup bge
  */
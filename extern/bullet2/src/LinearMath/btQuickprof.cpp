@@ -439,6 +439,20 @@ CProfileNode *	CProfileManager::CurrentNode = &CProfileManager::Root;
 int				CProfileManager::FrameCounter = 0;
 unsigned long int			CProfileManager::ResetTime = 0;
 
+// Samples are only recorded by the thread which last reset the profiler,
+// solvers running in worker threads would otherwise corrupt the tree.
+#if defined(_MSC_VER)
+static __declspec(thread) char gProfileThreadTag;
+#else
+static __thread char gProfileThreadTag;
+#endif
+static char *gProfileThread = NULL;
+
+static inline bool Profile_Is_Thread( void )
+{
+	return (gProfileThread == NULL || gProfileThread == &gProfileThreadTag);
+}
+
 
 /***********************************************************************************************
  * CProfileManager::Start_Profile -- Begin a named profile                                    *
@@ -455,6 +469,10 @@ unsigned long int			CProfileManager::ResetTime = 0;
  *=============================================================================================*/
 void	CProfileManager::Start_Profile( const char * name )
 {
+	if (!Profile_Is_Thread()) {
+		return;
+	}
+
 	if (name != CurrentNode->Get_Name()) {
 		CurrentNode = CurrentNode->Get_Sub_Node( name );
 	}
@@ -468,6 +486,10 @@ void	CProfileManager::Start_Profile( const char * name )
  *=============================================================================================*/
 void	CProfileManager::Stop_Profile( void )
 {
+	if (!Profile_Is_Thread()) {
+		return;
+	}
+
 	// Return will indicate whether we should back up to our parent (we may
 	// be profiling a recursive function)
 	if (CurrentNode->Return()) {
@@ -483,6 +505,7 @@ void	CProfileManager::Stop_Profile( void )
  *=============================================================================================*/
 void	CProfileManager::Reset( void )
 {
+	gProfileThread = &gProfileThreadTag;
 	gProfileClock.reset();
 	Root.Reset();
     Root.Call();
@@ -206,6 +206,10 @@ extern const char *(*MEM_name_ptr)(void *vmemh);
 /* Switch allocator to slower but fully guarded mode. */
 void MEM_use_guarded_allocator(void);
 
+/* Let lock-free allocator keep small blocks in per-thread caches,
+ * must be called before any other thread allocates memory. */
+void MEM_use_lockfree_small_cache(void);
+
 #ifdef __cplusplus
 /* alloc funcs for C++ only */
 #define MEM_CXX_CLASS_ALLOC_FUNCS(_id)                                        \
@@ -128,3 +128,8 @@ void MEM_use_guarded_allocator(void)
 	MEM_name_ptr = MEM_guarded_name_ptr;
 #endif
 }
+
+void MEM_use_lockfree_small_cache(void)
+{
+	MEM_lockfree_use_small_cache();
+}
@@ -149,6 +149,7 @@ size_t MEM_lockfree_get_peak_memory(void) ATTR_WARN_UNUSED_RESULT;
 #ifndef NDEBUG
 const char *MEM_lockfree_name_ptr(void *vmemh);
 #endif
+void MEM_lockfree_use_small_cache(void);
 
 /* Prototypes for fully guarded allocator functions */
 size_t MEM_guarded_allocN_len(const void *vmemh) ATTR_WARN_UNUSED_RESULT;
@@ -41,6 +41,12 @@
 #include "atomic_ops.h"
 #include "mallocn_intern.h"
 
+#if defined(WIN32)
+#  include <windows.h>
+#else
+#  include <pthread.h>
+#endif
+
 typedef struct MemHead {
 	/* Length of allocated memory block. */
 	size_t len;
@@ -69,6 +75,10 @@ enum {
 #define MEMHEAD_ALIGNED_FROM_PTR(ptr) (((MemHeadAligned*) vmemh) - 1)
 #define MEMHEAD_IS_MMAP(memhead) ((memhead)->len & (size_t) MEMHEAD_MMAP_FLAG)
 #define MEMHEAD_IS_ALIGNED(memhead) ((memhead)->len & (size_t) MEMHEAD_ALIGN_FLAG)
+/* Lengths are only aligned to 4 bytes, use the highest bit for blocks owned by the small cache. */
+#define MEMHEAD_SMALL_FLAG ((size_t)1 << (sizeof(size_t) * 8 - 1))
+#define MEMHEAD_IS_SMALL(memhead) ((memhead)->len & MEMHEAD_SMALL_FLAG)
+#define MEMHEAD_FLAG_MASK ((size_t) (MEMHEAD_MMAP_FLAG | MEMHEAD_ALIGN_FLAG) | MEMHEAD_SMALL_FLAG)
 
 /* Uncomment this to have proper peak counter. */
 #define USE_ATOMIC_MAX
@@ -119,10 +129,301 @@ static void mem_unlock_thread(void)
 }
 #endif
 
+/* -------------------------------------------------------------------- */
+/* Small block cache
+ *
+ * Optional, see #MEM_lockfree_use_small_cache.
+ *
+ * Blocks up to SMALL_BLOCK_MAX bytes are carved from larger chunks into size
+ * classes and kept in per-thread free-lists, so allocating and freeing small
+ * blocks neither calls system malloc nor touches shared cache-lines.
+ *
+ * - Freed blocks go to the cache of the freeing thread, slots of a class are
+ *   interchangeable so it doesn't matter which thread allocated them.
+ * - When a thread's list grows too big, half of it is moved to a central list
+ *   (protected by a spin-lock) where other threads refill from.
+ * - Block and memory counters are accumulated per thread (wrapping around on
+ *   frees from other threads) and summed when queried.
+ * - Chunks are never given back to the system.
+ */
+
+#define SMALL_BLOCK_MAX 512
+#define SMALL_CLASS_SIZE 16
+#define SMALL_CLASS_NUM ((SMALL_BLOCK_MAX + sizeof(MemHead) + SMALL_CLASS_SIZE - 1) / SMALL_CLASS_SIZE)
+#define SMALL_CLASS_INDEX(len) ((unsigned int)(((len) + sizeof(MemHead) - 1) / SMALL_CLASS_SIZE))
+/* Slot size includes MemHead, multiple of 16 so data keeps the same alignment as system malloc. */
+#define SMALL_SLOT_SIZE(index) (((size_t)(index) + 1) * SMALL_CLASS_SIZE)
+#define SMALL_CHUNK_SIZE (64 * 1024)
+/* Maximum number of free blocks a thread keeps per class, in bytes and absolute. */
+#define SMALL_CACHE_BYTES (32 * 1024)
+#define SMALL_CACHE_NUM_MAX 512
+
+#if defined(_MSC_VER)
+#  define SMALL_THREAD_LOCAL __declspec(thread)
+#else
+#  define SMALL_THREAD_LOCAL __thread
+#endif
+
+typedef struct SmallBlock {
+	struct SmallBlock *next;
+	/* Only used for the first block of a batch in the central list. */
+	struct SmallBlock *next_batch;
+} SmallBlock;
+
+typedef struct SmallFreeList {
+	SmallBlock *first;
+	unsigned int num;
+} SmallFreeList;
+
+typedef struct SmallThreadCache {
+	struct SmallThreadCache *next, *prev;
+	SmallFreeList free[SMALL_CLASS_NUM];
+	/* Not yet applied to the global counters. */
+	size_t mem_in_use;
+	unsigned int totblock;
+} SmallThreadCache;
+
+typedef struct SmallCentralList {
+	SmallBlock *batches;
+	uint32_t lock;
+} SmallCentralList;
+
+static bool use_small_cache = false;
+static size_t small_chunk_mem = 0;
+static SmallCentralList small_central[SMALL_CLASS_NUM];
+/* All thread caches, so counters can be summed. */
+static SmallThreadCache *small_caches = NULL;
+static uint32_t small_caches_lock = 0;
+static SMALL_THREAD_LOCAL SmallThreadCache *small_cache_tls = NULL;
+/* Only used to get notified when a thread exits. */
+#if defined(WIN32)
+static DWORD small_cache_key;
+#else
+static pthread_key_t small_cache_key;
+#endif
+
+MEM_INLINE void small_spin_lock(uint32_t *lock)
+{
+	while (atomic_cas_uint32(lock, 0, 1) != 0) {
+		/* pass */
+	}
+}
+
+MEM_INLINE void small_spin_unlock(uint32_t *lock)
+{
+	atomic_cas_uint32(lock, 1, 0);
+}
+
+MEM_INLINE unsigned int small_cache_num_max(const unsigned int index)
+{
+	const size_t num = SMALL_CACHE_BYTES / SMALL_SLOT_SIZE(index);
+	return (num < SMALL_CACHE_NUM_MAX) ? (unsigned int)num : SMALL_CACHE_NUM_MAX;
+}
+
+static void small_central_push(const unsigned int index, SmallBlock *first)
+{
+	SmallCentralList *central = &small_central[index];
+	small_spin_lock(&central->lock);
+	first->next_batch = central->batches;
+	central->batches = first;
+	small_spin_unlock(&central->lock);
+}
+
+static SmallBlock *small_central_pop(const unsigned int index)
+{
+	SmallCentralList *central = &small_central[index];
+	SmallBlock *first;
+	small_spin_lock(&central->lock);
+	first = central->batches;
+	if (first) {
+		central->batches = first->next_batch;
+	}
+	small_spin_unlock(&central->lock);
+	return first;
+}
+
+#if defined(WIN32)
+static void WINAPI small_cache_thread_exit(void *cache_v)
+#else
+static void small_cache_thread_exit(void *cache_v)
+#endif
+{
+	SmallThreadCache *cache = cache_v;
+	unsigned int i;
+
+	if (cache == NULL) {
+		return;
+	}
+
+	for (i = 0; i < SMALL_CLASS_NUM; i++) {
+		if (cache->free[i].first) {
+			small_central_push(i, cache->free[i].first);
+		}
+	}
+
+	small_spin_lock(&small_caches_lock);
+	if (cache->prev) {
+		cache->prev->next = cache->next;
+	}
+	else {
+		small_caches = cache->next;
+	}
+	if (cache->next) {
+		cache->next->prev = cache->prev;
+	}
+	atomic_add_z(&mem_in_use, cache->mem_in_use);
+	atomic_add_u(&totblock, cache->totblock);
+	small_spin_unlock(&small_caches_lock);
+
+	small_cache_tls = NULL;
+	free(cache);
+}
+
+static SmallThreadCache *small_cache_ensure(void)
+{
+	SmallThreadCache *cache = small_cache_tls;
+
+	if (UNLIKELY(cache == NULL)) {
+		cache = (SmallThreadCache *)calloc(1, sizeof(*cache));
+		if (UNLIKELY(cache == NULL)) {
+			return NULL;
+		}
+
+		small_spin_lock(&small_caches_lock);
+		cache->next = small_caches;
+		if (small_caches) {
+			small_caches->prev = cache;
+		}
+		small_caches = cache;
+		small_spin_unlock(&small_caches_lock);
+
+#if defined(WIN32)
+		FlsSetValue(small_cache_key, cache);
+#else
+		pthread_setspecific(small_cache_key, cache);
+#endif
+		small_cache_tls = cache;
+	}
+
+	return cache;
+}
+
+static bool small_cache_refill(SmallThreadCache *cache, const unsigned int index)
+{
+	SmallFreeList *list = &cache->free[index];
+	SmallBlock *first = small_central_pop(index);
+	unsigned int num = 0;
+
+	if (first) {
+		SmallBlock *block;
+		for (block = first; block; block = block->next) {
+			num++;
+		}
+	}
+	else {
+		const size_t slot_size = SMALL_SLOT_SIZE(index);
+		char *chunk = (char *)malloc(SMALL_CHUNK_SIZE);
+		size_t ofs;
+
+		if (UNLIKELY(chunk == NULL)) {
+			return false;
+		}
+		atomic_add_z(&small_chunk_mem, SMALL_CHUNK_SIZE);
+
+		first = (SmallBlock *)chunk;
+		for (ofs = 0; ofs + 2 * slot_size <= SMALL_CHUNK_SIZE; ofs += slot_size) {
+			((SmallBlock *)(chunk + ofs))->next = (SmallBlock *)(chunk + ofs + slot_size);
+			num++;
+		}
+		((SmallBlock *)(chunk + ofs))->next = NULL;
+		num++;
+	}
+
+	list->first = first;
+	list->num = num;
+
+	/* Peak memory only accounts this thread's small blocks when refilling. */
+	update_maximum(&peak_mem, mem_in_use + cache->mem_in_use);
+
+	return true;
+}
+
+/* Keep the most recently freed half (likely still in CPU cache), move the rest to the central list. */
+static void small_cache_release(SmallFreeList *list, const unsigned int index)
+{
+	const unsigned int keep = list->num / 2;
+	SmallBlock *last = list->first;
+	unsigned int i;
+
+	for (i = 1; i < keep; i++) {
+		last = last->next;
+	}
+	small_central_push(index, last->next);
+	last->next = NULL;
+	list->num = keep;
+}
+
+/* Returns NULL when the block can't be allocated from the cache, caller falls back to system malloc. */
+MEM_INLINE void *small_alloc(size_t len)
+{
+	SmallThreadCache *cache = small_cache_ensure();
+	const unsigned int index = SMALL_CLASS_INDEX(len);
+	SmallFreeList *list;
+	MemHead *memh;
+
+	if (UNLIKELY(cache == NULL)) {
+		return NULL;
+	}
+
+	list = &cache->free[index];
+	if (UNLIKELY(list->first == NULL) && !small_cache_refill(cache, index)) {
+		return NULL;
+	}
+
+	memh = (MemHead *)list->first;
+	list->first = list->first->next;
+	list->num--;
+
+	memh->len = len | MEMHEAD_SMALL_FLAG;
+	cache->totblock++;
+	cache->mem_in_use += len;
+
+	return PTR_FROM_MEMHEAD(memh);
+}
+
+MEM_INLINE void small_free(MemHead *memh, size_t len)
+{
+	SmallThreadCache *cache = small_cache_ensure();
+	const unsigned int index = SMALL_CLASS_INDEX(len);
+	SmallBlock *block = (SmallBlock *)memh;
+	SmallFreeList *list;
+
+	if (UNLIKELY(cache == NULL)) {
+		/* Hand it directly to the central list. */
+		atomic_sub_u(&totblock, 1);
+		atomic_sub_z(&mem_in_use, len);
+		block->next = NULL;
+		small_central_push(index, block);
+		return;
+	}
+
+	cache->totblock--;
+	cache->mem_in_use -= len;
+
+	list = &cache->free[index];
+	block->next = list->first;
+	list->first = block;
+	list->num++;
+
+	if (UNLIKELY(list->num > small_cache_num_max(index))) {
+		small_cache_release(list, index);
+	}
+}
+
 size_t MEM_lockfree_allocN_len(const void *vmemh)
 {
 	if (vmemh) {
-		return MEMHEAD_FROM_PTR(vmemh)->len & ~((size_t) (MEMHEAD_MMAP_FLAG | MEMHEAD_ALIGN_FLAG));
+		return MEMHEAD_FROM_PTR(vmemh)->len & ~MEMHEAD_FLAG_MASK;
 	}
 	else {
 		return 0;
@@ -142,6 +443,14 @@ void MEM_lockfree_freeN(void *vmemh)
 		return;
 	}
 
+	if (MEMHEAD_IS_SMALL(memh)) {
+		if (UNLIKELY(malloc_debug_memset && len)) {
+			memset(memh + 1, 255, len);
+		}
+		small_free(memh, len);
+		return;
+	}
+
 	atomic_sub_u(&totblock, 1);
 	atomic_sub_z(&mem_in_use, len);
 
@@ -283,6 +592,14 @@ void *MEM_lockfree_callocN(size_t len, const char *str)
 
 	len = SIZET_ALIGN_4(len);
 
+	if (use_small_cache && len <= SMALL_BLOCK_MAX) {
+		void *ptr = small_alloc(len);
+		if (LIKELY(ptr)) {
+			memset(ptr, 0, len);
+			return ptr;
+		}
+	}
+
 	memh = (MemHead *)calloc(1, len + sizeof(MemHead));
 
 	if (LIKELY(memh)) {
@@ -304,6 +621,16 @@ void *MEM_lockfree_mallocN(size_t len, const char *str)
 
 	len = SIZET_ALIGN_4(len);
 
+	if (use_small_cache && len <= SMALL_BLOCK_MAX) {
+		void *ptr = small_alloc(len);
+		if (LIKELY(ptr)) {
+			if (UNLIKELY(malloc_debug_memset && len)) {
+				memset(ptr, 255, len);
+			}
+			return ptr;
+		}
+	}
+
 	memh = (MemHead *)malloc(len + sizeof(MemHead));
 
 	if (LIKELY(memh)) {
@@ -428,9 +755,13 @@ void MEM_lockfree_callbackmemlist(void (*func)(void *))
 void MEM_lockfree_printmemlist_stats(void)
 {
 	printf("\ntotal memory len: %.3f MB\n",
-	       (double)mem_in_use / (double)(1024 * 1024));
+	       (double)MEM_lockfree_get_memory_in_use() / (double)(1024 * 1024));
 	printf("peak memory len: %.3f MB\n",
-	       (double)peak_mem / (double)(1024 * 1024));
+	       (double)MEM_lockfree_get_peak_memory() / (double)(1024 * 1024));
+	if (use_small_cache) {
+		printf("small block cache chunks: %.3f MB\n",
+		       (double)small_chunk_mem / (double)(1024 * 1024));
+	}
 	printf("\nFor more detailed per-block statistics run Blender with memory debugging command line argument.\n");
 
 #ifdef HAVE_MALLOC_STATS
@@ -462,7 +793,16 @@ void MEM_lockfree_set_memory_debug(void)
 
 size_t MEM_lockfree_get_memory_in_use(void)
 {
-	return mem_in_use;
+	size_t mem = mem_in_use;
+	if (use_small_cache) {
+		SmallThreadCache *cache;
+		small_spin_lock(&small_caches_lock);
+		for (cache = small_caches; cache; cache = cache->next) {
+			mem += cache->mem_in_use;
+		}
+		small_spin_unlock(&small_caches_lock);
+	}
+	return mem;
 }
 
 size_t MEM_lockfree_get_mapped_memory_in_use(void)
@@ -472,20 +812,45 @@ size_t MEM_lockfree_get_mapped_memory_in_use(void)
 
 unsigned int MEM_lockfree_get_memory_blocks_in_use(void)
 {
-	return totblock;
+	unsigned int blocks = totblock;
+	if (use_small_cache) {
+		SmallThreadCache *cache;
+		small_spin_lock(&small_caches_lock);
+		for (cache = small_caches; cache; cache = cache->next) {
+			blocks += cache->totblock;
+		}
+		small_spin_unlock(&small_caches_lock);
+	}
+	return blocks;
 }
 
 /* dummy */
 void MEM_lockfree_reset_peak_memory(void)
 {
-	peak_mem = mem_in_use;
+	peak_mem = MEM_lockfree_get_memory_in_use();
 }
 
 size_t MEM_lockfree_get_peak_memory(void)
 {
+	if (use_small_cache) {
+		update_maximum(&peak_mem, MEM_lockfree_get_memory_in_use());
+	}
 	return peak_mem;
 }
 
+void MEM_lockfree_use_small_cache(void)
+{
+	if (use_small_cache) {
+		return;
+	}
+#if defined(WIN32)
+	small_cache_key = FlsAlloc(small_cache_thread_exit);
+#else
+	pthread_key_create(&small_cache_key, small_cache_thread_exit);
+#endif
+	use_small_cache = true;
+}
+
 #ifndef NDEBUG
 const char *MEM_lockfree_name_ptr(void *vmemh)
 {
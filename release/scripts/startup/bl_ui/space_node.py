@@ -420,6 +420,7 @@ class NODE_PT_quality(bpy.types.Panel):
         col.prop(tree, "render_quality", text="Render")
         col.prop(tree, "edit_quality", text="Edit")
         col.prop(tree, "chunk_size")
+        col.prop(tree, "progressive_preview", text="Preview")
 
         col = layout.column()
         col.prop(tree, "use_opencl")
@@ -428,6 +429,12 @@ class NODE_PT_quality(bpy.types.Panel):
         col.prop(tree, "use_viewer_border")
         col.prop(snode, "show_highlight")
 
+        col = layout.column()
+        col.prop(tree, "use_result_cache")
+        sub = col.column()
+        sub.active = tree.use_result_cache
+        sub.prop(tree, "cache_size")
+
 
 class NODE_UL_interface_sockets(bpy.types.UIList):
     def draw_item(self, context, layout, data, item, icon, active_data, active_propname, index):
@@ -486,12 +486,12 @@ class USERPREF_PT_system(Panel):
 
         col.label(text="Images Draw Method:")
         col.prop(system, "image_draw_method", text="")
+        col.prop(system, "use_display_lut")
 
         col.separator()
 
         col.label(text="Sequencer / Clip Editor:")
-        # currently disabled in the code
-        # col.prop(system, "prefetch_frames")
+        col.prop(system, "prefetch_frames")
         col.prop(system, "memory_cache_limit")
 
         # 3. Column
@@ -187,10 +187,13 @@ struct SeqEffectHandle {
  * ********************************************************************** */
 
 struct ImBuf *BKE_sequencer_give_ibuf(const SeqRenderData *context, float cfra, int chanshown);
-struct ImBuf *BKE_sequencer_give_ibuf_threaded(const SeqRenderData *context, float cfra, int chanshown);
 struct ImBuf *BKE_sequencer_give_ibuf_direct(const SeqRenderData *context, float cfra, struct Sequence *seq);
 struct ImBuf *BKE_sequencer_give_ibuf_seqbase(const SeqRenderData *context, float cfra, int chan_shown, struct ListBase *seqbasep);
-void BKE_sequencer_give_ibuf_prefetch_request(const SeqRenderData *context, float cfra, int chan_shown);
+
+/* render the frames following cfra into the cache in the background, up to U.prefetchframes */
+void BKE_sequencer_prefetch_start(const SeqRenderData *context, float cfra, int chanshown);
+void BKE_sequencer_prefetch_stop(void);
+void BKE_sequencer_prefetch_free(void);
 
 /* **********************************************************************
  * sequencer.c
@@ -251,6 +254,8 @@ bool BKE_sequencer_input_have_to_preprocess(const SeqRenderData *context, struct
 
 void BKE_sequencer_proxy_rebuild_context(struct Main *bmain, struct Scene *scene, struct Sequence *seq, struct GSet *file_list, ListBase *queue);
 void BKE_sequencer_proxy_rebuild(struct SeqIndexBuildContext *context, short *stop, short *do_update, float *progress);
+void BKE_sequencer_proxy_rebuild_batch(struct SeqIndexBuildContext **contexts, int num_contexts,
+                                       short *stop, short *do_update, float *progress);
 void BKE_sequencer_proxy_rebuild_finish(struct SeqIndexBuildContext *context, bool stop);
 
 void BKE_sequencer_proxy_set(struct Sequence *seq, bool value);
@@ -251,6 +251,9 @@ static void movieclip_open_anim_file(MovieClip *clip)
 		clip->anim = openanim(str, IB_rect, 0, clip->colorspace_settings.name);
 
 		if (clip->anim) {
+			/* decode the frames following the shown one in the background */
+			IMB_anim_set_readahead(clip->anim, 8);
+
 			if (clip->flag & MCLIP_USE_PROXY_CUSTOM_DIR) {
 				char dir[FILE_MAX];
 				BLI_strncpy(dir, clip->proxy.dir, sizeof(dir));
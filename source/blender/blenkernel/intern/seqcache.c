@@ -40,6 +40,7 @@
 #include "IMB_imbuf_types.h"
 
 #include "BLI_listbase.h"
+#include "BLI_threads.h"
 
 #include "BKE_sequencer.h"
 #include "BKE_scene.h"
@@ -69,7 +70,11 @@ typedef struct SeqPreprocessCache {
 static struct MovieCache *moviecache = NULL;
 static struct SeqPreprocessCache *preprocess_cache = NULL;
 
+/* strips of a stack and prefetched frames are rendered from several threads */
+static ThreadMutex cache_lock = BLI_MUTEX_INITIALIZER;
+
 static void preprocessed_cache_destruct(void);
+static void preprocessed_cache_cleanup(void);
 
 static bool seq_cmp_render_data(const SeqRenderData *a, const SeqRenderData *b)
 {
@@ -123,6 +128,8 @@ static bool seqcache_hashcmp(const void *a_, const void *b_)
 
 void BKE_sequencer_cache_destruct(void)
 {
+	BKE_sequencer_prefetch_free();
+
 	if (moviecache)
 		IMB_moviecache_free(moviecache);
 
@@ -131,12 +138,19 @@ void BKE_sequencer_cache_destruct(void)
 
 void BKE_sequencer_cache_cleanup(void)
 {
+	/* prefetched frames would be rendered from the old data */
+	BKE_sequencer_prefetch_stop();
+
+	BLI_mutex_lock(&cache_lock);
+
 	if (moviecache) {
 		IMB_moviecache_free(moviecache);
 		moviecache = IMB_moviecache_create("seqcache", sizeof(SeqCacheKey), seqcache_hashhash, seqcache_hashcmp);
 	}
 
-	BKE_sequencer_preprocessed_cache_cleanup();
+	preprocessed_cache_cleanup();
+
+	BLI_mutex_unlock(&cache_lock);
 }
 
 static bool seqcache_key_check_seq(ImBuf *UNUSED(ibuf), void *userkey, void *userdata)
@@ -149,12 +163,20 @@ static bool seqcache_key_check_seq(ImBuf *UNUSED(ibuf), void *userkey, void *use
 
 void BKE_sequencer_cache_cleanup_sequence(Sequence *seq)
 {
+	BKE_sequencer_prefetch_stop();
+
+	BLI_mutex_lock(&cache_lock);
 	if (moviecache)
 		IMB_moviecache_cleanup(moviecache, seqcache_key_check_seq, seq);
+	BLI_mutex_unlock(&cache_lock);
 }
 
 struct ImBuf *BKE_sequencer_cache_get(const SeqRenderData *context, Sequence *seq, float cfra, eSeqStripElemIBuf type)
 {
+	ImBuf *ibuf = NULL;
+
+	BLI_mutex_lock(&cache_lock);
+
 	if (moviecache && seq) {
 		SeqCacheKey key;
 
@@ -163,10 +185,12 @@ struct ImBuf *BKE_sequencer_cache_get(const SeqRenderData *context, Sequence *se
 		key.cfra = cfra - seq->start;
 		key.type = type;
 
-		return IMB_moviecache_get(moviecache, &key);
+		ibuf = IMB_moviecache_get(moviecache, &key);
 	}
 
-	return NULL;
+	BLI_mutex_unlock(&cache_lock);
+
+	return ibuf;
 }
 
 void BKE_sequencer_cache_put(const SeqRenderData *context, Sequence *seq, float cfra, eSeqStripElemIBuf type, ImBuf *i)
@@ -177,19 +201,23 @@ void BKE_sequencer_cache_put(const SeqRenderData *context, Sequence *seq, float
 		return;
 	}
 
-	if (!moviecache) {
-		moviecache = IMB_moviecache_create("seqcache", sizeof(SeqCacheKey), seqcache_hashhash, seqcache_hashcmp);
-	}
-
 	key.seq = seq;
 	key.context = *context;
 	key.cfra = cfra - seq->start;
 	key.type = type;
 
+	BLI_mutex_lock(&cache_lock);
+
+	if (!moviecache) {
+		moviecache = IMB_moviecache_create("seqcache", sizeof(SeqCacheKey), seqcache_hashhash, seqcache_hashcmp);
+	}
+
 	IMB_moviecache_put(moviecache, &key, i);
+
+	BLI_mutex_unlock(&cache_lock);
 }
 
-void BKE_sequencer_preprocessed_cache_cleanup(void)
+static void preprocessed_cache_cleanup(void)
 {
 	SeqPreprocessCacheElem *elem;
 
@@ -204,12 +232,19 @@ void BKE_sequencer_preprocessed_cache_cleanup(void)
 	BLI_listbase_clear(&preprocess_cache->elems);
 }
 
+void BKE_sequencer_preprocessed_cache_cleanup(void)
+{
+	BLI_mutex_lock(&cache_lock);
+	preprocessed_cache_cleanup();
+	BLI_mutex_unlock(&cache_lock);
+}
+
 static void preprocessed_cache_destruct(void)
 {
 	if (!preprocess_cache)
 		return;
 
-	BKE_sequencer_preprocessed_cache_cleanup();
+	preprocessed_cache_cleanup();
 
 	MEM_freeN(preprocess_cache);
 	preprocess_cache = NULL;
@@ -218,40 +253,44 @@ static void preprocessed_cache_destruct(void)
 ImBuf *BKE_sequencer_preprocessed_cache_get(const SeqRenderData *context, Sequence *seq, float cfra, eSeqStripElemIBuf type)
 {
 	SeqPreprocessCacheElem *elem;
+	ImBuf *ibuf = NULL;
 
-	if (!preprocess_cache)
-		return NULL;
-
-	if (preprocess_cache->cfra != cfra)
-		return NULL;
+	BLI_mutex_lock(&cache_lock);
 
-	for (elem = preprocess_cache->elems.first; elem; elem = elem->next) {
-		if (elem->seq != seq)
-			continue;
+	if (preprocess_cache && preprocess_cache->cfra == cfra) {
+		for (elem = preprocess_cache->elems.first; elem; elem = elem->next) {
+			if (elem->seq != seq)
+				continue;
 
-		if (elem->type != type)
-			continue;
+			if (elem->type != type)
+				continue;
 
-		if (seq_cmp_render_data(&elem->context, context) != 0)
-			continue;
+			if (seq_cmp_render_data(&elem->context, context) != 0)
+				continue;
 
-		IMB_refImBuf(elem->ibuf);
-		return elem->ibuf;
+			IMB_refImBuf(elem->ibuf);
+			ibuf = elem->ibuf;
+			break;
+		}
 	}
 
-	return NULL;
+	BLI_mutex_unlock(&cache_lock);
+
+	return ibuf;
 }
 
 void BKE_sequencer_preprocessed_cache_put(const SeqRenderData *context, Sequence *seq, float cfra, eSeqStripElemIBuf type, ImBuf *ibuf)
 {
 	SeqPreprocessCacheElem *elem;
 
+	BLI_mutex_lock(&cache_lock);
+
 	if (!preprocess_cache) {
 		preprocess_cache = MEM_callocN(sizeof(SeqPreprocessCache), "sequencer preprocessed cache");
 	}
 	else {
 		if (preprocess_cache->cfra != cfra)
-			BKE_sequencer_preprocessed_cache_cleanup();
+			preprocessed_cache_cleanup();
 	}
 
 	elem = MEM_callocN(sizeof(SeqPreprocessCacheElem), "sequencer preprocessed cache element");
@@ -266,6 +305,8 @@ void BKE_sequencer_preprocessed_cache_put(const SeqRenderData *context, Sequence
 	IMB_refImBuf(ibuf);
 
 	BLI_addtail(&preprocess_cache->elems, elem);
+
+	BLI_mutex_unlock(&cache_lock);
 }
 
 void BKE_sequencer_preprocessed_cache_cleanup_sequence(Sequence *seq)
@@ -275,6 +316,8 @@ void BKE_sequencer_preprocessed_cache_cleanup_sequence(Sequence *seq)
 	if (!preprocess_cache)
 		return;
 
+	BLI_mutex_lock(&cache_lock);
+
 	for (elem = preprocess_cache->elems.first; elem; elem = elem_next) {
 		elem_next = elem->next;
 
@@ -284,4 +327,6 @@ void BKE_sequencer_preprocessed_cache_cleanup_sequence(Sequence *seq)
 			BLI_freelinkN(&preprocess_cache->elems, elem);
 		}
 	}
+
+	BLI_mutex_unlock(&cache_lock);
 }
@@ -36,6 +36,7 @@
 
 #include "MEM_guardedalloc.h"
 
+#include "DNA_action_types.h"
 #include "DNA_sequence_types.h"
 #include "DNA_movieclip_types.h"
 #include "DNA_mask_types.h"
@@ -50,6 +51,7 @@
 #include "BLI_path_util.h"
 #include "BLI_string.h"
 #include "BLI_string_utf8.h"
+#include "BLI_task.h"
 #include "BLI_threads.h"
 #include "BLI_utildefines.h"
 
@@ -78,8 +80,6 @@
 
 #include "RE_pipeline.h"
 
-#include <pthread.h>
-
 #include "IMB_imbuf.h"
 #include "IMB_imbuf_types.h"
 #include "IMB_colormanagement.h"
@@ -93,10 +93,14 @@
 
 #define USE_SCENE_RECURSIVE_HACK
 
+/* movie frames decoded in the background ahead of the playback */
+#define SEQ_ANIM_READAHEAD 8
+
 static ImBuf *seq_render_strip_stack(const SeqRenderData *context, ListBase *seqbasep, float cfra, int chanshown);
 static ImBuf *seq_render_strip(const SeqRenderData *context, Sequence *seq, float cfra);
 static void seq_free_animdata(Scene *scene, Sequence *seq);
 static ImBuf *seq_render_mask(const SeqRenderData *context, Mask *mask, float nr, bool make_float);
+static bool seq_prefetch_is_running(void);
 static int seq_num_files(Scene *scene, char views_format, const bool is_multiview);
 static void seq_anim_add_suffix(Scene *scene, struct anim *anim, const int view_id);
 
@@ -188,6 +192,11 @@ static void seq_free_strip(Strip *strip)
 /* only give option to skip cache locally (static func) */
 static void BKE_sequence_free_ex(Scene *scene, Sequence *seq, const bool do_cache)
 {
+	/* copies without a scene are never prefetched */
+	if (scene) {
+		BKE_sequencer_prefetch_stop();
+	}
+
 	if (seq->strip)
 		seq_free_strip(seq->strip);
 
@@ -1728,6 +1737,9 @@ static ImBuf *seq_proxy_fetch(const SeqRenderData *context, Sequence *seq, int c
 			}
 
 			proxy->anim = openanim(name, IB_rect, 0, seq->strip->colorspace_settings.name);
+			if (proxy->anim) {
+				IMB_anim_set_readahead(proxy->anim, SEQ_ANIM_READAHEAD);
+			}
 		}
 		if (proxy->anim == NULL) {
 			return NULL;
@@ -2000,6 +2012,35 @@ void BKE_sequencer_proxy_rebuild(SeqIndexBuildContext *context, short *stop, sho
 	}
 }
 
+/* Movie strips are rebuilt concurrently, other strips are rendered by the sequencer one at a time. */
+void BKE_sequencer_proxy_rebuild_batch(SeqIndexBuildContext **contexts, int num_contexts,
+                                       short *stop, short *do_update, float *progress)
+{
+	struct IndexBuildContext **index_contexts = MEM_mallocN(sizeof(*index_contexts) * num_contexts, __func__);
+	int num_movies = 0;
+	int i;
+
+	for (i = 0; i < num_contexts; i++) {
+		if (contexts[i]->seq->type == SEQ_TYPE_MOVIE) {
+			index_contexts[num_movies++] = contexts[i]->index_context;
+		}
+	}
+
+	IMB_anim_index_rebuild_batch(index_contexts, num_movies, stop, do_update, progress);
+
+	for (i = 0; i < num_contexts; i++) {
+		if (*stop || G.is_break) {
+			break;
+		}
+
+		if (contexts[i]->seq->type != SEQ_TYPE_MOVIE) {
+			BKE_sequencer_proxy_rebuild(contexts[i], stop, do_update, progress);
+		}
+	}
+
+	MEM_freeN(index_contexts);
+}
+
 void BKE_sequencer_proxy_rebuild_finish(SeqIndexBuildContext *context, bool stop)
 {
 	if (context->index_context) {
@@ -2898,6 +2939,7 @@ static ImBuf *seq_render_movie_strip(const SeqRenderData *context, Sequence *seq
 			if (sanim->anim) {
 				IMB_Proxy_Size proxy_size = seq_rendersize_to_proxysize(context->preview_render_size);
 				IMB_anim_set_preseek(sanim->anim, seq->anim_preseek);
+				IMB_anim_set_readahead(sanim->anim, SEQ_ANIM_READAHEAD);
 
 				ibuf_arr[i] = IMB_anim_absolute(sanim->anim, nr + seq->anim_startofs,
 				                                seq->strip->proxy ? seq->strip->proxy->tc : IMB_TC_RECORD_RUN,
@@ -2964,6 +3006,7 @@ monoview_movie:
 		if (sanim && sanim->anim) {
 			IMB_Proxy_Size proxy_size = seq_rendersize_to_proxysize(context->preview_render_size);
 			IMB_anim_set_preseek(sanim->anim, seq->anim_preseek);
+			IMB_anim_set_readahead(sanim->anim, SEQ_ANIM_READAHEAD);
 
 			ibuf = IMB_anim_absolute(sanim->anim, nr + seq->anim_startofs,
 			                         seq->strip->proxy ? seq->strip->proxy->tc : IMB_TC_RECORD_RUN,
@@ -3636,9 +3679,131 @@ static ImBuf *seq_render_strip_stack_apply_effect(const SeqRenderData *context,
 	return out;
 }
 
+/* Strips which only read their own image or movie and can be rendered alongside each other,
+ * others may render strips or data which are shared with other strips. */
+static bool seq_render_strip_is_threadsafe(Sequence *seq)
+{
+	SequenceModifierData *smd;
+
+	if (!ELEM(seq->type, SEQ_TYPE_IMAGE, SEQ_TYPE_MOVIE)) {
+		return false;
+	}
+
+	for (smd = seq->modifiers.first; smd; smd = smd->next) {
+		if (smd->mask_sequence || smd->mask_id) {
+			return false;
+		}
+	}
+
+	return true;
+}
+
+typedef struct RenderStackThreadData {
+	const SeqRenderData *context;
+	Sequence **seq_arr;
+	ImBuf **ibuf_arr;
+	float cfra;
+} RenderStackThreadData;
+
+static void seq_render_strip_stack_task(TaskPool * __restrict pool, void *taskdata, int UNUSED(threadid))
+{
+	RenderStackThreadData *data = BLI_task_pool_userdata(pool);
+	int i = GET_INT_FROM_POINTER(taskdata);
+
+	data->ibuf_arr[i] = seq_render_strip(data->context, data->seq_arr[i], data->cfra);
+}
+
+/* Render the strips which are going to be blended in parallel, following the same early outs
+ * as seq_render_strip_stack. Only done when there's more than one of them which is threadsafe. */
+static void seq_render_strip_stack_threaded(const SeqRenderData *context, Sequence **seq_arr, int count,
+                                            float cfra, ImBuf **ibuf_arr)
+{
+	bool use_thread[MAXSEQ + 1] = {false};
+	int tot_thread = 0;
+	int i;
+
+	for (i = count - 1; i >= 0; i--) {
+		Sequence *seq = seq_arr[i];
+		ImBuf *ibuf = BKE_sequencer_cache_get(context, seq, cfra, SEQ_STRIPELEM_IBUF_COMP);
+		int early_out;
+
+		if (ibuf) {
+			IMB_freeImBuf(ibuf);
+			break;
+		}
+
+		if (seq->blend_mode == SEQ_BLEND_REPLACE) {
+			early_out = EARLY_NO_INPUT;
+		}
+		else {
+			early_out = seq_get_early_out_for_blend_mode(seq);
+		}
+
+		if (early_out != EARLY_USE_INPUT_1 && seq_render_strip_is_threadsafe(seq)) {
+			use_thread[i] = true;
+			tot_thread++;
+		}
+
+		if (ELEM(early_out, EARLY_NO_INPUT, EARLY_USE_INPUT_2)) {
+			break;
+		}
+	}
+
+	if (tot_thread > 1) {
+		TaskScheduler *task_scheduler = BLI_task_scheduler_get();
+		TaskPool *task_pool;
+		RenderStackThreadData data;
+
+		data.context = context;
+		data.seq_arr = seq_arr;
+		data.ibuf_arr = ibuf_arr;
+		data.cfra = cfra;
+
+		task_pool = BLI_task_pool_create(task_scheduler, &data);
+
+		for (i = 0; i < count; i++) {
+			if (use_thread[i]) {
+				/* the movie read-ahead can't be started from the tasks, only from the main thread */
+				if (seq_arr[i]->type == SEQ_TYPE_MOVIE) {
+					StripAnim *sanim;
+
+					seq_open_anim_file(context->scene, seq_arr[i], false);
+
+					for (sanim = seq_arr[i]->anims.first; sanim; sanim = sanim->next) {
+						if (sanim->anim) {
+							IMB_anim_set_readahead(sanim->anim, SEQ_ANIM_READAHEAD);
+						}
+					}
+				}
+
+				BLI_task_pool_push(task_pool, seq_render_strip_stack_task, SET_INT_IN_POINTER(i), false,
+				                   TASK_PRIORITY_HIGH);
+			}
+		}
+
+		BLI_task_pool_work_and_wait(task_pool);
+		BLI_task_pool_free(task_pool);
+	}
+}
+
+/* take the strip rendered by seq_render_strip_stack_threaded, or render it now */
+static ImBuf *seq_render_strip_stack_ibuf(const SeqRenderData *context, Sequence **seq_arr, ImBuf **ibuf_arr,
+                                          int i, float cfra)
+{
+	ImBuf *ibuf = ibuf_arr[i];
+
+	if (ibuf == NULL) {
+		return seq_render_strip(context, seq_arr[i], cfra);
+	}
+
+	ibuf_arr[i] = NULL;
+	return ibuf;
+}
+
 static ImBuf *seq_render_strip_stack(const SeqRenderData *context, ListBase *seqbasep, float cfra, int chanshown)
 {
 	Sequence *seq_arr[MAXSEQ + 1];
+	ImBuf *ibuf_arr[MAXSEQ + 1] = {NULL};
 	int count;
 	int i;
 	ImBuf *out = NULL;
@@ -3710,6 +3875,8 @@ static ImBuf *seq_render_strip_stack(const SeqRenderData *context, ListBase *seq
 		return out;
 	}
 
+	seq_render_strip_stack_threaded(context, seq_arr, count, cfra, ibuf_arr);
+
 	for (i = count - 1; i >= 0; i--) {
 		int early_out;
 		Sequence *seq = seq_arr[i];
@@ -3720,7 +3887,7 @@ static ImBuf *seq_render_strip_stack(const SeqRenderData *context, ListBase *seq
 			break;
 		}
 		if (seq->blend_mode == SEQ_BLEND_REPLACE) {
-			out = seq_render_strip(context, seq, cfra);
+			out = seq_render_strip_stack_ibuf(context, seq_arr, ibuf_arr, i, cfra);
 			break;
 		}
 
@@ -3729,7 +3896,7 @@ static ImBuf *seq_render_strip_stack(const SeqRenderData *context, ListBase *seq
 		switch (early_out) {
 			case EARLY_NO_INPUT:
 			case EARLY_USE_INPUT_2:
-				out = seq_render_strip(context, seq, cfra);
+				out = seq_render_strip_stack_ibuf(context, seq_arr, ibuf_arr, i, cfra);
 				break;
 			case EARLY_USE_INPUT_1:
 				if (i == 0) {
@@ -3739,7 +3906,7 @@ static ImBuf *seq_render_strip_stack(const SeqRenderData *context, ListBase *seq
 			case EARLY_DO_EFFECT:
 				if (i == 0) {
 					ImBuf *ibuf1 = IMB_allocImBuf(context->rectx, context->recty, 32, IB_rect);
-					ImBuf *ibuf2 = seq_render_strip(context, seq, cfra);
+					ImBuf *ibuf2 = seq_render_strip_stack_ibuf(context, seq_arr, ibuf_arr, i, cfra);
 
 					out = seq_render_strip_stack_apply_effect(context, seq, cfra, ibuf1, ibuf2);
 
@@ -3763,7 +3930,7 @@ static ImBuf *seq_render_strip_stack(const SeqRenderData *context, ListBase *seq
 
 		if (seq_get_early_out_for_blend_mode(seq) == EARLY_DO_EFFECT) {
 			ImBuf *ibuf1 = out;
-			ImBuf *ibuf2 = seq_render_strip(context, seq, cfra);
+			ImBuf *ibuf2 = seq_render_strip_stack_ibuf(context, seq_arr, ibuf_arr, i, cfra);
 
 			out = seq_render_strip_stack_apply_effect(context, seq, cfra, ibuf1, ibuf2);
 
@@ -3774,6 +3941,13 @@ static ImBuf *seq_render_strip_stack(const SeqRenderData *context, ListBase *seq
 		BKE_sequencer_cache_put(context, seq_arr[i], cfra, SEQ_STRIPELEM_IBUF_COMP, out);
 	}
 
+	/* in case the blending didn't take all of the strips rendered in advance */
+	for (i = 0; i < count; i++) {
+		if (ibuf_arr[i]) {
+			IMB_freeImBuf(ibuf_arr[i]);
+		}
+	}
+
 	return out;
 }
 
@@ -3782,6 +3956,17 @@ static ImBuf *seq_render_strip_stack(const SeqRenderData *context, ListBase *seq
  * you have to free after usage!
  */
 
+static ListBase *seq_get_seqbase_shown(Editing *ed, int chanshown)
+{
+	if ((chanshown < 0) && !BLI_listbase_is_empty(&ed->metastack)) {
+		int count = BLI_listbase_count(&ed->metastack);
+		count = max_ii(count + chanshown, 0);
+		return ((MetaStack *)BLI_findlink(&ed->metastack, count))->oldbasep;
+	}
+
+	return ed->seqbasep;
+}
+
 ImBuf *BKE_sequencer_give_ibuf(const SeqRenderData *context, float cfra, int chanshown)
 {
 	Editing *ed = BKE_sequencer_editing_get(context->scene, false);
@@ -3789,13 +3974,25 @@ ImBuf *BKE_sequencer_give_ibuf(const SeqRenderData *context, float cfra, int cha
 	
 	if (ed == NULL) return NULL;
 
-	if ((chanshown < 0) && !BLI_listbase_is_empty(&ed->metastack)) {
-		int count = BLI_listbase_count(&ed->metastack);
-		count = max_ii(count + chanshown, 0);
-		seqbasep = ((MetaStack *)BLI_findlink(&ed->metastack, count))->oldbasep;
-	}
-	else {
-		seqbasep = ed->seqbasep;
+	seqbasep = seq_get_seqbase_shown(ed, chanshown);
+
+	if (seq_prefetch_is_running()) {
+		/* the prefetch may be rendering the same strips, only take frames it rendered already */
+		Sequence *seq_arr[MAXSEQ + 1];
+		int count = get_shown_sequences(seqbasep, cfra, chanshown, seq_arr);
+		ImBuf *ibuf;
+
+		if (count == 0) {
+			return NULL;
+		}
+
+		ibuf = BKE_sequencer_cache_get(context, seq_arr[count - 1], cfra, SEQ_STRIPELEM_IBUF_COMP);
+
+		if (ibuf) {
+			return ibuf;
+		}
+
+		BKE_sequencer_prefetch_stop();
 	}
 
 #ifdef USE_SCENE_RECURSIVE_HACK
@@ -3807,165 +4004,227 @@ ImBuf *BKE_sequencer_give_ibuf(const SeqRenderData *context, float cfra, int cha
 
 ImBuf *BKE_sequencer_give_ibuf_seqbase(const SeqRenderData *context, float cfra, int chanshown, ListBase *seqbasep)
 {
+	BKE_sequencer_prefetch_stop();
+
 	return seq_render_strip_stack(context, seqbasep, cfra, chanshown);
 }
 
 
 ImBuf *BKE_sequencer_give_ibuf_direct(const SeqRenderData *context, float cfra, Sequence *seq)
 {
+	BKE_sequencer_prefetch_stop();
+
 	return seq_render_strip(context, seq, cfra);
 }
 
-/* *********************** threading api ******************* */
+/* *********************** prefetch ******************* */
 
-static ListBase running_threads;
-static ListBase prefetch_wait;
-static ListBase prefetch_done;
+/* Frames following the one given to the preview are rendered into the cache by a background task
+ * while playing back. Only the prefetch renders strips while it's running, the give_ibuf functions
+ * take frames it already rendered from the cache and stop it before rendering anything themselves.
+ * It's also stopped before the cache is cleared, so it never renders from data which is being changed. */
 
-static pthread_mutex_t queue_lock          = PTHREAD_MUTEX_INITIALIZER;
-static pthread_mutex_t wakeup_lock         = PTHREAD_MUTEX_INITIALIZER;
-static pthread_cond_t wakeup_cond          = PTHREAD_COND_INITIALIZER;
+typedef struct SeqPrefetch {
+	TaskPool *pool;
 
-//static pthread_mutex_t prefetch_ready_lock = PTHREAD_MUTEX_INITIALIZER;
-//static pthread_cond_t  prefetch_ready_cond = PTHREAD_COND_INITIALIZER;
+	/* render settings of the preview, seqbasep is NULL when stopped */
+	SeqRenderData context;
+	ListBase *seqbasep;
+	int chanshown;
 
-static pthread_mutex_t frame_done_lock     = PTHREAD_MUTEX_INITIALIZER;
-static pthread_cond_t frame_done_cond      = PTHREAD_COND_INITIALIZER;
+	/* frame given to the preview and last frame rendered ahead of it */
+	int cfra;
+	int rendered_cfra;
+	int end_cfra;
+	int frames;
 
-static volatile bool seq_thread_shutdown = true; 
-static volatile int seq_last_given_monoton_cfra = 0;
-static int monoton_cfra = 0;
+	bool running;
+} SeqPrefetch;
 
-typedef struct PrefetchThread {
-	struct PrefetchThread *next, *prev;
-	
-	Scene *scene;
-	struct PrefetchQueueElem *current;
-	pthread_t pthread;
-	int running;
-	
-} PrefetchThread;
+static SeqPrefetch seq_prefetch = {NULL};
+static ThreadMutex prefetch_lock = BLI_MUTEX_INITIALIZER;
 
-typedef struct PrefetchQueueElem {
-	struct PrefetchQueueElem *next, *prev;
-	
-	int rectx;
-	int recty;
-	float cfra;
-	int chanshown;
-	int preview_render_size;
+/* scenes are rendered with OpenGL or the render pipeline, which only works from the main thread */
+static bool seq_prefetch_seqbase_is_supported(ListBase *seqbase)
+{
+	Sequence *seq;
 
-	int monoton_cfra;
+	for (seq = seqbase->first; seq; seq = seq->next) {
+		if (seq->type == SEQ_TYPE_SCENE) {
+			return false;
+		}
+		if (seq->seqbase.first && !seq_prefetch_seqbase_is_supported(&seq->seqbase)) {
+			return false;
+		}
+	}
 
-	ImBuf *ibuf;
-} PrefetchQueueElem;
+	return true;
+}
 
-void BKE_sequencer_give_ibuf_prefetch_request(const SeqRenderData *context, float cfra, int chanshown)
+/* prefetched frames would use the values of the current frame */
+static bool seq_prefetch_fcurves_are_animated(ListBase *fcurves)
 {
-	PrefetchQueueElem *e;
-	if (seq_thread_shutdown) {
-		return;
-	}
+	FCurve *fcu;
 
-	e = MEM_callocN(sizeof(PrefetchQueueElem), "prefetch_queue_elem");
-	e->rectx = context->rectx;
-	e->recty = context->recty;
-	e->cfra = cfra;
-	e->chanshown = chanshown;
-	e->preview_render_size = context->preview_render_size;
-	e->monoton_cfra = monoton_cfra++;
+	for (fcu = fcurves->first; fcu; fcu = fcu->next) {
+		if (fcu->rna_path && STRPREFIX(fcu->rna_path, "sequence_editor")) {
+			return true;
+		}
+	}
 
-	pthread_mutex_lock(&queue_lock);
-	BLI_addtail(&prefetch_wait, e);
-	pthread_mutex_unlock(&queue_lock);
-	
-	pthread_mutex_lock(&wakeup_lock);
-	pthread_cond_signal(&wakeup_cond);
-	pthread_mutex_unlock(&wakeup_lock);
+	return false;
 }
 
-ImBuf *BKE_sequencer_give_ibuf_threaded(const SeqRenderData *context, float cfra, int chanshown)
+static bool seq_prefetch_is_animated(Scene *scene)
 {
-	PrefetchQueueElem *e = NULL;
-	bool found_something = false;
+	AnimData *adt = scene->adt;
 
-	if (seq_thread_shutdown) {
-		return BKE_sequencer_give_ibuf(context, cfra, chanshown);
+	if (adt == NULL) {
+		return false;
 	}
 
-	while (!e) {
-		bool success = false;
-		pthread_mutex_lock(&queue_lock);
+	return ((adt->action && seq_prefetch_fcurves_are_animated(&adt->action->curves)) ||
+	        seq_prefetch_fcurves_are_animated(&adt->drivers));
+}
 
-		for (e = prefetch_done.first; e; e = e->next) {
-			if (cfra == e->cfra &&
-			    chanshown == e->chanshown &&
-			    context->rectx == e->rectx &&
-			    context->recty == e->recty &&
-			    context->preview_render_size == e->preview_render_size)
-			{
-				success = true;
-				found_something = true;
-				break;
-			}
-		}
+static bool seq_prefetch_context_equals(const SeqRenderData *a, const SeqRenderData *b)
+{
+	return ((a->bmain == b->bmain) &&
+	        (a->scene == b->scene) &&
+	        (a->rectx == b->rectx) &&
+	        (a->recty == b->recty) &&
+	        (a->preview_render_size == b->preview_render_size) &&
+	        (a->view_id == b->view_id));
+}
 
-		if (!e) {
-			for (e = prefetch_wait.first; e; e = e->next) {
-				if (cfra == e->cfra &&
-				    chanshown == e->chanshown &&
-				    context->rectx == e->rectx &&
-				    context->recty == e->recty &&
-				    context->preview_render_size == e->preview_render_size)
-				{
-					found_something = true;
-					break;
-				}
-			}
+static bool seq_prefetch_is_running(void)
+{
+	bool running;
+
+	BLI_mutex_lock(&prefetch_lock);
+	running = seq_prefetch.running;
+	BLI_mutex_unlock(&prefetch_lock);
+
+	return running;
+}
+
+static void seq_prefetch_task(TaskPool * __restrict pool, void *UNUSED(taskdata), int UNUSED(threadid))
+{
+	while (!BLI_task_pool_canceled(pool)) {
+		SeqRenderData context;
+		ListBase *seqbasep;
+		int chanshown, cfra;
+		ImBuf *ibuf;
+
+		BLI_mutex_lock(&prefetch_lock);
+
+		/* start again after the current frame when it jumped, e.g. when playback looped */
+		if (seq_prefetch.rendered_cfra < seq_prefetch.cfra ||
+		    seq_prefetch.rendered_cfra > seq_prefetch.cfra + seq_prefetch.frames)
+		{
+			seq_prefetch.rendered_cfra = seq_prefetch.cfra;
 		}
 
-		if (!e) {
-			PrefetchThread *tslot;
+		cfra = seq_prefetch.rendered_cfra + 1;
 
-			for (tslot = running_threads.first;
-			     tslot;
-			     tslot = tslot->next)
-			{
-				if (tslot->current &&
-				    cfra == tslot->current->cfra &&
-				    chanshown == tslot->current->chanshown &&
-				    context->rectx == tslot->current->rectx &&
-				    context->recty == tslot->current->recty &&
-				    context->preview_render_size == tslot->current->preview_render_size)
-				{
-					found_something = true;
-					break;
-				}
-			}
+		if (cfra > seq_prefetch.cfra + seq_prefetch.frames || cfra > seq_prefetch.end_cfra) {
+			seq_prefetch.running = false;
+			BLI_mutex_unlock(&prefetch_lock);
+			break;
 		}
 
-		/* e->ibuf is unrefed by render thread on next round. */
+		seq_prefetch.rendered_cfra = cfra;
+		context = seq_prefetch.context;
+		seqbasep = seq_prefetch.seqbasep;
+		chanshown = seq_prefetch.chanshown;
 
-		if (e) {
-			seq_last_given_monoton_cfra = e->monoton_cfra;
+		BLI_mutex_unlock(&prefetch_lock);
+
+		/* frames which are already cached are returned right away */
+		ibuf = seq_render_strip_stack(&context, seqbasep, cfra, chanshown);
+
+		if (ibuf) {
+			IMB_freeImBuf(ibuf);
 		}
+	}
+}
 
-		pthread_mutex_unlock(&queue_lock);
+void BKE_sequencer_prefetch_start(const SeqRenderData *context, float cfra, int chanshown)
+{
+	Scene *scene = context->scene;
+	Editing *ed = BKE_sequencer_editing_get(scene, false);
+	ListBase *seqbasep;
+	bool changed;
 
-		if (!success) {
-			e = NULL;
+	if (ed == NULL || U.prefetchframes <= 0 || G.is_rendering || context->skip_cache) {
+		return;
+	}
 
-			if (!found_something) {
-				fprintf(stderr, "SEQ-THREAD: Requested frame not in queue ???\n");
-				break;
-			}
-			pthread_mutex_lock(&frame_done_lock);
-			pthread_cond_wait(&frame_done_cond, &frame_done_lock);
-			pthread_mutex_unlock(&frame_done_lock);
+	if (!seq_prefetch_seqbase_is_supported(&ed->seqbase) || seq_prefetch_is_animated(scene)) {
+		BKE_sequencer_prefetch_stop();
+		return;
+	}
+
+	seqbasep = seq_get_seqbase_shown(ed, chanshown);
+
+	BLI_mutex_lock(&prefetch_lock);
+	changed = (seq_prefetch.seqbasep != seqbasep ||
+	           seq_prefetch.chanshown != chanshown ||
+	           !seq_prefetch_context_equals(&seq_prefetch.context, context));
+	BLI_mutex_unlock(&prefetch_lock);
+
+	if (changed) {
+		BKE_sequencer_prefetch_stop();
+	}
+
+	BLI_mutex_lock(&prefetch_lock);
+
+	if (changed) {
+		seq_prefetch.context = *context;
+		seq_prefetch.seqbasep = seqbasep;
+		seq_prefetch.chanshown = chanshown;
+		seq_prefetch.rendered_cfra = (int)cfra;
+	}
+
+	seq_prefetch.cfra = (int)cfra;
+	seq_prefetch.end_cfra = PEFRA;
+	seq_prefetch.frames = U.prefetchframes;
+
+	if (!seq_prefetch.running) {
+		if (seq_prefetch.pool == NULL) {
+			seq_prefetch.pool = BLI_task_pool_create_background(BLI_task_scheduler_get(), NULL);
 		}
+
+		seq_prefetch.running = true;
+		BLI_task_pool_push(seq_prefetch.pool, seq_prefetch_task, NULL, false, TASK_PRIORITY_LOW);
+	}
+
+	BLI_mutex_unlock(&prefetch_lock);
+}
+
+void BKE_sequencer_prefetch_stop(void)
+{
+	if (seq_prefetch.pool == NULL) {
+		return;
+	}
+
+	/* waits for the frame which is being rendered */
+	BLI_task_pool_cancel(seq_prefetch.pool);
+
+	BLI_mutex_lock(&prefetch_lock);
+	/* canceled tasks which didn't start yet never clear it */
+	seq_prefetch.running = false;
+	seq_prefetch.seqbasep = NULL;
+	BLI_mutex_unlock(&prefetch_lock);
+}
+
+void BKE_sequencer_prefetch_free(void)
+{
+	if (seq_prefetch.pool) {
+		BKE_sequencer_prefetch_stop();
+		BLI_task_pool_free(seq_prefetch.pool);
+		seq_prefetch.pool = NULL;
 	}
-	
-	return e ? e->ibuf : NULL;
 }
 
 /* check whether sequence cur depends on seq */
@@ -4017,6 +4276,9 @@ static void sequence_invalidate_cache(Scene *scene, Sequence *seq, bool invalida
 {
 	Editing *ed = scene->ed;
 
+	/* the prefetch may be using the animation which is freed below */
+	BKE_sequencer_prefetch_stop();
+
 	/* invalidate cache for current sequence */
 	if (invalidate_self) {
 		/* Animation structure holds some buffers inside,
@@ -0,0 +1,45 @@
+/*
+ * ***** BEGIN GPL LICENSE BLOCK *****
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ * ***** END GPL LICENSE BLOCK *****
+ */
+
+#ifndef __BLI_COLOR_LUT_H__
+#define __BLI_COLOR_LUT_H__
+
+/** \file BLI_color_lut.h
+ *  \ingroup bli
+ *  \brief A 3D LUT baked from a color transform of scene linear values.
+ */
+
+#include "BLI_compiler_attrs.h"
+#include "BLI_sys_types.h"
+
+struct ColorLUT;
+typedef struct ColorLUT ColorLUT;
+
+/* transforms num_pixels RGB triplets in place */
+typedef void (*ColorLUTBakeFunc)(void *userdata, float *rgb, size_t num_pixels);
+
+ColorLUT *BLI_color_lut_bake(int size, ColorLUTBakeFunc bake, void *userdata) ATTR_WARN_UNUSED_RESULT ATTR_NONNULL(2);
+void BLI_color_lut_free(ColorLUT *lut) ATTR_NONNULL();
+
+void BLI_color_lut_apply_v3(const ColorLUT *lut, float rgb[3]) ATTR_NONNULL();
+void BLI_color_lut_apply(const ColorLUT *lut, float *buffer, size_t num_pixels, int channels, bool predivide)
+        ATTR_NONNULL();
+
+#endif  /* __BLI_COLOR_LUT_H__ */
@@ -139,6 +139,16 @@ int BLI_bvhtree_ray_cast_all(
         BVHTree *tree, const float co[3], const float dir[3], float radius,
         BVHTree_RayCastCallback callback, void *userdata);
 
+/* batch queries: many rays/coordinates at once, threaded (callbacks must be thread-safe) */
+int BLI_bvhtree_ray_cast_batch(
+        BVHTree *tree, const float (*co)[3], const float (*dir)[3], const int rays_num, float radius,
+        BVHTreeRayHit *hits,
+        BVHTree_RayCastCallback callback, void *userdata,
+        int flag);
+int BLI_bvhtree_find_nearest_batch(
+        BVHTree *tree, const float (*co)[3], const int co_num, BVHTreeNearest *nearest,
+        BVHTree_NearestPointCallback callback, void *userdata);
+
 float BLI_bvhtree_bb_raycast(const float bv[6], const float light_start[3], const float light_end[3], float pos[3]);
 
 /* range query */
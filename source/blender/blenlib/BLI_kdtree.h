@@ -58,6 +58,11 @@ int BLI_kdtree_find_nearest(
 #define BLI_kdtree_range_search(tree, co, r_nearest, range) \
         BLI_kdtree_range_search__normal(tree, co, NULL, r_nearest, range)
 
+void BLI_kdtree_find_nearest_n_batch(
+        const KDTree *tree, const float (*co)[3], unsigned int co_num,
+        KDTreeNearest *r_nearest, unsigned int *r_found,
+        unsigned int n) ATTR_NONNULL(1, 2, 4);
+
 int BLI_kdtree_find_nearest_cb(
         const KDTree *tree, const float co[3],
         int (*filter_cb)(void *user_data, int index, const float co[3], float dist_sq), void *user_data,
@@ -56,6 +56,12 @@ void         BLI_mempool_destroy(BLI_mempool *pool) ATTR_NONNULL(1);
 int          BLI_mempool_count(BLI_mempool *pool) ATTR_NONNULL(1);
 void        *BLI_mempool_findelem(BLI_mempool *pool, unsigned int index) ATTR_WARN_UNUSED_RESULT ATTR_NONNULL(1);
 
+/* only for BLI_MEMPOOL_THREADED pools */
+void        *BLI_mempool_alloc_thread(BLI_mempool *pool, const int thread_id) ATTR_MALLOC ATTR_WARN_UNUSED_RESULT ATTR_NONNULL(1);
+void        *BLI_mempool_calloc_thread(BLI_mempool *pool, const int thread_id) ATTR_MALLOC ATTR_WARN_UNUSED_RESULT ATTR_NONNULL(1);
+void         BLI_mempool_free_thread(BLI_mempool *pool, void *addr, const int thread_id) ATTR_NONNULL(1, 2);
+void         BLI_mempool_thread_caches_flush(BLI_mempool *pool) ATTR_NONNULL(1);
+
 void        BLI_mempool_as_table(BLI_mempool *pool, void **data) ATTR_NONNULL(1, 2);
 void      **BLI_mempool_as_tableN(BLI_mempool *pool, const char *allocstr) ATTR_MALLOC ATTR_WARN_UNUSED_RESULT ATTR_NONNULL(1, 2);
 void        BLI_mempool_as_array(BLI_mempool *pool, void *data) ATTR_NONNULL(1, 2);
@@ -82,6 +88,13 @@ enum {
 	 * \note order of iteration is only assured to be the order of allocation when no chunks have been freed.
 	 */
 	BLI_MEMPOOL_ALLOW_ITER = (1 << 0),
+	/** allow allocating and freeing from multiple threads,
+	 * using the ``_thread`` functions and a task thread id.
+	 *
+	 * \note #BLI_mempool_thread_caches_flush must be called once threads are done,
+	 * before using any other function on the pool.
+	 */
+	BLI_MEMPOOL_THREADED   = (1 << 1),
 };
 
 void  BLI_mempool_iternew(BLI_mempool *pool, BLI_mempool_iter *iter) ATTR_NONNULL();
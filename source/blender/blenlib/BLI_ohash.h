@@ -0,0 +1,161 @@
+/*
+ * ***** BEGIN GPL LICENSE BLOCK *****
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ * ***** END GPL LICENSE BLOCK *****
+ */
+
+#ifndef __BLI_OHASH_H__
+#define __BLI_OHASH_H__
+
+/** \file BLI_ohash.h
+ *  \ingroup bli
+ *
+ * Open-addressing variant of #GHash/#GSet, with the same callbacks & flags.
+ */
+
+#include "BLI_ghash.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef struct OHash OHash;
+
+typedef struct OHashIterator {
+	OHash *oh;
+	struct OHashEntry *curEntry;
+	unsigned int curIndex;
+} OHashIterator;
+
+/* *** */
+
+OHash *BLI_ohash_new_ex(GHashHashFP hashfp, GHashCmpFP cmpfp, const char *info,
+                        const unsigned int nentries_reserve) ATTR_MALLOC ATTR_WARN_UNUSED_RESULT;
+OHash *BLI_ohash_new(GHashHashFP hashfp, GHashCmpFP cmpfp, const char *info) ATTR_MALLOC ATTR_WARN_UNUSED_RESULT;
+OHash *BLI_ohash_copy(OHash *oh, GHashKeyCopyFP keycopyfp,
+                      GHashValCopyFP valcopyfp) ATTR_MALLOC ATTR_WARN_UNUSED_RESULT;
+void   BLI_ohash_free(OHash *oh, GHashKeyFreeFP keyfreefp, GHashValFreeFP valfreefp);
+void   BLI_ohash_reserve(OHash *oh, const unsigned int nentries_reserve);
+void   BLI_ohash_insert(OHash *oh, void *key, void *val);
+bool   BLI_ohash_reinsert(OHash *oh, void *key, void *val, GHashKeyFreeFP keyfreefp, GHashValFreeFP valfreefp);
+void  *BLI_ohash_lookup(OHash *oh, const void *key) ATTR_WARN_UNUSED_RESULT;
+void  *BLI_ohash_lookup_default(OHash *oh, const void *key, void *val_default) ATTR_WARN_UNUSED_RESULT;
+void **BLI_ohash_lookup_p(OHash *oh, const void *key) ATTR_WARN_UNUSED_RESULT;
+bool   BLI_ohash_ensure_p(OHash *oh, void *key, void ***r_val) ATTR_WARN_UNUSED_RESULT;
+bool   BLI_ohash_remove(OHash *oh, const void *key, GHashKeyFreeFP keyfreefp, GHashValFreeFP valfreefp);
+void   BLI_ohash_clear(OHash *oh, GHashKeyFreeFP keyfreefp, GHashValFreeFP valfreefp);
+void   BLI_ohash_clear_ex(OHash *oh, GHashKeyFreeFP keyfreefp, GHashValFreeFP valfreefp,
+                          const unsigned int nentries_reserve);
+void  *BLI_ohash_popkey(OHash *oh, const void *key, GHashKeyFreeFP keyfreefp) ATTR_WARN_UNUSED_RESULT;
+bool   BLI_ohash_haskey(OHash *oh, const void *key) ATTR_WARN_UNUSED_RESULT;
+unsigned int BLI_ohash_size(OHash *oh) ATTR_WARN_UNUSED_RESULT;
+void   BLI_ohash_flag_set(OHash *oh, unsigned int flag);
+void   BLI_ohash_flag_clear(OHash *oh, unsigned int flag);
+
+OHash *BLI_ohash_ptr_new_ex(const char *info, const unsigned int nentries_reserve) ATTR_MALLOC ATTR_WARN_UNUSED_RESULT;
+OHash *BLI_ohash_ptr_new(const char *info) ATTR_MALLOC ATTR_WARN_UNUSED_RESULT;
+OHash *BLI_ohash_int_new_ex(const char *info, const unsigned int nentries_reserve) ATTR_MALLOC ATTR_WARN_UNUSED_RESULT;
+OHash *BLI_ohash_int_new(const char *info) ATTR_MALLOC ATTR_WARN_UNUSED_RESULT;
+
+/* *** */
+
+/**
+ * \note Unlike #GHashIterator, removing entries while iterating is not supported,
+ * since removal shifts following entries back into the freed slot.
+ */
+void           BLI_ohashIterator_init(OHashIterator *ohi, OHash *oh);
+void           BLI_ohashIterator_step(OHashIterator *ohi);
+
+BLI_INLINE void  *BLI_ohashIterator_getKey(OHashIterator *ohi) ATTR_WARN_UNUSED_RESULT;
+BLI_INLINE void  *BLI_ohashIterator_getValue(OHashIterator *ohi) ATTR_WARN_UNUSED_RESULT;
+BLI_INLINE void **BLI_ohashIterator_getValue_p(OHashIterator *ohi) ATTR_WARN_UNUSED_RESULT;
+BLI_INLINE bool   BLI_ohashIterator_done(OHashIterator *ohi) ATTR_WARN_UNUSED_RESULT;
+
+struct _oh_Entry { void *key, *val; unsigned int hash; };
+BLI_INLINE void  *BLI_ohashIterator_getKey(OHashIterator *ohi)     { return  ((struct _oh_Entry *)ohi->curEntry)->key; }
+BLI_INLINE void  *BLI_ohashIterator_getValue(OHashIterator *ohi)   { return  ((struct _oh_Entry *)ohi->curEntry)->val; }
+BLI_INLINE void **BLI_ohashIterator_getValue_p(OHashIterator *ohi) { return &((struct _oh_Entry *)ohi->curEntry)->val; }
+BLI_INLINE bool   BLI_ohashIterator_done(OHashIterator *ohi)       { return !ohi->curEntry; }
+/* disallow further access */
+#ifdef __GNUC__
+#  pragma GCC poison _oh_Entry
+#else
+#  define _oh_Entry void
+#endif
+
+#define OHASH_ITER(oh_iter_, ohash_) \
+	for (BLI_ohashIterator_init(&oh_iter_, ohash_); \
+	     BLI_ohashIterator_done(&oh_iter_) == false; \
+	     BLI_ohashIterator_step(&oh_iter_))
+
+/* *** */
+
+typedef struct OSet OSet;
+
+typedef struct OSetIterator {
+	OHashIterator _ohi;
+} OSetIterator;
+
+OSet  *BLI_oset_new_ex(GSetHashFP hashfp, GSetCmpFP cmpfp, const char *info,
+                       const unsigned int nentries_reserve) ATTR_MALLOC ATTR_WARN_UNUSED_RESULT;
+OSet  *BLI_oset_new(GSetHashFP hashfp, GSetCmpFP cmpfp, const char *info) ATTR_MALLOC ATTR_WARN_UNUSED_RESULT;
+OSet  *BLI_oset_copy(OSet *os, GSetKeyCopyFP keycopyfp) ATTR_MALLOC ATTR_WARN_UNUSED_RESULT;
+unsigned int BLI_oset_size(OSet *os) ATTR_WARN_UNUSED_RESULT;
+void   BLI_oset_flag_set(OSet *os, unsigned int flag);
+void   BLI_oset_flag_clear(OSet *os, unsigned int flag);
+void   BLI_oset_free(OSet *os, GSetKeyFreeFP keyfreefp);
+void   BLI_oset_insert(OSet *os, void *key);
+bool   BLI_oset_add(OSet *os, void *key);
+bool   BLI_oset_reinsert(OSet *os, void *key, GSetKeyFreeFP keyfreefp);
+bool   BLI_oset_haskey(OSet *os, const void *key) ATTR_WARN_UNUSED_RESULT;
+bool   BLI_oset_remove(OSet *os, const void *key, GSetKeyFreeFP keyfreefp);
+void   BLI_oset_clear_ex(OSet *os, GSetKeyFreeFP keyfreefp,
+                         const unsigned int nentries_reserve);
+void   BLI_oset_clear(OSet *os, GSetKeyFreeFP keyfreefp);
+
+OSet *BLI_oset_ptr_new_ex(const char *info, const unsigned int nentries_reserve) ATTR_MALLOC ATTR_WARN_UNUSED_RESULT;
+OSet *BLI_oset_ptr_new(const char *info) ATTR_MALLOC ATTR_WARN_UNUSED_RESULT;
+OSet *BLI_oset_int_new_ex(const char *info, const unsigned int nentries_reserve) ATTR_MALLOC ATTR_WARN_UNUSED_RESULT;
+OSet *BLI_oset_int_new(const char *info) ATTR_MALLOC ATTR_WARN_UNUSED_RESULT;
+
+BLI_INLINE void BLI_osetIterator_init(OSetIterator *osi, OSet *os) { BLI_ohashIterator_init((OHashIterator *)osi, (OHash *)os); }
+BLI_INLINE void *BLI_osetIterator_getKey(OSetIterator *osi) { return BLI_ohashIterator_getKey((OHashIterator *)osi); }
+BLI_INLINE void BLI_osetIterator_step(OSetIterator *osi) { BLI_ohashIterator_step((OHashIterator *)osi); }
+BLI_INLINE bool BLI_osetIterator_done(OSetIterator *osi) { return BLI_ohashIterator_done((OHashIterator *)osi); }
+
+#define OSET_ITER(os_iter_, oset_) \
+	for (BLI_osetIterator_init(&os_iter_, oset_); \
+	     BLI_osetIterator_done(&os_iter_) == false; \
+	     BLI_osetIterator_step(&os_iter_))
+
+
+/* For testing, debugging only */
+#ifdef GHASH_INTERNAL_API
+int BLI_ohash_slots_size(OHash *oh);
+int BLI_oset_slots_size(OSet *os);
+
+double BLI_ohash_calc_quality_ex(
+        OHash *oh, double *r_load, double *r_probe_mean, int *r_probe_max);
+double BLI_oset_calc_quality_ex(
+        OSet *os, double *r_load, double *r_probe_mean, int *r_probe_max);
+#endif  /* GHASH_INTERNAL_API */
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __BLI_OHASH_H__ */
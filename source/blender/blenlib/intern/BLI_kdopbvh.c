@@ -37,10 +37,16 @@
  *   #BLI_bvhtree_find_nearest, #BVHNearestData
  * - Overlapping 2 trees:
  *   #BLI_bvhtree_overlap, #BVHOverlapData_Shared, #BVHOverlapData_Thread
+ * - Batches of ray-casts & nearest point queries, threaded:
+ *   #BLI_bvhtree_ray_cast_batch, #BLI_bvhtree_find_nearest_batch
  */
 
 #include <assert.h>
 
+#ifdef __SSE__
+#  include <xmmintrin.h>
+#endif
+
 #include "MEM_guardedalloc.h"
 
 #include "BLI_utildefines.h"
@@ -61,8 +67,18 @@
  */
 #ifdef DEBUG
 #  define KDOPBVH_THREAD_LEAF_THRESHOLD 0
+#  define KDOPBVH_THREAD_QUERY_THRESHOLD 0
 #else
 #  define KDOPBVH_THREAD_LEAF_THRESHOLD 1024
+#  define KDOPBVH_THREAD_QUERY_THRESHOLD 256
+#endif
+
+/* Number of leafs computed by a single task when refitting the top-most branches in parallel. */
+#define KDOPBVH_REFIT_CHUNK_SIZE 4096
+
+/* Use SIMD versions of the node tests for the first 3 axes (the AABB part of any k-DOP). */
+#ifdef __SSE__
+#  define USE_KDOPBVH_SSE
 #endif
 
 typedef unsigned char axis_t;
@@ -143,6 +159,13 @@ typedef struct BVHRayCastData {
 	float idot_axis[13];
 	int index[6];
 
+#ifdef USE_KDOPBVH_SSE
+	/* (x, y, z, z) lanes, the last one duplicated so it doesn't affect horizontal min/max */
+	__m128 sse_origin;
+	__m128 sse_idot_axis;
+	__m128 sse_idot_neg;  /* lane mask, set when the ray travels toward the negative side of the axis */
+#endif
+
 	BVHTreeRayHit hit;
 } BVHRayCastData;
 
@@ -176,6 +199,35 @@ MINLINE axis_t min_axis(axis_t a, axis_t b)
 {
 	return (a < b) ? a : b;
 }
+
+#ifdef USE_KDOPBVH_SSE
+/**
+ * Load the first 3 axes of a bounding volume, lanes are (x, y, z, z),
+ * duplicating the last axis so horizontal min/max and compares can use all lanes.
+ */
+BLI_INLINE void bv_aabb_load_sse(const float *bv, __m128 *r_min, __m128 *r_max)
+{
+	const __m128 xy = _mm_loadu_ps(bv);  /* x_min, x_max, y_min, y_max */
+	const __m128 z = _mm_loadl_pi(_mm_setzero_ps(), (const __m64 *)(bv + 4));  /* z_min, z_max, 0, 0 */
+
+	*r_min = _mm_shuffle_ps(xy, z, _MM_SHUFFLE(0, 0, 2, 0));
+	*r_max = _mm_shuffle_ps(xy, z, _MM_SHUFFLE(1, 1, 3, 1));
+}
+
+BLI_INLINE float sse_hmax(__m128 v)
+{
+	v = _mm_max_ps(v, _mm_shuffle_ps(v, v, _MM_SHUFFLE(2, 3, 0, 1)));
+	v = _mm_max_ps(v, _mm_shuffle_ps(v, v, _MM_SHUFFLE(1, 0, 3, 2)));
+	return _mm_cvtss_f32(v);
+}
+
+BLI_INLINE float sse_hmin(__m128 v)
+{
+	v = _mm_min_ps(v, _mm_shuffle_ps(v, v, _MM_SHUFFLE(2, 3, 0, 1)));
+	v = _mm_min_ps(v, _mm_shuffle_ps(v, v, _MM_SHUFFLE(1, 0, 3, 2)));
+	return _mm_cvtss_f32(v);
+}
+#endif  /* USE_KDOPBVH_SSE */
 #if 0
 MINLINE axis_t max_axis(axis_t a, axis_t b)
 {
@@ -497,6 +549,62 @@ static void refit_kdop_hull(BVHTree *tree, BVHNode *node, int start, int end)
 
 }
 
+typedef struct BVHRefitData {
+	BVHTree *tree;
+	BVHNode *chunk_nodes;
+	int start, end;
+} BVHRefitData;
+
+static void refit_kdop_hull_chunk_task_cb(void *userdata, const int chunk)
+{
+	BVHRefitData *data = userdata;
+	const int start = data->start + chunk * KDOPBVH_REFIT_CHUNK_SIZE;
+	const int end = min_ii(start + KDOPBVH_REFIT_CHUNK_SIZE, data->end);
+
+	refit_kdop_hull(data->tree, &data->chunk_nodes[chunk], start, end);
+}
+
+/**
+ * A version of #refit_kdop_hull for large leaf ranges (top-most branches),
+ * refitting fixed size chunks of leafs in parallel, then joining them.
+ */
+static void refit_kdop_hull_threaded(BVHTree *tree, BVHNode *node, int start, int end)
+{
+	const int chunks_num = (end - start + KDOPBVH_REFIT_CHUNK_SIZE - 1) / KDOPBVH_REFIT_CHUNK_SIZE;
+	BVHNode *chunk_nodes = MEM_mallocN(sizeof(*chunk_nodes) * (size_t)chunks_num, __func__);
+	float *chunk_bv = MEM_mallocN(sizeof(*chunk_bv) * (size_t)(tree->axis * chunks_num), __func__);
+	float *bv = node->bv;
+	int i;
+	axis_t axis_iter;
+
+	BVHRefitData data = {
+		.tree = tree, .chunk_nodes = chunk_nodes,
+		.start = start, .end = end,
+	};
+
+	for (i = 0; i < chunks_num; i++) {
+		chunk_nodes[i].bv = &chunk_bv[i * tree->axis];
+	}
+
+	BLI_task_parallel_range(0, chunks_num, &data, refit_kdop_hull_chunk_task_cb, true);
+
+	node_minmax_init(tree, node);
+
+	for (i = 0; i < chunks_num; i++) {
+		const float *chunk_node_bv = chunk_nodes[i].bv;
+		for (axis_iter = tree->start_axis; axis_iter < tree->stop_axis; axis_iter++) {
+			if (chunk_node_bv[(2 * axis_iter)] < bv[(2 * axis_iter)])
+				bv[(2 * axis_iter)] = chunk_node_bv[(2 * axis_iter)];
+
+			if (chunk_node_bv[(2 * axis_iter) + 1] > bv[(2 * axis_iter) + 1])
+				bv[(2 * axis_iter) + 1] = chunk_node_bv[(2 * axis_iter) + 1];
+		}
+	}
+
+	MEM_freeN(chunk_nodes);
+	MEM_freeN(chunk_bv);
+}
+
 /**
  * only supports x,y,z axis in the moment
  * but we should use a plain and simple function here for speed sake */
@@ -759,6 +867,9 @@ typedef struct BVHDivNodesData {
 	int depth;
 	int i;
 	int first_of_next_level;
+
+	/* branches of this level were already refitted (see #refit_kdop_hull_threaded) */
+	bool is_refit;
 } BVHDivNodesData;
 
 static void non_recursive_bvh_div_nodes_task_cb(void *userdata, const int j)
@@ -776,7 +887,9 @@ static void non_recursive_bvh_div_nodes_task_cb(void *userdata, const int j)
 
 	/* This calculates the bounding box of this branch
 	 * and chooses the largest axis as the axis to divide leafs */
-	refit_kdop_hull(data->tree, parent, parent_leafs_begin, parent_leafs_end);
+	if (!data->is_refit) {
+		refit_kdop_hull(data->tree, parent, parent_leafs_begin, parent_leafs_end);
+	}
 	split_axis = get_largest_axis(parent->bv);
 
 	/* Save split axis (this can be used on raytracing to speedup the query time) */
@@ -844,6 +957,7 @@ static void non_recursive_bvh_div_nodes(BVHTree *tree, BVHNode *branches_array,
 	const int tree_type   = tree->tree_type;
 	const int tree_offset = 2 - tree->tree_type; /* this value is 0 (on binary trees) and negative on the others */
 	const int num_branches = implicit_needed_branches(tree_type, num_leafs);
+	const bool use_threading = num_leafs > KDOPBVH_THREAD_LEAF_THRESHOLD;
 
 	BVHBuildHelper data;
 	int depth;
@@ -871,7 +985,7 @@ static void non_recursive_bvh_div_nodes(BVHTree *tree, BVHNode *branches_array,
 	BVHDivNodesData cb_data = {
 		.tree = tree, .branches_array = branches_array, .leafs_array = leafs_array,
 		.tree_type = tree_type, .tree_offset = tree_offset, .data = &data,
-		.first_of_next_level = 0, .depth = 0, .i = 0,
+		.first_of_next_level = 0, .depth = 0, .i = 0, .is_refit = false,
 	};
 
 	/* Loop tree levels (log N) loops */
@@ -884,9 +998,22 @@ static void non_recursive_bvh_div_nodes(BVHTree *tree, BVHNode *branches_array,
 		cb_data.i = i;
 		cb_data.depth = depth;
 
+		/* The top-most levels have few branches holding many leafs each,
+		 * threading over branches only would leave most threads idle, so refit them in chunks first. */
+		cb_data.is_refit = use_threading && (num_leafs / (end_j - i) >= KDOPBVH_REFIT_CHUNK_SIZE * 2);
+		if (cb_data.is_refit) {
+			int j;
+			for (j = i; j < end_j; j++) {
+				refit_kdop_hull_threaded(
+				        tree, branches_array + j,
+				        implicit_leafs_index(&data, depth, j - i),
+				        implicit_leafs_index(&data, depth, j - i + 1));
+			}
+		}
+
 		BLI_task_parallel_range(
 		            i, end_j, &cb_data, non_recursive_bvh_div_nodes_task_cb,
-		            num_leafs > KDOPBVH_THREAD_LEAF_THRESHOLD);
+		            use_threading);
 	}
 }
 
@@ -1097,7 +1224,21 @@ static bool tree_overlap_test(const BVHNode *node1, const BVHNode *node2, axis_t
 	const float *bv1     = node1->bv + (start_axis << 1);
 	const float *bv2     = node2->bv + (start_axis << 1);
 	const float *bv1_end = node1->bv + (stop_axis  << 1);
-	
+
+#ifdef USE_KDOPBVH_SSE
+	/* test the x, y, z axes at once, then any remaining k-DOP axis */
+	if (start_axis == 0 && stop_axis >= 3) {
+		__m128 min1, max1, min2, max2;
+		bv_aabb_load_sse(bv1, &min1, &max1);
+		bv_aabb_load_sse(bv2, &min2, &max2);
+		if (_mm_movemask_ps(_mm_or_ps(_mm_cmpgt_ps(min1, max2), _mm_cmpgt_ps(min2, max1)))) {
+			return 0;
+		}
+		bv1 += 6;
+		bv2 += 6;
+	}
+#endif
+
 	/* test all axis if min + max overlap */
 	for (; bv1 != bv1_end; bv1 += 2, bv2 += 2) {
 		if ((bv1[0] > bv2[1]) || (bv2[0] > bv1[1])) {
@@ -1294,9 +1435,28 @@ BVHTreeOverlap *BLI_bvhtree_overlap(
 /* Determines the nearest point of the given node BV. Returns the squared distance to that point. */
 static float calc_nearest_point_squared(const float proj[3], BVHNode *node, float nearest[3])
 {
-	int i;
 	const float *bv = node->bv;
 
+#ifdef USE_KDOPBVH_SSE
+	{
+		__m128 bv_min, bv_max, v_proj, v_nearest, v_delta;
+		float r_nearest[4], r_delta[4];
+
+		bv_aabb_load_sse(bv, &bv_min, &bv_max);
+		v_proj = _mm_setr_ps(proj[0], proj[1], proj[2], proj[2]);
+
+		/* nearest on AABB hull */
+		v_nearest = _mm_min_ps(_mm_max_ps(v_proj, bv_min), bv_max);
+		v_delta = _mm_sub_ps(v_proj, v_nearest);
+		_mm_storeu_ps(r_nearest, v_nearest);
+		_mm_storeu_ps(r_delta, _mm_mul_ps(v_delta, v_delta));
+
+		copy_v3_v3(nearest, r_nearest);
+		return r_delta[0] + r_delta[1] + r_delta[2];
+	}
+#else
+	int i;
+
 	/* nearest on AABB hull */
 	for (i = 0; i != 3; i++, bv += 2) {
 		if (bv[0] > proj[i])
@@ -1325,6 +1485,7 @@ static float calc_nearest_point_squared(const float proj[3], BVHNode *node, floa
 #endif
 
 	return len_squared_v3v3(proj, nearest);
+#endif  /* USE_KDOPBVH_SSE */
 }
 
 /* TODO: use a priority queue to reduce the number of nodes looked on */
@@ -1505,6 +1666,53 @@ int BLI_bvhtree_find_nearest(BVHTree *tree, const float co[3], BVHTreeNearest *n
 }
 
 
+typedef struct BVHNearestBatchData {
+	BVHTree *tree;
+	const float (*co)[3];
+	BVHTreeNearest *nearest;
+	BVHTree_NearestPointCallback callback;
+	void *userdata;
+} BVHNearestBatchData;
+
+static void bvhtree_find_nearest_batch_task_cb(void *userdata, const int i)
+{
+	BVHNearestBatchData *data = userdata;
+
+	BLI_bvhtree_find_nearest(data->tree, data->co[i], &data->nearest[i], data->callback, data->userdata);
+}
+
+/**
+ * Find the nearest node for many coordinates at once, using threads for large batches.
+ *
+ * \param nearest: Array of \a co_num results, initialized by the caller as for #BLI_bvhtree_find_nearest
+ * (index & maximum squared distance).
+ * \note \a callback may run from multiple threads, it must only write into the nearest it's given.
+ * \return the number of coordinates which found a nearest node.
+ */
+int BLI_bvhtree_find_nearest_batch(
+        BVHTree *tree, const float (*co)[3], const int co_num, BVHTreeNearest *nearest,
+        BVHTree_NearestPointCallback callback, void *userdata)
+{
+	int i, found_num = 0;
+
+	BVHNearestBatchData data = {
+		.tree = tree, .co = co, .nearest = nearest,
+		.callback = callback, .userdata = userdata,
+	};
+
+	BLI_task_parallel_range(
+	            0, co_num, &data, bvhtree_find_nearest_batch_task_cb,
+	            co_num > KDOPBVH_THREAD_QUERY_THRESHOLD);
+
+	for (i = 0; i < co_num; i++) {
+		if (nearest[i].index != -1) {
+			found_num++;
+		}
+	}
+	return found_num;
+}
+
+
 /**
  * Raycast - BLI_bvhtree_ray_cast
  *
@@ -1556,7 +1764,37 @@ static float ray_nearest_hit(BVHRayCastData *data, const float bv[6])
 static float fast_ray_nearest_hit(const BVHRayCastData *data, const BVHNode *node)
 {
 	const float *bv = node->bv;
-	
+
+#ifdef USE_KDOPBVH_SSE
+	__m128 bv_min, bv_max, v_near, v_far, t_near, t_far, ord_near, ord_far;
+	float t1, t2;
+
+	bv_aabb_load_sse(bv, &bv_min, &bv_max);
+
+	/* same as picking the planes using data->index */
+	v_near = _mm_or_ps(_mm_and_ps(data->sse_idot_neg, bv_max), _mm_andnot_ps(data->sse_idot_neg, bv_min));
+	v_far  = _mm_or_ps(_mm_and_ps(data->sse_idot_neg, bv_min), _mm_andnot_ps(data->sse_idot_neg, bv_max));
+
+	t_near = _mm_mul_ps(_mm_sub_ps(v_near, data->sse_origin), data->sse_idot_axis);
+	t_far  = _mm_mul_ps(_mm_sub_ps(v_far,  data->sse_origin), data->sse_idot_axis);
+
+	/* 0 * inf is NaN for axis aligned rays starting on a plane, those axes don't limit the ray
+	 * (as the scalar comparisons below, which are false for NaN) */
+	ord_near = _mm_cmpord_ps(t_near, t_near);
+	ord_far  = _mm_cmpord_ps(t_far, t_far);
+	t_near = _mm_or_ps(_mm_and_ps(ord_near, t_near), _mm_andnot_ps(ord_near, _mm_set1_ps(-FLT_MAX)));
+	t_far  = _mm_or_ps(_mm_and_ps(ord_far, t_far), _mm_andnot_ps(ord_far, _mm_set1_ps(FLT_MAX)));
+
+	t1 = sse_hmax(t_near);
+	t2 = sse_hmin(t_far);
+
+	if ((t1 > t2) || (t2 < 0.0f) || (t1 > data->hit.dist)) {
+		return FLT_MAX;
+	}
+	else {
+		return t1;
+	}
+#else
 	float t1x = (bv[data->index[0]] - data->ray.origin[0]) * data->idot_axis[0];
 	float t2x = (bv[data->index[1]] - data->ray.origin[0]) * data->idot_axis[0];
 	float t1y = (bv[data->index[2]] - data->ray.origin[1]) * data->idot_axis[1];
@@ -1573,6 +1811,7 @@ static float fast_ray_nearest_hit(const BVHRayCastData *data, const BVHNode *nod
 	else {
 		return max_fff(t1x, t1y, t1z);
 	}
+#endif  /* USE_KDOPBVH_SSE */
 }
 
 static void dfs_raycast(BVHRayCastData *data, BVHNode *node)
@@ -1692,6 +1931,12 @@ static void bvhtree_ray_cast_data_precalc(BVHRayCastData *data, int flag)
 		data->index[2 * i + 1] += 2 * i;
 	}
 
+#ifdef USE_KDOPBVH_SSE
+	data->sse_origin = _mm_setr_ps(data->ray.origin[0], data->ray.origin[1], data->ray.origin[2], data->ray.origin[2]);
+	data->sse_idot_axis = _mm_setr_ps(data->idot_axis[0], data->idot_axis[1], data->idot_axis[2], data->idot_axis[2]);
+	data->sse_idot_neg = _mm_cmplt_ps(data->sse_idot_axis, _mm_setzero_ps());
+#endif
+
 #ifdef USE_KDOPBVH_WATERTIGHT
 	if (flag & BVH_RAYCAST_WATERTIGHT) {
 		isect_ray_tri_watertight_v3_precalc(&data->isect_precalc, data->ray.direction);
@@ -1753,6 +1998,59 @@ int BLI_bvhtree_ray_cast(
 	return BLI_bvhtree_ray_cast_ex(tree, co, dir, radius, hit, callback, userdata, BVH_RAYCAST_DEFAULT);
 }
 
+typedef struct BVHRayCastBatchData {
+	BVHTree *tree;
+	const float (*co)[3];
+	const float (*dir)[3];
+	float radius;
+	BVHTreeRayHit *hits;
+	BVHTree_RayCastCallback callback;
+	void *userdata;
+	int flag;
+} BVHRayCastBatchData;
+
+static void bvhtree_ray_cast_batch_task_cb(void *userdata, const int i)
+{
+	BVHRayCastBatchData *data = userdata;
+
+	BLI_bvhtree_ray_cast_ex(
+	        data->tree, data->co[i], data->dir[i], data->radius, &data->hits[i],
+	        data->callback, data->userdata, data->flag);
+}
+
+/**
+ * Cast many rays at once, using threads for large batches.
+ *
+ * \param hits: Array of \a rays_num hits, initialized by the caller as for #BLI_bvhtree_ray_cast
+ * (index & maximum distance).
+ * \note \a callback may run from multiple threads, it must only write into the hit it's given.
+ * \return the number of rays that hit something.
+ */
+int BLI_bvhtree_ray_cast_batch(
+        BVHTree *tree, const float (*co)[3], const float (*dir)[3], const int rays_num, float radius,
+        BVHTreeRayHit *hits,
+        BVHTree_RayCastCallback callback, void *userdata,
+        int flag)
+{
+	int i, hits_num = 0;
+
+	BVHRayCastBatchData data = {
+		.tree = tree, .co = co, .dir = dir, .radius = radius, .hits = hits,
+		.callback = callback, .userdata = userdata, .flag = flag,
+	};
+
+	BLI_task_parallel_range(
+	            0, rays_num, &data, bvhtree_ray_cast_batch_task_cb,
+	            rays_num > KDOPBVH_THREAD_QUERY_THRESHOLD);
+
+	for (i = 0; i < rays_num; i++) {
+		if (hits[i].index != -1) {
+			hits_num++;
+		}
+	}
+	return hits_num;
+}
+
 float BLI_bvhtree_bb_raycast(const float bv[6], const float light_start[3], const float light_end[3], float pos[3])
 {
 	BVHRayCastData data;
@@ -25,10 +25,13 @@
  *  \ingroup bli
  */
 
+#include <limits.h>
+
 #include "MEM_guardedalloc.h"
 
 #include "BLI_math.h"
 #include "BLI_kdtree.h"
+#include "BLI_task.h"
 #include "BLI_utildefines.h"
 #include "BLI_strict_flags.h"
 
@@ -61,6 +64,12 @@ struct KDTree {
 
 #define KD_NODE_UNSET ((unsigned int)-1)
 
+/* balancing & batch queries use threads above these sizes */
+#define KD_THREAD_THRESHOLD 10000
+#define KD_THREAD_QUERY_THRESHOLD 256
+/* levels partitioned on the main thread, leaving up to (1 << KD_THREAD_DEPTH) sub-trees for threads */
+#define KD_THREAD_DEPTH 6
+
 /**
  * Creates or free a kdtree
  */
@@ -113,18 +122,14 @@ void BLI_kdtree_insert(KDTree *tree, int index, const float co[3])
 #endif
 }
 
-static unsigned int kdtree_balance(KDTreeNode *nodes, unsigned int totnode, unsigned int axis, const unsigned int ofs)
+/**
+ * Quicksort style sorting around the median (``totnode / 2``) on \a axis, which is returned.
+ */
+static unsigned int kdtree_median_partition(KDTreeNode *nodes, const unsigned int totnode, const unsigned int axis)
 {
-	KDTreeNode *node;
 	float co;
 	unsigned int left, right, median, i, j;
 
-	if (totnode <= 0)
-		return KD_NODE_UNSET;
-	else if (totnode == 1)
-		return 0 + ofs;
-	
-	/* quicksort style sorting around median */
 	left = 0;
 	right = totnode - 1;
 	median = totnode / 2;
@@ -151,19 +156,167 @@ static unsigned int kdtree_balance(KDTreeNode *nodes, unsigned int totnode, unsi
 			left = i + 1;
 	}
 
+	nodes[median].d = axis;
+
+	return median;
+}
+
+/**
+ * Balance a sub-tree in place, sorted around medians:
+ * the root is always at ``totnode / 2``, with the left sub-tree before it and the right one after.
+ */
+static void kdtree_balance(KDTreeNode *nodes, unsigned int totnode, unsigned int axis)
+{
+	unsigned int median;
+
+	if (totnode <= 1)
+		return;
+
+	median = kdtree_median_partition(nodes, totnode, axis);
+
+	/* sort subnodes */
+	axis = (axis + 1) % 3;
+	kdtree_balance(nodes, median, axis);
+	kdtree_balance(nodes + median + 1, (totnode - (median + 1)), axis);
+}
+
+/**
+ * Balance in place, like #kdtree_balance, also setting the children of each node.
+ * Used for small trees, which aren't worth copying into depth first order.
+ */
+static unsigned int kdtree_balance_inplace(KDTreeNode *nodes, unsigned int totnode, unsigned int axis,
+                                           const unsigned int ofs)
+{
+	KDTreeNode *node;
+	unsigned int median;
+
+	if (totnode == 0)
+		return KD_NODE_UNSET;
+	else if (totnode == 1)
+		return 0 + ofs;
+
+	median = kdtree_median_partition(nodes, totnode, axis);
+
 	/* set node and sort subnodes */
 	node = &nodes[median];
-	node->d = axis;
 	axis = (axis + 1) % 3;
-	node->left = kdtree_balance(nodes, median, axis, ofs);
-	node->right = kdtree_balance(nodes + median + 1, (totnode - (median + 1)), axis, (median + 1) + ofs);
+	node->left = kdtree_balance_inplace(nodes, median, axis, ofs);
+	node->right = kdtree_balance_inplace(nodes + median + 1, (totnode - (median + 1)), axis, (median + 1) + ofs);
 
 	return median + ofs;
 }
 
+/**
+ * Copy a sub-tree balanced by #kdtree_balance from \a ofs_src into \a nodes_dst at \a ofs_dst,
+ * in depth first order: each node is directly followed by its left sub-tree, then its right one.
+ *
+ * \param depth: Only copy nodes above this depth (deeper sub-trees are copied separately).
+ */
+static void kdtree_preorder_copy(
+        const KDTreeNode *nodes_src, KDTreeNode *nodes_dst, const unsigned int totnode,
+        const unsigned int ofs_src, const unsigned int ofs_dst, const unsigned int depth)
+{
+	KDTreeNode *node;
+	unsigned int median;
+
+	if (totnode == 0 || depth == 0)
+		return;
+
+	median = totnode / 2;
+
+	node = &nodes_dst[ofs_dst];
+	*node = nodes_src[ofs_src + median];
+	node->left  = (median != 0) ? ofs_dst + 1 : KD_NODE_UNSET;
+	node->right = (totnode - (median + 1) != 0) ? ofs_dst + 1 + median : KD_NODE_UNSET;
+
+	kdtree_preorder_copy(
+	        nodes_src, nodes_dst, median,
+	        ofs_src, ofs_dst + 1, depth - 1);
+	kdtree_preorder_copy(
+	        nodes_src, nodes_dst, totnode - (median + 1),
+	        ofs_src + median + 1, ofs_dst + median + 1, depth - 1);
+}
+
+typedef struct KDTreeBalanceTask {
+	unsigned int totnode, axis;
+	unsigned int ofs_src, ofs_dst;
+} KDTreeBalanceTask;
+
+typedef struct KDTreeBalanceData {
+	KDTreeNode *nodes, *nodes_dst;
+	const KDTreeBalanceTask *tasks;
+} KDTreeBalanceData;
+
+/**
+ * Partition the top \a depth levels, collecting the sub-trees below them as independent tasks.
+ */
+static void kdtree_balance_top(
+        KDTreeNode *nodes, unsigned int totnode, unsigned int axis,
+        const unsigned int ofs_src, const unsigned int ofs_dst, const unsigned int depth,
+        KDTreeBalanceTask *tasks, unsigned int *r_tasks_len)
+{
+	unsigned int median;
+
+	if (totnode == 0)
+		return;
+
+	if (depth == 0) {
+		KDTreeBalanceTask *task = &tasks[(*r_tasks_len)++];
+		task->totnode = totnode;
+		task->axis = axis;
+		task->ofs_src = ofs_src;
+		task->ofs_dst = ofs_dst;
+		return;
+	}
+	else if (totnode == 1) {
+		return;
+	}
+
+	median = kdtree_median_partition(nodes + ofs_src, totnode, axis);
+
+	axis = (axis + 1) % 3;
+	kdtree_balance_top(
+	        nodes, median, axis,
+	        ofs_src, ofs_dst + 1, depth - 1, tasks, r_tasks_len);
+	kdtree_balance_top(
+	        nodes, totnode - (median + 1), axis,
+	        ofs_src + median + 1, ofs_dst + median + 1, depth - 1, tasks, r_tasks_len);
+}
+
+static void kdtree_balance_task_cb(void *userdata, const int i)
+{
+	KDTreeBalanceData *data = userdata;
+	const KDTreeBalanceTask *task = &data->tasks[i];
+
+	kdtree_balance(data->nodes + task->ofs_src, task->totnode, task->axis);
+	kdtree_preorder_copy(data->nodes, data->nodes_dst, task->totnode, task->ofs_src, task->ofs_dst, UINT_MAX);
+}
+
 void BLI_kdtree_balance(KDTree *tree)
 {
-	tree->root = kdtree_balance(tree->nodes, tree->totnode, 0, 0);
+	if (tree->totnode > KD_THREAD_THRESHOLD) {
+		/* partition the top levels on the main thread, giving enough sub-trees to balance in parallel,
+		 * which are copied into depth first order */
+		KDTreeBalanceTask tasks[1 << KD_THREAD_DEPTH];
+		unsigned int tasks_len = 0;
+		KDTreeBalanceData data;
+
+		data.nodes = tree->nodes;
+		data.nodes_dst = MEM_mallocN(MEM_allocN_len(tree->nodes), "KDTreeNode");
+		data.tasks = tasks;
+
+		kdtree_balance_top(data.nodes, tree->totnode, 0, 0, 0, KD_THREAD_DEPTH, tasks, &tasks_len);
+
+		BLI_task_parallel_range(0, (int)tasks_len, &data, kdtree_balance_task_cb, true);
+		kdtree_preorder_copy(data.nodes, data.nodes_dst, tree->totnode, 0, 0, KD_THREAD_DEPTH);
+
+		MEM_freeN(tree->nodes);
+		tree->nodes = data.nodes_dst;
+		tree->root = 0;
+	}
+	else {
+		tree->root = kdtree_balance_inplace(tree->nodes, tree->totnode, 0, 0);
+	}
 
 #ifdef DEBUG
 	tree->is_balanced = true;
@@ -510,6 +663,51 @@ int BLI_kdtree_find_nearest_n__normal(
 	return (int)found;
 }
 
+typedef struct KDTreeNearestBatchData {
+	const KDTree *tree;
+	const float (*co)[3];
+	KDTreeNearest *r_nearest;
+	unsigned int *r_found;
+	unsigned int n;
+} KDTreeNearestBatchData;
+
+static void kdtree_find_nearest_n_batch_task_cb(void *userdata, const int i)
+{
+	KDTreeNearestBatchData *data = userdata;
+	const int found = BLI_kdtree_find_nearest_n(data->tree, data->co[i], &data->r_nearest[(unsigned int)i * data->n], data->n);
+
+	if (data->r_found) {
+		data->r_found[i] = (unsigned int)found;
+	}
+}
+
+/**
+ * Run #BLI_kdtree_find_nearest_n for many coordinates, using threads for large batches.
+ *
+ * \param r_nearest: An array of nearest, sized at least \a co_num * \a n,
+ * results for coordinate ``i`` start at ``r_nearest[i * n]``.
+ * \param r_found: Optional array of \a co_num, number of points found for each coordinate.
+ */
+void BLI_kdtree_find_nearest_n_batch(
+        const KDTree *tree, const float (*co)[3], unsigned int co_num,
+        KDTreeNearest *r_nearest, unsigned int *r_found,
+        unsigned int n)
+{
+	KDTreeNearestBatchData data = {
+		.tree = tree, .co = co,
+		.r_nearest = r_nearest, .r_found = r_found,
+		.n = n,
+	};
+
+	if (co_num == 0) {
+		return;
+	}
+
+	BLI_task_parallel_range(
+	        0, (int)co_num, &data, kdtree_find_nearest_n_batch_task_cb,
+	        co_num > KD_THREAD_QUERY_THRESHOLD);
+}
+
 static int range_compare(const void *a, const void *b)
 {
 	const KDTreeNearest *kda = a;
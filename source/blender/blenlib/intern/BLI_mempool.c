@@ -36,12 +36,21 @@
  * - Freeing chunks.
  * - Iterating over allocated chunks
  *   (optionally when using the #BLI_MEMPOOL_ALLOW_ITER flag).
+ * - Allocating and freeing from multiple threads
+ *   (optionally when using the #BLI_MEMPOOL_THREADED flag).
+ *
+ * Threaded pools give each thread its own cache: a free list and the chunks that thread allocated.
+ * Threads only synchronize (with a spin-lock) when taking elements reserved in the shared free list,
+ * new chunks are allocated and filled privately, so allocation never waits on other threads.
  */
 
 #include <string.h>
 #include <stdlib.h>
 
+#include "atomic_ops.h"
+
 #include "BLI_utildefines.h"
+#include "BLI_threads.h"
 
 #include "BLI_mempool.h" /* own include */
 
@@ -101,6 +110,19 @@ typedef struct BLI_mempool_chunk {
 #endif
 } BLI_mempool_chunk;
 
+/**
+ * Per-thread state of a #BLI_MEMPOOL_THREADED pool,
+ * merged back into the pool by #BLI_mempool_thread_caches_flush.
+ */
+typedef struct BLI_mempool_thread_cache {
+	BLI_freenode *free;          /* thread local free list */
+	BLI_mempool_chunk *chunks;   /* chunks allocated by this thread */
+	BLI_mempool_chunk *chunk_tail;
+	int totused;                 /* can be negative, when freeing elements allocated by other threads */
+	/* avoid false sharing between threads, the caches are allocated cache line aligned */
+	char _pad[64 - (3 * sizeof(void *)) - sizeof(int)];
+} BLI_mempool_thread_cache;
+
 /**
  * The mempool, stores and tracks memory \a chunks and elements within those chunks \a free.
  */
@@ -122,6 +144,10 @@ struct BLI_mempool {
 #ifdef USE_TOTALLOC
 	unsigned int totalloc;          /* number of elements allocated in total */
 #endif
+
+	/* only for BLI_MEMPOOL_THREADED */
+	BLI_mempool_thread_cache *thread_caches;  /* BLENDER_MAX_THREADS items */
+	uint32_t free_lock;         /* protects 'free' while caches are in use, see #mempool_free_lock */
 };
 
 #define MEMPOOL_ELEM_SIZE_MIN (sizeof(void *) * 2)
@@ -189,37 +215,16 @@ static BLI_mempool_chunk *mempool_chunk_alloc(BLI_mempool *pool)
 }
 
 /**
- * Initialize a chunk and add into \a pool->chunks
+ * Link all elements of \a mpchunk into a free list.
  *
- * \param pool  The pool to add the chunk into.
- * \param mpchunk  The new uninitialized chunk (can be malloc'd)
- * \param lasttail  The last element of the previous chunk
- * (used when building free chunks initially)
- * \return The last chunk,
+ * \return The last element of the chunk (terminating the list).
  */
-static BLI_freenode *mempool_chunk_add(BLI_mempool *pool, BLI_mempool_chunk *mpchunk,
-                                       BLI_freenode *lasttail)
+static BLI_freenode *mempool_chunk_freelist_init(BLI_mempool *pool, BLI_mempool_chunk *mpchunk)
 {
 	const unsigned int esize = pool->esize;
 	BLI_freenode *curnode = CHUNK_DATA(mpchunk);
 	unsigned int j;
 
-	/* append */
-	if (pool->chunk_tail) {
-		pool->chunk_tail->next = mpchunk;
-	}
-	else {
-		BLI_assert(pool->chunks == NULL);
-		pool->chunks = mpchunk;
-	}
-
-	mpchunk->next = NULL;
-	pool->chunk_tail = mpchunk;
-
-	if (UNLIKELY(pool->free == NULL)) {
-		pool->free = curnode;
-	}
-
 	/* loop through the allocated data, building the pointer structures */
 	j = pool->pchunk;
 	if (pool->flag & BLI_MEMPOOL_ALLOW_ITER) {
@@ -241,6 +246,41 @@ static BLI_freenode *mempool_chunk_add(BLI_mempool *pool, BLI_mempool_chunk *mpc
 	curnode = NODE_STEP_PREV(curnode);
 	curnode->next = NULL;
 
+	return curnode;
+}
+
+/**
+ * Initialize a chunk and add into \a pool->chunks
+ *
+ * \param pool  The pool to add the chunk into.
+ * \param mpchunk  The new uninitialized chunk (can be malloc'd)
+ * \param lasttail  The last element of the previous chunk
+ * (used when building free chunks initially)
+ * \return The last chunk,
+ */
+static BLI_freenode *mempool_chunk_add(BLI_mempool *pool, BLI_mempool_chunk *mpchunk,
+                                       BLI_freenode *lasttail)
+{
+	BLI_freenode *curnode;
+
+	/* append */
+	if (pool->chunk_tail) {
+		pool->chunk_tail->next = mpchunk;
+	}
+	else {
+		BLI_assert(pool->chunks == NULL);
+		pool->chunks = mpchunk;
+	}
+
+	mpchunk->next = NULL;
+	pool->chunk_tail = mpchunk;
+
+	if (UNLIKELY(pool->free == NULL)) {
+		pool->free = CHUNK_DATA(mpchunk);
+	}
+
+	curnode = mempool_chunk_freelist_init(pool, mpchunk);
+
 #ifdef USE_TOTALLOC
 	pool->totalloc += pool->pchunk;
 #endif
@@ -253,6 +293,19 @@ static BLI_freenode *mempool_chunk_add(BLI_mempool *pool, BLI_mempool_chunk *mpc
 	return curnode;
 }
 
+/* Own spin-lock on atomics: mempool is also built into makesdna/makesrna, which don't link threads.c */
+BLI_INLINE void mempool_free_lock(BLI_mempool *pool)
+{
+	while (atomic_cas_uint32(&pool->free_lock, 0, 1) != 0) {
+		/* pass */
+	}
+}
+
+BLI_INLINE void mempool_free_unlock(BLI_mempool *pool)
+{
+	atomic_cas_uint32(&pool->free_lock, 1, 0);
+}
+
 static void mempool_chunk_free(BLI_mempool_chunk *mpchunk)
 {
 
@@ -272,6 +325,22 @@ static void mempool_chunk_free_all(BLI_mempool_chunk *mpchunk)
 	}
 }
 
+#ifndef NDEBUG
+static bool mempool_thread_caches_is_flushed(BLI_mempool *pool)
+{
+	int i;
+	if (pool->thread_caches) {
+		for (i = 0; i < BLENDER_MAX_THREADS; i++) {
+			const BLI_mempool_thread_cache *cache = &pool->thread_caches[i];
+			if (cache->free || cache->chunks || cache->totused) {
+				return false;
+			}
+		}
+	}
+	return true;
+}
+#endif
+
 BLI_mempool *BLI_mempool_create(unsigned int esize, unsigned int totelem,
                                 unsigned int pchunk, unsigned int flag)
 {
@@ -318,6 +387,16 @@ BLI_mempool *BLI_mempool_create(unsigned int esize, unsigned int totelem,
 #endif
 	pool->totused = 0;
 
+	if (flag & BLI_MEMPOOL_THREADED) {
+		const size_t caches_size = sizeof(*pool->thread_caches) * BLENDER_MAX_THREADS;
+		pool->thread_caches = MEM_mallocN_aligned(caches_size, 64, "mempool thread caches");
+		memset(pool->thread_caches, 0, caches_size);
+		pool->free_lock = 0;
+	}
+	else {
+		pool->thread_caches = NULL;
+	}
+
 	if (totelem) {
 		/* allocate the actual chunks */
 		for (i = 0; i < maxchunks; i++) {
@@ -455,6 +534,183 @@ void BLI_mempool_free(BLI_mempool *pool, void *addr)
 	}
 }
 
+/* -------------------------------------------------------------------- */
+/** \name Threaded Allocation
+ *
+ * Only for pools created with #BLI_MEMPOOL_THREADED,
+ * \a thread_id is the one passed to task callbacks (in ``[0, BLENDER_MAX_THREADS)``).
+ * \{ */
+
+/**
+ * Refill an empty thread cache, from the shared free list when possible, else with a new chunk.
+ */
+static void mempool_thread_cache_refill(BLI_mempool *pool, BLI_mempool_thread_cache *cache)
+{
+	BLI_mempool_chunk *mpchunk;
+
+	BLI_assert(cache->free == NULL);
+
+	{
+		/* Take at most a chunk worth of elements, so other threads get their share. */
+		BLI_freenode *head, *tail;
+		unsigned int j = pool->pchunk;
+
+		mempool_free_lock(pool);
+		head = tail = pool->free;
+		if (head) {
+			while (--j && tail->next) {
+				tail = tail->next;
+			}
+			pool->free = tail->next;
+			tail->next = NULL;
+		}
+		mempool_free_unlock(pool);
+
+		if (head) {
+			cache->free = head;
+			return;
+		}
+	}
+
+	/* Nothing left to share, allocate a chunk for this thread only, no locking needed. */
+	mpchunk = mempool_chunk_alloc(pool);
+	mpchunk->next = NULL;
+	if (cache->chunk_tail) {
+		cache->chunk_tail->next = mpchunk;
+	}
+	else {
+		cache->chunks = mpchunk;
+	}
+	cache->chunk_tail = mpchunk;
+
+	mempool_chunk_freelist_init(pool, mpchunk);
+	cache->free = CHUNK_DATA(mpchunk);
+}
+
+/**
+ * Thread-safe version of #BLI_mempool_alloc.
+ */
+void *BLI_mempool_alloc_thread(BLI_mempool *pool, const int thread_id)
+{
+	BLI_mempool_thread_cache *cache;
+	BLI_freenode *free_pop;
+
+	BLI_assert(pool->flag & BLI_MEMPOOL_THREADED);
+	BLI_assert(thread_id >= 0 && thread_id < BLENDER_MAX_THREADS);
+
+	cache = &pool->thread_caches[thread_id];
+
+	if (UNLIKELY(cache->free == NULL)) {
+		mempool_thread_cache_refill(pool, cache);
+	}
+
+	free_pop = cache->free;
+
+	if (pool->flag & BLI_MEMPOOL_ALLOW_ITER) {
+		free_pop->freeword = USEDWORD;
+	}
+
+	cache->free = free_pop->next;
+	cache->totused++;
+
+	return (void *)free_pop;
+}
+
+/**
+ * Thread-safe version of #BLI_mempool_calloc.
+ */
+void *BLI_mempool_calloc_thread(BLI_mempool *pool, const int thread_id)
+{
+	void *retval = BLI_mempool_alloc_thread(pool, thread_id);
+	memset(retval, 0, (size_t)pool->esize);
+	return retval;
+}
+
+/**
+ * Thread-safe version of #BLI_mempool_free,
+ * \a addr may have been allocated by any thread (or before threading started).
+ *
+ * \note Unlike #BLI_mempool_free, chunks are never released here,
+ * this happens on #BLI_mempool_clear or #BLI_mempool_destroy.
+ */
+void BLI_mempool_free_thread(BLI_mempool *pool, void *addr, const int thread_id)
+{
+	BLI_mempool_thread_cache *cache;
+	BLI_freenode *newhead = addr;
+
+	BLI_assert(pool->flag & BLI_MEMPOOL_THREADED);
+	BLI_assert(thread_id >= 0 && thread_id < BLENDER_MAX_THREADS);
+
+	cache = &pool->thread_caches[thread_id];
+
+#ifndef NDEBUG
+	/* enable for debugging */
+	if (UNLIKELY(mempool_debug_memset)) {
+		memset(addr, 255, pool->esize);
+	}
+#endif
+
+	if (pool->flag & BLI_MEMPOOL_ALLOW_ITER) {
+		/* this will detect double free's */
+		BLI_assert(newhead->freeword != FREEWORD);
+		newhead->freeword = FREEWORD;
+	}
+
+	newhead->next = cache->free;
+	cache->free = newhead;
+	cache->totused--;
+}
+
+/**
+ * Merge all thread caches back into the pool.
+ *
+ * Must be called from a single thread once threaded allocation is done,
+ * before using functions that need a consistent pool
+ * (#BLI_mempool_alloc, #BLI_mempool_free, iteration, #BLI_mempool_as_table...).
+ * Threaded allocation can start again afterwards.
+ */
+void BLI_mempool_thread_caches_flush(BLI_mempool *pool)
+{
+	int i;
+
+	BLI_assert(pool->flag & BLI_MEMPOOL_THREADED);
+
+	for (i = 0; i < BLENDER_MAX_THREADS; i++) {
+		BLI_mempool_thread_cache *cache = &pool->thread_caches[i];
+
+		if (cache->chunks) {
+			if (pool->chunk_tail) {
+				pool->chunk_tail->next = cache->chunks;
+			}
+			else {
+				pool->chunks = cache->chunks;
+			}
+			pool->chunk_tail = cache->chunk_tail;
+#ifdef USE_TOTALLOC
+			for (BLI_mempool_chunk *mpchunk = cache->chunks; mpchunk; mpchunk = mpchunk->next) {
+				pool->totalloc += pool->pchunk;
+			}
+#endif
+		}
+
+		if (cache->free) {
+			BLI_freenode *tail = cache->free;
+			while (tail->next) {
+				tail = tail->next;
+			}
+			tail->next = pool->free;
+			pool->free = cache->free;
+		}
+
+		BLI_assert((int)pool->totused + cache->totused >= 0);
+		pool->totused = (unsigned int)((int)pool->totused + cache->totused);
+
+		memset(cache, 0, sizeof(*cache));
+	}
+}
+
+/** \} */
+
 int BLI_mempool_count(BLI_mempool *pool)
 {
 	return (int)pool->totused;
@@ -541,6 +797,7 @@ void *BLI_mempool_as_arrayN(BLI_mempool *pool, const char *allocstr)
 void BLI_mempool_iternew(BLI_mempool *pool, BLI_mempool_iter *iter)
 {
 	BLI_assert(pool->flag & BLI_MEMPOOL_ALLOW_ITER);
+	BLI_assert(mempool_thread_caches_is_flushed(pool));
 
 	iter->pool = pool;
 	iter->curchunk = pool->chunks;
@@ -629,6 +886,10 @@ void BLI_mempool_clear_ex(BLI_mempool *pool, const int totelem_reserve)
 	VALGRIND_CREATE_MEMPOOL(pool, 0, false);
 #endif
 
+	if (pool->thread_caches) {
+		BLI_mempool_thread_caches_flush(pool);
+	}
+
 	if (totelem_reserve == -1) {
 		maxchunks = pool->maxchunks;
 	}
@@ -680,6 +941,11 @@ void BLI_mempool_clear(BLI_mempool *pool)
  */
 void BLI_mempool_destroy(BLI_mempool *pool)
 {
+	if (pool->thread_caches) {
+		BLI_mempool_thread_caches_flush(pool);
+		MEM_freeN(pool->thread_caches);
+	}
+
 	mempool_chunk_free_all(pool->chunks);
 
 #ifdef WITH_MEM_VALGRIND
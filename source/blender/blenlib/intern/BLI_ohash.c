@@ -0,0 +1,933 @@
+/*
+ * ***** BEGIN GPL LICENSE BLOCK *****
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ * ***** END GPL LICENSE BLOCK *****
+ */
+
+/** \file blender/blenlib/intern/BLI_ohash.c
+ *  \ingroup bli
+ *
+ * A general (pointer -> pointer) open-addressing hash table,
+ * drop-in alternative to #GHash for large tables of pointer or integer keys.
+ *
+ * Uses linear probing with Robin Hood insertion and backward-shift deletion,
+ * so probe sequences stay short even at high load and no tombstones are needed.
+ *
+ * All entries live in a single flat array of slots, each storing key, value and full hash
+ * (with #OHASH_HASH_USED bit set, so a zero hash means an empty slot).
+ * A lookup typically touches a single cache line, and the key comparison callback
+ * is only called once the stored hash matches. Resizing never has to call the hash callback again.
+ * There is no per-entry allocation, unlike #GHash which allocates every entry from a mempool.
+ */
+
+#include <string.h>
+#include <stdlib.h>
+#include <limits.h>
+
+#include "MEM_guardedalloc.h"
+
+#include "BLI_sys_types.h"
+#include "BLI_utildefines.h"
+
+#define GHASH_INTERNAL_API
+#include "BLI_ohash.h"
+#include "BLI_strict_flags.h"
+
+#define OHASH_SLOT_BIT_MIN 3
+#define OHASH_SLOT_BIT_MAX 31  /* Hash top bit is used as 'used' tag, so we can't use more bits for indices. */
+
+/* Set on every stored hash, so that zero always means an empty slot. */
+#define OHASH_HASH_USED 0x80000000u
+
+/* Fibonacci hashing, golden ratio multiplier: spreads hashes whose low bits are constant
+ * (e.g. #BLI_ghashutil_ptrhash of aligned pointers) over all slots. */
+#define OHASH_FIB_MUL 2654435769u
+
+/**
+ * Same limits as #GHash, Robin Hood hashing would handle higher loads fine,
+ * but those keep probing sequences within one or two cache lines on average.
+ */
+#define OHASH_LIMIT_GROW(_nslots)   (((_nslots) * 3) /  4)
+#define OHASH_LIMIT_SHRINK(_nslots) (((_nslots) * 3) / 16)
+
+/* WARNING! Keep in sync with ugly _oh_Entry in header!!! */
+typedef struct OHashEntry {
+	void *key;
+	void *val;
+	unsigned int hash;
+} OHashEntry;
+
+struct OHash {
+	GHashHashFP hashfp;
+	GHashCmpFP cmpfp;
+
+	OHashEntry *entries;
+
+	unsigned int nslots;
+	unsigned int slot_mask, slot_bit, slot_bit_min, slot_shift;
+	unsigned int limit_grow, limit_shrink;
+
+	unsigned int nentries;
+	unsigned int flag;
+};
+
+/* -------------------------------------------------------------------- */
+/* OHash API */
+
+/** \name Internal Utility API
+ * \{ */
+
+/**
+ * Get the (tagged) full hash for a key.
+ */
+BLI_INLINE unsigned int ohash_keyhash(OHash *oh, const void *key)
+{
+	return oh->hashfp(key) | OHASH_HASH_USED;
+}
+
+/**
+ * Get the ideal slot-index for an already-computed full hash.
+ */
+BLI_INLINE unsigned int ohash_slot_index(OHash *oh, const unsigned int hash)
+{
+	return (hash * OHASH_FIB_MUL) >> oh->slot_shift;
+}
+
+/**
+ * Distance of the entry stored in \a index from its ideal slot.
+ */
+BLI_INLINE unsigned int ohash_probe_dist(OHash *oh, const unsigned int hash, const unsigned int index)
+{
+	return (index - ohash_slot_index(oh, hash)) & oh->slot_mask;
+}
+
+static void ohash_slots_alloc(OHash *oh, const unsigned int slot_bit)
+{
+	const unsigned int nslots = 1u << slot_bit;
+
+	oh->nslots = nslots;
+	oh->slot_mask = nslots - 1;
+	oh->slot_shift = 32 - slot_bit;
+	oh->limit_grow   = OHASH_LIMIT_GROW(nslots);
+	oh->limit_shrink = OHASH_LIMIT_SHRINK(nslots);
+
+	oh->entries = MEM_callocN(sizeof(*oh->entries) * nslots, "OHash entries");
+}
+
+/**
+ * Robin Hood insertion, the key must not already be in \a oh (unless dupes are allowed)
+ * and there must be at least one free slot.
+ *
+ * \return the slot index where \a key ended up.
+ */
+BLI_INLINE unsigned int ohash_insert_slot(OHash *oh, unsigned int hash, void *key, void *val)
+{
+	OHashEntry e_ins = {key, val, hash};
+	unsigned int index = ohash_slot_index(oh, hash);
+	unsigned int dist = 0;
+	unsigned int index_inserted = UINT_MAX;
+
+	for (;; index = (index + 1) & oh->slot_mask, dist++) {
+		OHashEntry *e = &oh->entries[index];
+
+		if (e->hash == 0) {
+			*e = e_ins;
+			return (index_inserted != UINT_MAX) ? index_inserted : index;
+		}
+		else {
+			/* Steal the slot from 'richer' entries (closer to their ideal slot than we are). */
+			const unsigned int dist_slot = ohash_probe_dist(oh, e->hash, index);
+			if (dist_slot < dist) {
+				SWAP(OHashEntry, *e, e_ins);
+				if (index_inserted == UINT_MAX) {
+					index_inserted = index;
+				}
+				dist = dist_slot;
+			}
+		}
+	}
+}
+
+/**
+ * Change the number of slots to 2^slot_bit, re-inserting all entries (using their stored hashes).
+ */
+static void ohash_slots_resize(OHash *oh, const unsigned int slot_bit)
+{
+	OHashEntry *entries_old = oh->entries;
+	const unsigned int nslots_old = oh->nslots;
+	unsigned int i;
+
+	BLI_assert((oh->slot_bit != slot_bit) || !oh->entries);
+
+	oh->slot_bit = slot_bit;
+	ohash_slots_alloc(oh, slot_bit);
+
+	if (entries_old) {
+		for (i = 0; i < nslots_old; i++) {
+			const OHashEntry *e = &entries_old[i];
+			if (e->hash != 0) {
+				ohash_insert_slot(oh, e->hash, e->key, e->val);
+			}
+		}
+		MEM_freeN(entries_old);
+	}
+}
+
+/**
+ * Check if the number of items in the OHash is large enough to require more slots,
+ * and resize \a oh accordingly.
+ */
+static void ohash_slots_expand(OHash *oh, const unsigned int nentries, const bool user_defined)
+{
+	unsigned int slot_bit = oh->slot_bit;
+
+	if (LIKELY(oh->entries && (nentries <= oh->limit_grow))) {
+		return;
+	}
+
+	while ((nentries > OHASH_LIMIT_GROW(1u << slot_bit)) &&
+	       (slot_bit < OHASH_SLOT_BIT_MAX))
+	{
+		slot_bit++;
+	}
+
+	if (user_defined) {
+		oh->slot_bit_min = slot_bit;
+	}
+
+	if ((slot_bit == oh->slot_bit) && oh->entries) {
+		return;
+	}
+
+	ohash_slots_resize(oh, slot_bit);
+}
+
+static void ohash_slots_contract(
+        OHash *oh, const unsigned int nentries, const bool user_defined, const bool force_shrink)
+{
+	unsigned int slot_bit = oh->slot_bit;
+
+	if (!(force_shrink || (oh->flag & GHASH_FLAG_ALLOW_SHRINK))) {
+		return;
+	}
+
+	if (LIKELY(oh->entries && (nentries >= oh->limit_shrink))) {
+		return;
+	}
+
+	while ((nentries < OHASH_LIMIT_SHRINK(1u << slot_bit)) &&
+	       (slot_bit > oh->slot_bit_min))
+	{
+		slot_bit--;
+	}
+
+	if (user_defined) {
+		oh->slot_bit_min = slot_bit;
+	}
+
+	if ((slot_bit == oh->slot_bit) && oh->entries) {
+		return;
+	}
+
+	ohash_slots_resize(oh, slot_bit);
+}
+
+/**
+ * Clear and reset \a oh slots, reserve again slots for given number of entries.
+ */
+BLI_INLINE void ohash_slots_reset(OHash *oh, const unsigned int nentries)
+{
+	MEM_SAFE_FREE(oh->entries);
+
+	oh->slot_bit = OHASH_SLOT_BIT_MIN;
+	oh->slot_bit_min = OHASH_SLOT_BIT_MIN;
+	oh->nentries = 0;
+
+	ohash_slots_alloc(oh, oh->slot_bit);
+	ohash_slots_expand(oh, nentries, (nentries != 0));
+}
+
+/**
+ * Internal lookup function.
+ * \return the slot index of \a key, or UINT_MAX when not found.
+ */
+BLI_INLINE unsigned int ohash_lookup_slot_ex(OHash *oh, const void *key, const unsigned int hash)
+{
+	unsigned int index = ohash_slot_index(oh, hash);
+	unsigned int dist = 0;
+
+	for (;; index = (index + 1) & oh->slot_mask, dist++) {
+		const OHashEntry *e = &oh->entries[index];
+
+		if (e->hash == 0) {
+			return UINT_MAX;
+		}
+		/* Robin Hood invariant: our key would have stolen this slot, so it can't be further on. */
+		if (ohash_probe_dist(oh, e->hash, index) < dist) {
+			return UINT_MAX;
+		}
+		if ((e->hash == hash) && (oh->cmpfp(key, e->key) == false)) {
+			return index;
+		}
+	}
+}
+
+BLI_INLINE unsigned int ohash_lookup_slot(OHash *oh, const void *key)
+{
+	return ohash_lookup_slot_ex(oh, key, ohash_keyhash(oh, key));
+}
+
+static OHash *ohash_new(GHashHashFP hashfp, GHashCmpFP cmpfp, const char *info,
+                        const unsigned int nentries_reserve, const unsigned int flag)
+{
+	OHash *oh = MEM_mallocN(sizeof(*oh), info);
+
+	oh->hashfp = hashfp;
+	oh->cmpfp = cmpfp;
+
+	oh->entries = NULL;
+	oh->flag = flag;
+
+	ohash_slots_reset(oh, nentries_reserve);
+
+	return oh;
+}
+
+/**
+ * Internal insert function, grows slots first so the returned index stays valid.
+ */
+BLI_INLINE unsigned int ohash_insert_ex(OHash *oh, void *key, void *val, const unsigned int hash)
+{
+	BLI_assert((oh->flag & GHASH_FLAG_ALLOW_DUPES) || (ohash_lookup_slot_ex(oh, key, hash) == UINT_MAX));
+
+	ohash_slots_expand(oh, ++oh->nentries, false);
+	return ohash_insert_slot(oh, hash, key, val);
+}
+
+BLI_INLINE bool ohash_insert_safe(
+        OHash *oh, void *key, void *val, const bool override,
+        GHashKeyFreeFP keyfreefp, GHashValFreeFP valfreefp)
+{
+	const unsigned int hash = ohash_keyhash(oh, key);
+	const unsigned int index = ohash_lookup_slot_ex(oh, key, hash);
+
+	BLI_assert(!valfreefp || !(oh->flag & GHASH_FLAG_IS_GSET));
+
+	if (index != UINT_MAX) {
+		if (override) {
+			OHashEntry *e = &oh->entries[index];
+			if (keyfreefp) {
+				keyfreefp(e->key);
+			}
+			if (valfreefp) {
+				valfreefp(e->val);
+			}
+			e->key = key;
+			e->val = val;
+		}
+		return false;
+	}
+	else {
+		ohash_insert_ex(oh, key, val, hash);
+		return true;
+	}
+}
+
+/**
+ * Remove the entry in \a index, shifting back following entries of the probing sequence.
+ */
+static void ohash_remove_slot(OHash *oh, unsigned int index)
+{
+	unsigned int index_next = (index + 1) & oh->slot_mask;
+
+	while ((oh->entries[index_next].hash != 0) &&
+	       (ohash_probe_dist(oh, oh->entries[index_next].hash, index_next) != 0))
+	{
+		oh->entries[index] = oh->entries[index_next];
+		index = index_next;
+		index_next = (index + 1) & oh->slot_mask;
+	}
+	oh->entries[index].hash = 0;
+
+	ohash_slots_contract(oh, --oh->nentries, false, false);
+}
+
+static bool ohash_remove(
+        OHash *oh, const void *key,
+        GHashKeyFreeFP keyfreefp, GHashValFreeFP valfreefp, void **r_val)
+{
+	const unsigned int index = ohash_lookup_slot(oh, key);
+	OHashEntry *e;
+
+	BLI_assert(!valfreefp || !(oh->flag & GHASH_FLAG_IS_GSET));
+
+	if (index == UINT_MAX) {
+		return false;
+	}
+
+	e = &oh->entries[index];
+	if (keyfreefp) {
+		keyfreefp(e->key);
+	}
+	if (valfreefp) {
+		valfreefp(e->val);
+	}
+	if (r_val) {
+		*r_val = e->val;
+	}
+
+	ohash_remove_slot(oh, index);
+	return true;
+}
+
+/**
+ * Run free callbacks for freeing entries.
+ */
+static void ohash_free_cb(
+        OHash *oh,
+        GHashKeyFreeFP keyfreefp, GHashValFreeFP valfreefp)
+{
+	unsigned int i;
+
+	BLI_assert(keyfreefp  || valfreefp);
+	BLI_assert(!valfreefp || !(oh->flag & GHASH_FLAG_IS_GSET));
+
+	for (i = 0; i < oh->nslots; i++) {
+		OHashEntry *e = &oh->entries[i];
+		if (e->hash != 0) {
+			if (keyfreefp) {
+				keyfreefp(e->key);
+			}
+			if (valfreefp) {
+				valfreefp(e->val);
+			}
+		}
+	}
+}
+
+/**
+ * Copy the OHash, slots layout is kept identical.
+ */
+static OHash *ohash_copy(OHash *oh, GHashKeyCopyFP keycopyfp, GHashValCopyFP valcopyfp)
+{
+	OHash *oh_new;
+	unsigned int i;
+
+	BLI_assert(!valcopyfp || !(oh->flag & GHASH_FLAG_IS_GSET));
+
+	oh_new = ohash_new(oh->hashfp, oh->cmpfp, __func__, 0, oh->flag);
+	if (oh_new->slot_bit != oh->slot_bit) {
+		ohash_slots_resize(oh_new, oh->slot_bit);
+	}
+	oh_new->slot_bit_min = oh->slot_bit_min;
+
+	BLI_assert(oh_new->nslots == oh->nslots);
+
+	memcpy(oh_new->entries, oh->entries, sizeof(*oh->entries) * oh->nslots);
+
+	if (keycopyfp || valcopyfp) {
+		for (i = 0; i < oh->nslots; i++) {
+			OHashEntry *e = &oh_new->entries[i];
+			if (e->hash != 0) {
+				if (keycopyfp) {
+					e->key = keycopyfp(e->key);
+				}
+				if (valcopyfp) {
+					e->val = valcopyfp(e->val);
+				}
+			}
+		}
+	}
+	oh_new->nentries = oh->nentries;
+
+	return oh_new;
+}
+
+/** \} */
+
+
+/** \name Public API
+ * \{ */
+
+/**
+ * Creates a new, empty OHash.
+ *
+ * \param hashfp  Hash callback.
+ * \param cmpfp  Comparison callback.
+ * \param info  Identifier string for the OHash.
+ * \param nentries_reserve  Optionally reserve the number of members that the hash will hold.
+ * \return  An empty OHash.
+ */
+OHash *BLI_ohash_new_ex(GHashHashFP hashfp, GHashCmpFP cmpfp, const char *info,
+                        const unsigned int nentries_reserve)
+{
+	return ohash_new(hashfp, cmpfp, info, nentries_reserve, 0);
+}
+
+/**
+ * Wraps #BLI_ohash_new_ex with zero entries reserved.
+ */
+OHash *BLI_ohash_new(GHashHashFP hashfp, GHashCmpFP cmpfp, const char *info)
+{
+	return BLI_ohash_new_ex(hashfp, cmpfp, info, 0);
+}
+
+/**
+ * Copy given OHash. Keys and values are also copied if relevant callback is provided, else pointers remain the same.
+ */
+OHash *BLI_ohash_copy(OHash *oh, GHashKeyCopyFP keycopyfp, GHashValCopyFP valcopyfp)
+{
+	return ohash_copy(oh, keycopyfp, valcopyfp);
+}
+
+/**
+ * Reserve given amount of entries (resize \a oh accordingly if needed).
+ */
+void BLI_ohash_reserve(OHash *oh, const unsigned int nentries_reserve)
+{
+	ohash_slots_expand(oh, nentries_reserve, true);
+	ohash_slots_contract(oh, nentries_reserve, true, false);
+}
+
+/**
+ * \return size of the OHash.
+ */
+unsigned int BLI_ohash_size(OHash *oh)
+{
+	return oh->nentries;
+}
+
+/**
+ * Insert a key/value pair into the \a oh.
+ *
+ * \note Duplicates are not checked,
+ * the caller is expected to ensure elements are unique unless
+ * GHASH_FLAG_ALLOW_DUPES flag is set.
+ */
+void BLI_ohash_insert(OHash *oh, void *key, void *val)
+{
+	BLI_assert(!(oh->flag & GHASH_FLAG_IS_GSET));
+	ohash_insert_ex(oh, key, val, ohash_keyhash(oh, key));
+}
+
+/**
+ * Inserts a new value to a key that may already be in ohash.
+ *
+ * \returns true if a new key has been added.
+ */
+bool BLI_ohash_reinsert(OHash *oh, void *key, void *val, GHashKeyFreeFP keyfreefp, GHashValFreeFP valfreefp)
+{
+	BLI_assert(!(oh->flag & GHASH_FLAG_IS_GSET));
+	return ohash_insert_safe(oh, key, val, true, keyfreefp, valfreefp);
+}
+
+/**
+ * Lookup the value of \a key in \a oh.
+ *
+ * \returns the value for \a key or NULL.
+ */
+void *BLI_ohash_lookup(OHash *oh, const void *key)
+{
+	const unsigned int index = ohash_lookup_slot(oh, key);
+	BLI_assert(!(oh->flag & GHASH_FLAG_IS_GSET));
+	return (index != UINT_MAX) ? oh->entries[index].val : NULL;
+}
+
+/**
+ * A version of #BLI_ohash_lookup which accepts a fallback argument.
+ */
+void *BLI_ohash_lookup_default(OHash *oh, const void *key, void *val_default)
+{
+	const unsigned int index = ohash_lookup_slot(oh, key);
+	BLI_assert(!(oh->flag & GHASH_FLAG_IS_GSET));
+	return (index != UINT_MAX) ? oh->entries[index].val : val_default;
+}
+
+/**
+ * Lookup a pointer to the value of \a key in \a oh.
+ *
+ * \warning The pointer is only valid until the next insertion or removal,
+ * since those may move entries around (unlike #BLI_ghash_lookup_p).
+ */
+void **BLI_ohash_lookup_p(OHash *oh, const void *key)
+{
+	const unsigned int index = ohash_lookup_slot(oh, key);
+	BLI_assert(!(oh->flag & GHASH_FLAG_IS_GSET));
+	return (index != UINT_MAX) ? &oh->entries[index].val : NULL;
+}
+
+/**
+ * Ensure \a key is exists in \a oh, see #BLI_ghash_ensure_p.
+ *
+ * \warning Same as #BLI_ohash_lookup_p, \a r_val is only valid until the next insertion or removal.
+ *
+ * \returns true when the value didn't need to be added.
+ * (when false, the caller _must_ initialize the value).
+ */
+bool BLI_ohash_ensure_p(OHash *oh, void *key, void ***r_val)
+{
+	const unsigned int hash = ohash_keyhash(oh, key);
+	unsigned int index = ohash_lookup_slot_ex(oh, key, hash);
+	const bool haskey = (index != UINT_MAX);
+
+	BLI_assert(!(oh->flag & GHASH_FLAG_IS_GSET));
+
+	if (!haskey) {
+		index = ohash_insert_ex(oh, key, NULL, hash);
+	}
+
+	*r_val = &oh->entries[index].val;
+	return haskey;
+}
+
+/**
+ * Remove \a key from \a oh, or return false if the key wasn't found.
+ *
+ * \param key  The key to remove.
+ * \param keyfreefp  Optional callback to free the key.
+ * \param valfreefp  Optional callback to free the value.
+ * \return true if \a key was removed from \a oh.
+ */
+bool BLI_ohash_remove(OHash *oh, const void *key, GHashKeyFreeFP keyfreefp, GHashValFreeFP valfreefp)
+{
+	return ohash_remove(oh, key, keyfreefp, valfreefp, NULL);
+}
+
+/**
+ * Remove \a key from \a oh, returning the value or NULL if the key wasn't found.
+ *
+ * \param key  The key to remove.
+ * \param keyfreefp  Optional callback to free the key.
+ * \return the value of \a key int \a oh or NULL.
+ */
+void *BLI_ohash_popkey(OHash *oh, const void *key, GHashKeyFreeFP keyfreefp)
+{
+	void *val = NULL;
+	BLI_assert(!(oh->flag & GHASH_FLAG_IS_GSET));
+	ohash_remove(oh, key, keyfreefp, NULL, &val);
+	return val;
+}
+
+/**
+ * \return true if the \a key is in \a oh.
+ */
+bool BLI_ohash_haskey(OHash *oh, const void *key)
+{
+	return (ohash_lookup_slot(oh, key) != UINT_MAX);
+}
+
+/**
+ * Reset \a oh clearing all entries.
+ *
+ * \param keyfreefp  Optional callback to free the key.
+ * \param valfreefp  Optional callback to free the value.
+ * \param nentries_reserve  Optionally reserve the number of members that the hash will hold.
+ */
+void BLI_ohash_clear_ex(OHash *oh, GHashKeyFreeFP keyfreefp, GHashValFreeFP valfreefp,
+                        const unsigned int nentries_reserve)
+{
+	if (keyfreefp || valfreefp)
+		ohash_free_cb(oh, keyfreefp, valfreefp);
+
+	ohash_slots_reset(oh, nentries_reserve);
+}
+
+/**
+ * Wraps #BLI_ohash_clear_ex with zero entries reserved.
+ */
+void BLI_ohash_clear(OHash *oh, GHashKeyFreeFP keyfreefp, GHashValFreeFP valfreefp)
+{
+	BLI_ohash_clear_ex(oh, keyfreefp, valfreefp, 0);
+}
+
+/**
+ * Frees the OHash and its members.
+ *
+ * \param oh  The OHash to free.
+ * \param keyfreefp  Optional callback to free the key.
+ * \param valfreefp  Optional callback to free the value.
+ */
+void BLI_ohash_free(OHash *oh, GHashKeyFreeFP keyfreefp, GHashValFreeFP valfreefp)
+{
+	if (keyfreefp || valfreefp)
+		ohash_free_cb(oh, keyfreefp, valfreefp);
+
+	MEM_freeN(oh->entries);
+	MEM_freeN(oh);
+}
+
+/**
+ * Sets a OHash flag.
+ */
+void BLI_ohash_flag_set(OHash *oh, unsigned int flag)
+{
+	oh->flag |= flag;
+}
+
+/**
+ * Clear a OHash flag.
+ */
+void BLI_ohash_flag_clear(OHash *oh, unsigned int flag)
+{
+	oh->flag &= ~flag;
+}
+
+/** \} */
+
+
+/* -------------------------------------------------------------------- */
+/* OHash Iterator API */
+
+/** \name Iterator API
+ * \{ */
+
+/**
+ * Init an already allocated OHashIterator. The hash table must not
+ * be mutated while the iterator is in use.
+ */
+void BLI_ohashIterator_init(OHashIterator *ohi, OHash *oh)
+{
+	ohi->oh = oh;
+	ohi->curEntry = NULL;
+	ohi->curIndex = UINT_MAX;  /* wraps to zero */
+	BLI_ohashIterator_step(ohi);
+}
+
+/**
+ * Steps the iterator to the next used slot.
+ */
+void BLI_ohashIterator_step(OHashIterator *ohi)
+{
+	OHash *oh = ohi->oh;
+
+	while (++ohi->curIndex < oh->nslots) {
+		if (oh->entries[ohi->curIndex].hash != 0) {
+			ohi->curEntry = &oh->entries[ohi->curIndex];
+			return;
+		}
+	}
+	ohi->curIndex = oh->nslots;
+	ohi->curEntry = NULL;
+}
+
+/** \} */
+
+
+/** \name Convenience OHash Creation Functions
+ * \{ */
+
+OHash *BLI_ohash_ptr_new_ex(const char *info, const unsigned int nentries_reserve)
+{
+	return BLI_ohash_new_ex(BLI_ghashutil_ptrhash, BLI_ghashutil_ptrcmp, info, nentries_reserve);
+}
+OHash *BLI_ohash_ptr_new(const char *info)
+{
+	return BLI_ohash_ptr_new_ex(info, 0);
+}
+
+OHash *BLI_ohash_int_new_ex(const char *info, const unsigned int nentries_reserve)
+{
+	return BLI_ohash_new_ex(BLI_ghashutil_inthash_p, BLI_ghashutil_intcmp, info, nentries_reserve);
+}
+OHash *BLI_ohash_int_new(const char *info)
+{
+	return BLI_ohash_int_new_ex(info, 0);
+}
+
+/** \} */
+
+
+/* -------------------------------------------------------------------- */
+/* OSet API */
+
+/* Use ohash API to give 'set' functionality */
+
+/** \name OSet Functions
+ * \{ */
+OSet *BLI_oset_new_ex(GSetHashFP hashfp, GSetCmpFP cmpfp, const char *info,
+                      const unsigned int nentries_reserve)
+{
+	return (OSet *)ohash_new(hashfp, cmpfp, info, nentries_reserve, GHASH_FLAG_IS_GSET);
+}
+
+OSet *BLI_oset_new(GSetHashFP hashfp, GSetCmpFP cmpfp, const char *info)
+{
+	return BLI_oset_new_ex(hashfp, cmpfp, info, 0);
+}
+
+/**
+ * Copy given OSet. Keys are also copied if callback is provided, else pointers remain the same.
+ */
+OSet *BLI_oset_copy(OSet *os, GSetKeyCopyFP keycopyfp)
+{
+	return (OSet *)ohash_copy((OHash *)os, keycopyfp, NULL);
+}
+
+unsigned int BLI_oset_size(OSet *os)
+{
+	return ((OHash *)os)->nentries;
+}
+
+/**
+ * Adds the key to the set (no checks for unique keys!).
+ * Matching #BLI_ohash_insert
+ */
+void BLI_oset_insert(OSet *os, void *key)
+{
+	OHash *oh = (OHash *)os;
+	ohash_insert_ex(oh, key, NULL, ohash_keyhash(oh, key));
+}
+
+/**
+ * A version of BLI_oset_insert which checks first if the key is in the set.
+ * \returns true if a new key has been added.
+ */
+bool BLI_oset_add(OSet *os, void *key)
+{
+	return ohash_insert_safe((OHash *)os, key, NULL, false, NULL, NULL);
+}
+
+/**
+ * Adds the key to the set (duplicates are managed).
+ * Matching #BLI_ohash_reinsert
+ *
+ * \returns true if a new key has been added.
+ */
+bool BLI_oset_reinsert(OSet *os, void *key, GSetKeyFreeFP keyfreefp)
+{
+	return ohash_insert_safe((OHash *)os, key, NULL, true, keyfreefp, NULL);
+}
+
+bool BLI_oset_remove(OSet *os, const void *key, GSetKeyFreeFP keyfreefp)
+{
+	return ohash_remove((OHash *)os, key, keyfreefp, NULL, NULL);
+}
+
+bool BLI_oset_haskey(OSet *os, const void *key)
+{
+	return (ohash_lookup_slot((OHash *)os, key) != UINT_MAX);
+}
+
+void BLI_oset_clear_ex(OSet *os, GSetKeyFreeFP keyfreefp,
+                       const unsigned int nentries_reserve)
+{
+	BLI_ohash_clear_ex((OHash *)os, keyfreefp, NULL,
+	                   nentries_reserve);
+}
+
+void BLI_oset_clear(OSet *os, GSetKeyFreeFP keyfreefp)
+{
+	BLI_ohash_clear((OHash *)os, keyfreefp, NULL);
+}
+
+void BLI_oset_free(OSet *os, GSetKeyFreeFP keyfreefp)
+{
+	BLI_ohash_free((OHash *)os, keyfreefp, NULL);
+}
+
+void BLI_oset_flag_set(OSet *os, unsigned int flag)
+{
+	((OHash *)os)->flag |= flag;
+}
+
+void BLI_oset_flag_clear(OSet *os, unsigned int flag)
+{
+	((OHash *)os)->flag &= ~flag;
+}
+
+/** \} */
+
+
+/** \name Convenience OSet Creation Functions
+ * \{ */
+
+OSet *BLI_oset_ptr_new_ex(const char *info, const unsigned int nentries_reserve)
+{
+	return BLI_oset_new_ex(BLI_ghashutil_ptrhash, BLI_ghashutil_ptrcmp, info, nentries_reserve);
+}
+OSet *BLI_oset_ptr_new(const char *info)
+{
+	return BLI_oset_ptr_new_ex(info, 0);
+}
+
+OSet *BLI_oset_int_new_ex(const char *info, const unsigned int nentries_reserve)
+{
+	return BLI_oset_new_ex(BLI_ghashutil_inthash_p, BLI_ghashutil_intcmp, info, nentries_reserve);
+}
+OSet *BLI_oset_int_new(const char *info)
+{
+	return BLI_oset_int_new_ex(info, 0);
+}
+
+/** \} */
+
+
+/** \name Debugging & Introspection
+ * \{ */
+
+/**
+ * \return number of slots in the OHash.
+ */
+int BLI_ohash_slots_size(OHash *oh)
+{
+	return (int)oh->nslots;
+}
+int BLI_oset_slots_size(OSet *os)
+{
+	return BLI_ohash_slots_size((OHash *)os);
+}
+
+/**
+ * Measure the average number of slots visited by a successful lookup (1.0 is the ideal),
+ * and return a few other stats like load and longest probing sequence.
+ *
+ * Smaller is better!
+ */
+double BLI_ohash_calc_quality_ex(
+        OHash *oh, double *r_load, double *r_probe_mean, int *r_probe_max)
+{
+	uint64_t sum = 0;
+	unsigned int probe_max = 0;
+	unsigned int i;
+
+	for (i = 0; i < oh->nslots; i++) {
+		if (oh->entries[i].hash != 0) {
+			const unsigned int dist = ohash_probe_dist(oh, oh->entries[i].hash, i);
+			sum += dist;
+			probe_max = MAX2(probe_max, dist);
+		}
+	}
+
+	if (r_load) {
+		*r_load = (double)oh->nentries / (double)oh->nslots;
+	}
+	if (r_probe_mean) {
+		*r_probe_mean = oh->nentries ? (double)sum / (double)oh->nentries : 0.0;
+	}
+	if (r_probe_max) {
+		*r_probe_max = (int)probe_max;
+	}
+
+	return oh->nentries ? 1.0 + (double)sum / (double)oh->nentries : 0.0;
+}
+double BLI_oset_calc_quality_ex(
+        OSet *os, double *r_load, double *r_probe_mean, int *r_probe_max)
+{
+	return BLI_ohash_calc_quality_ex((OHash *)os, r_load, r_probe_mean, r_probe_max);
+}
+
+/** \} */
@@ -0,0 +1,264 @@
+/*
+ * ***** BEGIN GPL LICENSE BLOCK *****
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ * ***** END GPL LICENSE BLOCK *****
+ */
+
+/** \file blender/blenlib/intern/color_lut.c
+ *  \ingroup bli
+ *
+ * Scene linear values are mapped onto the lattice by a shaper which approximates log2,
+ * so each stop gets the same number of lattice points. Values outside of the shaper range
+ * are clamped. Lattice points are interpolated tetrahedrally.
+ */
+
+#include <math.h>
+
+#include "MEM_guardedalloc.h"
+
+#include "BLI_color_lut.h"
+#include "BLI_math_base.h"
+#include "BLI_utildefines.h"
+
+#ifdef __SSE2__
+#  include <emmintrin.h>
+#endif
+
+/* range of the shaper in stops */
+#define LUT_LOG2_MIN -10
+#define LUT_LOG2_MAX 6
+#define LUT_STOPS (LUT_LOG2_MAX - LUT_LOG2_MIN)
+
+/* added before the shaper, so zero maps onto the first lattice point */
+#define LUT_BIAS (1.0f / (1 << -LUT_LOG2_MIN))
+#define LUT_MAX ((float)(1 << LUT_LOG2_MAX))
+
+struct ColorLUT {
+	int size;
+	/* shaper to lattice coordinates */
+	float scale;
+	/* size^3 RGB values with red changing fastest, one float larger for 4 wide loads of the last one */
+	float *table;
+};
+
+/* Piecewise linear log2, exact at powers of two. It's inverted exactly when baking,
+ * so the interpolation is exact at the lattice points. */
+BLI_INLINE float lut_shaper(float x)
+{
+	union { float f; int i; } u;
+	float exponent;
+
+	/* also takes NaN to zero */
+	x = (x > 0.0f) ? x : 0.0f;
+	u.f = min_ff(x + LUT_BIAS, LUT_MAX);
+
+	exponent = (float)((u.i >> 23) - 127);
+	u.i = (u.i & 0x007fffff) | 0x3f800000;
+
+	return exponent + u.f - 1.0f - (float)LUT_LOG2_MIN;
+}
+
+BLI_INLINE float lut_shaper_inverse(float t)
+{
+	float exponent = floorf(t);
+
+	return ldexpf(1.0f + t - exponent, (int)exponent + LUT_LOG2_MIN) - LUT_BIAS;
+}
+
+ColorLUT *BLI_color_lut_bake(int size, ColorLUTBakeFunc bake, void *userdata)
+{
+	ColorLUT *lut = MEM_callocN(sizeof(ColorLUT), "ColorLUT");
+	const size_t num_points = (size_t)size * size * size;
+	float *values = MEM_mallocN(sizeof(float) * size, "ColorLUT values");
+	float *rgb;
+	int r, g, b;
+
+	BLI_assert(size >= 2);
+
+	lut->size = size;
+	lut->scale = (float)(size - 1) / LUT_STOPS;
+	lut->table = MEM_mallocN(sizeof(float) * (3 * num_points + 1), "ColorLUT table");
+
+	for (r = 0; r < size; r++) {
+		values[r] = lut_shaper_inverse((float)r / lut->scale);
+	}
+
+	rgb = lut->table;
+	for (b = 0; b < size; b++) {
+		for (g = 0; g < size; g++) {
+			for (r = 0; r < size; r++, rgb += 3) {
+				rgb[0] = values[r];
+				rgb[1] = values[g];
+				rgb[2] = values[b];
+			}
+		}
+	}
+	lut->table[3 * num_points] = 0.0f;
+
+	bake(userdata, lut->table, num_points);
+
+	MEM_freeN(values);
+
+	return lut;
+}
+
+void BLI_color_lut_free(ColorLUT *lut)
+{
+	MEM_freeN(lut->table);
+	MEM_freeN(lut);
+}
+
+/* Find the tetrahedron of the lattice cell which contains the lattice coordinates co,
+ * as offsets of its corners from the first one and their weights. */
+BLI_INLINE const float *lut_tetrahedron(const ColorLUT *lut, const float co[3], int offset[3], float weight[4])
+{
+	const int last = lut->size - 2;
+	const int stride[3] = {3, 3 * lut->size, 3 * lut->size * lut->size};
+	int index[3], i;
+	float f[3];
+
+	for (i = 0; i < 3; i++) {
+		index[i] = min_ii((int)co[i], last);
+		f[i] = co[i] - (float)index[i];
+	}
+
+	/* walk from the first corner towards the opposite one along the axes with the largest fractions */
+	if (f[0] > f[1]) {
+		if (f[1] > f[2]) {
+			offset[0] = stride[0]; offset[1] = stride[0] + stride[1];
+			weight[0] = 1.0f - f[0]; weight[1] = f[0] - f[1]; weight[2] = f[1] - f[2]; weight[3] = f[2];
+		}
+		else if (f[0] > f[2]) {
+			offset[0] = stride[0]; offset[1] = stride[0] + stride[2];
+			weight[0] = 1.0f - f[0]; weight[1] = f[0] - f[2]; weight[2] = f[2] - f[1]; weight[3] = f[1];
+		}
+		else {
+			offset[0] = stride[2]; offset[1] = stride[0] + stride[2];
+			weight[0] = 1.0f - f[2]; weight[1] = f[2] - f[0]; weight[2] = f[0] - f[1]; weight[3] = f[1];
+		}
+	}
+	else {
+		if (f[2] > f[1]) {
+			offset[0] = stride[2]; offset[1] = stride[1] + stride[2];
+			weight[0] = 1.0f - f[2]; weight[1] = f[2] - f[1]; weight[2] = f[1] - f[0]; weight[3] = f[0];
+		}
+		else if (f[2] > f[0]) {
+			offset[0] = stride[1]; offset[1] = stride[1] + stride[2];
+			weight[0] = 1.0f - f[1]; weight[1] = f[1] - f[2]; weight[2] = f[2] - f[0]; weight[3] = f[0];
+		}
+		else {
+			offset[0] = stride[1]; offset[1] = stride[0] + stride[1];
+			weight[0] = 1.0f - f[1]; weight[1] = f[1] - f[0]; weight[2] = f[0] - f[2]; weight[3] = f[2];
+		}
+	}
+	offset[2] = stride[0] + stride[1] + stride[2];
+
+	return lut->table + index[0] * stride[0] + index[1] * stride[1] + index[2] * stride[2];
+}
+
+#ifdef __SSE2__
+
+BLI_INLINE void lut_apply_v3(const ColorLUT *lut, float rgb[3])
+{
+	const __m128i mantissa_mask = _mm_set1_epi32(0x007fffff);
+	const __m128i one_bits = _mm_set1_epi32(0x3f800000);
+	__m128 x, co, result;
+	__m128i bits;
+	float co_v[4], weight[4];
+	const float *corner;
+	int offset[3];
+
+	/* shaper, as lut_shaper */
+	x = _mm_max_ps(_mm_setr_ps(rgb[0], rgb[1], rgb[2], 0.0f), _mm_setzero_ps());
+	x = _mm_min_ps(_mm_add_ps(x, _mm_set1_ps(LUT_BIAS)), _mm_set1_ps(LUT_MAX));
+	bits = _mm_castps_si128(x);
+
+	co = _mm_cvtepi32_ps(_mm_sub_epi32(_mm_srli_epi32(bits, 23), _mm_set1_epi32(127 + LUT_LOG2_MIN)));
+	co = _mm_add_ps(co, _mm_sub_ps(_mm_castsi128_ps(_mm_or_si128(_mm_and_si128(bits, mantissa_mask), one_bits)),
+	                               _mm_set1_ps(1.0f)));
+	_mm_storeu_ps(co_v, _mm_mul_ps(co, _mm_set1_ps(lut->scale)));
+
+	corner = lut_tetrahedron(lut, co_v, offset, weight);
+
+	result = _mm_mul_ps(_mm_loadu_ps(corner), _mm_set1_ps(weight[0]));
+	result = _mm_add_ps(result, _mm_mul_ps(_mm_loadu_ps(corner + offset[0]), _mm_set1_ps(weight[1])));
+	result = _mm_add_ps(result, _mm_mul_ps(_mm_loadu_ps(corner + offset[1]), _mm_set1_ps(weight[2])));
+	result = _mm_add_ps(result, _mm_mul_ps(_mm_loadu_ps(corner + offset[2]), _mm_set1_ps(weight[3])));
+
+	_mm_storeu_ps(co_v, result);
+	rgb[0] = co_v[0];
+	rgb[1] = co_v[1];
+	rgb[2] = co_v[2];
+}
+
+#else
+
+BLI_INLINE void lut_apply_v3(const ColorLUT *lut, float rgb[3])
+{
+	float co[3], weight[4];
+	const float *corner;
+	int offset[3], i;
+
+	for (i = 0; i < 3; i++) {
+		co[i] = lut_shaper(rgb[i]) * lut->scale;
+	}
+
+	corner = lut_tetrahedron(lut, co, offset, weight);
+
+	for (i = 0; i < 3; i++) {
+		rgb[i] = corner[i] * weight[0] +
+		         corner[offset[0] + i] * weight[1] +
+		         corner[offset[1] + i] * weight[2] +
+		         corner[offset[2] + i] * weight[3];
+	}
+}
+
+#endif  /* __SSE2__ */
+
+void BLI_color_lut_apply_v3(const ColorLUT *lut, float rgb[3])
+{
+	lut_apply_v3(lut, rgb);
+}
+
+/* predivide matches OpenColorIO, fully transparent and opaque pixels aren't divided */
+void BLI_color_lut_apply(const ColorLUT *lut, float *buffer, size_t num_pixels, int channels, bool predivide)
+{
+	float *pixel = buffer;
+	size_t i;
+
+	BLI_assert(channels >= 3);
+
+	for (i = 0; i < num_pixels; i++, pixel += channels) {
+		if (predivide && channels == 4 && !ELEM(pixel[3], 0.0f, 1.0f)) {
+			const float alpha = pixel[3];
+			const float inv_alpha = 1.0f / alpha;
+
+			pixel[0] *= inv_alpha;
+			pixel[1] *= inv_alpha;
+			pixel[2] *= inv_alpha;
+
+			lut_apply_v3(lut, pixel);
+
+			pixel[0] *= alpha;
+			pixel[1] *= alpha;
+			pixel[2] *= alpha;
+		}
+		else {
+			lut_apply_v3(lut, pixel);
+		}
+	}
+}
@@ -1057,4 +1057,12 @@ void blo_do_versions_270(FileData *fd, Library *UNUSED(lib), Main *main)
 			scene->r.bake.pass_filter = R_BAKE_PASS_FILTER_ALL;
 		}
 	}
+
+	if (!DNA_struct_elem_find(fd->filesdna, "bNodeTree", "int", "cache_size")) {
+		for (Scene *scene = main->scene.first; scene != NULL; scene = scene->id.next) {
+			if (scene->nodetree) {
+				scene->nodetree->cache_size = 1024;
+			}
+		}
+	}
 }
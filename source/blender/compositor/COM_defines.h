@@ -111,4 +111,11 @@ typedef enum OrderOfChunks {
 
 #define COM_BLUR_BOKEH_PIXELS 512
 
+/**
+ * @brief maximum number of pixels computed by one SocketReader.executeRow call.
+ * Operations keep temporary rows of this length on the stack.
+ * @see SocketReader.executeRow
+ */
+#define COM_ROW_LENGTH 64
+
 #endif  /* __COM_DEFINES_H__ */
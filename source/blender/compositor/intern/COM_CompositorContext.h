@@ -82,6 +82,11 @@ private:
 	 */
 	bool m_fastCalculation;
 
+	/**
+	 * @brief calculate the tree at 1/divider of its resolution, for the progressive viewer preview
+	 */
+	int m_resolutionDivider;
+
 	/* @brief color management settings */
 	const ColorManagedViewSettings *m_viewSettings;
 	const ColorManagedDisplaySettings *m_displaySettings;
@@ -199,6 +204,16 @@ public:
 	
 	void setFastCalculation(bool fastCalculation) {this->m_fastCalculation = fastCalculation;}
 	bool isFastCalculation() const { return this->m_fastCalculation; }
+	void setResolutionDivider(int resolutionDivider) { this->m_resolutionDivider = resolutionDivider; }
+	int getResolutionDivider() const { return this->m_resolutionDivider; }
+
+	/**
+	 * @brief convert a distance in pixels of the full resolution to the resolution the tree is calculated at
+	 */
+	int scalePixelDistance(int distance) const {
+		const int half = this->m_resolutionDivider / 2;
+		return (distance >= 0 ? distance + half : distance - half) / this->m_resolutionDivider;
+	}
 	bool isGroupnodeBufferEnabled() const { return (this->getbNodeTree()->flag & NTREE_COM_GROUPNODE_BUFFER) != 0; }
 };
 
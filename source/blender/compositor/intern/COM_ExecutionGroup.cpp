@@ -21,9 +21,11 @@
  */
 
 #include <algorithm>
+#include <map>
 #include <math.h>
 #include <sstream>
 #include <stdlib.h>
+#include <typeinfo>
 
 #include "atomic_ops.h"
 
@@ -31,6 +33,7 @@
 #include "COM_defines.h"
 #include "COM_ExecutionSystem.h"
 #include "COM_ReadBufferOperation.h"
+#include "COM_ResultCache.h"
 #include "COM_WriteBufferOperation.h"
 #include "COM_WorkScheduler.h"
 #include "COM_ViewerOperation.h"
@@ -63,6 +66,10 @@ ExecutionGroup::ExecutionGroup()
 	this->m_chunksFinished = 0;
 	BLI_rcti_init(&this->m_viewerBorder, 0, 0, 0, 0);
 	this->m_executionStartTime = 0;
+	this->m_resultCacheState = COM_RC_UNKNOWN;
+	this->m_resultKey = 0;
+	this->m_chunkTime = 0;
+	this->m_buffersAllocated = false;
 }
 
 CompositorPriority ExecutionGroup::getRenderPriotrity()
@@ -137,7 +144,9 @@ void ExecutionGroup::initExecution()
 	}
 	maxNumber++;
 	this->m_cachedMaxReadBufferOffset = maxNumber;
+	this->m_buffersAllocated = false;
 
+	setResultCacheState(COM_RC_UNKNOWN);
 }
 
 void ExecutionGroup::deinitExecution()
@@ -383,7 +392,14 @@ void ExecutionGroup::finalizeChunkExecution(int chunkNumber, MemoryBuffer **memo
 	if (this->m_chunkExecutionStates[chunkNumber] == COM_ES_SCHEDULED)
 		this->m_chunkExecutionStates[chunkNumber] = COM_ES_EXECUTED;
 	
-	atomic_add_u(&this->m_chunksFinished, 1);
+	if (atomic_add_u(&this->m_chunksFinished, 1) == this->m_numberOfChunks) {
+		/* all chunks are calculated, the input buffers aren't needed anymore by this group */
+		vector<MemoryProxy *> memoryProxies;
+		determineDependingMemoryProxies(&memoryProxies);
+		for (unsigned int index = 0; index < memoryProxies.size(); index++) {
+			memoryProxies[index]->releaseReader();
+		}
+	}
 	if (memoryBuffers) {
 		for (unsigned int index = 0; index < this->m_cachedMaxReadBufferOffset; index++) {
 			MemoryBuffer *buffer = memoryBuffers[index];
@@ -485,6 +501,9 @@ bool ExecutionGroup::scheduleAreaWhenPossible(ExecutionSystem *graph, rcti *area
 bool ExecutionGroup::scheduleChunk(unsigned int chunkNumber)
 {
 	if (this->m_chunkExecutionStates[chunkNumber] == COM_ES_NOT_SCHEDULED) {
+		if (!this->m_buffersAllocated) {
+			allocateBuffers();
+		}
 		this->m_chunkExecutionStates[chunkNumber] = COM_ES_SCHEDULED;
 		WorkScheduler::schedule(this, chunkNumber);
 		return true;
@@ -492,6 +511,21 @@ bool ExecutionGroup::scheduleChunk(unsigned int chunkNumber)
 	return false;
 }
 
+void ExecutionGroup::allocateBuffers()
+{
+	NodeOperation *operation = this->getOutputOperation();
+	if (operation->isWriteBufferOperation()) {
+		((WriteBufferOperation *)operation)->getMemoryProxy()->allocateWhenNeeded();
+	}
+
+	for (unsigned int index = 0; index < this->m_cachedReadOperations.size(); index++) {
+		ReadBufferOperation *readOperation = (ReadBufferOperation *)this->m_cachedReadOperations[index];
+		readOperation->getMemoryProxy()->allocateWhenNeeded();
+		readOperation->updateMemoryBuffer();
+	}
+	this->m_buffersAllocated = true;
+}
+
 bool ExecutionGroup::scheduleChunkWhenPossible(ExecutionSystem *graph, int xChunk, int yChunk)
 {
 	if (xChunk < 0 || xChunk >= (int)this->m_numberOfXChunks) {
@@ -559,6 +593,79 @@ void ExecutionGroup::determineDependingMemoryProxies(vector<MemoryProxy *> *memo
 	}
 }
 
+bool ExecutionGroup::hashOperations(ResultCacheHash &hash) const
+{
+	std::map<const NodeOperation *, int> indices;
+	unsigned int index;
+	for (index = 0; index < this->m_operations.size(); index++) {
+		indices[this->m_operations[index]] = index;
+	}
+
+	hash.addInt(this->m_width);
+	hash.addInt(this->m_height);
+
+	for (index = 0; index < this->m_operations.size(); index++) {
+		NodeOperation *operation = this->m_operations[index];
+
+		hash.addString(typeid(*operation).name());
+		hash.addInt(operation->getWidth());
+		hash.addInt(operation->getHeight());
+		if (!operation->hashSettings(hash)) {
+			return false;
+		}
+
+		if (operation->isReadBufferOperation()) {
+			MemoryProxy *memoryProxy = ((ReadBufferOperation *)operation)->getMemoryProxy();
+			BLI_assert(memoryProxy->getExecutor()->getResultCacheState() != COM_RC_UNKNOWN);
+			hash.addKey(memoryProxy->getExecutor()->getResultKey());
+		}
+		else if (operation->isWriteBufferOperation()) {
+			hash.addInt(((WriteBufferOperation *)operation)->getMemoryProxy()->getDataType());
+		}
+
+		/* links inside the group, by index of the linked operation */
+		for (unsigned int i = 0; i < operation->getNumberOfInputSockets(); i++) {
+			NodeOperationInput *input = operation->getInputSocket(i);
+			int link = -1;
+			if (input->isConnected()) {
+				std::map<const NodeOperation *, int>::const_iterator it = indices.find(&input->getLink()->getOperation());
+				if (it != indices.end()) {
+					link = it->second;
+				}
+			}
+			hash.addInt(input->getDataType());
+			hash.addInt(input->getResizeMode());
+			hash.addInt(link);
+		}
+		for (unsigned int i = 0; i < operation->getNumberOfOutputSockets(); i++) {
+			hash.addInt(operation->getOutputSocket(i)->getDataType());
+		}
+	}
+	return true;
+}
+
+void ExecutionGroup::addChunkTime(double seconds)
+{
+	atomic_add_z(&this->m_chunkTime, (size_t)(seconds * 1e6));
+}
+
+void ExecutionGroup::setExecuted()
+{
+	for (unsigned int index = 0; index < this->m_numberOfChunks; index++) {
+		this->m_chunkExecutionStates[index] = COM_ES_EXECUTED;
+	}
+}
+
+bool ExecutionGroup::isExecuted() const
+{
+	for (unsigned int index = 0; index < this->m_numberOfChunks; index++) {
+		if (this->m_chunkExecutionStates[index] != COM_ES_EXECUTED) {
+			return false;
+		}
+	}
+	return true;
+}
+
 bool ExecutionGroup::isOpenCL()
 {
 	return this->m_openCL;
@@ -36,6 +36,7 @@ using std::vector;
 class ExecutionSystem;
 class MemoryProxy;
 class ReadBufferOperation;
+class ResultCacheHash;
 class Device;
 
 /**
@@ -57,6 +58,34 @@ typedef enum ChunkExecutionState {
 	COM_ES_EXECUTED = 2
 } ChunkExecutionState;
 
+/**
+ * @brief the state of the result of an ExecutionGroup in the ResultCache
+ * @ingroup Execution
+ */
+typedef enum ResultCacheState {
+	/**
+	 * @brief the key of the result is not determined yet
+	 */
+	COM_RC_UNKNOWN = 0,
+	/**
+	 * @brief the result can't be keyed, it is not cached
+	 */
+	COM_RC_NONE = 1,
+	/**
+	 * @brief the result depends on data outside of the node tree, it is calculated before
+	 * the other groups and keyed by its content. It is not cached.
+	 */
+	COM_RC_VOLATILE = 2,
+	/**
+	 * @brief the result is keyed by the settings of the operations, it is cached after execution
+	 */
+	COM_RC_KEYED = 3,
+	/**
+	 * @brief the result has been restored from the cache
+	 */
+	COM_RC_RESTORED = 4
+} ResultCacheState;
+
 /**
  * @brief Class ExecutionGroup is a group of Operations that are executed as one.
  * This grouping is used to combine Operations that can be executed as one whole when multi-processing.
@@ -178,6 +207,26 @@ private:
 	 */
 	double m_executionStartTime;
 
+	/**
+	 * @brief time spent calculating chunks of this group by all devices, in microseconds
+	 */
+	size_t m_chunkTime;
+
+	/**
+	 * @brief state of the result in the ResultCache
+	 */
+	ResultCacheState m_resultCacheState;
+
+	/**
+	 * @brief key of the result in the ResultCache, see ResultCacheState
+	 */
+	uint64_t m_resultKey;
+
+	/**
+	 * @brief the buffers written and read by this group are allocated, see allocateBuffers
+	 */
+	bool m_buffersAllocated;
+
 	// methods
 	/**
 	 * @brief check whether parameter operation can be added to the execution group
@@ -236,6 +285,13 @@ private:
 	 * @param chunknumber
 	 */
 	bool scheduleChunk(unsigned int chunkNumber);
+
+	/**
+	 * @brief allocate the MemoryProxy this group writes and connect its ReadBufferOperations,
+	 * called when the first chunk is scheduled.
+	 * @note the MemoryProxies read are allocated by the groups writing them, except when no chunk of them was needed
+	 */
+	void allocateBuffers();
 	
 	/**
 	 * @brief determine the area of interest of a certain input area
@@ -383,6 +439,49 @@ public:
 	 * @param memoryProxies result
 	 */
 	void determineDependingMemoryProxies(vector<MemoryProxy *> *memoryProxies);
+
+	/**
+	 * @brief add the operations of this group, their settings and links to a hash
+	 * @note the result key of the groups this group reads from must be determined.
+	 * @return false when an operation depends on data outside of the node tree
+	 * @see NodeOperation.hashSettings
+	 */
+	bool hashOperations(ResultCacheHash &hash) const;
+
+	ResultCacheState getResultCacheState() const { return this->m_resultCacheState; }
+	uint64_t getResultKey() const { return this->m_resultKey; }
+	void setResultCacheState(ResultCacheState state, uint64_t key = 0) {
+		this->m_resultCacheState = state;
+		this->m_resultKey = key;
+	}
+
+	const Operations &getOperations() const { return this->m_operations; }
+
+	/**
+	 * @brief add the time a device spent calculating a chunk of this group
+	 * @note called from the worker threads
+	 */
+	void addChunkTime(double seconds);
+
+	/**
+	 * @brief time spent calculating chunks of this group by all devices, in seconds
+	 */
+	double getChunkTime() const { return this->m_chunkTime / 1e6; }
+
+	/**
+	 * @brief number of chunks calculated by the devices
+	 */
+	unsigned int getChunksFinished() const { return this->m_chunksFinished; }
+
+	/**
+	 * @brief mark all chunks as executed, used when the result is restored from the ResultCache
+	 */
+	void setExecuted();
+
+	/**
+	 * @brief are all chunks of this ExecutionGroup executed
+	 */
+	bool isExecuted() const;
 	
 	/**
 	 * @brief Determine the rect (minx, maxx, miny, maxy) of a chunk.
@@ -25,6 +25,7 @@
 #include "PIL_time.h"
 #include "BLI_utildefines.h"
 extern "C" {
+#include "BKE_global.h"
 #include "BKE_node.h"
 }
 
@@ -36,6 +37,8 @@ extern "C" {
 #include "COM_ExecutionGroup.h"
 #include "COM_WorkScheduler.h"
 #include "COM_ReadBufferOperation.h"
+#include "COM_WriteBufferOperation.h"
+#include "COM_ResultCache.h"
 #include "COM_Debug.h"
 
 #ifdef WITH_CXX_GUARDEDALLOC
@@ -43,14 +46,16 @@ extern "C" {
 #endif
 
 ExecutionSystem::ExecutionSystem(RenderData *rd, Scene *scene, bNodeTree *editingtree, bool rendering, bool fastcalculation,
-                                 const ColorManagedViewSettings *viewSettings, const ColorManagedDisplaySettings *displaySettings,
-                                 const char *viewName)
+                                 int resolutionDivider, const ColorManagedViewSettings *viewSettings,
+                                 const ColorManagedDisplaySettings *displaySettings, const char *viewName)
 {
 	this->m_context.setViewName(viewName);
+	this->m_contextKey = 0;
 	this->m_context.setScene(scene);
 	this->m_context.setbNodeTree(editingtree);
 	this->m_context.setPreviewHash(editingtree->previews);
 	this->m_context.setFastCalculation(fastcalculation);
+	this->m_context.setResolutionDivider(resolutionDivider);
 	/* initialize the CompositorContext */
 	if (rendering) {
 		this->m_context.setQuality((CompositorQuality)editingtree->render_quality);
@@ -144,20 +149,17 @@ void ExecutionSystem::execute()
 	}
 	unsigned int index;
 
-	// First allocale all write buffer
+	// The write buffers are allocated when their group is scheduled, the peak only counts this execution
+	MemoryProxy::resetPeakSize();
+	size_t buffersSize = 0;
+
+	// First initialize all write buffers
 	for (index = 0; index < this->m_operations.size(); index++) {
 		NodeOperation *operation = this->m_operations[index];
 		if (operation->isWriteBufferOperation()) {
 			operation->setbNodeTree(this->m_context.getbNodeTree());
 			operation->initExecution();
-		}
-	}
-	// Connect read buffers to their write buffers
-	for (index = 0; index < this->m_operations.size(); index++) {
-		NodeOperation *operation = this->m_operations[index];
-		if (operation->isReadBufferOperation()) {
-			ReadBufferOperation *readOperation = (ReadBufferOperation *)operation;
-			readOperation->updateMemoryBuffer();
+			buffersSize += ((WriteBufferOperation *)operation)->getMemoryProxy()->determineSize();
 		}
 	}
 	// initialize other operations
@@ -173,9 +175,24 @@ void ExecutionSystem::execute()
 		executionGroup->setChunksize(this->m_context.getChunksize());
 		executionGroup->initExecution();
 	}
+	// Count the readers of the buffers, so they are freed when the last one is finished
+	for (index = 0; index < this->m_groups.size(); index++) {
+		vector<MemoryProxy *> memoryProxies;
+		this->m_groups[index]->determineDependingMemoryProxies(&memoryProxies);
+		for (unsigned int i = 0; i < memoryProxies.size(); i++) {
+			memoryProxies[i]->addReader();
+		}
+	}
 
 	WorkScheduler::start(this->m_context);
 
+	const bool use_result_cache = ResultCache::getLimit() > 0;
+	if (use_result_cache) {
+		/* the buffers of this execution come first in the memory budget */
+		ResultCache::reserve(buffersSize);
+		restoreCachedResults();
+	}
+
 	executeGroups(COM_PRIORITY_HIGH);
 	if (!this->getContext().isFastCalculation()) {
 		executeGroups(COM_PRIORITY_MEDIUM);
@@ -185,6 +202,15 @@ void ExecutionSystem::execute()
 	WorkScheduler::finish();
 	WorkScheduler::stop();
 
+	if (use_result_cache && !(editingtree->test_break && editingtree->test_break(editingtree->tbh))) {
+		storeCachedResults();
+	}
+
+	if (G.debug & G_DEBUG) {
+		reportExecutionTimes();
+		reportMemoryUsage();
+	}
+
 	editingtree->stats_draw(editingtree->sdh, IFACE_("Compositing | De-initializing execution"));
 	for (index = 0; index < this->m_operations.size(); index++) {
 		NodeOperation *operation = this->m_operations[index];
@@ -196,6 +222,59 @@ void ExecutionSystem::execute()
 	}
 }
 
+void ExecutionSystem::reportExecutionTimes()
+{
+	double total = 0.0;
+	printf("Compositor execution groups:\n");
+	for (unsigned int index = 0; index < this->m_groups.size(); index++) {
+		ExecutionGroup *group = this->m_groups[index];
+		if (group->getChunksFinished() == 0) {
+			continue;
+		}
+
+		/* name a group by the nodes its operations come from */
+		std::string names;
+		const ExecutionGroup::Operations &operations = group->getOperations();
+		const bNode *last_node = NULL;
+		for (unsigned int i = 0; i < operations.size(); i++) {
+			const bNode *node = operations[i]->getbNode();
+			if (node && node != last_node) {
+				if (!names.empty()) {
+					names += ", ";
+				}
+				names += node->name;
+				last_node = node;
+			}
+		}
+
+		printf("  group %-3u %5u chunks %9.3f s  %s\n",
+		       index, group->getChunksFinished(), group->getChunkTime(), names.c_str());
+		total += group->getChunkTime();
+	}
+	printf("  total %.3f s\n", total);
+}
+
+void ExecutionSystem::reportMemoryUsage()
+{
+	size_t total = 0;
+	printf("Compositor buffers:\n");
+	for (unsigned int index = 0; index < this->m_operations.size(); index++) {
+		NodeOperation *operation = this->m_operations[index];
+		if (operation->isWriteBufferOperation()) {
+			MemoryProxy *memoryProxy = ((WriteBufferOperation *)operation)->getMemoryProxy();
+			const bNode *node = operation->getbNode();
+			printf("  %-32s %5dx%-5d %8.2f MB%s\n",
+			       node ? node->name : "", operation->getWidth(), operation->getHeight(),
+			       memoryProxy->getSize() / (1024.0 * 1024.0),
+			       memoryProxy->isReleased() ? " (freed after last reader)" : "");
+			total += memoryProxy->getSize();
+		}
+	}
+	printf("  total %.2f MB, peak %.2f MB, result cache %.2f MB\n",
+	       total / (1024.0 * 1024.0), MemoryProxy::getPeakSize() / (1024.0 * 1024.0),
+	       ResultCache::getSize() / (1024.0 * 1024.0));
+}
+
 void ExecutionSystem::executeGroups(CompositorPriority priority)
 {
 	unsigned int index;
@@ -208,6 +287,131 @@ void ExecutionSystem::executeGroups(CompositorPriority priority)
 	}
 }
 
+void ExecutionSystem::restoreCachedResults()
+{
+	const bNodeTree *editingtree = this->m_context.getbNodeTree();
+	editingtree->stats_draw(editingtree->sdh, IFACE_("Compositing | Restoring cached results"));
+
+	ResultCacheHash hash;
+	hash.addInt(this->m_context.getQuality());
+	hash.addInt(this->m_context.isFastCalculation());
+	hash.addInt(this->m_context.getResolutionDivider());
+	hash.addInt(this->m_context.getFramenumber());
+	hash.addInt(this->m_context.getRenderData()->size);
+	hash.addString(this->m_context.getViewName() ? this->m_context.getViewName() : "");
+	if (this->m_context.getViewSettings()) {
+		const ColorManagedViewSettings *view_settings = this->m_context.getViewSettings();
+		hash.addString(view_settings->look);
+		hash.addString(view_settings->view_transform);
+		hash.addFloat(view_settings->exposure);
+		hash.addFloat(view_settings->gamma);
+	}
+	if (this->m_context.getDisplaySettings()) {
+		hash.addString(this->m_context.getDisplaySettings()->display_device);
+	}
+	this->m_contextKey = hash.end();
+
+	vector<ExecutionGroup *> executionGroups;
+	this->findOutputExecutionGroup(&executionGroups, COM_PRIORITY_HIGH);
+	if (!this->getContext().isFastCalculation()) {
+		this->findOutputExecutionGroup(&executionGroups, COM_PRIORITY_MEDIUM);
+		this->findOutputExecutionGroup(&executionGroups, COM_PRIORITY_LOW);
+	}
+
+	std::set<ExecutionGroup *> visited;
+	for (unsigned int index = 0; index < executionGroups.size(); index++) {
+		restoreCachedResult(executionGroups[index], visited);
+	}
+}
+
+void ExecutionSystem::restoreCachedResult(ExecutionGroup *group, std::set<ExecutionGroup *> &visited)
+{
+	if (!visited.insert(group).second) {
+		return;
+	}
+
+	if (determineResultKey(group, visited) == COM_RC_KEYED) {
+		MemoryProxy *memoryProxy = ((WriteBufferOperation *)group->getOutputOperation())->getMemoryProxy();
+		memoryProxy->allocateWhenNeeded();
+		if (ResultCache::restore(group->getResultKey(), memoryProxy->getBuffer())) {
+			group->setResultCacheState(COM_RC_RESTORED, group->getResultKey());
+			group->setExecuted();
+			return;
+		}
+		/* allocated again when the group is scheduled */
+		memoryProxy->free();
+	}
+
+	/* not restored, the groups it reads from are needed */
+	vector<MemoryProxy *> memoryProxies;
+	group->determineDependingMemoryProxies(&memoryProxies);
+	for (unsigned int index = 0; index < memoryProxies.size(); index++) {
+		restoreCachedResult(memoryProxies[index]->getExecutor(), visited);
+	}
+}
+
+ResultCacheState ExecutionSystem::determineResultKey(ExecutionGroup *group, std::set<ExecutionGroup *> &visited)
+{
+	if (group->getResultCacheState() != COM_RC_UNKNOWN) {
+		return group->getResultCacheState();
+	}
+
+	/* only results written to a MemoryBuffer can be cached */
+	if (!group->getOutputOperation()->isWriteBufferOperation()) {
+		group->setResultCacheState(COM_RC_NONE);
+		return COM_RC_NONE;
+	}
+
+	vector<MemoryProxy *> memoryProxies;
+	group->determineDependingMemoryProxies(&memoryProxies);
+	unsigned int index;
+	for (index = 0; index < memoryProxies.size(); index++) {
+		if (determineResultKey(memoryProxies[index]->getExecutor(), visited) == COM_RC_NONE) {
+			group->setResultCacheState(COM_RC_NONE);
+			return COM_RC_NONE;
+		}
+	}
+
+	ResultCacheHash hash;
+	hash.addKey(this->m_contextKey);
+	if (group->hashOperations(hash)) {
+		group->setResultCacheState(COM_RC_KEYED, hash.end());
+		return COM_RC_KEYED;
+	}
+
+	/* the result depends on data outside of the node tree, calculate it now and key it by its content */
+	for (index = 0; index < memoryProxies.size(); index++) {
+		restoreCachedResult(memoryProxies[index]->getExecutor(), visited);
+	}
+	group->execute(this);
+	WorkScheduler::finish();
+
+	if (!group->isExecuted()) {
+		group->setResultCacheState(COM_RC_NONE);
+		return COM_RC_NONE;
+	}
+
+	MemoryBuffer *buffer = ((WriteBufferOperation *)group->getOutputOperation())->getMemoryProxy()->getBuffer();
+	ResultCacheHash content;
+	content.addInt(buffer->getWidth());
+	content.addInt(buffer->getHeight());
+	content.addInt(buffer->get_num_channels());
+	content.add(buffer->getBuffer(), sizeof(float) * buffer->getWidth() * buffer->getHeight() * buffer->get_num_channels());
+	group->setResultCacheState(COM_RC_VOLATILE, content.end());
+	return COM_RC_VOLATILE;
+}
+
+void ExecutionSystem::storeCachedResults()
+{
+	for (unsigned int index = 0; index < this->m_groups.size(); index++) {
+		ExecutionGroup *group = this->m_groups[index];
+		if (group->getResultCacheState() == COM_RC_KEYED && group->isExecuted()) {
+			MemoryProxy *memoryProxy = ((WriteBufferOperation *)group->getOutputOperation())->getMemoryProxy();
+			ResultCache::store(group->getResultKey(), memoryProxy->getBuffer());
+		}
+	}
+}
+
 void ExecutionSystem::findOutputExecutionGroup(vector<ExecutionGroup *> *result, CompositorPriority priority) const
 {
 	unsigned int index;
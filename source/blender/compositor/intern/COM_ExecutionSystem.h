@@ -32,6 +32,8 @@ class ExecutionGroup;
 #include "COM_ExecutionGroup.h"
 #include "COM_NodeOperation.h"
 
+#include <set>
+
 /**
  * @page execution Execution model
  * In order to get to an efficient model for execution, several steps are being done. these steps are explained below.
@@ -105,6 +107,17 @@ class ExecutionGroup;
  * @see ExecutionSystem.addReadWriteBufferOperations
  * @see NodeOperation.isComplex
  * @see ExecutionGroup class representing the ExecutionGroup
+ *
+ * @section EM_Step6 Step 6: reusing results of the previous executions
+ * When the result cache of the node tree is enabled, every ExecutionGroup writing a MemoryBuffer is keyed by
+ * a hash of its operations, their settings and the keys of the groups it reads from. Groups found in the
+ * ResultCache are restored instead of calculated, the others are stored in it after execution.
+ * Groups depending on data outside of the node tree (images, render results) are calculated first
+ * and keyed by the content of their result.
+ *
+ * @see ExecutionSystem.restoreCachedResults
+ * @see NodeOperation.hashSettings
+ * @see ResultCache
  */
 
 /**
@@ -149,9 +162,10 @@ public:
 	 *
 	 * @param editingtree [bNodeTree *]
 	 * @param rendering [true false]
+	 * @param resolutionDivider calculate the tree at 1/resolutionDivider of its resolution
 	 */
 	ExecutionSystem(RenderData *rd, Scene *scene, bNodeTree *editingtree, bool rendering, bool fastcalculation,
-	                const ColorManagedViewSettings *viewSettings, const ColorManagedDisplaySettings *displaySettings,
+	                int resolutionDivider, const ColorManagedViewSettings *viewSettings, const ColorManagedDisplaySettings *displaySettings,
 	                const char *viewName);
 
 	/**
@@ -177,6 +191,38 @@ public:
 private:
 	void executeGroups(CompositorPriority priority);
 
+	/**
+	 * @brief restore the results of the groups needed by the outputs from the ResultCache
+	 */
+	void restoreCachedResults();
+	void restoreCachedResult(ExecutionGroup *group, std::set<ExecutionGroup *> &visited);
+
+	/**
+	 * @brief determine the key of the result of a group and of the groups it reads from
+	 * @note volatile groups are executed to key them by their result
+	 */
+	ResultCacheState determineResultKey(ExecutionGroup *group, std::set<ExecutionGroup *> &visited);
+
+	/**
+	 * @brief store the keyed results of this execution in the ResultCache
+	 */
+	void storeCachedResults();
+
+	/**
+	 * @brief print the memory used by the buffers of this execution, for debugging
+	 */
+	void reportMemoryUsage();
+
+	/**
+	 * @brief print the time spent calculating each ExecutionGroup, for debugging
+	 */
+	void reportExecutionTimes();
+
+	/**
+	 * @brief hash of the settings of the context all results depend on
+	 */
+	uint64_t m_contextKey;
+
 	/* allow the DebugInfo class to look at internals */
 	friend class DebugInfo;
 
@@ -27,7 +27,7 @@
 using std::min;
 using std::max;
 
-static unsigned int determine_num_channels(DataType datatype)
+unsigned int MemoryBuffer::determineNumChannels(DataType datatype)
 {
 	switch (datatype) {
 		case COM_DT_VALUE:
@@ -61,7 +61,7 @@ MemoryBuffer::MemoryBuffer(MemoryProxy *memoryProxy, unsigned int chunkNumber, r
 	this->m_height = BLI_rcti_size_y(&this->m_rect);
 	this->m_memoryProxy = memoryProxy;
 	this->m_chunkNumber = chunkNumber;
-	this->m_num_channels = determine_num_channels(memoryProxy->getDataType());
+	this->m_num_channels = determineNumChannels(memoryProxy->getDataType());
 	this->m_buffer = (float *)MEM_mallocN_aligned(sizeof(float) * determineBufferSize() * this->m_num_channels, 16, "COM_MemoryBuffer");
 	this->m_state = COM_MB_ALLOCATED;
 	this->m_datatype = memoryProxy->getDataType();
@@ -74,7 +74,7 @@ MemoryBuffer::MemoryBuffer(MemoryProxy *memoryProxy, rcti *rect)
 	this->m_height = BLI_rcti_size_y(&this->m_rect);
 	this->m_memoryProxy = memoryProxy;
 	this->m_chunkNumber = -1;
-	this->m_num_channels = determine_num_channels(memoryProxy->getDataType());
+	this->m_num_channels = determineNumChannels(memoryProxy->getDataType());
 	this->m_buffer = (float *)MEM_mallocN_aligned(sizeof(float) * determineBufferSize() * this->m_num_channels, 16, "COM_MemoryBuffer");
 	this->m_state = COM_MB_TEMPORARILY;
 	this->m_datatype = memoryProxy->getDataType();
@@ -87,7 +87,7 @@ MemoryBuffer::MemoryBuffer(DataType dataType, rcti *rect)
 	this->m_height = this->m_rect.ymax - this->m_rect.ymin;
 	this->m_memoryProxy = NULL;
 	this->m_chunkNumber = -1;
-	this->m_num_channels = determine_num_channels(dataType);
+	this->m_num_channels = determineNumChannels(dataType);
 	this->m_buffer = (float *)MEM_mallocN_aligned(sizeof(float) * determineBufferSize() * this->m_num_channels, 16, "COM_MemoryBuffer");
 	this->m_state = COM_MB_TEMPORARILY;
 	this->m_datatype = dataType;
@@ -172,6 +172,46 @@ void MemoryBuffer::copyContentFrom(MemoryBuffer *otherBuffer)
 	}
 }
 
+void MemoryBuffer::readRow(float *result, int x, int y, int num)
+{
+	const int xmin = max(x, this->m_rect.xmin);
+	const int xmax = min(x + num, this->m_rect.xmax);
+
+	if (y < this->m_rect.ymin || y >= this->m_rect.ymax || xmin >= xmax) {
+		/* clip result outside rect is zero */
+		memset(result, 0, sizeof(float) * 4 * num);
+		return;
+	}
+
+	if (xmin > x) {
+		memset(result, 0, sizeof(float) * 4 * (xmin - x));
+	}
+	if (xmax < x + num) {
+		memset(&result[(xmax - x) * 4], 0, sizeof(float) * 4 * (x + num - xmax));
+	}
+
+	const int offset = (this->m_width * (y - this->m_rect.ymin) + xmin - this->m_rect.xmin) * this->m_num_channels;
+	const float *src = &this->m_buffer[offset];
+	float *dst = &result[(xmin - x) * 4];
+	const int len = xmax - xmin;
+
+	switch (this->m_num_channels) {
+		case COM_NUM_CHANNELS_COLOR:
+			memcpy(dst, src, sizeof(float) * 4 * len);
+			break;
+		case COM_NUM_CHANNELS_VALUE:
+			for (int i = 0; i < len; i++) {
+				dst[i * 4] = src[i];
+			}
+			break;
+		default:
+			for (int i = 0; i < len; i++, dst += 4, src += this->m_num_channels) {
+				memcpy(dst, src, sizeof(float) * this->m_num_channels);
+			}
+			break;
+	}
+}
+
 void MemoryBuffer::writePixel(int x, int y, const float color[4])
 {
 	if (x >= this->m_rect.xmin && x < this->m_rect.xmax &&
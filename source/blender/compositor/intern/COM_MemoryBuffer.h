@@ -129,6 +129,11 @@ public:
 
 	unsigned int get_num_channels() { return this->m_num_channels; }
 
+	/**
+	 * @brief number of channels of the MemoryBuffers of \a datatype
+	 */
+	static unsigned int determineNumChannels(DataType datatype);
+
 	/**
 	 * @brief get the data of this MemoryBuffer
 	 * @note buffer should already be available in memory
@@ -250,6 +255,12 @@ public:
 		memcpy(result, buffer, sizeof(float) * this->m_num_channels);
 	}
 	
+	/**
+	 * @brief read \a num pixels of row \a y starting at \a x, 4 floats per pixel
+	 * like SocketReader.readRow, pixels outside the rect are zero.
+	 */
+	void readRow(float *result, int x, int y, int num);
+
 	void writePixel(int x, int y, const float color[4]);
 	void addPixel(int x, int y, const float color[4]);
 	inline void readBilinear(float *result, float x, float y,
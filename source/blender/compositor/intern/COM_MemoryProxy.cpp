@@ -21,13 +21,22 @@
  */
 
 #include "COM_MemoryProxy.h"
+#include "COM_WriteBufferOperation.h"
 
+#include "atomic_ops.h"
+
+static size_t s_allocated = 0;
+static size_t s_peak = 0;
 
 MemoryProxy::MemoryProxy(DataType datatype)
 {
 	this->m_writeBufferOperation = NULL;
 	this->m_executor = NULL;
 	this->m_datatype = datatype;
+	this->m_buffer = NULL;
+	this->m_numReaders = 0;
+	this->m_size = 0;
+	this->m_released = false;
 }
 
 void MemoryProxy::allocate(unsigned int width, unsigned int height)
@@ -39,6 +48,31 @@ void MemoryProxy::allocate(unsigned int width, unsigned int height)
 	result.ymax = height;
 
 	this->m_buffer = new MemoryBuffer(this, 1, &result);
+	this->m_size = sizeof(float) * width * height * this->m_buffer->get_num_channels();
+	this->m_released = false;
+
+	size_t allocated = atomic_add_z(&s_allocated, this->m_size);
+	size_t peak = s_peak;
+	while (allocated > peak) {
+		size_t old_peak = atomic_cas_z(&s_peak, peak, allocated);
+		if (old_peak == peak) {
+			break;
+		}
+		peak = old_peak;
+	}
+}
+
+void MemoryProxy::allocateWhenNeeded()
+{
+	if (this->m_buffer == NULL && !this->m_released) {
+		allocate(this->m_writeBufferOperation->getWidth(), this->m_writeBufferOperation->getHeight());
+	}
+}
+
+size_t MemoryProxy::determineSize()
+{
+	return sizeof(float) * this->m_writeBufferOperation->getWidth() * this->m_writeBufferOperation->getHeight() *
+	       MemoryBuffer::determineNumChannels(this->m_datatype);
 }
 
 void MemoryProxy::free()
@@ -46,6 +80,33 @@ void MemoryProxy::free()
 	if (this->m_buffer) {
 		delete this->m_buffer;
 		this->m_buffer = NULL;
+		atomic_sub_z(&s_allocated, this->m_size);
 	}
 }
 
+void MemoryProxy::releaseReader()
+{
+	if (atomic_sub_u(&this->m_numReaders, 1) == 0) {
+		/* results kept in the ResultCache are stored after the execution */
+		if (this->m_executor->getResultCacheState() != COM_RC_KEYED) {
+			this->m_released = true;
+			free();
+		}
+	}
+}
+
+size_t MemoryProxy::getAllocatedSize()
+{
+	return s_allocated;
+}
+
+size_t MemoryProxy::getPeakSize()
+{
+	return s_peak;
+}
+
+void MemoryProxy::resetPeakSize()
+{
+	s_peak = s_allocated;
+}
+
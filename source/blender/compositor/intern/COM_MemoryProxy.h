@@ -68,6 +68,21 @@ private:
 	 */
 	DataType m_datatype;
 
+	/**
+	 * @brief number of ExecutionGroups reading this MemoryProxy that are not finished yet
+	 */
+	unsigned int m_numReaders;
+
+	/**
+	 * @brief size of the allocated memory in bytes, kept after it is freed for reporting
+	 */
+	size_t m_size;
+
+	/**
+	 * @brief the memory was freed when the last reader finished
+	 */
+	bool m_released;
+
 public:
 	MemoryProxy(DataType type);
 	
@@ -99,16 +114,53 @@ public:
 	 */
 	void allocate(unsigned int width, unsigned int height);
 
+	/**
+	 * @brief allocate memory of the resolution of the WriteBufferOperation, unless it is already allocated or freed
+	 * @note called when the first chunk writing or reading this MemoryProxy is scheduled,
+	 * so the buffers of groups that aren't calculated yet don't use memory
+	 */
+	void allocateWhenNeeded();
+
+	/**
+	 * @brief size of the memory of the resolution of the WriteBufferOperation in bytes
+	 */
+	size_t determineSize();
+
 	/**
 	 * @brief free the allocated memory
 	 */
 	void free();
 
+	/**
+	 * @brief register an ExecutionGroup reading this MemoryProxy
+	 */
+	void addReader() { this->m_numReaders++; }
+
+	/**
+	 * @brief an ExecutionGroup reading this MemoryProxy finished, the memory is freed after the last one.
+	 * @note called from the worker threads
+	 */
+	void releaseReader();
+
 	/**
 	 * @brief get the allocated memory
 	 */
 	inline MemoryBuffer *getBuffer() { return this->m_buffer; }
 
+	size_t getSize() const { return this->m_size; }
+	bool isReleased() const { return this->m_released; }
+
+	/**
+	 * @brief memory allocated by all MemoryProxies in bytes
+	 */
+	static size_t getAllocatedSize();
+
+	/**
+	 * @brief maximum of getAllocatedSize since the last resetPeakSize
+	 */
+	static size_t getPeakSize();
+	static void resetPeakSize();
+
 	inline DataType getDataType() { return this->m_datatype; }
 
 #ifdef WITH_CXX_GUARDEDALLOC
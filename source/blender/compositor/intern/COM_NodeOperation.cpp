@@ -25,6 +25,9 @@
 
 #include "COM_defines.h"
 #include "COM_ExecutionSystem.h"
+#include "COM_ResultCache.h"
+
+#include "MEM_guardedalloc.h"
 
 #include "COM_NodeOperation.h" /* own include */
 
@@ -41,6 +44,7 @@ NodeOperation::NodeOperation()
 	this->m_isResolutionSet = false;
 	this->m_openCL = false;
 	this->m_btree = NULL;
+	this->m_bnode = NULL;
 }
 
 NodeOperation::~NodeOperation()
@@ -67,6 +71,41 @@ NodeOperationInput *NodeOperation::getInputSocket(unsigned int index) const
 	return m_inputs[index];
 }
 
+bool NodeOperation::hashSettings(ResultCacheHash &hash) const
+{
+	if (this->m_bnode == NULL) {
+		/* added by the builder, the result only depends on the inputs */
+		return true;
+	}
+	if (this->m_bnode->id) {
+		/* reads an image, render result, movie clip... */
+		return false;
+	}
+	hashNodeSettings(hash, true);
+	return true;
+}
+
+void NodeOperation::hashNodeSettings(ResultCacheHash &hash, bool storage) const
+{
+	const bNode *node = this->m_bnode;
+
+	hash.addInt(node->type);
+	hash.addInt(node->custom1);
+	hash.addInt(node->custom2);
+	hash.addFloat(node->custom3);
+	hash.addFloat(node->custom4);
+	if (storage && node->storage) {
+		hash.add(node->storage, MEM_allocN_len(node->storage));
+	}
+
+	/* some nodes copy unlinked input values to their operations */
+	for (const bNodeSocket *sock = (const bNodeSocket *)node->inputs.first; sock; sock = sock->next) {
+		if (sock->default_value) {
+			hash.add(sock->default_value, MEM_allocN_len(sock->default_value));
+		}
+	}
+}
+
 void NodeOperation::addInputSocket(DataType datatype, InputResizeMode resize_mode)
 {
 	NodeOperationInput *socket = new NodeOperationInput(this, datatype, resize_mode);
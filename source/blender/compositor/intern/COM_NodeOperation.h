@@ -46,6 +46,7 @@ using std::max;
 
 class OpenCLDevice;
 class ReadBufferOperation;
+class ResultCacheHash;
 class WriteBufferOperation;
 
 class NodeOperationInput;
@@ -121,6 +122,11 @@ private:
 	 */
 	const bNodeTree *m_btree;
 
+	/**
+	 * @brief the node this operation was converted from, NULL for operations added by the NodeOperationBuilder
+	 */
+	const bNode *m_bnode;
+
 	/**
 	 * @brief set to truth when resolution for this operation is set
 	 */
@@ -166,6 +172,18 @@ public:
 	virtual int isSingleThreaded() { return false; }
 
 	void setbNodeTree(const bNodeTree *tree) { this->m_btree = tree; }
+	void setbNode(const bNode *node) { this->m_bnode = node; }
+	const bNode *getbNode() const { return this->m_bnode; }
+
+	/**
+	 * @brief add the settings the result of this operation depends on to a hash
+	 * @note The default adds the settings of the node the operation was converted from,
+	 * operations with settings of their own or depending on other data override this.
+	 * @see ResultCache
+	 * @return false when the result depends on data outside of the node tree (images, render results...)
+	 * and can't be described by its settings.
+	 */
+	virtual bool hashSettings(ResultCacheHash &hash) const;
 	virtual void initExecution();
 	
 	/**
@@ -315,6 +333,12 @@ protected:
 	SocketReader *getInputSocketReader(unsigned int inputSocketindex);
 	NodeOperation *getInputOperation(unsigned int inputSocketindex);
 
+	/**
+	 * @brief add the settings of the node this operation was converted from to a hash
+	 * @param storage add the node storage, operations with pointers in the storage hash it themselves.
+	 */
+	void hashNodeSettings(ResultCacheHash &hash, bool storage) const;
+
 	void deinitMutex();
 	void initMutex();
 	void lockMutex();
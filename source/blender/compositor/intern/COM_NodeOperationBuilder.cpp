@@ -37,6 +37,7 @@ extern "C" {
 #include "COM_SetColorOperation.h"
 #include "COM_SocketProxyOperation.h"
 #include "COM_ReadBufferOperation.h"
+#include "COM_ScaleOperation.h"
 #include "COM_WriteBufferOperation.h"
 #include "COM_ViewerOperation.h"
 
@@ -107,6 +108,9 @@ void NodeOperationBuilder::convertToOperations(ExecutionSystem *system)
 	
 	add_datatype_conversions();
 	
+	if (m_context->getResolutionDivider() > 1)
+		add_resolution_scales();
+	
 	determineResolutions();
 	
 	/* surround complex ops with read/write buffer */
@@ -130,6 +134,8 @@ void NodeOperationBuilder::convertToOperations(ExecutionSystem *system)
 
 void NodeOperationBuilder::addOperation(NodeOperation *operation)
 {
+	if (m_current_node)
+		operation->setbNode(m_current_node->getbNode());
 	m_operations.push_back(operation);
 }
 
@@ -390,6 +396,85 @@ void NodeOperationBuilder::resolve_proxies()
 	}
 }
 
+/* operations producing images from their settings only, like images or render layers */
+static bool is_resolution_source(NodeOperation *op)
+{
+	if (op->isSetOperation())
+		return false;
+	
+	for (unsigned int index = 0; index < op->getNumberOfInputSockets(); index++) {
+		NodeOperationInput *input = op->getInputSocket(index);
+		if (input->isConnected() && !input->getLink()->getOperation().isSetOperation())
+			return false;
+	}
+	return true;
+}
+
+void NodeOperationBuilder::add_resolution_scales()
+{
+	const int divider = m_context->getResolutionDivider();
+	
+	/* cached first to avoid modifying m_operations while iterating over it */
+	Operations sources, outputs;
+	for (Operations::const_iterator it = m_operations.begin(); it != m_operations.end(); ++it) {
+		NodeOperation *op = *it;
+		
+		/* previews determine their own size from the input */
+		if (op->isOutputOperation(m_context->isRendering())) {
+			if (!op->isPreviewOperation())
+				outputs.push_back(op);
+		}
+		else if (is_resolution_source(op)) {
+			sources.push_back(op);
+		}
+	}
+	
+	/* the tree is calculated at the resolution of the scaled down sources ... */
+	for (Operations::const_iterator it = sources.begin(); it != sources.end(); ++it) {
+		NodeOperation *op = *it;
+		
+		for (unsigned int index = 0; index < op->getNumberOfOutputSockets(); index++) {
+			NodeOperationOutput *output = op->getOutputSocket(index);
+			OpInputs targets = cache_output_links(output);
+			if (targets.empty())
+				continue;
+			
+			ScaleResolutionOperation *scale = new ScaleResolutionOperation(output->getDataType());
+			scale->setFactor(1.0f / divider);
+			scale->setbNode(op->getbNode());
+			addOperation(scale);
+			
+			addLink(output, scale->getInputSocket(0));
+			for (OpInputs::const_iterator it_target = targets.begin(); it_target != targets.end(); ++it_target) {
+				NodeOperationInput *target = *it_target;
+				removeInputLink(target);
+				addLink(scale->getOutputSocket(), target);
+			}
+		}
+	}
+	
+	/* ... and scaled up again for display */
+	for (Operations::const_iterator it = outputs.begin(); it != outputs.end(); ++it) {
+		NodeOperation *op = *it;
+		
+		for (unsigned int index = 0; index < op->getNumberOfInputSockets(); index++) {
+			NodeOperationInput *input = op->getInputSocket(index);
+			if (!input->isConnected() || input->getLink()->getOperation().isSetOperation())
+				continue;
+			
+			NodeOperationOutput *from = input->getLink();
+			ScaleResolutionOperation *scale = new ScaleResolutionOperation(from->getDataType());
+			scale->setFactor(divider);
+			scale->setbNode(op->getbNode());
+			addOperation(scale);
+			
+			removeInputLink(input);
+			addLink(from, scale->getInputSocket(0));
+			addLink(scale->getOutputSocket(), input);
+		}
+	}
+}
+
 void NodeOperationBuilder::determineResolutions()
 {
 	/* determine all resolutions of the operations (Width/Height) */
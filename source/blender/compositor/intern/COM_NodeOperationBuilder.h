@@ -137,6 +137,9 @@ protected:
 	/** Replace proxy operations with direct links */
 	void resolve_proxies();
 	
+	/** Scale the inputs of the tree down and its outputs up, to calculate at a fraction of the resolution */
+	void add_resolution_scales();
+	
 	/** Calculate resolution for each operation */
 	void determineResolutions();
 	
@@ -23,6 +23,8 @@
 #include "COM_OpenCLDevice.h"
 #include "COM_WorkScheduler.h"
 
+#include "PIL_time.h"
+
 typedef enum COM_VendorID  {NVIDIA = 0x10DE, AMD = 0x1002} COM_VendorID;
 const cl_image_format IMAGE_FORMAT_COLOR = {
 	CL_RGBA,
@@ -67,6 +69,7 @@ void OpenCLDevice::execute(WorkPackage *work)
 	rcti rect;
 
 	executionGroup->determineChunkRect(&rect, chunkNumber);
+	const double start = PIL_check_seconds_timer();
 	MemoryBuffer **inputBuffers = executionGroup->getInputBuffersOpenCL(chunkNumber);
 	MemoryBuffer *outputBuffer = executionGroup->allocateOutputBuffer(chunkNumber, &rect);
 
@@ -74,6 +77,7 @@ void OpenCLDevice::execute(WorkPackage *work)
 	                                                              chunkNumber, inputBuffers, outputBuffer);
 
 	delete outputBuffer;
+	executionGroup->addChunkTime(PIL_check_seconds_timer() - start);
 	
 	executionGroup->finalizeChunkExecution(chunkNumber, inputBuffers);
 }
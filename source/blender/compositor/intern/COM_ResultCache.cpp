@@ -0,0 +1,175 @@
+/*
+ * Copyright 2016, Blender Foundation.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ */
+
+#include <list>
+#include <map>
+#include <string.h>
+
+#include "COM_ResultCache.h"
+#include "COM_MemoryBuffer.h"
+
+#include "MEM_guardedalloc.h"
+
+/* ******** Hash ******** */
+
+ResultCacheHash::ResultCacheHash()
+{
+	BLI_hash_mm2a_init(&m_low, 0);
+	BLI_hash_mm2a_init(&m_high, 0x9e3779b9);
+}
+
+void ResultCacheHash::add(const void *data, size_t len)
+{
+	BLI_hash_mm2a_add(&m_low, (const unsigned char *)data, len);
+	BLI_hash_mm2a_add(&m_high, (const unsigned char *)data, len);
+}
+
+void ResultCacheHash::addInt(int value)
+{
+	BLI_hash_mm2a_add_int(&m_low, value);
+	BLI_hash_mm2a_add_int(&m_high, value);
+}
+
+void ResultCacheHash::addFloat(float value)
+{
+	add(&value, sizeof(value));
+}
+
+void ResultCacheHash::addKey(uint64_t key)
+{
+	add(&key, sizeof(key));
+}
+
+void ResultCacheHash::addString(const char *str)
+{
+	/* include the terminator so consecutive strings can't run into each other */
+	add(str, strlen(str) + 1);
+}
+
+uint64_t ResultCacheHash::end()
+{
+	return ((uint64_t)BLI_hash_mm2a_end(&m_high) << 32) | BLI_hash_mm2a_end(&m_low);
+}
+
+/* ******** Cache ******** */
+
+typedef struct ResultCacheEntry {
+	float *buffer;
+	int width;
+	int height;
+	int num_channels;
+	size_t size;
+	std::list<uint64_t>::iterator lru;
+} ResultCacheEntry;
+
+typedef std::map<uint64_t, ResultCacheEntry> ResultCacheEntries;
+
+static ResultCacheEntries s_entries;
+/* most recently used key first */
+static std::list<uint64_t> s_lru;
+static size_t s_size = 0;
+static size_t s_limit = 0;
+
+static void result_cache_free_entry(ResultCacheEntries::iterator it)
+{
+	s_size -= it->second.size;
+	s_lru.erase(it->second.lru);
+	MEM_freeN(it->second.buffer);
+	s_entries.erase(it);
+}
+
+static void result_cache_evict(size_t limit)
+{
+	while (s_size > limit && !s_lru.empty()) {
+		result_cache_free_entry(s_entries.find(s_lru.back()));
+	}
+}
+
+void ResultCache::setLimit(size_t limit)
+{
+	s_limit = limit;
+	result_cache_evict(limit);
+}
+
+size_t ResultCache::getLimit()
+{
+	return s_limit;
+}
+
+void ResultCache::reserve(size_t size)
+{
+	result_cache_evict(size < s_limit ? s_limit - size : 0);
+}
+
+size_t ResultCache::getSize()
+{
+	return s_size;
+}
+
+bool ResultCache::restore(uint64_t key, MemoryBuffer *buffer)
+{
+	ResultCacheEntries::iterator it = s_entries.find(key);
+	if (it == s_entries.end()) {
+		return false;
+	}
+
+	ResultCacheEntry &entry = it->second;
+	if (entry.width != buffer->getWidth() || entry.height != buffer->getHeight() ||
+	    entry.num_channels != (int)buffer->get_num_channels())
+	{
+		return false;
+	}
+
+	memcpy(buffer->getBuffer(), entry.buffer, entry.size);
+	buffer->setCreatedState();
+
+	s_lru.splice(s_lru.begin(), s_lru, entry.lru);
+	return true;
+}
+
+void ResultCache::store(uint64_t key, MemoryBuffer *buffer)
+{
+	const size_t size = sizeof(float) * buffer->getWidth() * buffer->getHeight() * buffer->get_num_channels();
+	if (size > s_limit) {
+		return;
+	}
+
+	ResultCacheEntries::iterator it = s_entries.find(key);
+	if (it != s_entries.end()) {
+		result_cache_free_entry(it);
+	}
+	result_cache_evict(s_limit - size);
+
+	ResultCacheEntry entry;
+	entry.buffer = (float *)MEM_mallocN(size, "COM ResultCache buffer");
+	memcpy(entry.buffer, buffer->getBuffer(), size);
+	entry.width = buffer->getWidth();
+	entry.height = buffer->getHeight();
+	entry.num_channels = buffer->get_num_channels();
+	entry.size = size;
+	s_lru.push_front(key);
+	entry.lru = s_lru.begin();
+
+	s_entries[key] = entry;
+	s_size += size;
+}
+
+void ResultCache::clear()
+{
+	result_cache_evict(0);
+}
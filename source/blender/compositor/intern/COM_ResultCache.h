@@ -0,0 +1,95 @@
+/*
+ * Copyright 2016, Blender Foundation.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ */
+
+#ifndef _COM_ResultCache_h_
+#define _COM_ResultCache_h_
+
+#include <stddef.h>
+
+extern "C" {
+#include "BLI_hash_mm2a.h"
+}
+
+class MemoryBuffer;
+
+/**
+ * @brief 64 bit hash of the settings an ExecutionGroup result depends on
+ * @ingroup Memory
+ */
+class ResultCacheHash {
+private:
+	BLI_HashMurmur2A m_low;
+	BLI_HashMurmur2A m_high;
+
+public:
+	ResultCacheHash();
+
+	void add(const void *data, size_t len);
+	void addInt(int value);
+	void addFloat(float value);
+	void addKey(uint64_t key);
+	void addString(const char *str);
+
+	uint64_t end();
+};
+
+/**
+ * @brief Results of ExecutionGroups kept between executions of the compositor.
+ *
+ * Results are keyed by a hash of the operations of the group, their settings and the keys of
+ * the groups they read from, so a group is only calculated again when something upstream changed.
+ * The least recently used results are freed when the cache grows over its limit.
+ * @note only used from COM_execute, which is locked by the compositor mutex.
+ * @ingroup Memory
+ */
+class ResultCache {
+public:
+	/**
+	 * @brief set the maximum memory used by the cached results in bytes, 0 disables the cache
+	 */
+	static void setLimit(size_t limit);
+	static size_t getLimit();
+
+	/**
+	 * @brief free cached results so \a size bytes of other memory fit in the limit
+	 */
+	static void reserve(size_t size);
+
+	/**
+	 * @brief memory used by the cached results in bytes
+	 */
+	static size_t getSize();
+
+	/**
+	 * @brief copy the result cached for \a key into \a buffer
+	 * @return false when there is no result of the size of \a buffer for \a key
+	 */
+	static bool restore(uint64_t key, MemoryBuffer *buffer);
+
+	/**
+	 * @brief store a copy of \a buffer as result for \a key
+	 */
+	static void store(uint64_t key, MemoryBuffer *buffer);
+
+	/**
+	 * @brief free all cached results
+	 */
+	static void clear();
+};
+
+#endif
@@ -95,6 +95,21 @@ protected:
 	                                  float /*x*/, float /*y*/,
 	                                  float /*dx*/[2], float /*dy*/[2]) {}
 
+	/**
+	 * @brief calculate a run of pixels of a single row
+	 * @note this method is called for non-complex, operations that don't
+	 * implement it calculate the pixels one by one with executePixelSampled.
+	 * @param output is a float array of num * 4 floats, pixel i is stored at output[i * 4]
+	 * @param x the x-coordinate of the first pixel to calculate in image space
+	 * @param y the y-coordinate of the row to calculate in image space
+	 * @param num number of pixels to calculate, at most COM_ROW_LENGTH
+	 */
+	virtual void executeRow(float *output, int x, int y, int num) {
+		for (int i = 0; i < num; i++) {
+			executePixelSampled(&output[i * 4], x + i, y, COM_PS_NEAREST);
+		}
+	}
+
 public:
 	inline void readSampled(float result[4], float x, float y, PixelSampler sampler) {
 		executePixelSampled(result, x, y, sampler);
@@ -105,6 +120,9 @@ public:
 	inline void readFiltered(float result[4], float x, float y, float dx[2], float dy[2]) {
 		executePixelFiltered(result, x, y, dx, dy);
 	}
+	inline void readRow(float *result, int x, int y, int num) {
+		executeRow(result, x, y, num);
+	}
 
 	virtual void *initializeTileData(rcti * /*rect*/) { return 0; }
 	virtual void deinitializeTileData(rcti * /*rect*/, void * /*data*/) {}
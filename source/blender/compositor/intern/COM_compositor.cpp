@@ -23,6 +23,7 @@
 
 extern "C" {
 #include "BKE_node.h"
+#include "BLI_math_base.h"
 #include "BLI_threads.h"
 }
 
@@ -32,6 +33,7 @@ extern "C" {
 
 #include "COM_compositor.h"
 #include "COM_ExecutionSystem.h"
+#include "COM_ResultCache.h"
 #include "COM_WorkScheduler.h"
 #include "clew.h"
 #include "COM_MovieDistortionOperation.h"
@@ -76,10 +78,22 @@ void COM_execute(RenderData *rd, Scene *scene, bNodeTree *editingtree, int rende
 	editingtree->progress(editingtree->prh, 0.0);
 	editingtree->stats_draw(editingtree->sdh, IFACE_("Compositing"));
 
+	/* results of unchanged execution groups are reused between executions */
+	if (editingtree->flag & NTREE_COM_RESULT_CACHE) {
+		ResultCache::setLimit((size_t)editingtree->cache_size * 1024 * 1024);
+	}
+	else {
+		ResultCache::setLimit(0);
+	}
+
+	/* while editing, a first pass calculates the tree at a fraction of its resolution,
+	 * or only the fast nodes, so the viewer updates quickly before the full result */
+	int divider = rendering ? 1 : max_ii(1, editingtree->progressive_divider);
 	bool twopass = (editingtree->flag & NTREE_TWO_PASS) > 0 && !rendering;
 	/* initialize execution system */
-	if (twopass) {
-		ExecutionSystem *system = new ExecutionSystem(rd, scene, editingtree, rendering, twopass, viewSettings, displaySettings, viewName);
+	if (divider > 1 || twopass) {
+		ExecutionSystem *system = new ExecutionSystem(rd, scene, editingtree, rendering, divider == 1, divider,
+		                                              viewSettings, displaySettings, viewName);
 		system->execute();
 		delete system;
 		
@@ -91,7 +105,7 @@ void COM_execute(RenderData *rd, Scene *scene, bNodeTree *editingtree, int rende
 		}
 	}
 
-	ExecutionSystem *system = new ExecutionSystem(rd, scene, editingtree, rendering, false,
+	ExecutionSystem *system = new ExecutionSystem(rd, scene, editingtree, rendering, false, 1,
 	                                              viewSettings, displaySettings, viewName);
 	system->execute();
 	delete system;
@@ -104,6 +118,7 @@ void COM_deinitialize()
 	if (is_compositorMutex_init) {
 		BLI_mutex_lock(&s_compositorMutex);
 		WorkScheduler::deinitialize();
+		ResultCache::clear();
 		is_compositorMutex_init = false;
 		BLI_mutex_unlock(&s_compositorMutex);
 		BLI_mutex_end(&s_compositorMutex);
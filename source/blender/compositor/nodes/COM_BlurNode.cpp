@@ -41,7 +41,8 @@ BlurNode::BlurNode(bNode *editorNode) : Node(editorNode)
 void BlurNode::convertToOperations(NodeConverter &converter, const CompositorContext &context) const
 {
 	bNode *editorNode = this->getbNode();
-	NodeBlurData *data = (NodeBlurData *)editorNode->storage;
+	NodeBlurData blur_data = *(NodeBlurData *)editorNode->storage;
+	NodeBlurData *data = &blur_data;
 	NodeInput *inputSizeSocket = this->getInputSocket(1);
 	bool connectedSizeSocket = inputSizeSocket->isLinked();
 
@@ -51,6 +52,12 @@ void BlurNode::convertToOperations(NodeConverter &converter, const CompositorCon
 	CompositorQuality quality = context.getQuality();
 	NodeOperation *input_operation = NULL, *output_operation = NULL;
 
+	/* blur sizes are in pixels of the full resolution, relative sizes follow the image */
+	if (!data->relative) {
+		data->sizex = context.scalePixelDistance(data->sizex);
+		data->sizey = context.scalePixelDistance(data->sizey);
+	}
+
 	if (data->filtertype == R_FILTER_FAST_GAUSS) {
 		FastGaussianBlurOperation *operationfgb = new FastGaussianBlurOperation();
 		operationfgb->setData(data);
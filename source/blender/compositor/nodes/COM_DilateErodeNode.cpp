@@ -47,9 +47,10 @@ void DilateErodeNode::convertToOperations(NodeConverter &converter, const Compos
 {
 	
 	bNode *editorNode = this->getbNode();
+	const int distance = context.scalePixelDistance(editorNode->custom2);
 	if (editorNode->custom1 == CMP_NODE_DILATEERODE_DISTANCE_THRESH) {
 		DilateErodeThresholdOperation *operation = new DilateErodeThresholdOperation();
-		operation->setDistance(editorNode->custom2);
+		operation->setDistance(distance);
 		operation->setInset(editorNode->custom3);
 		converter.addOperation(operation);
 		
@@ -69,7 +70,7 @@ void DilateErodeNode::convertToOperations(NodeConverter &converter, const Compos
 	else if (editorNode->custom1 == CMP_NODE_DILATEERODE_DISTANCE) {
 		if (editorNode->custom2 > 0) {
 			DilateDistanceOperation *operation = new DilateDistanceOperation();
-			operation->setDistance(editorNode->custom2);
+			operation->setDistance(distance);
 			converter.addOperation(operation);
 			
 			converter.mapInputSocket(getInputSocket(0), operation->getInputSocket(0));
@@ -77,7 +78,7 @@ void DilateErodeNode::convertToOperations(NodeConverter &converter, const Compos
 		}
 		else {
 			ErodeDistanceOperation *operation = new ErodeDistanceOperation();
-			operation->setDistance(-editorNode->custom2);
+			operation->setDistance(-distance);
 			converter.addOperation(operation);
 			
 			converter.mapInputSocket(getInputSocket(0), operation->getInputSocket(0));
@@ -87,9 +88,11 @@ void DilateErodeNode::convertToOperations(NodeConverter &converter, const Compos
 	else if (editorNode->custom1 == CMP_NODE_DILATEERODE_DISTANCE_FEATHER) {
 		/* this uses a modified gaussian blur function otherwise its far too slow */
 		CompositorQuality quality = context.getQuality();
+		NodeBlurData alpha_blur = m_alpha_blur;
+		alpha_blur.sizex = alpha_blur.sizey = abs(distance);
 
 		GaussianAlphaXBlurOperation *operationx = new GaussianAlphaXBlurOperation();
-		operationx->setData(&m_alpha_blur);
+		operationx->setData(&alpha_blur);
 		operationx->setQuality(quality);
 		operationx->setFalloff(PROP_SMOOTH);
 		converter.addOperation(operationx);
@@ -98,7 +101,7 @@ void DilateErodeNode::convertToOperations(NodeConverter &converter, const Compos
 		// converter.mapInputSocket(getInputSocket(1), operationx->getInputSocket(1)); // no size input yet
 		
 		GaussianAlphaYBlurOperation *operationy = new GaussianAlphaYBlurOperation();
-		operationy->setData(&m_alpha_blur);
+		operationy->setData(&alpha_blur);
 		operationy->setQuality(quality);
 		operationy->setFalloff(PROP_SMOOTH);
 		converter.addOperation(operationy);
@@ -132,7 +135,7 @@ void DilateErodeNode::convertToOperations(NodeConverter &converter, const Compos
 	else {
 		if (editorNode->custom2 > 0) {
 			DilateStepOperation *operation = new DilateStepOperation();
-			operation->setIterations(editorNode->custom2);
+			operation->setIterations(distance);
 			converter.addOperation(operation);
 			
 			converter.mapInputSocket(getInputSocket(0), operation->getInputSocket(0));
@@ -140,7 +143,7 @@ void DilateErodeNode::convertToOperations(NodeConverter &converter, const Compos
 		}
 		else {
 			ErodeStepOperation *operation = new ErodeStepOperation();
-			operation->setIterations(-editorNode->custom2);
+			operation->setIterations(-distance);
 			converter.addOperation(operation);
 			
 			converter.mapInputSocket(getInputSocket(0), operation->getInputSocket(0));
@@ -22,8 +22,11 @@
 
 #include "COM_CalculateMeanOperation.h"
 #include "BLI_math.h"
+#include "BLI_task.h"
 #include "BLI_utildefines.h"
 
+#include "MEM_guardedalloc.h"
+
 extern "C" {
 #include "IMB_colormanagement.h"
 }
@@ -86,47 +89,104 @@ void *CalculateMeanOperation::initializeTileData(rcti *rect)
 	return NULL;
 }
 
-void CalculateMeanOperation::calculateMean(MemoryBuffer *tile)
+/* rows summed by one task */
+#define CALCULATE_MEAN_ROWS_PER_TASK 32
+
+typedef struct CalculateMeanData {
+	const float *buffer;
+	int width, height;
+	int setting;
+	bool deviation;
+	float mean;
+	/* one per task */
+	float *sums;
+	int *pixels;
+} CalculateMeanData;
+
+static float calculate_mean_value(int setting, const float *pixel)
 {
-	this->m_result = 0.0f;
-	float *buffer = tile->getBuffer();
-	int size = tile->getWidth() * tile->getHeight();
+	switch (setting) {
+		case 1:  /* rgb combined */
+			return IMB_colormanagement_get_luminance(pixel);
+		case 2:  /* red */
+			return pixel[0];
+		case 3:  /* green */
+			return pixel[1];
+		case 4:  /* blue */
+			return pixel[2];
+		case 5:  /* luminance */
+		{
+			float yuv[3];
+			rgb_to_yuv(pixel[0], pixel[1], pixel[2], &yuv[0], &yuv[1], &yuv[2]);
+			return yuv[0];
+		}
+	}
+	return 0.0f;
+}
+
+static void calculate_mean_task(void *userdata, const int task)
+{
+	CalculateMeanData *data = (CalculateMeanData *)userdata;
+	const int ystart = task * CALCULATE_MEAN_ROWS_PER_TASK;
+	const int yend = min(ystart + CALCULATE_MEAN_ROWS_PER_TASK, data->height);
+	const float *buffer = data->buffer + (size_t)ystart * data->width * 4;
+	const int size = (yend - ystart) * data->width;
 	int pixels = 0;
 	float sum = 0.0f;
+
 	for (int i = 0, offset = 0; i < size; i++, offset += 4) {
 		if (buffer[offset + 3] > 0) {
+			const float value = calculate_mean_value(data->setting, &buffer[offset]);
 			pixels++;
-	
-			switch (this->m_setting) {
-				case 1:
-				{
-					sum += IMB_colormanagement_get_luminance(&buffer[offset]);
-					break;
-				}
-				case 2:
-				{
-					sum += buffer[offset];
-					break;
-				}
-				case 3:
-				{
-					sum += buffer[offset + 1];
-					break;
-				}
-				case 4:
-				{
-					sum += buffer[offset + 2];
-					break;
-				}
-				case 5:
-				{
-					float yuv[3];
-					rgb_to_yuv(buffer[offset], buffer[offset + 1], buffer[offset + 2], &yuv[0], &yuv[1], &yuv[2]);
-					sum += yuv[0];
-					break;
+
+			if (data->deviation) {
+				/* XXX the single channel settings always added the value itself as well */
+				if (data->setting >= 2 && data->setting <= 4) {
+					sum += value;
 				}
+				sum += (value - data->mean) * (value - data->mean);
+			}
+			else {
+				sum += value;
 			}
 		}
 	}
+
+	data->sums[task] = sum;
+	data->pixels[task] = pixels;
+}
+
+void CalculateMeanOperation::calculateSum(MemoryBuffer *tile, bool deviation, float mean, float *r_sum, int *r_pixels)
+{
+	CalculateMeanData data;
+	const int num_tasks = (tile->getHeight() + CALCULATE_MEAN_ROWS_PER_TASK - 1) / CALCULATE_MEAN_ROWS_PER_TASK;
+
+	data.buffer = tile->getBuffer();
+	data.width = tile->getWidth();
+	data.height = tile->getHeight();
+	data.setting = this->m_setting;
+	data.deviation = deviation;
+	data.mean = mean;
+	data.sums = (float *)MEM_mallocN(sizeof(float) * max(num_tasks, 1), __func__);
+	data.pixels = (int *)MEM_mallocN(sizeof(int) * max(num_tasks, 1), __func__);
+
+	BLI_task_parallel_range(0, num_tasks, &data, calculate_mean_task, num_tasks > 1);
+
+	*r_sum = 0.0f;
+	*r_pixels = 0;
+	for (int task = 0; task < num_tasks; task++) {
+		*r_sum += data.sums[task];
+		*r_pixels += data.pixels[task];
+	}
+
+	MEM_freeN(data.sums);
+	MEM_freeN(data.pixels);
+}
+
+void CalculateMeanOperation::calculateMean(MemoryBuffer *tile)
+{
+	int pixels;
+	float sum;
+	calculateSum(tile, false, 0.0f, &sum, &pixels);
 	this->m_result = sum / pixels;
 }
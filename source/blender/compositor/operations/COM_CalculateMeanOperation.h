@@ -65,5 +65,11 @@ public:
 	
 protected:
 	void calculateMean(MemoryBuffer *tile);
+
+	/**
+	 * @brief sum the values of the pixels with alpha, in parallel over the rows of \a tile
+	 * @param deviation sum the squared difference with \a mean instead
+	 */
+	void calculateSum(MemoryBuffer *tile, bool deviation, float mean, float *r_sum, int *r_pixels);
 };
 #endif
@@ -21,6 +21,7 @@
  */
 
 #include "COM_ConvertDepthToRadiusOperation.h"
+#include "COM_ResultCache.h"
 #include "BLI_math.h"
 #include "BKE_camera.h"
 #include "DNA_camera_types.h"
@@ -105,3 +106,19 @@ void ConvertDepthToRadiusOperation::deinitExecution()
 {
 	this->m_inputOperation = NULL;
 }
+
+bool ConvertDepthToRadiusOperation::hashSettings(ResultCacheHash &hash) const
+{
+	/* the node can point to another scene, but only the settings of its camera are used */
+	hash.addFloat(this->m_fStop);
+	hash.addFloat(this->m_maxRadius);
+	if (this->m_cameraObject && this->m_cameraObject->type == OB_CAMERA) {
+		const Camera *camera = (const Camera *)this->m_cameraObject->data;
+		hash.addFloat(camera->lens);
+		hash.addInt(camera->sensor_fit);
+		hash.addFloat(camera->sensor_x);
+		hash.addFloat(camera->sensor_y);
+		hash.addFloat(BKE_camera_object_dof_distance(this->m_cameraObject));
+	}
+	return true;
+}
@@ -71,6 +71,8 @@ public:
 	void setCameraObject(Object *camera) { this->m_cameraObject = camera; }
 	float determineFocalDistance();
 	void setPostBlur(FastGaussianBlurValueOperation *operation) {this->m_blurPostOperation = operation;}
+
+	bool hashSettings(ResultCacheHash &hash) const;
 	
 };
 #endif
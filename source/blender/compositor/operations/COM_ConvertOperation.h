@@ -43,6 +43,7 @@ public:
 	ConvertValueToColorOperation();
 	
 	void executePixelSampled(float output[4], float x, float y, PixelSampler sampler);
+	void executeRow(float *output, int x, int y, int num);
 };
 
 
@@ -51,6 +52,7 @@ public:
 	ConvertColorToValueOperation();
 	
 	void executePixelSampled(float output[4], float x, float y, PixelSampler sampler);
+	void executeRow(float *output, int x, int y, int num);
 };
 
 
@@ -59,6 +61,7 @@ public:
 	ConvertColorToBWOperation();
 	
 	void executePixelSampled(float output[4], float x, float y, PixelSampler sampler);
+	void executeRow(float *output, int x, int y, int num);
 };
 
 
@@ -67,6 +70,7 @@ public:
 	ConvertColorToVectorOperation();
 	
 	void executePixelSampled(float output[4], float x, float y, PixelSampler sampler);
+	void executeRow(float *output, int x, int y, int num);
 };
 
 
@@ -75,6 +79,7 @@ public:
 	ConvertValueToVectorOperation();
 	
 	void executePixelSampled(float output[4], float x, float y, PixelSampler sampler);
+	void executeRow(float *output, int x, int y, int num);
 };
 
 
@@ -83,6 +88,7 @@ public:
 	ConvertVectorToColorOperation();
 	
 	void executePixelSampled(float output[4], float x, float y, PixelSampler sampler);
+	void executeRow(float *output, int x, int y, int num);
 };
 
 
@@ -91,6 +97,7 @@ public:
 	ConvertVectorToValueOperation();
 	
 	void executePixelSampled(float output[4], float x, float y, PixelSampler sampler);
+	void executeRow(float *output, int x, int y, int num);
 };
 
 
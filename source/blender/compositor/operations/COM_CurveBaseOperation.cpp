@@ -21,6 +21,7 @@
  */
 
 #include "COM_CurveBaseOperation.h"
+#include "COM_ResultCache.h"
 
 #ifdef __cplusplus
 extern "C" {
@@ -63,3 +64,28 @@ void CurveBaseOperation::setCurveMapping(CurveMapping *mapping)
 	}
 	this->m_curveMapping = curvemapping_copy(mapping);
 }
+
+bool CurveBaseOperation::hashSettings(ResultCacheHash &hash) const
+{
+	/* the node storage is the curve mapping, hash its points instead of their pointers */
+	if (this->getbNode()) {
+		hashNodeSettings(hash, false);
+	}
+
+	const CurveMapping *cumap = this->m_curveMapping;
+	if (cumap) {
+		hash.addInt(cumap->flag);
+		hash.add(&cumap->clipr, sizeof(cumap->clipr));
+		hash.add(cumap->black, sizeof(cumap->black));
+		hash.add(cumap->white, sizeof(cumap->white));
+		for (int a = 0; a < CM_TOT; a++) {
+			const CurveMap *cuma = &cumap->cm[a];
+			hash.addInt(cuma->flag);
+			hash.addInt(cuma->totpoint);
+			if (cuma->curve) {
+				hash.add(cuma->curve, sizeof(CurveMapPoint) * cuma->totpoint);
+			}
+		}
+	}
+	return true;
+}
@@ -42,5 +42,7 @@ public:
 	void deinitExecution();
 	
 	void setCurveMapping(CurveMapping *mapping);
+
+	bool hashSettings(ResultCacheHash &hash) const;
 };
 #endif
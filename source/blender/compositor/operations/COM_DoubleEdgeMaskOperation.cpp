@@ -22,6 +22,7 @@
 
 #include "COM_DoubleEdgeMaskOperation.h"
 #include "BLI_math.h"
+#include "BLI_task.h"
 #include "DNA_node_types.h"
 #include "MEM_guardedalloc.h"
 
@@ -1000,9 +1001,17 @@ static void do_createEdgeLocationBuffer(unsigned int t, unsigned int rw, unsigne
 	
 }
 
-static void do_fillGradientBuffer(unsigned int rw, float *res, unsigned short *gbuf, unsigned int isz, unsigned int osz, unsigned int gsz, unsigned int innerEdgeOffset, unsigned int outerEdgeOffset)
+typedef struct FillGradientData {
+	unsigned int rw;
+	float *res;
+	const unsigned short *gbuf;
+	unsigned int isz, osz;
+	unsigned int innerEdgeOffset, outerEdgeOffset;
+} FillGradientData;
+
+static void do_fillGradientPixel(void *userdata, const int x)
 {
-	int x;                             // x = pixel loop counter
+	const FillGradientData *data = (const FillGradientData *)userdata;
 	int a;                             // a = temporary pixel index buffer loop counter
 	int fsz;                           // size of the frame
 	unsigned int rsl;                  // long used for finding fast 1.0/sqrt
@@ -1017,7 +1026,66 @@ static void do_fillGradientBuffer(unsigned int rw, float *res, unsigned short *g
 	float idist;                       // idist = current inner edge distance
 	int dx;                            // dx = X-delta (used for distance proportion calculation)
 	int dy;                            // dy = Y-delta (used for distance proportion calculation)
+
+	gradientFillOffset = x << 1;
+	t = data->gbuf[gradientFillOffset];            // calculate column of pixel indexed by gbuf[x]
+	fsz = data->gbuf[gradientFillOffset + 1];      // calculate row of pixel indexed by gbuf[x]
+	dmin = 0xffffffff;                       // reset min distance to edge pixel
+	for (a = data->outerEdgeOffset + data->osz - 1; a >= (int)data->outerEdgeOffset; a--) {   // loop through all outer edge buffer pixels
+		ud = a << 1;
+		dy = t - data->gbuf[ud];                   // set dx to gradient pixel column - outer edge pixel row
+		dx = fsz - data->gbuf[ud + 1];             // set dy to gradient pixel row - outer edge pixel column
+		ud = dx * dx + dy * dy;              // compute sum of squares
+		if (ud < dmin) {                     // if our new sum of squares is less than the current minimum
+			dmin = ud;                       // set a new minimum equal to the new lower value
+		}
+	}
+	odist = (float)(dmin);                   // cast outer min to a float
+	rsf = odist * 0.5f;                      //
+	rsl = *(unsigned int *)&odist;           // use some peculiar properties of the way bits are stored
+	rsl = 0x5f3759df - (rsl >> 1);           // in floats vs. unsigned ints to compute an approximate
+	odist = *(float *)&rsl;                  // reciprocal square root
+	odist = odist * (rsopf - (rsf * odist * odist));   // -- ** this line can be iterated for more accuracy ** --
+	dmin = 0xffffffff;                       // reset min distance to edge pixel
+	for (a = data->innerEdgeOffset + data->isz - 1; a >= (int)data->innerEdgeOffset; a--) {   // loop through all inside edge pixels
+		ud = a << 1;
+		dy = t - data->gbuf[ud];         // compute delta in Y from gradient pixel to inside edge pixel
+		dx = fsz - data->gbuf[ud + 1];     // compute delta in X from gradient pixel to inside edge pixel
+		ud = dx * dx + dy * dy;        // compute sum of squares
+		if (ud < dmin) {          // if our new sum of squares is less than the current minimum we've found
+			dmin = ud;           // set a new minimum equal to the new lower value
+		}
+	}
+	idist = (float)(dmin);                   // cast inner min to a float
+	rsf = idist * 0.5f;                      //
+	rsl = *(unsigned int *)&idist;           //
+	rsl = 0x5f3759df - (rsl >> 1);           // see notes above
+	idist = *(float *)&rsl;                  //
+	idist = idist * (rsopf - (rsf * idist * idist));   //
+	/*
+	 * Note once again that since we are using reciprocals of distance values our
+	 * proportion is already the correct intensity, and does not need to be
+	 * subtracted from 1.0 like it would have if we used real distances.
+	 */
 	
+	/*
+	 * Here we reconstruct the pixel's memory location in the CompBuf by
+	 * Pixel Index = Pixel Column + ( Pixel Row * Row Width )
+	 */
+	data->res[data->gbuf[gradientFillOffset + 1] + (data->gbuf[gradientFillOffset] * data->rw)] = (idist / (idist + odist));    //set intensity
+}
+
+static void do_fillGradientBuffer(unsigned int rw, float *res, unsigned short *gbuf, unsigned int isz, unsigned int osz, unsigned int gsz, unsigned int innerEdgeOffset, unsigned int outerEdgeOffset)
+{
+	FillGradientData data;
+	data.rw = rw;
+	data.res = res;
+	data.gbuf = gbuf;
+	data.isz = isz;
+	data.osz = osz;
+	data.innerEdgeOffset = innerEdgeOffset;
+	data.outerEdgeOffset = outerEdgeOffset;
+
 	/*
 	 * The general algorithm used to color each gradient pixel is:
 	 *
@@ -1074,58 +1142,9 @@ static void do_fillGradientBuffer(unsigned int rw, float *res, unsigned short *g
 	 * the sums-of-squares against eachother, since they are in the same
 	 * mathematical sort-order as if we did go ahead and take square roots
 	 *
-	 * Loop through all gradient pixels.
+	 * Loop through all gradient pixels, each one only writes its own result so they are done in parallel.
 	 */
-
-	for (x = gsz - 1; x >= 0; x--) {
-		gradientFillOffset = x << 1;
-		t = gbuf[gradientFillOffset];            // calculate column of pixel indexed by gbuf[x]
-		fsz = gbuf[gradientFillOffset + 1];      // calculate row of pixel indexed by gbuf[x]
-		dmin = 0xffffffff;                       // reset min distance to edge pixel
-		for (a = outerEdgeOffset + osz - 1; a >= outerEdgeOffset; a--) {   // loop through all outer edge buffer pixels
-			ud = a << 1;
-			dy = t - gbuf[ud];                   // set dx to gradient pixel column - outer edge pixel row
-			dx = fsz - gbuf[ud + 1];             // set dy to gradient pixel row - outer edge pixel column
-			ud = dx * dx + dy * dy;              // compute sum of squares
-			if (ud < dmin) {                     // if our new sum of squares is less than the current minimum
-				dmin = ud;                       // set a new minimum equal to the new lower value
-			}
-		}
-		odist = (float)(dmin);                   // cast outer min to a float
-		rsf = odist * 0.5f;                      //
-		rsl = *(unsigned int *)&odist;           // use some peculiar properties of the way bits are stored
-		rsl = 0x5f3759df - (rsl >> 1);           // in floats vs. unsigned ints to compute an approximate
-		odist = *(float *)&rsl;                  // reciprocal square root
-		odist = odist * (rsopf - (rsf * odist * odist));   // -- ** this line can be iterated for more accuracy ** --
-		dmin = 0xffffffff;                       // reset min distance to edge pixel
-		for (a = innerEdgeOffset + isz - 1; a >= innerEdgeOffset; a--) {   // loop through all inside edge pixels
-			ud = a << 1;
-			dy = t - gbuf[ud];         // compute delta in Y from gradient pixel to inside edge pixel
-			dx = fsz - gbuf[ud + 1];     // compute delta in X from gradient pixel to inside edge pixel
-			ud = dx * dx + dy * dy;        // compute sum of squares
-			if (ud < dmin) {          // if our new sum of squares is less than the current minimum we've found
-				dmin = ud;           // set a new minimum equal to the new lower value
-			}
-		}
-		idist = (float)(dmin);                   // cast inner min to a float
-		rsf = idist * 0.5f;                      //
-		rsl = *(unsigned int *)&idist;           //
-		rsl = 0x5f3759df - (rsl >> 1);           // see notes above
-		idist = *(float *)&rsl;                  //
-		idist = idist * (rsopf - (rsf * idist * idist));   //
-		/*
-		 * Note once again that since we are using reciprocals of distance values our
-		 * proportion is already the correct intensity, and does not need to be
-		 * subtracted from 1.0 like it would have if we used real distances.
-		 */
-		
-		/*
-		 * Here we reconstruct the pixel's memory location in the CompBuf by
-		 * Pixel Index = Pixel Column + ( Pixel Row * Row Width )
-		 */
-		res[gbuf[gradientFillOffset + 1] + (gbuf[gradientFillOffset] * rw)] = (idist / (idist + odist));    //set intensity
-	}
-	
+	BLI_task_parallel_range(0, gsz, &data, do_fillGradientPixel, gsz > 256);
 }
 
 // end of copy
@@ -25,6 +25,7 @@
 #include "COM_FastGaussianBlurOperation.h"
 #include "MEM_guardedalloc.h"
 #include "BLI_utildefines.h"
+#include "BLI_task.h"
 
 FastGaussianBlurOperation::FastGaussianBlurOperation() : BlurBaseOperation(COM_DT_COLOR)
 {
@@ -111,14 +112,85 @@ void *FastGaussianBlurOperation::initializeTileData(rcti *rect)
 	return this->m_iirgaus;
 }
 
+typedef struct IIRGaussData {
+	float *buffer;
+	unsigned int length;     /* pixels in a line */
+	unsigned int num_lines;
+	unsigned int stride;     /* floats between pixels of a line */
+	unsigned int line_stride; /* floats between lines */
+	double cf[4];
+	double tsM[9];
+} IIRGaussData;
+
+/* lines filtered by one task, the intermediate buffers are allocated per task */
+#define IIR_GAUSS_LINES_PER_TASK 16
+
+static void IIR_gauss_line(const IIRGaussData *data, const double *X, double *Y, double *W)
+{
+	const double *cf = data->cf;
+	const double *tsM = data->tsM;
+	const unsigned int L = data->length;
+	double tsu[3], tsv[3];
+	unsigned int i;
+
+	W[0] = cf[0] * X[0] + cf[1] * X[0] + cf[2] * X[0] + cf[3] * X[0];
+	W[1] = cf[0] * X[1] + cf[1] * W[0] + cf[2] * X[0] + cf[3] * X[0];
+	W[2] = cf[0] * X[2] + cf[1] * W[1] + cf[2] * W[0] + cf[3] * X[0];
+	for (i = 3; i < L; i++) {
+		W[i] = cf[0] * X[i] + cf[1] * W[i - 1] + cf[2] * W[i - 2] + cf[3] * W[i - 3];
+	}
+	tsu[0] = W[L - 1] - X[L - 1];
+	tsu[1] = W[L - 2] - X[L - 1];
+	tsu[2] = W[L - 3] - X[L - 1];
+	tsv[0] = tsM[0] * tsu[0] + tsM[1] * tsu[1] + tsM[2] * tsu[2] + X[L - 1];
+	tsv[1] = tsM[3] * tsu[0] + tsM[4] * tsu[1] + tsM[5] * tsu[2] + X[L - 1];
+	tsv[2] = tsM[6] * tsu[0] + tsM[7] * tsu[1] + tsM[8] * tsu[2] + X[L - 1];
+	Y[L - 1] = cf[0] * W[L - 1] + cf[1] * tsv[0] + cf[2] * tsv[1] + cf[3] * tsv[2];
+	Y[L - 2] = cf[0] * W[L - 2] + cf[1] * Y[L - 1] + cf[2] * tsv[0] + cf[3] * tsv[1];
+	Y[L - 3] = cf[0] * W[L - 3] + cf[1] * Y[L - 2] + cf[2] * Y[L - 1] + cf[3] * tsv[0];
+	/* 'i != UINT_MAX' is really 'i >= 0', but necessary for unsigned int wrapping */
+	for (i = L - 4; i != UINT_MAX; i--) {
+		Y[i] = cf[0] * W[i] + cf[1] * Y[i + 1] + cf[2] * Y[i + 2] + cf[3] * Y[i + 3];
+	}
+}
+
+static void IIR_gauss_lines_task(void *userdata, const int task)
+{
+	const IIRGaussData *data = (const IIRGaussData *)userdata;
+	const unsigned int L = data->length;
+	const unsigned int line_start = task * IIR_GAUSS_LINES_PER_TASK;
+	const unsigned int line_end = min(line_start + IIR_GAUSS_LINES_PER_TASK, data->num_lines);
+
+	// intermediate buffers
+	double *X = (double *)MEM_mallocN(L * sizeof(double), "IIR_gauss X buf");
+	double *Y = (double *)MEM_mallocN(L * sizeof(double), "IIR_gauss Y buf");
+	double *W = (double *)MEM_mallocN(L * sizeof(double), "IIR_gauss W buf");
+
+	for (unsigned int line = line_start; line < line_end; line++) {
+		float *buffer = data->buffer + line * data->line_stride;
+		unsigned int i, offset;
+
+		for (i = 0, offset = 0; i < L; i++, offset += data->stride) {
+			X[i] = buffer[offset];
+		}
+		IIR_gauss_line(data, X, Y, W);
+		for (i = 0, offset = 0; i < L; i++, offset += data->stride) {
+			buffer[offset] = Y[i];
+		}
+	}
+
+	MEM_freeN(X);
+	MEM_freeN(W);
+	MEM_freeN(Y);
+}
+
 void FastGaussianBlurOperation::IIR_gauss(MemoryBuffer *src, float sigma, unsigned int chan, unsigned int xy)
 {
-	double q, q2, sc, cf[4], tsM[9], tsu[3], tsv[3];
-	double *X, *Y, *W;
+	IIRGaussData data;
+	double q, q2, sc;
+	double *cf = data.cf, *tsM = data.tsM;
 	const unsigned int src_width = src->getWidth();
 	const unsigned int src_height = src->getHeight();
-	unsigned int x, y, sz;
-	unsigned int i;
 	float *buffer = src->getBuffer();
 	const unsigned int num_channels = src->get_num_channels();
 	
@@ -127,7 +199,7 @@ void FastGaussianBlurOperation::IIR_gauss(MemoryBuffer *src, float sigma, unsign
 	
 	if ((xy < 1) || (xy > 3)) xy = 3;
 	
-	// XXX The YVV macro defined below explicitly expects sources of at least 3x3 pixels,
+	// XXX IIR_gauss_line explicitly expects sources of at least 3x3 pixels,
 	//     so just skiping blur along faulty direction if src's def is below that limit!
 	if (src_width < 3) xy &= ~1;
 	if (src_height < 3) xy &= ~2;
@@ -166,76 +238,26 @@ void FastGaussianBlurOperation::IIR_gauss(MemoryBuffer *src, float sigma, unsign
 	tsM[6] = sc * (cf[3] * cf[1] + cf[2] + cf[1] * cf[1] - cf[2] * cf[2]);
 	tsM[7] = sc * (cf[1] * cf[2] + cf[3] * cf[2] * cf[2] - cf[1] * cf[3] * cf[3] - cf[3] * cf[3] * cf[3] - cf[3] * cf[2] + cf[3]);
 	tsM[8] = sc * (cf[3] * (cf[1] + cf[3] * cf[2]));
-	
-#define YVV(L)                                                                          \
-{                                                                                       \
-	W[0] = cf[0] * X[0] + cf[1] * X[0] + cf[2] * X[0] + cf[3] * X[0];                   \
-	W[1] = cf[0] * X[1] + cf[1] * W[0] + cf[2] * X[0] + cf[3] * X[0];                   \
-	W[2] = cf[0] * X[2] + cf[1] * W[1] + cf[2] * W[0] + cf[3] * X[0];                   \
-	for (i = 3; i < L; i++) {                                                           \
-		W[i] = cf[0] * X[i] + cf[1] * W[i - 1] + cf[2] * W[i - 2] + cf[3] * W[i - 3];   \
-	}                                                                                   \
-	tsu[0] = W[L - 1] - X[L - 1];                                                       \
-	tsu[1] = W[L - 2] - X[L - 1];                                                       \
-	tsu[2] = W[L - 3] - X[L - 1];                                                       \
-	tsv[0] = tsM[0] * tsu[0] + tsM[1] * tsu[1] + tsM[2] * tsu[2] + X[L - 1];            \
-	tsv[1] = tsM[3] * tsu[0] + tsM[4] * tsu[1] + tsM[5] * tsu[2] + X[L - 1];            \
-	tsv[2] = tsM[6] * tsu[0] + tsM[7] * tsu[1] + tsM[8] * tsu[2] + X[L - 1];            \
-	Y[L - 1] = cf[0] * W[L - 1] + cf[1] * tsv[0] + cf[2] * tsv[1] + cf[3] * tsv[2];     \
-	Y[L - 2] = cf[0] * W[L - 2] + cf[1] * Y[L - 1] + cf[2] * tsv[0] + cf[3] * tsv[1];   \
-	Y[L - 3] = cf[0] * W[L - 3] + cf[1] * Y[L - 2] + cf[2] * Y[L - 1] + cf[3] * tsv[0]; \
-	/* 'i != UINT_MAX' is really 'i >= 0', but necessary for unsigned int wrapping */   \
-	for (i = L - 4; i != UINT_MAX; i--) {                                               \
-		Y[i] = cf[0] * W[i] + cf[1] * Y[i + 1] + cf[2] * Y[i + 2] + cf[3] * Y[i + 3];   \
-	}                                                                                   \
-} (void)0
-	
-	// intermediate buffers
-	sz = max(src_width, src_height);
-	X = (double *)MEM_callocN(sz * sizeof(double), "IIR_gauss X buf");
-	Y = (double *)MEM_callocN(sz * sizeof(double), "IIR_gauss Y buf");
-	W = (double *)MEM_callocN(sz * sizeof(double), "IIR_gauss W buf");
+
+	data.buffer = buffer + chan;
+
+	/* lines are independent, filter them in parallel */
 	if (xy & 1) {   // H
-		int offset;
-		for (y = 0; y < src_height; ++y) {
-			const int yx = y * src_width;
-			offset = yx * num_channels + chan;
-			for (x = 0; x < src_width; ++x) {
-				X[x] = buffer[offset];
-				offset += num_channels;
-			}
-			YVV(src_width);
-			offset = yx * num_channels + chan;
-			for (x = 0; x < src_width; ++x) {
-				buffer[offset] = Y[x];
-				offset += num_channels;
-			}
-		}
+		data.length = src_width;
+		data.num_lines = src_height;
+		data.stride = num_channels;
+		data.line_stride = src_width * num_channels;
+		BLI_task_parallel_range(0, (data.num_lines + IIR_GAUSS_LINES_PER_TASK - 1) / IIR_GAUSS_LINES_PER_TASK,
+		                        &data, IIR_gauss_lines_task, data.num_lines > IIR_GAUSS_LINES_PER_TASK);
 	}
 	if (xy & 2) {   // V
-		int offset;
-		const int add = src_width * num_channels;
-
-		for (x = 0; x < src_width; ++x) {
-			offset = x * num_channels + chan;
-			for (y = 0; y < src_height; ++y) {
-				X[y] = buffer[offset];
-				offset += add;
-			}
-			YVV(src_height);
-			offset = x * num_channels + chan;
-			for (y = 0; y < src_height; ++y) {
-				buffer[offset] = Y[y];
-				offset += add;
-			}
-		}
+		data.length = src_height;
+		data.num_lines = src_width;
+		data.stride = src_width * num_channels;
+		data.line_stride = num_channels;
+		BLI_task_parallel_range(0, (data.num_lines + IIR_GAUSS_LINES_PER_TASK - 1) / IIR_GAUSS_LINES_PER_TASK,
+		                        &data, IIR_gauss_lines_task, data.num_lines > IIR_GAUSS_LINES_PER_TASK);
 	}
-	
-	MEM_freeN(X);
-	MEM_freeN(W);
-	MEM_freeN(Y);
-#undef YVV
-	
 }
 
 
@@ -53,6 +53,24 @@ void GammaOperation::executePixelSampled(float output[4], float x, float y, Pixe
 	output[3] = inputValue[3];
 }
 
+void GammaOperation::executeRow(float *output, int x, int y, int num)
+{
+	float inputGamma[COM_ROW_LENGTH * 4];
+
+	/* the color is read in place, every pixel only depends on itself */
+	this->m_inputProgram->readRow(output, x, y, num);
+	this->m_inputGammaProgram->readRow(inputGamma, x, y, num);
+
+	for (int i = 0; i < num * 4; i += 4) {
+		const float gamma = inputGamma[i];
+		/* check for negative to avoid nan's */
+		for (int c = 0; c < 3; c++) {
+			if (output[i + c] > 0.0f)
+				output[i + c] = powf(output[i + c], gamma);
+		}
+	}
+}
+
 void GammaOperation::deinitExecution()
 {
 	this->m_inputProgram = NULL;
@@ -23,6 +23,8 @@
 #include "COM_GlareFogGlowOperation.h"
 #include "MEM_guardedalloc.h"
 
+#include "BLI_task.h"
+
 /*
  *  2D Fast Hartley Transform, used for convolution
  */
@@ -119,6 +121,29 @@ static void FHT(fREAL *data, unsigned int M, unsigned int inverse)
 	}
 }
 //------------------------------------------------------------------------------
+typedef struct FHTRowsData {
+	fREAL *data;
+	unsigned int M, N;
+	unsigned int inverse;
+} FHTRowsData;
+
+static void FHT_row_task(void *userdata, const int row)
+{
+	const FHTRowsData *rows = (const FHTRowsData *)userdata;
+	FHT(&rows->data[rows->N * row], rows->M, rows->inverse);
+}
+
+/* transform rows of length N = 1 << M, rows are independent so are transformed in parallel */
+static void FHT_rows(fREAL *data, unsigned int M, unsigned int num_rows, unsigned int inverse)
+{
+	FHTRowsData rows;
+	rows.data = data;
+	rows.M = M;
+	rows.N = 1 << M;
+	rows.inverse = inverse;
+	BLI_task_parallel_range(0, num_rows, &rows, FHT_row_task, num_rows > 1);
+}
+//------------------------------------------------------------------------------
 /* 2D Fast Hartley Transform, Mx/My -> log2 of width/height,
  * nzp -> the row where zero pad data starts,
  * inverse -> see above */
@@ -133,8 +158,7 @@ static void FHT2D(fREAL *data, unsigned int Mx, unsigned int My,
 
 	// rows (forward transform skips 0 pad data)
 	maxy = inverse ? Ny : nzp;
-	for (j = 0; j < maxy; ++j)
-		FHT(&data[Nx * j], Mx, inverse);
+	FHT_rows(data, Mx, maxy, inverse);
 
 	// transpose data
 	if (Nx == Ny) {  // square
@@ -162,8 +186,7 @@ static void FHT2D(fREAL *data, unsigned int Mx, unsigned int My,
 	i = Mx, Mx = My, My = i;
 
 	// now columns == transposed rows
-	for (j = 0; j < Ny; ++j)
-		FHT(&data[Nx * j], Mx, inverse);
+	FHT_rows(data, Mx, Ny, inverse);
 
 	// finalize
 	for (j = 0; j <= (Ny >> 1); j++) {
@@ -26,6 +26,7 @@
 #include "COM_OpenCLDevice.h"
 
 #include "BLI_math.h"
+#include "BLI_task.h"
 
 #define ASSERT_XY_RANGE(x, y)  \
 	BLI_assert(x >= 0 && x < this->getWidth() && \
@@ -96,23 +97,29 @@ int InpaintSimpleOperation::mdist(int x, int y)
 	return this->m_manhatten_distance[y * width + x];
 }
 
-bool InpaintSimpleOperation::next_pixel(int &x, int &y, int & curr, int iters)
+/* find the next range of m_pixelorder with the same distance, starting at \a end */
+bool InpaintSimpleOperation::next_ring(int &start, int &end, int iters)
 {
 	int width = this->getWidth();
 
-	if (curr >= this->m_area_size) {
+	start = end;
+	if (start >= this->m_area_size) {
 		return false;
 	}
-	
-	int r = this->m_pixelorder[curr++];
-
-	x = r % width;
-	y = r / width;
 
-	if (this->mdist(x, y) > iters) {
+	int r = this->m_pixelorder[start];
+	const int d = this->mdist(r % width, r / width);
+	if (d > iters) {
 		return false;
 	}
-	
+
+	for (end = start + 1; end < this->m_area_size; end++) {
+		r = this->m_pixelorder[end];
+		if (this->mdist(r % width, r / width) != d) {
+			break;
+		}
+	}
+
 	return true;
 }
 
@@ -215,6 +222,15 @@ void InpaintSimpleOperation::pix_step(int x, int y)
 	}
 }
 
+void InpaintSimpleOperation::pix_step_task(void *userdata, const int index)
+{
+	InpaintSimpleOperation *operation = (InpaintSimpleOperation *)userdata;
+	const int r = operation->m_pixelorder[index];
+	const int width = operation->getWidth();
+
+	operation->pix_step(r % width, r / width);
+}
+
 void *InpaintSimpleOperation::initializeTileData(rcti *rect)
 {
 	if (this->m_cached_buffer_ready) {
@@ -227,12 +243,10 @@ void *InpaintSimpleOperation::initializeTileData(rcti *rect)
 
 		this->calc_manhatten_distance();
 
-		int curr = 0;
-		int x, y;
-
-	
-		while (this->next_pixel(x, y, curr, this->m_iterations)) {
-			this->pix_step(x, y);
+		/* pixels of a ring only read pixels closer to the known area, so a ring is filled in parallel */
+		int start, end = 0;
+		while (this->next_ring(start, end, this->m_iterations)) {
+			BLI_task_parallel_range(start, end, this, pix_step_task, (end - start) > 1024);
 		}
 		this->m_cached_buffer_ready = true;
 	}
@@ -67,8 +67,9 @@ private:
 	void clamp_xy(int &x, int &y);
 	float *get_pixel(int x, int y);
 	int mdist(int x, int y);
-	bool next_pixel(int &x, int &y, int &curr, int iters);
+	bool next_ring(int &start, int &end, int iters);
 	void pix_step(int x, int y);
+	static void pix_step_task(void *userdata, const int index);
 };
 
 
@@ -65,6 +65,34 @@ void InvertOperation::executePixelSampled(float output[4], float x, float y, Pix
 
 }
 
+void InvertOperation::executeRow(float *output, int x, int y, int num)
+{
+	float inputValue[COM_ROW_LENGTH * 4];
+	float inputColor[COM_ROW_LENGTH * 4];
+	this->m_inputValueProgram->readRow(inputValue, x, y, num);
+	this->m_inputColorProgram->readRow(inputColor, x, y, num);
+
+	for (int i = 0; i < num * 4; i += 4) {
+		const float value = inputValue[i];
+		const float invertedValue = 1.0f - value;
+		const float *color = &inputColor[i];
+
+		if (this->m_color) {
+			output[i] = (1.0f - color[0]) * value + color[0] * invertedValue;
+			output[i + 1] = (1.0f - color[1]) * value + color[1] * invertedValue;
+			output[i + 2] = (1.0f - color[2]) * value + color[2] * invertedValue;
+		}
+		else {
+			copy_v3_v3(&output[i], color);
+		}
+
+		if (this->m_alpha)
+			output[i + 3] = (1.0f - color[3]) * value + color[3] * invertedValue;
+		else
+			output[i + 3] = color[3];
+	}
+}
+
 void InvertOperation::deinitExecution()
 {
 	this->m_inputValueProgram = NULL;
@@ -72,6 +72,21 @@ void MathBaseOperation::clampIfNeeded(float *color)
 	}
 }
 
+void MathBaseOperation::readInputRows(float *inputValue1, float *inputValue2, int x, int y, int num)
+{
+	this->m_inputValue1Operation->readRow(inputValue1, x, y, num);
+	this->m_inputValue2Operation->readRow(inputValue2, x, y, num);
+}
+
+void MathBaseOperation::clampRowIfNeeded(float *output, int num)
+{
+	if (this->m_useClamp) {
+		for (int i = 0; i < num * 4; i += 4) {
+			CLAMP(output[i], 0.0f, 1.0f);
+		}
+	}
+}
+
 void MathAddOperation::executePixelSampled(float output[4], float x, float y, PixelSampler sampler)
 {
 	float inputValue1[4];
@@ -85,6 +100,20 @@ void MathAddOperation::executePixelSampled(float output[4], float x, float y, Pi
 	clampIfNeeded(output);
 }
 
+void MathAddOperation::executeRow(float *output, int x, int y, int num)
+{
+	float inputValue1[COM_ROW_LENGTH * 4];
+	float inputValue2[COM_ROW_LENGTH * 4];
+
+	readInputRows(inputValue1, inputValue2, x, y, num);
+
+	for (int i = 0; i < num * 4; i += 4) {
+		output[i] = inputValue1[i] + inputValue2[i];
+	}
+
+	clampRowIfNeeded(output, num);
+}
+
 void MathSubtractOperation::executePixelSampled(float output[4], float x, float y, PixelSampler sampler)
 {
 	float inputValue1[4];
@@ -98,6 +127,20 @@ void MathSubtractOperation::executePixelSampled(float output[4], float x, float
 	clampIfNeeded(output);
 }
 
+void MathSubtractOperation::executeRow(float *output, int x, int y, int num)
+{
+	float inputValue1[COM_ROW_LENGTH * 4];
+	float inputValue2[COM_ROW_LENGTH * 4];
+
+	readInputRows(inputValue1, inputValue2, x, y, num);
+
+	for (int i = 0; i < num * 4; i += 4) {
+		output[i] = inputValue1[i] - inputValue2[i];
+	}
+
+	clampRowIfNeeded(output, num);
+}
+
 void MathMultiplyOperation::executePixelSampled(float output[4], float x, float y, PixelSampler sampler)
 {
 	float inputValue1[4];
@@ -111,6 +154,20 @@ void MathMultiplyOperation::executePixelSampled(float output[4], float x, float
 	clampIfNeeded(output);
 }
 
+void MathMultiplyOperation::executeRow(float *output, int x, int y, int num)
+{
+	float inputValue1[COM_ROW_LENGTH * 4];
+	float inputValue2[COM_ROW_LENGTH * 4];
+
+	readInputRows(inputValue1, inputValue2, x, y, num);
+
+	for (int i = 0; i < num * 4; i += 4) {
+		output[i] = inputValue1[i] * inputValue2[i];
+	}
+
+	clampRowIfNeeded(output, num);
+}
+
 void MathDivideOperation::executePixelSampled(float output[4], float x, float y, PixelSampler sampler)
 {
 	float inputValue1[4];
@@ -127,6 +184,21 @@ void MathDivideOperation::executePixelSampled(float output[4], float x, float y,
 	clampIfNeeded(output);
 }
 
+void MathDivideOperation::executeRow(float *output, int x, int y, int num)
+{
+	float inputValue1[COM_ROW_LENGTH * 4];
+	float inputValue2[COM_ROW_LENGTH * 4];
+
+	readInputRows(inputValue1, inputValue2, x, y, num);
+
+	for (int i = 0; i < num * 4; i += 4) {
+		/* We don't want to divide by zero. */
+		output[i] = (inputValue2[i] == 0) ? 0.0f : inputValue1[i] / inputValue2[i];
+	}
+
+	clampRowIfNeeded(output, num);
+}
+
 void MathSineOperation::executePixelSampled(float output[4], float x, float y, PixelSampler sampler)
 {
 	float inputValue1[4];
@@ -265,6 +337,20 @@ void MathMinimumOperation::executePixelSampled(float output[4], float x, float y
 	clampIfNeeded(output);
 }
 
+void MathMinimumOperation::executeRow(float *output, int x, int y, int num)
+{
+	float inputValue1[COM_ROW_LENGTH * 4];
+	float inputValue2[COM_ROW_LENGTH * 4];
+
+	readInputRows(inputValue1, inputValue2, x, y, num);
+
+	for (int i = 0; i < num * 4; i += 4) {
+		output[i] = min(inputValue1[i], inputValue2[i]);
+	}
+
+	clampRowIfNeeded(output, num);
+}
+
 void MathMaximumOperation::executePixelSampled(float output[4], float x, float y, PixelSampler sampler)
 {
 	float inputValue1[4];
@@ -278,6 +364,20 @@ void MathMaximumOperation::executePixelSampled(float output[4], float x, float y
 	clampIfNeeded(output);
 }
 
+void MathMaximumOperation::executeRow(float *output, int x, int y, int num)
+{
+	float inputValue1[COM_ROW_LENGTH * 4];
+	float inputValue2[COM_ROW_LENGTH * 4];
+
+	readInputRows(inputValue1, inputValue2, x, y, num);
+
+	for (int i = 0; i < num * 4; i += 4) {
+		output[i] = max(inputValue1[i], inputValue2[i]);
+	}
+
+	clampRowIfNeeded(output, num);
+}
+
 void MathRoundOperation::executePixelSampled(float output[4], float x, float y, PixelSampler sampler)
 {
 	float inputValue1[4];
@@ -304,6 +404,20 @@ void MathLessThanOperation::executePixelSampled(float output[4], float x, float
 	clampIfNeeded(output);
 }
 
+void MathLessThanOperation::executeRow(float *output, int x, int y, int num)
+{
+	float inputValue1[COM_ROW_LENGTH * 4];
+	float inputValue2[COM_ROW_LENGTH * 4];
+
+	readInputRows(inputValue1, inputValue2, x, y, num);
+
+	for (int i = 0; i < num * 4; i += 4) {
+		output[i] = inputValue1[i] < inputValue2[i] ? 1.0f : 0.0f;
+	}
+
+	clampRowIfNeeded(output, num);
+}
+
 void MathGreaterThanOperation::executePixelSampled(float output[4], float x, float y, PixelSampler sampler)
 {
 	float inputValue1[4];
@@ -317,6 +431,20 @@ void MathGreaterThanOperation::executePixelSampled(float output[4], float x, flo
 	clampIfNeeded(output);
 }
 
+void MathGreaterThanOperation::executeRow(float *output, int x, int y, int num)
+{
+	float inputValue1[COM_ROW_LENGTH * 4];
+	float inputValue2[COM_ROW_LENGTH * 4];
+
+	readInputRows(inputValue1, inputValue2, x, y, num);
+
+	for (int i = 0; i < num * 4; i += 4) {
+		output[i] = inputValue1[i] > inputValue2[i] ? 1.0f : 0.0f;
+	}
+
+	clampRowIfNeeded(output, num);
+}
+
 void MathModuloOperation::executePixelSampled(float output[4], float x, float y, PixelSampler sampler)
 {
 	float inputValue1[4];
@@ -343,3 +471,16 @@ void MathAbsoluteOperation::executePixelSampled(float output[4], float x, float
 
 	clampIfNeeded(output);
 }
+
+void MathAbsoluteOperation::executeRow(float *output, int x, int y, int num)
+{
+	float inputValue1[COM_ROW_LENGTH * 4];
+
+	this->m_inputValue1Operation->readRow(inputValue1, x, y, num);
+
+	for (int i = 0; i < num * 4; i += 4) {
+		output[i] = fabsf(inputValue1[i]);
+	}
+
+	clampRowIfNeeded(output, num);
+}
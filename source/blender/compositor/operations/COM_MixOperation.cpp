@@ -100,6 +100,34 @@ void MixBaseOperation::deinitExecution()
 	this->m_inputColor2Operation = NULL;
 }
 
+void MixBaseOperation::readInputRows(float *inputValue, float *inputColor1, float *inputColor2, int x, int y, int num)
+{
+	this->m_inputValueOperation->readRow(inputValue, x, y, num);
+	this->m_inputColor1Operation->readRow(inputColor1, x, y, num);
+	this->m_inputColor2Operation->readRow(inputColor2, x, y, num);
+
+	/* pack the factors, value i is never written before value i * 4 is read */
+	if (this->useValueAlphaMultiply()) {
+		for (int i = 0; i < num; i++) {
+			inputValue[i] = inputValue[i * 4] * inputColor2[i * 4 + 3];
+		}
+	}
+	else {
+		for (int i = 0; i < num; i++) {
+			inputValue[i] = inputValue[i * 4];
+		}
+	}
+}
+
+void MixBaseOperation::clampRowIfNeeded(float *output, int num)
+{
+	if (m_useClamp) {
+		for (int i = 0; i < num * 4; i++) {
+			CLAMP(output[i], 0.0f, 1.0f);
+		}
+	}
+}
+
 /* ******** Mix Add Operation ******** */
 
 MixAddOperation::MixAddOperation() : MixBaseOperation()
@@ -129,6 +157,28 @@ void MixAddOperation::executePixelSampled(float output[4], float x, float y, Pix
 	clampIfNeeded(output);
 }
 
+void MixAddOperation::executeRow(float *output, int x, int y, int num)
+{
+	float inputColor1[COM_ROW_LENGTH * 4];
+	float inputColor2[COM_ROW_LENGTH * 4];
+	float inputValue[COM_ROW_LENGTH * 4];
+
+	readInputRows(inputValue, inputColor1, inputColor2, x, y, num);
+
+	for (int i = 0; i < num; i++) {
+		const float value = inputValue[i];
+		const float *color1 = &inputColor1[i * 4];
+		const float *color2 = &inputColor2[i * 4];
+		float *color = &output[i * 4];
+		color[0] = color1[0] + value * color2[0];
+		color[1] = color1[1] + value * color2[1];
+		color[2] = color1[2] + value * color2[2];
+		color[3] = color1[3];
+	}
+
+	clampRowIfNeeded(output, num);
+}
+
 /* ******** Mix Blend Operation ******** */
 
 MixBlendOperation::MixBlendOperation() : MixBaseOperation()
@@ -160,6 +210,29 @@ void MixBlendOperation::executePixelSampled(float output[4], float x, float y, P
 	clampIfNeeded(output);
 }
 
+void MixBlendOperation::executeRow(float *output, int x, int y, int num)
+{
+	float inputColor1[COM_ROW_LENGTH * 4];
+	float inputColor2[COM_ROW_LENGTH * 4];
+	float inputValue[COM_ROW_LENGTH * 4];
+
+	readInputRows(inputValue, inputColor1, inputColor2, x, y, num);
+
+	for (int i = 0; i < num; i++) {
+		const float value = inputValue[i];
+		const float *color1 = &inputColor1[i * 4];
+		const float *color2 = &inputColor2[i * 4];
+		float *color = &output[i * 4];
+		const float valuem = 1.0f - value;
+		color[0] = valuem * color1[0] + value * color2[0];
+		color[1] = valuem * color1[1] + value * color2[1];
+		color[2] = valuem * color1[2] + value * color2[2];
+		color[3] = color1[3];
+	}
+
+	clampRowIfNeeded(output, num);
+}
+
 /* ******** Mix Burn Operation ******** */
 
 MixBurnOperation::MixBurnOperation() : MixBaseOperation()
@@ -623,6 +696,29 @@ void MixMultiplyOperation::executePixelSampled(float output[4], float x, float y
 	clampIfNeeded(output);
 }
 
+void MixMultiplyOperation::executeRow(float *output, int x, int y, int num)
+{
+	float inputColor1[COM_ROW_LENGTH * 4];
+	float inputColor2[COM_ROW_LENGTH * 4];
+	float inputValue[COM_ROW_LENGTH * 4];
+
+	readInputRows(inputValue, inputColor1, inputColor2, x, y, num);
+
+	for (int i = 0; i < num; i++) {
+		const float value = inputValue[i];
+		const float *color1 = &inputColor1[i * 4];
+		const float *color2 = &inputColor2[i * 4];
+		float *color = &output[i * 4];
+		const float valuem = 1.0f - value;
+		color[0] = color1[0] * (valuem + value * color2[0]);
+		color[1] = color1[1] * (valuem + value * color2[1]);
+		color[2] = color1[2] * (valuem + value * color2[2]);
+		color[3] = color1[3];
+	}
+
+	clampRowIfNeeded(output, num);
+}
+
 /* ******** Mix Ovelray Operation ******** */
 
 MixOverlayOperation::MixOverlayOperation() : MixBaseOperation()
@@ -740,6 +836,29 @@ void MixScreenOperation::executePixelSampled(float output[4], float x, float y,
 	clampIfNeeded(output);
 }
 
+void MixScreenOperation::executeRow(float *output, int x, int y, int num)
+{
+	float inputColor1[COM_ROW_LENGTH * 4];
+	float inputColor2[COM_ROW_LENGTH * 4];
+	float inputValue[COM_ROW_LENGTH * 4];
+
+	readInputRows(inputValue, inputColor1, inputColor2, x, y, num);
+
+	for (int i = 0; i < num; i++) {
+		const float value = inputValue[i];
+		const float *color1 = &inputColor1[i * 4];
+		const float *color2 = &inputColor2[i * 4];
+		float *color = &output[i * 4];
+		const float valuem = 1.0f - value;
+		color[0] = 1.0f - (valuem + value * (1.0f - color2[0])) * (1.0f - color1[0]);
+		color[1] = 1.0f - (valuem + value * (1.0f - color2[1])) * (1.0f - color1[1]);
+		color[2] = 1.0f - (valuem + value * (1.0f - color2[2])) * (1.0f - color1[2]);
+		color[3] = color1[3];
+	}
+
+	clampRowIfNeeded(output, num);
+}
+
 /* ******** Mix Soft Light Operation ******** */
 
 MixSoftLightOperation::MixSoftLightOperation() : MixBaseOperation()
@@ -806,6 +925,28 @@ void MixSubtractOperation::executePixelSampled(float output[4], float x, float y
 	clampIfNeeded(output);
 }
 
+void MixSubtractOperation::executeRow(float *output, int x, int y, int num)
+{
+	float inputColor1[COM_ROW_LENGTH * 4];
+	float inputColor2[COM_ROW_LENGTH * 4];
+	float inputValue[COM_ROW_LENGTH * 4];
+
+	readInputRows(inputValue, inputColor1, inputColor2, x, y, num);
+
+	for (int i = 0; i < num; i++) {
+		const float value = inputValue[i];
+		const float *color1 = &inputColor1[i * 4];
+		const float *color2 = &inputColor2[i * 4];
+		float *color = &output[i * 4];
+		color[0] = color1[0] - value * color2[0];
+		color[1] = color1[1] - value * color2[1];
+		color[2] = color1[2] - value * color2[2];
+		color[3] = color1[3];
+	}
+
+	clampRowIfNeeded(output, num);
+}
+
 /* ******** Mix Value Operation ******** */
 
 MixValueOperation::MixValueOperation() : MixBaseOperation()
@@ -50,6 +50,13 @@ protected:
 			CLAMP(color[3], 0.0f, 1.0f);
 		}
 	}
+
+	/**
+	 * Read \a num pixels of the inputs for executeRow, inputValue[i] gets the
+	 * factor of pixel i with the value alpha multiply applied.
+	 */
+	void readInputRows(float *inputValue, float *inputColor1, float *inputColor2, int x, int y, int num);
+	void clampRowIfNeeded(float *output, int num);
 	
 public:
 	/**
@@ -84,12 +91,14 @@ class MixAddOperation : public MixBaseOperation {
 public:
 	MixAddOperation();
 	void executePixelSampled(float output[4], float x, float y, PixelSampler sampler);
+	void executeRow(float *output, int x, int y, int num);
 };
 
 class MixBlendOperation : public MixBaseOperation {
 public:
 	MixBlendOperation();
 	void executePixelSampled(float output[4], float x, float y, PixelSampler sampler);
+	void executeRow(float *output, int x, int y, int num);
 };
 
 class MixBurnOperation : public MixBaseOperation {
@@ -156,6 +165,7 @@ class MixMultiplyOperation : public MixBaseOperation {
 public:
 	MixMultiplyOperation();
 	void executePixelSampled(float output[4], float x, float y, PixelSampler sampler);
+	void executeRow(float *output, int x, int y, int num);
 };
 
 class MixOverlayOperation : public MixBaseOperation {
@@ -174,6 +184,7 @@ class MixScreenOperation : public MixBaseOperation {
 public:
 	MixScreenOperation();
 	void executePixelSampled(float output[4], float x, float y, PixelSampler sampler);
+	void executeRow(float *output, int x, int y, int num);
 };
 
 class MixSoftLightOperation : public MixBaseOperation {
@@ -186,6 +197,7 @@ class MixSubtractOperation : public MixBaseOperation {
 public:
 	MixSubtractOperation();
 	void executePixelSampled(float output[4], float x, float y, PixelSampler sampler);
+	void executeRow(float *output, int x, int y, int num);
 };
 
 class MixValueOperation : public MixBaseOperation {
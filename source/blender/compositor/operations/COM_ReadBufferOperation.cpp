@@ -74,6 +74,21 @@ void ReadBufferOperation::executePixelSampled(float output[4], float x, float y,
 	}
 }
 
+void ReadBufferOperation::executeRow(float *output, int x, int y, int num)
+{
+	if (m_single_value) {
+		/* write buffer has a single value stored at (0,0) */
+		float value[4];
+		m_buffer->read(value, 0, 0);
+		for (int i = 0; i < num; i++) {
+			copy_v4_v4(&output[i * 4], value);
+		}
+	}
+	else {
+		m_buffer->readRow(output, x, y, num);
+	}
+}
+
 void ReadBufferOperation::executePixelExtend(float output[4], float x, float y, PixelSampler sampler,
                                              MemoryBufferExtend extend_x, MemoryBufferExtend extend_y)
 {
@@ -288,3 +288,62 @@ void ScaleFixedSizeOperation::determineResolution(unsigned int resolution[2], un
 	resolution[0] = this->m_newWidth;
 	resolution[1] = this->m_newHeight;
 }
+
+
+// SCALE RESOLUTION
+ScaleResolutionOperation::ScaleResolutionOperation(DataType datatype) : BaseScaleOperation()
+{
+	this->addInputSocket(datatype, COM_SC_NO_RESIZE);
+	this->addOutputSocket(datatype);
+	this->setResolutionInputSocketIndex(0);
+	this->m_inputOperation = NULL;
+	this->m_factor = 1.0f;
+	this->m_relX = 1.0f;
+	this->m_relY = 1.0f;
+}
+
+void ScaleResolutionOperation::initExecution()
+{
+	this->m_inputOperation = this->getInputSocketReader(0);
+	this->m_relX = this->m_inputOperation->getWidth() / (float)this->getWidth();
+	this->m_relY = this->m_inputOperation->getHeight() / (float)this->getHeight();
+}
+
+void ScaleResolutionOperation::deinitExecution()
+{
+	this->m_inputOperation = NULL;
+}
+
+void ScaleResolutionOperation::executePixelSampled(float output[4], float x, float y, PixelSampler sampler)
+{
+	/* map pixel centers, so scaling down filters over the pixels that are merged */
+	const float nx = (x + 0.5f) * this->m_relX - 0.5f;
+	const float ny = (y + 0.5f) * this->m_relY - 0.5f;
+	this->m_inputOperation->readSampled(output, nx, ny, getEffectiveSampler(sampler));
+}
+
+bool ScaleResolutionOperation::determineDependingAreaOfInterest(rcti *input, ReadBufferOperation *readOperation, rcti *output)
+{
+	rcti newInput;
+
+	newInput.xmax = ceilf(input->xmax * this->m_relX) + 1;
+	newInput.xmin = floorf(input->xmin * this->m_relX) - 1;
+	newInput.ymax = ceilf(input->ymax * this->m_relY) + 1;
+	newInput.ymin = floorf(input->ymin * this->m_relY) - 1;
+
+	return BaseScaleOperation::determineDependingAreaOfInterest(&newInput, readOperation, output);
+}
+
+void ScaleResolutionOperation::determineResolution(unsigned int resolution[2], unsigned int preferredResolution[2])
+{
+	unsigned int nr[2];
+	nr[0] = preferredResolution[0] / this->m_factor;
+	nr[1] = preferredResolution[1] / this->m_factor;
+	BaseScaleOperation::determineResolution(resolution, nr);
+
+	/* keep 0 for inputs without resolution, such as images that failed to load */
+	if (resolution[0] && resolution[1]) {
+		resolution[0] = max_ii(1, (int)(resolution[0] * this->m_factor + 0.5f));
+		resolution[1] = max_ii(1, (int)(resolution[1] * this->m_factor + 0.5f));
+	}
+}
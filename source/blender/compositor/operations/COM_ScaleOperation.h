@@ -99,4 +99,24 @@ public:
 	void setOffset(float x, float y) { this->m_offsetX = x; this->m_offsetY = y; }
 };
 
+/**
+ * @brief scale the resolution of the input by a factor, keeping the datatype of the input.
+ * Used to calculate the tree at a fraction of its resolution for the progressive viewer preview.
+ */
+class ScaleResolutionOperation : public BaseScaleOperation {
+	SocketReader *m_inputOperation;
+	float m_factor;
+	float m_relX;
+	float m_relY;
+public:
+	ScaleResolutionOperation(DataType datatype);
+	bool determineDependingAreaOfInterest(rcti *input, ReadBufferOperation *readOperation, rcti *output);
+	void determineResolution(unsigned int resolution[2], unsigned int preferredResolution[2]);
+	void executePixelSampled(float output[4], float x, float y, PixelSampler sampler);
+
+	void initExecution();
+	void deinitExecution();
+	void setFactor(float factor) { this->m_factor = factor; }
+};
+
 #endif
@@ -21,6 +21,7 @@
  */
 
 #include "COM_SetColorOperation.h"
+#include "COM_ResultCache.h"
 
 SetColorOperation::SetColorOperation() : NodeOperation()
 {
@@ -34,6 +35,19 @@ void SetColorOperation::executePixelSampled(float output[4],
 	copy_v4_v4(output, this->m_color);
 }
 
+void SetColorOperation::executeRow(float *output, int /*x*/, int /*y*/, int num)
+{
+	for (int i = 0; i < num; i++) {
+		copy_v4_v4(&output[i * 4], this->m_color);
+	}
+}
+
+bool SetColorOperation::hashSettings(ResultCacheHash &hash) const
+{
+	hash.add(this->m_color, sizeof(this->m_color));
+	return true;
+}
+
 void SetColorOperation::determineResolution(unsigned int resolution[2], unsigned int preferredResolution[2])
 {
 	resolution[0] = preferredResolution[0];
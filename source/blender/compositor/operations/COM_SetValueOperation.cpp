@@ -21,6 +21,7 @@
  */
 
 #include "COM_SetValueOperation.h"
+#include "COM_ResultCache.h"
 
 SetValueOperation::SetValueOperation() : NodeOperation()
 {
@@ -34,6 +35,19 @@ void SetValueOperation::executePixelSampled(float output[4],
 	output[0] = this->m_value;
 }
 
+void SetValueOperation::executeRow(float *output, int /*x*/, int /*y*/, int num)
+{
+	for (int i = 0; i < num; i++) {
+		output[i * 4] = this->m_value;
+	}
+}
+
+bool SetValueOperation::hashSettings(ResultCacheHash &hash) const
+{
+	hash.addFloat(this->m_value);
+	return true;
+}
+
 void SetValueOperation::determineResolution(unsigned int resolution[2], unsigned int preferredResolution[2])
 {
 	resolution[0] = preferredResolution[0];
@@ -21,6 +21,7 @@
  */
 
 #include "COM_SetVectorOperation.h"
+#include "COM_ResultCache.h"
 #include "COM_defines.h"
 
 SetVectorOperation::SetVectorOperation() : NodeOperation()
@@ -37,6 +38,23 @@ void SetVectorOperation::executePixelSampled(float output[4],
 	output[2] = this->m_z;
 }
 
+void SetVectorOperation::executeRow(float *output, int /*x*/, int /*y*/, int num)
+{
+	for (int i = 0; i < num; i++) {
+		output[i * 4] = this->m_x;
+		output[i * 4 + 1] = this->m_y;
+		output[i * 4 + 2] = this->m_z;
+	}
+}
+
+bool SetVectorOperation::hashSettings(ResultCacheHash &hash) const
+{
+	hash.addFloat(this->m_x);
+	hash.addFloat(this->m_y);
+	hash.addFloat(this->m_z);
+	return true;
+}
+
 void SetVectorOperation::determineResolution(unsigned int resolution[2], unsigned int preferredResolution[2])
 {
 	resolution[0] = preferredResolution[0];
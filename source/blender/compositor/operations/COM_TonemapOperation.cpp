@@ -22,8 +22,11 @@
 
 #include "COM_TonemapOperation.h"
 #include "BLI_math.h"
+#include "BLI_task.h"
 #include "BLI_utildefines.h"
 
+#include "MEM_guardedalloc.h"
+
 extern "C" {
 #include "IMB_colormanagement.h"
 }
@@ -112,6 +115,47 @@ bool TonemapOperation::determineDependingAreaOfInterest(rcti * /*input*/, ReadBu
 	return false;
 }
 
+/* rows summed by one task */
+#define TONEMAP_ROWS_PER_TASK 32
+
+typedef struct TonemapLuminanceSums {
+	float lsum;
+	float Lav;
+	float cav[3];
+	float maxl, minl;
+} TonemapLuminanceSums;
+
+typedef struct TonemapLuminanceData {
+	const float *buffer;
+	int width, height;
+	TonemapLuminanceSums *sums; /* one per task */
+} TonemapLuminanceData;
+
+static void tonemap_luminance_task(void *userdata, const int task)
+{
+	TonemapLuminanceData *data = (TonemapLuminanceData *)userdata;
+	TonemapLuminanceSums *sums = &data->sums[task];
+	const int ystart = task * TONEMAP_ROWS_PER_TASK;
+	const int yend = min(ystart + TONEMAP_ROWS_PER_TASK, data->height);
+	const float *bc = data->buffer + (size_t)ystart * data->width * 4;
+	int p = (yend - ystart) * data->width;
+
+	sums->lsum = 0.0f;
+	sums->Lav = 0.0f;
+	zero_v3(sums->cav);
+	sums->maxl = -1e10f;
+	sums->minl = 1e10f;
+	while (p--) {
+		float L = IMB_colormanagement_get_luminance(bc);
+		sums->Lav += L;
+		add_v3_v3(sums->cav, bc);
+		sums->lsum += logf(MAX2(L, 0.0f) + 1e-5f);
+		sums->maxl = (L > sums->maxl) ? L : sums->maxl;
+		sums->minl = (L < sums->minl) ? L : sums->minl;
+		bc += 4;
+	}
+}
+
 void *TonemapOperation::initializeTileData(rcti *rect)
 {
 	lockMutex();
@@ -119,24 +163,31 @@ void *TonemapOperation::initializeTileData(rcti *rect)
 		MemoryBuffer *tile = (MemoryBuffer *)this->m_imageReader->initializeTileData(rect);
 		AvgLogLum *data = new AvgLogLum();
 
-		float *buffer = tile->getBuffer();
+		/* sum rows in parallel, then the per task sums */
+		TonemapLuminanceData luminance;
+		const int num_tasks = (tile->getHeight() + TONEMAP_ROWS_PER_TASK - 1) / TONEMAP_ROWS_PER_TASK;
+		luminance.buffer = tile->getBuffer();
+		luminance.width = tile->getWidth();
+		luminance.height = tile->getHeight();
+		luminance.sums = (TonemapLuminanceSums *)MEM_mallocN(sizeof(TonemapLuminanceSums) * max(num_tasks, 1), __func__);
+		BLI_task_parallel_range(0, num_tasks, &luminance, tonemap_luminance_task, num_tasks > 1);
 
 		float lsum = 0.0f;
 		int p = tile->getWidth() * tile->getHeight();
-		float *bc = buffer;
 		float avl, maxl = -1e10f, minl = 1e10f;
 		const float sc = 1.0f / p;
 		float Lav = 0.f;
 		float cav[4] = {0.0f, 0.0f, 0.0f, 0.0f};
-		while (p--) {
-			float L = IMB_colormanagement_get_luminance(bc);
-			Lav += L;
-			add_v3_v3(cav, bc);
-			lsum += logf(MAX2(L, 0.0f) + 1e-5f);
-			maxl = (L > maxl) ? L : maxl;
-			minl = (L < minl) ? L : minl;
-			bc += 4;
+		for (int task = 0; task < num_tasks; task++) {
+			const TonemapLuminanceSums *sums = &luminance.sums[task];
+			Lav += sums->Lav;
+			add_v3_v3(cav, sums->cav);
+			lsum += sums->lsum;
+			maxl = max(maxl, sums->maxl);
+			minl = min(minl, sums->minl);
 		}
+		MEM_freeN(luminance.sums);
+
 		data->lav = Lav * sc;
 		mul_v3_v3fl(data->cav, cav, sc);
 		maxl = log((double)maxl + 1e-5); minl = log((double)minl + 1e-5); avl = lsum * sc;
@@ -74,6 +74,12 @@ void WrapOperation::executePixelSampled(float output[4], float x, float y, Pixel
 	executePixelExtend(output, nx, ny, sampler, extend_x, extend_y);
 }
 
+void WrapOperation::executeRow(float *output, int x, int y, int num)
+{
+	/* wrapped pixels are not contiguous in the buffer, skip the row read of ReadBufferOperation */
+	NodeOperation::executeRow(output, x, y, num);
+}
+
 bool WrapOperation::determineDependingAreaOfInterest(rcti *input, ReadBufferOperation *readOperation, rcti *output)
 {
 	rcti newInput;
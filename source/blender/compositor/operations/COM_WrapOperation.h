@@ -32,6 +32,7 @@ public:
 	WrapOperation(DataType datetype);
 	bool determineDependingAreaOfInterest(rcti *input, ReadBufferOperation *readOperation, rcti *output);
 	void executePixelSampled(float output[4], float x, float y, PixelSampler sampler);
+	void executeRow(float *output, int x, int y, int num);
 
 	void setWrapping(int wrapping_type);
 	float getWrappedOriginalXPos(float x);
@@ -25,6 +25,8 @@
 #include <stdio.h>
 #include "COM_OpenCLDevice.h"
 
+using std::min;
+
 WriteBufferOperation::WriteBufferOperation(DataType datatype) : NodeOperation()
 {
 	this->addInputSocket(datatype);
@@ -47,8 +49,8 @@ void WriteBufferOperation::executePixelSampled(float output[4], float x, float y
 
 void WriteBufferOperation::initExecution()
 {
+	/* the memory is allocated when the ExecutionGroup schedules its first chunk */
 	this->m_input = this->getInputOperation(0);
-	this->m_memoryProxy->allocate(this->m_width, this->m_height);
 }
 
 void WriteBufferOperation::deinitExecution()
@@ -93,14 +95,25 @@ void WriteBufferOperation::executeRegion(rcti *rect, unsigned int /*tileNumber*/
 		int x2 = rect->xmax;
 		int y2 = rect->ymax;
 
+		float row[COM_ROW_LENGTH * COM_NUM_CHANNELS_COLOR];
 		int x;
 		int y;
 		bool breaked = false;
 		for (y = y1; y < y2 && (!breaked); y++) {
 			int offset4 = (y * memoryBuffer->getWidth() + x1) * num_channels;
-			for (x = x1; x < x2; x++) {
-				this->m_input->readSampled(&(buffer[offset4]), x, y, COM_PS_NEAREST);
-				offset4 += num_channels;
+			for (x = x1; x < x2; x += COM_ROW_LENGTH) {
+				const int num = min(x2 - x, COM_ROW_LENGTH);
+				if (num_channels == COM_NUM_CHANNELS_COLOR) {
+					/* color rows have the layout of the buffer, calculate them in place */
+					this->m_input->readRow(&(buffer[offset4]), x, y, num);
+				}
+				else {
+					this->m_input->readRow(row, x, y, num);
+					for (int i = 0; i < num; i++) {
+						memcpy(&(buffer[offset4 + i * num_channels]), &row[i * 4], sizeof(float) * num_channels);
+					}
+				}
+				offset4 += num * num_channels;
 			}
 			if (isBreaked()) {
 				breaked = true;
@@ -489,6 +489,7 @@ void ED_node_composit_default(const bContext *C, struct Scene *sce)
 	sce->nodetree = ntreeAddTree(NULL, "Compositing Nodetree", ntreeType_Composite->idname);
 	
 	sce->nodetree->chunksize = 256;
+	sce->nodetree->cache_size = 1024;
 	sce->nodetree->edit_quality = NTREE_QUALITY_HIGH;
 	sce->nodetree->render_quality = NTREE_QUALITY_HIGH;
 	
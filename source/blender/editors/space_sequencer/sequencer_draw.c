@@ -935,12 +935,17 @@ ImBuf *sequencer_ibuf_get(struct Main *bmain, Scene *scene, SpaceSeq *sseq, int
 	 */
 	G.is_break = false;
 
-	if (special_seq_update)
+	if (special_seq_update) {
 		ibuf = BKE_sequencer_give_ibuf_direct(&context, cfra + frame_ofs, special_seq_update);
-	else if (!U.prefetchframes) // XXX || (G.f & G_PLAYANIM) == 0) {
+	}
+	else {
 		ibuf = BKE_sequencer_give_ibuf(&context, cfra + frame_ofs, sseq->chanshown);
-	else
-		ibuf = BKE_sequencer_give_ibuf_threaded(&context, cfra + frame_ofs, sseq->chanshown);
+
+		/* render the following frames in the background while playing back */
+		if (frame_ofs == 0 && ED_screen_animation_playing(bmain->wm.first)) {
+			BKE_sequencer_prefetch_start(&context, cfra, sseq->chanshown);
+		}
+	}
 
 	/* restore state so real rendering would be canceled (if needed) */
 	G.is_break = is_break;
@@ -1437,33 +1442,6 @@ void draw_image_seq(const bContext *C, Scene *scene, ARegion *ar, SpaceSeq *sseq
 	}
 }
 
-#if 0
-void drawprefetchseqspace(Scene *scene, ARegion *UNUSED(ar), SpaceSeq *sseq)
-{
-	int rectx, recty;
-	int render_size = sseq->render_size;
-	int proxy_size = 100.0; 
-	if (render_size == 0) {
-		render_size = scene->r.size;
-	}
-	else {
-		proxy_size = render_size;
-	}
-	if (render_size < 0) {
-		return;
-	}
-
-	rectx = (render_size * scene->r.xsch) / 100;
-	recty = (render_size * scene->r.ysch) / 100;
-
-	if (sseq->mainb != SEQ_DRAW_SEQUENCE) {
-		give_ibuf_prefetch_request(
-		    rectx, recty, (scene->r.cfra), sseq->chanshown,
-		    proxy_size);
-	}
-}
-#endif
-
 /* draw backdrop of the sequencer strips view */
 static void draw_seq_backdrop(View2D *v2d)
 {
@@ -142,17 +142,40 @@ static void proxy_freejob(void *pjv)
 	MEM_freeN(pj);
 }
 
+/* rebuild link and the ones following it together, returns the last one */
+static LinkData *proxy_rebuild_queue(LinkData *link, short *stop, short *do_update, float *progress)
+{
+	struct SeqIndexBuildContext **contexts;
+	LinkData *last = link;
+	int num_contexts = 1, i;
+
+	while (last->next) {
+		last = last->next;
+		num_contexts++;
+	}
+
+	contexts = MEM_mallocN(sizeof(*contexts) * num_contexts, __func__);
+	for (i = 0; i < num_contexts; i++, link = link->next) {
+		contexts[i] = link->data;
+	}
+
+	BKE_sequencer_proxy_rebuild_batch(contexts, num_contexts, stop, do_update, progress);
+
+	MEM_freeN(contexts);
+
+	return last;
+}
+
 /* only this runs inside thread */
 static void proxy_startjob(void *pjv, short *stop, short *do_update, float *progress)
 {
 	ProxyJob *pj = pjv;
 	LinkData *link;
 
+	/* strips can be added to the queue while the job is running */
 	for (link = pj->queue.first; link; link = link->next) {
-		struct SeqIndexBuildContext *context = link->data;
+		link = proxy_rebuild_queue(link, stop, do_update, progress);
 
-		BKE_sequencer_proxy_rebuild(context, stop, do_update, progress);
-		
 		if (*stop) {
 			pj->stop = 1;
 			fprintf(stderr,  "Canceling proxy rebuild on users request...\n");
@@ -3419,6 +3442,8 @@ static int sequencer_rebuild_proxy_exec(bContext *C, wmOperator *UNUSED(op))
 	Editing *ed = BKE_sequencer_editing_get(scene, false);
 	Sequence *seq;
 	GSet *file_list;
+	ListBase queue = {NULL, NULL};
+	LinkData *link;
 	
 	if (ed == NULL) {
 		return OPERATOR_CANCELLED;
@@ -3429,24 +3454,26 @@ static int sequencer_rebuild_proxy_exec(bContext *C, wmOperator *UNUSED(op))
 	SEQP_BEGIN(ed, seq)
 	{
 		if ((seq->flag & SELECT)) {
-			ListBase queue = {NULL, NULL};
-			LinkData *link;
-			short stop = 0, do_update;
-			float progress;
-
 			BKE_sequencer_proxy_rebuild_context(bmain, scene, seq, file_list, &queue);
-
-			for (link = queue.first; link; link = link->next) {
-				struct SeqIndexBuildContext *context = link->data;
-				BKE_sequencer_proxy_rebuild(context, &stop, &do_update, &progress);
-				BKE_sequencer_proxy_rebuild_finish(context, 0);
-			}
-			BKE_sequencer_free_imbuf(scene, &ed->seqbase, false);
 		}
 	}
 	SEQ_END
 
 	BLI_gset_free(file_list, MEM_freeN);
+
+	if (queue.first) {
+		short stop = 0, do_update;
+		float progress = 0.0f;
+
+		proxy_rebuild_queue(queue.first, &stop, &do_update, &progress);
+
+		for (link = queue.first; link; link = link->next) {
+			BKE_sequencer_proxy_rebuild_finish(link->data, 0);
+		}
+		BLI_freelistN(&queue);
+
+		BKE_sequencer_free_imbuf(scene, &ed->seqbase, false);
+	}
 	
 	return OPERATOR_FINISHED;
 }
@@ -5132,6 +5132,9 @@ static void createTransSeqData(bContext *C, TransInfo *t)
 		return;
 	}
 
+	/* strips are moved without invalidating the cache until the transform ends */
+	BKE_sequencer_prefetch_stop();
+
 	t->customFree = freeSeqData;
 
 	xmouse = (int)UI_view2d_region_to_view_x(v2d, t->mouse.imval[0]);
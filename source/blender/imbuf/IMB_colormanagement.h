@@ -177,6 +177,8 @@ void IMB_colormanagement_processor_apply(struct ColormanageProcessor *cm_process
                                          int channels, bool predivide);
 void IMB_colormanagement_processor_free(struct ColormanageProcessor *cm_processor);
 
+void IMB_colormanagement_display_lut_set(bool use_display_lut);
+
 /* ** OpenGL drawing routines using GLSL for color space transform ** */
 
 /* Test if GLSL drawing is supported for combination of graphics card and this configuration */
@@ -265,6 +265,10 @@ struct IndexBuildContext *IMB_anim_index_rebuild_context(struct anim *anim, IMB_
 void IMB_anim_index_rebuild(struct IndexBuildContext *context,
                             short *stop, short *do_update, float *progress);
 
+/* rebuild indices and proxies of several movies at the same time, contexts may be NULL */
+void IMB_anim_index_rebuild_batch(struct IndexBuildContext **contexts, int num_contexts,
+                                  short *stop, short *do_update, float *progress);
+
 /* finish rebuilding proxises/timecodes and free temporary contexts used */
 void IMB_anim_index_rebuild_finish(struct IndexBuildContext *context, short stop);
 
@@ -298,6 +302,7 @@ void IMB_close_anim_proxies(struct anim *anim);
 int ismovie(const char *filepath);
 void IMB_anim_set_preseek(struct anim *anim, int preseek);
 int IMB_anim_get_preseek(struct anim *anim);
+void IMB_anim_set_readahead(struct anim *anim, int frames);
 
 /**
  *
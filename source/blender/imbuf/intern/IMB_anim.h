@@ -140,6 +140,7 @@ struct anim {
 	size_t framesize;
 	int interlacing;
 	int preseek;
+	int readahead;      /* frames decoded ahead of the playback, see IMB_anim_set_readahead */
 	int streamindex;
 	
 	/* avi */
@@ -175,6 +176,8 @@ struct anim {
 	int64_t last_pts;
 	int64_t next_pts;
 	AVPacket next_packet;
+
+	struct AnimReadAhead *readahead_data;
 #endif
 
 #ifdef WITH_REDCODE
@@ -193,4 +196,7 @@ struct anim {
 	char suffix[64]; /* MAX_NAME - multiview */
 };
 
+/* anim_movie.c */
+void imb_anim_readahead_clear(struct anim *anim);
+
 #endif
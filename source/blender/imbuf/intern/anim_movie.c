@@ -67,6 +67,8 @@
 #include "BLI_utildefines.h"
 #include "BLI_string.h"
 #include "BLI_path_util.h"
+#include "BLI_task.h"
+#include "BLI_threads.h"
 
 #include "MEM_guardedalloc.h"
 
@@ -87,6 +89,7 @@
 
 #include "IMB_anim.h"
 #include "IMB_indexer.h"
+#include "IMB_moviecache.h"
 
 #ifdef WITH_FFMPEG
 #include <libavformat/avformat.h>
@@ -214,6 +217,7 @@ static void free_anim_avi(struct anim *anim)
 #endif  /* WITH_AVI */
 
 #ifdef WITH_FFMPEG
+static void free_anim_ffmpeg_readahead(struct anim *anim);
 static void free_anim_ffmpeg(struct anim *anim);
 #endif
 #ifdef WITH_REDCODE
@@ -237,6 +241,7 @@ void IMB_free_anim(struct anim *anim)
 	free_anim_quicktime(anim);
 #endif
 #ifdef WITH_FFMPEG
+	free_anim_ffmpeg_readahead(anim);
 	free_anim_ffmpeg(anim);
 #endif
 #ifdef WITH_REDCODE
@@ -519,6 +524,10 @@ static int startffmpeg(struct anim *anim)
 
 	pCodecCtx->workaround_bugs = 1;
 
+	/* decode on multiple threads, codecs pick the types of threading they support */
+	pCodecCtx->thread_count = BLI_system_thread_count();
+	pCodecCtx->thread_type = FF_THREAD_FRAME | FF_THREAD_SLICE;
+
 	if (avcodec_open2(pCodecCtx, pCodec, NULL) < 0) {
 		avformat_close_input(&pFormatCtx);
 		return -1;
@@ -1139,10 +1148,238 @@ static ImBuf *ffmpeg_fetchibuf(struct anim *anim, int position,
 	return anim->last_frame;
 }
 
+/* Read-ahead decodes the frames following the last requested one in playback direction
+ * in a background task, so sequential playback doesn't wait for the decoder.
+ *
+ * The decoder state of the anim is only used by one thread at a time: the task,
+ * or IMB_anim_absolute after cancelling the task when a frame wasn't decoded ahead. */
+
+typedef struct AnimReadAheadKey {
+	int position;
+	IMB_Timecode_Type tc;
+} AnimReadAheadKey;
+
+typedef struct AnimReadAhead {
+	struct MovieCache *cache;
+	TaskPool *pool;
+
+	/* protects the cache and the playback state below */
+	ThreadMutex lock;
+	int position;
+	int direction;
+	IMB_Timecode_Type tc;
+	bool running;
+
+	/* statistics, printed with --debug-ffmpeg */
+	int hits, misses;
+} AnimReadAhead;
+
+static unsigned int ffmpeg_readahead_hashhash(const void *keyv)
+{
+	const AnimReadAheadKey *key = keyv;
+
+	return key->position;
+}
+
+static bool ffmpeg_readahead_hashcmp(const void *av, const void *bv)
+{
+	const AnimReadAheadKey *a = av;
+	const AnimReadAheadKey *b = bv;
+
+	return ((a->position != b->position) ||
+	        (a->tc != b->tc));
+}
+
+static bool ffmpeg_readahead_cleanup_check(ImBuf *UNUSED(ibuf), void *userkey, void *userdata)
+{
+	const AnimReadAheadKey *key = userkey;
+	const struct anim *anim = userdata;
+	const AnimReadAhead *ra = anim->readahead_data;
+	int offset = (key->position - ra->position) * ra->direction;
+
+	return (key->tc != ra->tc) || (offset < 0) || (offset > anim->readahead);
+}
+
+static bool ffmpeg_readahead_cleanup_all(ImBuf *UNUSED(ibuf), void *UNUSED(userkey), void *UNUSED(userdata))
+{
+	return true;
+}
+
+/* first frame of the read-ahead window which isn't decoded yet, -1 when all are */
+static int ffmpeg_readahead_next(struct anim *anim)
+{
+	AnimReadAhead *ra = anim->readahead_data;
+	AnimReadAheadKey key;
+	ImBuf *ibuf;
+	int first, i;
+
+	/* decode backwards windows in increasing order too, so they only need a single seek */
+	first = (ra->direction > 0) ? ra->position + 1 : ra->position - anim->readahead;
+
+	key.tc = ra->tc;
+	for (i = 0; i < anim->readahead; i++) {
+		key.position = first + i;
+		if (key.position < 0 || key.position >= anim->duration) {
+			continue;
+		}
+
+		ibuf = IMB_moviecache_get(ra->cache, &key);
+		if (ibuf == NULL) {
+			return key.position;
+		}
+		IMB_freeImBuf(ibuf);
+	}
+
+	return -1;
+}
+
+static void ffmpeg_readahead_task(TaskPool *__restrict pool, void *UNUSED(taskdata), int UNUSED(threadid))
+{
+	struct anim *anim = BLI_task_pool_userdata(pool);
+	AnimReadAhead *ra = anim->readahead_data;
+	AnimReadAheadKey key;
+	ImBuf *ibuf;
+
+	BLI_mutex_lock(&ra->lock);
+
+	while (!BLI_task_pool_canceled(pool)) {
+		key.position = ffmpeg_readahead_next(anim);
+		key.tc = ra->tc;
+
+		if (key.position == -1) {
+			break;
+		}
+
+		BLI_mutex_unlock(&ra->lock);
+		ibuf = ffmpeg_fetchibuf(anim, key.position, key.tc);
+		BLI_mutex_lock(&ra->lock);
+
+		if (ibuf == NULL) {
+			break;
+		}
+
+		IMB_moviecache_put(ra->cache, &key, ibuf);
+		IMB_freeImBuf(ibuf);
+	}
+
+	ra->running = false;
+	BLI_mutex_unlock(&ra->lock);
+}
+
+static void ffmpeg_readahead_cancel(AnimReadAhead *ra)
+{
+	BLI_task_pool_cancel(ra->pool);
+	/* cancelled tasks which didn't start yet don't reset it */
+	ra->running = false;
+}
+
+static ImBuf *ffmpeg_fetchibuf_readahead(struct anim *anim, int position,
+                                         IMB_Timecode_Type tc)
+{
+	AnimReadAhead *ra = anim->readahead_data;
+	AnimReadAheadKey key;
+	ImBuf *ibuf;
+
+	/* not created yet when the read-ahead was only set from tasks */
+	if (anim->readahead <= 0 || ra == NULL) {
+		return ffmpeg_fetchibuf(anim, position, tc);
+	}
+
+	key.position = position;
+	key.tc = tc;
+
+	BLI_mutex_lock(&ra->lock);
+	ibuf = IMB_moviecache_get(ra->cache, &key);
+	BLI_mutex_unlock(&ra->lock);
+
+	if (ibuf == NULL) {
+		/* stop decoding ahead, the frame it was working on may be the requested one */
+		ffmpeg_readahead_cancel(ra);
+		ibuf = IMB_moviecache_get(ra->cache, &key);
+	}
+
+	if (ibuf) {
+		ra->hits++;
+	}
+	else {
+		ra->misses++;
+		ibuf = ffmpeg_fetchibuf(anim, position, tc);
+	}
+
+	BLI_mutex_lock(&ra->lock);
+
+	if (ibuf) {
+		if (position != ra->position) {
+			ra->direction = (position > ra->position) ? 1 : -1;
+		}
+		ra->position = position;
+		ra->tc = tc;
+
+		IMB_moviecache_cleanup(ra->cache, ffmpeg_readahead_cleanup_check, anim);
+
+		if (!ra->running) {
+			ra->running = true;
+			BLI_task_pool_push(ra->pool, ffmpeg_readahead_task, NULL, false, TASK_PRIORITY_LOW);
+		}
+	}
+
+	BLI_mutex_unlock(&ra->lock);
+
+	return ibuf;
+}
+
+static void ffmpeg_readahead_create(struct anim *anim)
+{
+	AnimReadAhead *ra = MEM_callocN(sizeof(AnimReadAhead), "anim read-ahead");
+
+	ra->cache = IMB_moviecache_create("anim read-ahead", sizeof(AnimReadAheadKey),
+	                                  ffmpeg_readahead_hashhash, ffmpeg_readahead_hashcmp);
+	ra->pool = BLI_task_pool_create_background(BLI_task_scheduler_get(), anim);
+	BLI_mutex_init(&ra->lock);
+	ra->direction = 1;
+
+	anim->readahead_data = ra;
+}
+
+static void free_anim_ffmpeg_readahead(struct anim *anim)
+{
+	AnimReadAhead *ra = anim->readahead_data;
+
+	if (ra == NULL) {
+		return;
+	}
+
+	ffmpeg_readahead_cancel(ra);
+	BLI_task_pool_free(ra->pool);
+
+	if (G.debug & G_DEBUG_FFMPEG) {
+		printf("%s: %s read-ahead %d hits, %d misses\n", __func__, anim->name, ra->hits, ra->misses);
+	}
+
+	IMB_moviecache_free(ra->cache);
+	BLI_mutex_end(&ra->lock);
+	MEM_freeN(ra);
+
+	anim->readahead_data = NULL;
+}
+
+static void ffmpeg_readahead_clear(struct anim *anim)
+{
+	AnimReadAhead *ra = anim->readahead_data;
+
+	if (ra) {
+		ffmpeg_readahead_cancel(ra);
+		IMB_moviecache_cleanup(ra->cache, ffmpeg_readahead_cleanup_all, NULL);
+	}
+}
+
 static void free_anim_ffmpeg(struct anim *anim)
 {
 	if (anim == NULL) return;
 
+	/* the read-ahead itself is kept until IMB_free_anim, startanim frees the decoder too */
+	ffmpeg_readahead_clear(anim);
+
 	if (anim->pCodecCtx) {
 		avcodec_close(anim->pCodecCtx);
 		avformat_close_input(&anim->pFormatCtx);
@@ -1389,9 +1626,8 @@ struct ImBuf *IMB_anim_absolute(struct anim *anim, int position,
 #endif
 #ifdef WITH_FFMPEG
 		case ANIM_FFMPEG:
-			ibuf = ffmpeg_fetchibuf(anim, position, tc);
-			if (ibuf)
-				anim->curposition = position;
+			/* sets anim->curposition itself, unless the frame was decoded ahead */
+			ibuf = ffmpeg_fetchibuf_readahead(anim, position, tc);
 			filter_y = 0; /* done internally */
 			break;
 #endif
@@ -1405,7 +1641,7 @@ struct ImBuf *IMB_anim_absolute(struct anim *anim, int position,
 
 	if (ibuf) {
 		if (filter_y) IMB_filtery(ibuf);
-		BLI_snprintf(ibuf->name, sizeof(ibuf->name), "%s.%04d", anim->name, anim->curposition + 1);
+		BLI_snprintf(ibuf->name, sizeof(ibuf->name), "%s.%04d", anim->name, position + 1);
 		
 	}
 	return(ibuf);
@@ -1455,3 +1691,31 @@ int IMB_anim_get_preseek(struct anim *anim)
 {
 	return anim->preseek;
 }
+
+/* decode up to \a frames frames ahead of the last requested one in the background, 0 disables it.
+ *
+ * Background task pools can't be created from tasks, so reading ahead only starts once this
+ * is called from the main thread, calls from other threads only set the amount of frames. */
+void IMB_anim_set_readahead(struct anim *anim, int frames)
+{
+	anim->readahead = frames;
+
+#ifdef WITH_FFMPEG
+	if (frames == 0) {
+		free_anim_ffmpeg_readahead(anim);
+	}
+	else if (anim->readahead_data == NULL && BLI_thread_is_main()) {
+		ffmpeg_readahead_create(anim);
+	}
+#endif
+}
+
+/* frames decoded ahead become invalid when the indices change */
+void imb_anim_readahead_clear(struct anim *anim)
+{
+#ifdef WITH_FFMPEG
+	ffmpeg_readahead_clear(anim);
+#else
+	UNUSED_VARS(anim);
+#endif
+}
@@ -52,6 +52,7 @@
 #include "MEM_guardedalloc.h"
 
 #include "BLI_blenlib.h"
+#include "BLI_color_lut.h"
 #include "BLI_math.h"
 #include "BLI_math_color.h"
 #include "BLI_string.h"
@@ -72,6 +73,10 @@
 
 #define DISPLAY_BUFFER_CHANNELS 4
 
+/* lattice points per axis of baked display transforms, and how many of them are kept */
+#define DISPLAY_LUT_SIZE 65
+#define DISPLAY_LUT_MAX_CACHED 4
+
 /* ** list of all supported color spaces, displays and views */
 static char global_role_scene_linear[MAX_COLORSPACE_NAME];
 static char global_role_color_picking[MAX_COLORSPACE_NAME];
@@ -106,8 +111,36 @@ typedef struct ColormanageProcessor {
 	OCIO_ConstProcessorRcPtr *processor;
 	CurveMapping *curve_mapping;
 	bool is_data_result;
+
+	/* baked OCIO processor, used instead of it when set */
+	struct DisplayLUT *display_lut;
 } ColormanageProcessor;
 
+/* Display transforms baked into 3D LUTs, most recently used first. Display buffers
+ * are computed with them instead of the exact OCIO processor when enabled. */
+typedef struct DisplayLUT {
+	struct DisplayLUT *next, *prev;
+
+	/* settings of the baked processor */
+	char look[MAX_COLORSPACE_NAME];
+	char view[MAX_COLORSPACE_NAME];
+	char display[MAX_COLORSPACE_NAME];
+	float exposure, gamma;
+
+	/* processors using the LUT, only unused LUTs are freed */
+	int users;
+	ColorLUT *lut;
+} DisplayLUT;
+
+static ListBase global_display_luts = {NULL, NULL};
+static ThreadMutex display_lut_lock = BLI_MUTEX_INITIALIZER;
+static bool global_use_display_lut = false;
+
+static ColormanageProcessor *display_processor_new_ex(const ColorManagedViewSettings *view_settings,
+                                                      const ColorManagedDisplaySettings *display_settings,
+                                                      bool use_display_lut);
+static void display_luts_free(void);
+
 static struct global_glsl_state {
 	/* Actual processor used for GLSL baked LUTs. */
 	OCIO_ConstProcessorRcPtr *processor;
@@ -203,6 +236,7 @@ typedef struct ColormanageCacheViewSettings {
 	float gamma;
 	float dither;
 	CurveMapping *curve_mapping;
+	bool use_display_lut;
 } ColormanageCacheViewSettings;
 
 typedef struct ColormanageCacheDisplaySettings {
@@ -222,6 +256,7 @@ typedef struct ColormnaageCacheData {
 	float dither;    /* dither value cached buffer is calculated with */
 	CurveMapping *curve_mapping;  /* curve mapping used for cached buffer */
 	int curve_mapping_timestamp;  /* time stamp of curve mapping used for cached buffer */
+	bool use_display_lut;         /* whether cached buffer is calculated with a baked display transform */
 } ColormnaageCacheData;
 
 typedef struct ColormanageCache {
@@ -303,6 +338,7 @@ static void colormanage_view_settings_to_cache(ImBuf *ibuf,
 	cache_view_settings->dither = ibuf->dither;
 	cache_view_settings->flag = view_settings->flag;
 	cache_view_settings->curve_mapping = view_settings->curve_mapping;
+	cache_view_settings->use_display_lut = global_use_display_lut;
 }
 
 static void colormanage_display_settings_to_cache(ColormanageCacheDisplaySettings *cache_display_settings,
@@ -381,7 +417,8 @@ static unsigned char *colormanage_cache_get(ImBuf *ibuf, const ColormanageCacheV
 		    cache_data->dither != view_settings->dither ||
 		    cache_data->flag != view_settings->flag ||
 		    cache_data->curve_mapping != curve_mapping ||
-		    cache_data->curve_mapping_timestamp != curve_mapping_timestamp)
+		    cache_data->curve_mapping_timestamp != curve_mapping_timestamp ||
+		    cache_data->use_display_lut != view_settings->use_display_lut)
 		{
 			*cache_handle = NULL;
 
@@ -429,6 +466,7 @@ static void colormanage_cache_put(ImBuf *ibuf, const ColormanageCacheViewSetting
 	cache_data->flag = view_settings->flag;
 	cache_data->curve_mapping = curve_mapping;
 	cache_data->curve_mapping_timestamp = curve_mapping_timestamp;
+	cache_data->use_display_lut = view_settings->use_display_lut;
 
 	colormanage_cachedata_set(cache_ibuf, cache_data);
 
@@ -560,6 +598,9 @@ static void colormanage_free_config(void)
 	ColorSpace *colorspace;
 	ColorManagedDisplay *display;
 
+	/* free baked display transforms, they're referring to the config by names */
+	display_luts_free();
+
 	/* free color spaces */
 	colorspace = global_colorspaces.first;
 	while (colorspace) {
@@ -1530,7 +1571,7 @@ static void colormanage_display_buffer_process_ex(ImBuf *ibuf, float *display_bu
 	}
 
 	if (skip_transform == false)
-		cm_processor = IMB_colormanagement_display_processor_new(view_settings, display_settings);
+		cm_processor = display_processor_new_ex(view_settings, display_settings, global_use_display_lut);
 
 	display_buffer_apply_threaded(ibuf, ibuf->rect_float, (unsigned char *) ibuf->rect,
 	                              display_buffer, display_buffer_byte, cm_processor);
@@ -2087,7 +2128,8 @@ void IMB_display_buffer_transform_apply(unsigned char *display_buffer, float *li
                                         const ColorManagedDisplaySettings *display_settings, bool predivide)
 {
 	float *buffer;
-	ColormanageProcessor *cm_processor = IMB_colormanagement_display_processor_new(view_settings, display_settings);
+	ColormanageProcessor *cm_processor = display_processor_new_ex(view_settings, display_settings,
+	                                                              global_use_display_lut);
 
 	buffer = MEM_mallocN((size_t)channels * width * height * sizeof(float), "display transform temp buffer");
 	memcpy(buffer, linear_buffer, (size_t)channels * width * height * sizeof(float));
@@ -2793,7 +2835,7 @@ void IMB_partial_display_buffer_update(ImBuf *ibuf, const float *linear_buffer,
 		}
 
 		if (!skip_transform) {
-			cm_processor = IMB_colormanagement_display_processor_new(view_settings, display_settings);
+			cm_processor = display_processor_new_ex(view_settings, display_settings, global_use_display_lut);
 		}
 
 		partial_buffer_update_rect(ibuf, display_buffer, linear_buffer, byte_buffer, buffer_width, stride,
@@ -2827,10 +2869,121 @@ void IMB_partial_display_buffer_update_delayed(ImBuf *ibuf, int xmin, int ymin,
 	}
 }
 
+/*********************** Baked display transforms *************************/
+
+static void display_lut_bake(void *userdata, float *rgb, size_t num_pixels)
+{
+	OCIO_ConstProcessorRcPtr *processor = userdata;
+	OCIO_PackedImageDesc *img;
+
+	img = OCIO_createOCIO_PackedImageDesc(rgb, (long)num_pixels, 1, 3, sizeof(float),
+	                                      3 * sizeof(float), 3 * sizeof(float) * num_pixels);
+
+	OCIO_processorApply(processor, img);
+
+	OCIO_PackedImageDescRelease(img);
+}
+
+static void display_lut_free(DisplayLUT *display_lut)
+{
+	BLI_assert(display_lut->users == 0);
+
+	BLI_remlink(&global_display_luts, display_lut);
+	BLI_color_lut_free(display_lut->lut);
+	MEM_freeN(display_lut);
+}
+
+/* frees least recently used LUTs which aren't used by any processor */
+static void display_luts_trim(int max_cached)
+{
+	DisplayLUT *display_lut, *display_lut_next;
+	int tot = 0;
+
+	for (display_lut = global_display_luts.first; display_lut; display_lut = display_lut_next) {
+		display_lut_next = display_lut->next;
+
+		if (++tot > max_cached && display_lut->users == 0)
+			display_lut_free(display_lut);
+	}
+}
+
+static void display_luts_free(void)
+{
+	BLI_mutex_lock(&display_lut_lock);
+	display_luts_trim(0);
+	BLI_mutex_unlock(&display_lut_lock);
+}
+
+/* Get display transform baked from given processor, which is baked once per settings.
+ * Baking happens with the lock held, so concurrent redraws don't bake the same LUT twice. */
+static DisplayLUT *display_lut_acquire(OCIO_ConstProcessorRcPtr *processor,
+                                       const ColorManagedViewSettings *view_settings,
+                                       const ColorManagedDisplaySettings *display_settings)
+{
+	DisplayLUT *display_lut;
+
+	BLI_mutex_lock(&display_lut_lock);
+
+	for (display_lut = global_display_luts.first; display_lut; display_lut = display_lut->next) {
+		if (STREQ(display_lut->look, view_settings->look) &&
+		    STREQ(display_lut->view, view_settings->view_transform) &&
+		    STREQ(display_lut->display, display_settings->display_device) &&
+		    display_lut->exposure == view_settings->exposure &&
+		    display_lut->gamma == view_settings->gamma)
+		{
+			break;
+		}
+	}
+
+	if (display_lut) {
+		BLI_remlink(&global_display_luts, display_lut);
+	}
+	else {
+		display_lut = MEM_callocN(sizeof(DisplayLUT), "display transform LUT");
+
+		BLI_strncpy(display_lut->look, view_settings->look, sizeof(display_lut->look));
+		BLI_strncpy(display_lut->view, view_settings->view_transform, sizeof(display_lut->view));
+		BLI_strncpy(display_lut->display, display_settings->display_device, sizeof(display_lut->display));
+		display_lut->exposure = view_settings->exposure;
+		display_lut->gamma = view_settings->gamma;
+
+		display_lut->lut = BLI_color_lut_bake(DISPLAY_LUT_SIZE, display_lut_bake, processor);
+	}
+
+	BLI_addhead(&global_display_luts, display_lut);
+	display_lut->users++;
+
+	display_luts_trim(DISPLAY_LUT_MAX_CACHED);
+
+	BLI_mutex_unlock(&display_lut_lock);
+
+	return display_lut;
+}
+
+static void display_lut_release(DisplayLUT *display_lut)
+{
+	BLI_mutex_lock(&display_lut_lock);
+	display_lut->users--;
+	BLI_mutex_unlock(&display_lut_lock);
+}
+
+/* Display buffers are calculated with baked display transforms when enabled, which is
+ * faster than the OCIO processor but only approximates it. Scene linear values above 64
+ * are clamped by the LUT. */
+void IMB_colormanagement_display_lut_set(bool use_display_lut)
+{
+	global_use_display_lut = use_display_lut;
+
+	if (!use_display_lut) {
+		display_luts_free();
+	}
+}
+
 /*********************** Pixel processor functions *************************/
 
-ColormanageProcessor *IMB_colormanagement_display_processor_new(const ColorManagedViewSettings *view_settings,
-                                                                const ColorManagedDisplaySettings *display_settings)
+static ColormanageProcessor *display_processor_new_ex(const ColorManagedViewSettings *view_settings,
+                                                      const ColorManagedDisplaySettings *display_settings,
+                                                      bool use_display_lut)
 {
 	ColormanageProcessor *cm_processor;
 	ColorManagedViewSettings default_view_settings;
@@ -2858,6 +3011,11 @@ ColormanageProcessor *IMB_colormanagement_display_processor_new(const ColorManag
 	                                                          applied_view_settings->gamma,
 	                                                          global_role_scene_linear);
 
+	if (use_display_lut && cm_processor->processor) {
+		cm_processor->display_lut = display_lut_acquire(cm_processor->processor, applied_view_settings,
+		                                                display_settings);
+	}
+
 	if (applied_view_settings->flag & COLORMANAGE_VIEW_USE_CURVES) {
 		cm_processor->curve_mapping = curvemapping_copy(applied_view_settings->curve_mapping);
 		curvemapping_premultiply(cm_processor->curve_mapping, false);
@@ -2866,6 +3024,12 @@ ColormanageProcessor *IMB_colormanagement_display_processor_new(const ColorManag
 	return cm_processor;
 }
 
+ColormanageProcessor *IMB_colormanagement_display_processor_new(const ColorManagedViewSettings *view_settings,
+                                                                const ColorManagedDisplaySettings *display_settings)
+{
+	return display_processor_new_ex(view_settings, display_settings, false);
+}
+
 ColormanageProcessor *IMB_colormanagement_colorspace_processor_new(const char *from_colorspace, const char *to_colorspace)
 {
 	ColormanageProcessor *cm_processor;
@@ -2886,7 +3050,9 @@ void IMB_colormanagement_processor_apply_v4(ColormanageProcessor *cm_processor,
 	if (cm_processor->curve_mapping)
 		curvemapping_evaluate_premulRGBF(cm_processor->curve_mapping, pixel, pixel);
 
-	if (cm_processor->processor)
+	if (cm_processor->display_lut)
+		BLI_color_lut_apply_v3(cm_processor->display_lut->lut, pixel);
+	else if (cm_processor->processor)
 		OCIO_processorApplyRGBA(cm_processor->processor, pixel);
 }
 
@@ -2895,7 +3061,9 @@ void IMB_colormanagement_processor_apply_v4_predivide(ColormanageProcessor *cm_p
 	if (cm_processor->curve_mapping)
 		curvemapping_evaluate_premulRGBF(cm_processor->curve_mapping, pixel, pixel);
 
-	if (cm_processor->processor)
+	if (cm_processor->display_lut)
+		BLI_color_lut_apply(cm_processor->display_lut->lut, pixel, 1, 4, true);
+	else if (cm_processor->processor)
 		OCIO_processorApplyRGBA_predivide(cm_processor->processor, pixel);
 }
 
@@ -2904,7 +3072,9 @@ void IMB_colormanagement_processor_apply_v3(ColormanageProcessor *cm_processor,
 	if (cm_processor->curve_mapping)
 		curvemapping_evaluate_premulRGBF(cm_processor->curve_mapping, pixel, pixel);
 
-	if (cm_processor->processor)
+	if (cm_processor->display_lut)
+		BLI_color_lut_apply_v3(cm_processor->display_lut->lut, pixel);
+	else if (cm_processor->processor)
 		OCIO_processorApplyRGB(cm_processor->processor, pixel);
 }
 
@@ -2942,7 +3112,11 @@ void IMB_colormanagement_processor_apply(ColormanageProcessor *cm_processor, flo
 		}
 	}
 
-	if (cm_processor->processor && channels >= 3) {
+	if (cm_processor->display_lut && channels >= 3) {
+		/* apply baked OCIO processor */
+		BLI_color_lut_apply(cm_processor->display_lut->lut, buffer, (size_t)width * height, channels, predivide);
+	}
+	else if (cm_processor->processor && channels >= 3) {
 		OCIO_PackedImageDesc *img;
 
 		/* apply OCIO processor */
@@ -2966,6 +3140,8 @@ void IMB_colormanagement_processor_free(ColormanageProcessor *cm_processor)
 		curvemapping_free(cm_processor->curve_mapping);
 	if (cm_processor->processor)
 		OCIO_processorRelease(cm_processor->processor);
+	if (cm_processor->display_lut)
+		display_lut_release(cm_processor->display_lut);
 
 	MEM_freeN(cm_processor);
 }
@@ -36,6 +36,11 @@
 #include "BLI_string.h"
 #include "BLI_fileops.h"
 #include "BLI_ghash.h"
+#include "BLI_gsqueue.h"
+#include "BLI_task.h"
+#include "BLI_threads.h"
+
+#include "PIL_time.h"
 
 #include "IMB_indexer.h"
 #include "IMB_anim.h"
@@ -441,6 +446,174 @@ typedef struct IndexBuildContext {
 	int anim_type;
 } IndexBuildContext;
 
+/* ----------------------------------------------------------------------
+ * - proxy encoding pipeline
+ * ---------------------------------------------------------------------- */
+
+#if defined(WITH_FFMPEG) || defined(WITH_AVI)
+
+/* The rebuilding thread decodes the source and hands every frame to the
+ * proxy outputs, which scale and encode it in tasks. There's at most one task
+ * per output at a time, so its frames are encoded in order, while different
+ * sizes and the decoding of the following frames happen in parallel.
+ *
+ * Tasks never wait for frames, they only encode what's queued for their
+ * output, so pipelines of several movies can share the task scheduler. */
+
+/* frames decoded ahead of the slowest output, bounds the memory used */
+#define PROXY_PIPELINE_MAX_PENDING 8
+
+typedef void (*ProxyEncodeFunc)(void *userdata, int proxy_index, void *frame);
+typedef void (*ProxyFrameFreeFunc)(void *frame);
+
+typedef struct ProxyPipelineFrame {
+	void *frame;
+	/* outputs which didn't encode the frame yet */
+	int users;
+} ProxyPipelineFrame;
+
+typedef struct ProxyPipelineOutput {
+	struct ProxyPipeline *pipeline;
+	int proxy_index;
+	GSQueue *frames;
+	bool running;
+} ProxyPipelineOutput;
+
+typedef struct ProxyPipeline {
+	TaskPool *pool;
+
+	/* protects the frame queues, running flags and pending count */
+	ThreadMutex lock;
+	/* notified when a frame has been encoded by all outputs */
+	ThreadCondition frame_done;
+	int pending;
+
+	void *userdata;
+	ProxyEncodeFunc encode;
+	ProxyFrameFreeFunc free_frame;
+
+	int num_outputs;
+	ProxyPipelineOutput outputs[IMB_PROXY_MAX_SLOT];
+} ProxyPipeline;
+
+/* proxy_sizes_in_use are the outputs frames are encoded for, encode is called with their index */
+static ProxyPipeline *proxy_pipeline_create(IMB_Proxy_Size proxy_sizes_in_use, void *userdata,
+                                            ProxyEncodeFunc encode, ProxyFrameFreeFunc free_frame)
+{
+	ProxyPipeline *pipeline = MEM_callocN(sizeof(ProxyPipeline), "proxy pipeline");
+	int i;
+
+	/* the rebuilding thread waits for frames to be encoded, so the tasks must also run with a single thread */
+	pipeline->pool = BLI_task_pool_create_background(BLI_task_scheduler_get(), pipeline);
+	BLI_mutex_init(&pipeline->lock);
+	BLI_condition_init(&pipeline->frame_done);
+
+	pipeline->userdata = userdata;
+	pipeline->encode = encode;
+	pipeline->free_frame = free_frame;
+
+	for (i = 0; i < IMB_PROXY_MAX_SLOT; i++) {
+		if (proxy_sizes_in_use & proxy_sizes[i]) {
+			ProxyPipelineOutput *output = &pipeline->outputs[pipeline->num_outputs++];
+
+			output->pipeline = pipeline;
+			output->proxy_index = i;
+			output->frames = BLI_gsqueue_new(sizeof(ProxyPipelineFrame *));
+		}
+	}
+
+	return pipeline;
+}
+
+static void proxy_pipeline_output_task(TaskPool *__restrict UNUSED(pool), void *taskdata, int UNUSED(threadid))
+{
+	ProxyPipelineOutput *output = taskdata;
+	ProxyPipeline *pipeline = output->pipeline;
+	ProxyPipelineFrame *frame;
+
+	BLI_mutex_lock(&pipeline->lock);
+
+	while (!BLI_gsqueue_is_empty(output->frames)) {
+		BLI_gsqueue_pop(output->frames, &frame);
+
+		BLI_mutex_unlock(&pipeline->lock);
+		pipeline->encode(pipeline->userdata, output->proxy_index, frame->frame);
+		BLI_mutex_lock(&pipeline->lock);
+
+		if (--frame->users == 0) {
+			pipeline->free_frame(frame->frame);
+			MEM_freeN(frame);
+
+			pipeline->pending--;
+			BLI_condition_notify_all(&pipeline->frame_done);
+		}
+	}
+
+	output->running = false;
+
+	BLI_mutex_unlock(&pipeline->lock);
+}
+
+/* Queue frame for all outputs, which takes ownership of it.
+ * Waits while too many frames are pending. */
+static void proxy_pipeline_push(ProxyPipeline *pipeline, void *frame_data)
+{
+	ProxyPipelineFrame *frame;
+	int i;
+
+	if (pipeline->num_outputs == 0) {
+		pipeline->free_frame(frame_data);
+		return;
+	}
+
+	frame = MEM_mallocN(sizeof(ProxyPipelineFrame), "proxy pipeline frame");
+	frame->frame = frame_data;
+	frame->users = pipeline->num_outputs;
+
+	BLI_mutex_lock(&pipeline->lock);
+
+	while (pipeline->pending >= PROXY_PIPELINE_MAX_PENDING) {
+		BLI_condition_wait(&pipeline->frame_done, &pipeline->lock);
+	}
+
+	pipeline->pending++;
+
+	for (i = 0; i < pipeline->num_outputs; i++) {
+		ProxyPipelineOutput *output = &pipeline->outputs[i];
+
+		BLI_gsqueue_push(output->frames, &frame);
+
+		if (!output->running) {
+			output->running = true;
+			BLI_task_pool_push(pipeline->pool, proxy_pipeline_output_task, output, false, TASK_PRIORITY_HIGH);
+		}
+	}
+
+	BLI_mutex_unlock(&pipeline->lock);
+}
+
+/* encodes the frames which are still queued and frees the pipeline */
+static void proxy_pipeline_finish(ProxyPipeline *pipeline)
+{
+	int i;
+
+	BLI_task_pool_work_and_wait(pipeline->pool);
+	BLI_task_pool_free(pipeline->pool);
+
+	BLI_assert(pipeline->pending == 0);
+
+	for (i = 0; i < pipeline->num_outputs; i++) {
+		BLI_gsqueue_free(pipeline->outputs[i].frames);
+	}
+
+	BLI_condition_end(&pipeline->frame_done);
+	BLI_mutex_end(&pipeline->lock);
+
+	MEM_freeN(pipeline);
+}
+
+#endif  /* WITH_FFMPEG || WITH_AVI */
+
 
 /* ----------------------------------------------------------------------
  * - ffmpeg rebuilder
@@ -709,6 +882,9 @@ typedef struct FFmpegIndexBuilderContext {
 	struct proxy_output_ctx *proxy_ctx[IMB_PROXY_MAX_SLOT];
 	anim_index_builder *indexer[IMB_TC_MAX_SLOT];
 
+	/* scales and encodes decoded frames for proxy_ctx while rebuilding */
+	ProxyPipeline *proxy_pipeline;
+
 	IMB_Timecode_Type tcs_in_use;
 	IMB_Proxy_Size proxy_sizes_in_use;
 
@@ -784,6 +960,10 @@ static IndexBuildContext *index_ffmpeg_create_context(struct anim *anim, IMB_Tim
 
 	context->iCodecCtx->workaround_bugs = 1;
 
+	/* decode on multiple threads, proxies are encoded in parallel to it */
+	context->iCodecCtx->thread_count = BLI_system_thread_count();
+	context->iCodecCtx->thread_type = FF_THREAD_FRAME | FF_THREAD_SLICE;
+
 	if (avcodec_open2(context->iCodecCtx, context->iCodec, NULL) < 0) {
 		avformat_close_input(&context->iFormatCtx);
 		MEM_freeN(context);
@@ -842,6 +1022,39 @@ static void index_rebuild_ffmpeg_finish(FFmpegIndexBuilderContext *context, int
 	MEM_freeN(context);
 }
 
+static void index_rebuild_ffmpeg_encode_frame(void *userdata, int proxy_index, void *frame)
+{
+	FFmpegIndexBuilderContext *context = userdata;
+
+	/* the frame is only modified when it's encoded without scaling, which happens for one size at most */
+	add_to_proxy_output_ffmpeg(context->proxy_ctx[proxy_index], frame);
+}
+
+static void index_rebuild_ffmpeg_free_frame(void *frame_v)
+{
+	AVFrame *frame = frame_v;
+
+	MEM_freeN(frame->data[0]);
+	av_free(frame);
+}
+
+/* the decoder reuses its frames, proxies are encoded from a copy */
+static AVFrame *index_rebuild_ffmpeg_copy_frame(FFmpegIndexBuilderContext *context, AVFrame *in_frame)
+{
+	AVCodecContext *codec_ctx = context->iCodecCtx;
+	AVFrame *frame = avcodec_alloc_frame();
+
+	avpicture_fill((AVPicture *) frame,
+	               MEM_mallocN(avpicture_get_size(codec_ctx->pix_fmt, codec_ctx->width, codec_ctx->height),
+	                           "proxy input frame"),
+	               codec_ctx->pix_fmt, codec_ctx->width, codec_ctx->height);
+
+	av_picture_copy((AVPicture *) frame, (const AVPicture *) in_frame,
+	                codec_ctx->pix_fmt, codec_ctx->width, codec_ctx->height);
+
+	return frame;
+}
+
 static void index_rebuild_ffmpeg_proc_decoded_frame(
 	FFmpegIndexBuilderContext *context, 
 	AVPacket * curr_packet,
@@ -852,8 +1065,8 @@ static void index_rebuild_ffmpeg_proc_decoded_frame(
 	unsigned long long s_dts = context->seek_pos_dts;
 	unsigned long long pts = av_get_pts_from_frame(context->iFormatCtx, in_frame);
 
-	for (i = 0; i < context->num_proxy_sizes; i++) {
-		add_to_proxy_output_ffmpeg(context->proxy_ctx[i], in_frame);
+	if (context->proxy_pipeline->num_outputs) {
+		proxy_pipeline_push(context->proxy_pipeline, index_rebuild_ffmpeg_copy_frame(context, in_frame));
 	}
 
 	if (!context->start_pts_set) {
@@ -902,11 +1115,23 @@ static int index_rebuild_ffmpeg(FFmpegIndexBuilderContext *context,
 	AVFrame *in_frame = 0;
 	AVPacket next_packet;
 	uint64_t stream_size;
+	IMB_Proxy_Size proxy_sizes_to_encode = IMB_PROXY_NONE;
+	int i;
 
 	memset(&next_packet, 0, sizeof(AVPacket));
 
 	in_frame = avcodec_alloc_frame();
 
+	for (i = 0; i < context->num_proxy_sizes; i++) {
+		if (context->proxy_ctx[i]) {
+			proxy_sizes_to_encode |= proxy_sizes[i];
+		}
+	}
+
+	context->proxy_pipeline = proxy_pipeline_create(proxy_sizes_to_encode, context,
+	                                                index_rebuild_ffmpeg_encode_frame,
+	                                                index_rebuild_ffmpeg_free_frame);
+
 	stream_size = avio_size(context->iFormatCtx->pb);
 
 	context->frame_rate = av_q2d(av_get_r_frame_rate_compat(context->iStream));
@@ -973,6 +1198,10 @@ static int index_rebuild_ffmpeg(FFmpegIndexBuilderContext *context,
 		} while (frame_finished);
 	}
 
+	/* also when stopped, so all outputs can be closed */
+	proxy_pipeline_finish(context->proxy_pipeline);
+	context->proxy_pipeline = NULL;
+
 	av_free(in_frame);
 
 	return 1;
@@ -1095,16 +1324,65 @@ static void index_rebuild_fallback_finish(FallbackIndexBuilderContext *context,
 	}
 }
 
+typedef struct FallbackProxyFrame {
+	struct ImBuf *ibuf;
+	int pos;
+} FallbackProxyFrame;
+
+static void index_rebuild_fallback_encode_frame(void *userdata, int proxy_index, void *frame_v)
+{
+	FallbackIndexBuilderContext *context = userdata;
+	FallbackProxyFrame *frame = frame_v;
+	struct anim *anim = context->anim;
+	int x = anim->x * proxy_fac[proxy_index];
+	int y = anim->y * proxy_fac[proxy_index];
+
+	struct ImBuf *s_ibuf = IMB_dupImBuf(frame->ibuf);
+
+	IMB_scalefastImBuf(s_ibuf, x, y);
+
+	IMB_convert_rgba_to_abgr(s_ibuf);
+
+	AVI_write_frame(context->proxy_ctx[proxy_index], frame->pos,
+	                AVI_FORMAT_RGB32,
+	                s_ibuf->rect, x * y * 4);
+
+	/* note that libavi free's the buffer... */
+	s_ibuf->rect = NULL;
+
+	IMB_freeImBuf(s_ibuf);
+}
+
+static void index_rebuild_fallback_free_frame(void *frame_v)
+{
+	FallbackProxyFrame *frame = frame_v;
+
+	IMB_freeImBuf(frame->ibuf);
+	MEM_freeN(frame);
+}
+
 static void index_rebuild_fallback(FallbackIndexBuilderContext *context,
                                    short *stop, short *do_update, float *progress)
 {
 	int cnt = IMB_anim_get_duration(context->anim, IMB_TC_NONE);
 	int i, pos;
 	struct anim *anim = context->anim;
+	IMB_Proxy_Size proxy_sizes_to_encode = IMB_PROXY_NONE;
+	ProxyPipeline *pipeline;
+
+	for (i = 0; i < IMB_PROXY_MAX_SLOT; i++) {
+		if ((context->proxy_sizes_in_use & proxy_sizes[i]) && context->proxy_ctx[i]) {
+			proxy_sizes_to_encode |= proxy_sizes[i];
+		}
+	}
+
+	pipeline = proxy_pipeline_create(proxy_sizes_to_encode, context,
+	                                 index_rebuild_fallback_encode_frame,
+	                                 index_rebuild_fallback_free_frame);
 
 	for (pos = 0; pos < cnt; pos++) {
 		struct ImBuf *ibuf = IMB_anim_absolute(anim, pos, IMB_TC_NONE, IMB_PROXY_NONE);
-		struct ImBuf *tmp_ibuf = IMB_dupImBuf(ibuf);
+		FallbackProxyFrame *frame;
 		float next_progress = (float) pos / (float) cnt;
 
 		if (*progress != next_progress) {
@@ -1113,36 +1391,22 @@ static void index_rebuild_fallback(FallbackIndexBuilderContext *context,
 		}
 		
 		if (*stop) {
+			IMB_freeImBuf(ibuf);
 			break;
 		}
 
-		IMB_flipy(tmp_ibuf);
-
-		for (i = 0; i < IMB_PROXY_MAX_SLOT; i++) {
-			if (context->proxy_sizes_in_use & proxy_sizes[i]) {
-				int x = anim->x * proxy_fac[i];
-				int y = anim->y * proxy_fac[i];
-
-				struct ImBuf *s_ibuf = IMB_dupImBuf(tmp_ibuf);
+		frame = MEM_mallocN(sizeof(FallbackProxyFrame), "fallback proxy frame");
+		frame->ibuf = IMB_dupImBuf(ibuf);
+		frame->pos = pos;
 
-				IMB_scalefastImBuf(s_ibuf, x, y);
-
-				IMB_convert_rgba_to_abgr(s_ibuf);
-	
-				AVI_write_frame(context->proxy_ctx[i], pos,
-				                AVI_FORMAT_RGB32,
-				                s_ibuf->rect, x * y * 4);
+		IMB_flipy(frame->ibuf);
 
-				/* note that libavi free's the buffer... */
-				s_ibuf->rect = NULL;
+		proxy_pipeline_push(pipeline, frame);
 
-				IMB_freeImBuf(s_ibuf);
-			}
-		}
-
-		IMB_freeImBuf(tmp_ibuf);
 		IMB_freeImBuf(ibuf);
 	}
+
+	proxy_pipeline_finish(pipeline);
 }
 
 #endif  /* WITH_AVI */
@@ -1241,6 +1505,103 @@ void IMB_anim_index_rebuild(struct IndexBuildContext *context,
 	UNUSED_VARS(stop, do_update, progress);
 }
 
+/* movies rebuilt at the same time by IMB_anim_index_rebuild_batch,
+ * each of them decodes and encodes on multiple threads already */
+#define INDEX_BATCH_MAX_THREADS 4
+
+typedef struct IndexBuildBatch {
+	IndexBuildContext **contexts;
+	int num_contexts;
+	short *stop;
+
+	/* progress of every context, written by the thread rebuilding it */
+	float *progress;
+
+	/* protects next and done */
+	ThreadMutex lock;
+	int next, done;
+} IndexBuildBatch;
+
+static void *index_rebuild_batch_thread(void *batch_v)
+{
+	IndexBuildBatch *batch = batch_v;
+
+	for (;;) {
+		short do_update;
+		int index;
+
+		BLI_mutex_lock(&batch->lock);
+		index = batch->next++;
+		BLI_mutex_unlock(&batch->lock);
+
+		if (index >= batch->num_contexts) {
+			break;
+		}
+
+		if (batch->contexts[index] && !*batch->stop) {
+			IMB_anim_index_rebuild(batch->contexts[index], batch->stop, &do_update, &batch->progress[index]);
+		}
+
+		BLI_mutex_lock(&batch->lock);
+		batch->progress[index] = 1.0f;
+		batch->done++;
+		BLI_mutex_unlock(&batch->lock);
+	}
+
+	return NULL;
+}
+
+void IMB_anim_index_rebuild_batch(IndexBuildContext **contexts, int num_contexts,
+                                  short *stop, short *do_update, float *progress)
+{
+	IndexBuildBatch batch = {NULL};
+	ListBase threads;
+	int num_threads = MIN3(num_contexts, BLI_system_thread_count(), INDEX_BATCH_MAX_THREADS);
+	int i, done = 0;
+
+	if (num_contexts == 0) {
+		return;
+	}
+
+	batch.contexts = contexts;
+	batch.num_contexts = num_contexts;
+	batch.stop = stop;
+	batch.progress = MEM_callocN(sizeof(float) * num_contexts, "index rebuild batch progress");
+	BLI_mutex_init(&batch.lock);
+
+	BLI_init_threads(&threads, index_rebuild_batch_thread, num_threads);
+
+	for (i = 0; i < num_threads; i++) {
+		BLI_insert_thread(&threads, &batch);
+	}
+
+	/* report the average progress until all movies are done */
+	while (done != num_contexts) {
+		float next_progress = 0.0f;
+
+		PIL_sleep_ms(50);
+
+		BLI_mutex_lock(&batch.lock);
+		done = batch.done;
+		BLI_mutex_unlock(&batch.lock);
+
+		for (i = 0; i < num_contexts; i++) {
+			next_progress += batch.progress[i];
+		}
+		next_progress /= num_contexts;
+
+		if (*progress != next_progress) {
+			*progress = next_progress;
+			*do_update = true;
+		}
+	}
+
+	BLI_end_threads(&threads);
+
+	BLI_mutex_end(&batch.lock);
+	MEM_freeN(batch.progress);
+}
+
 void IMB_anim_index_rebuild_finish(IndexBuildContext *context, short stop)
 {
 	switch (context->anim_type) {
@@ -1265,6 +1626,8 @@ void IMB_free_indices(struct anim *anim)
 {
 	int i;
 
+	imb_anim_readahead_clear(anim);
+
 	for (i = 0; i < IMB_PROXY_MAX_SLOT; i++) {
 		if (anim->proxy_anim[i]) {
 			IMB_close_anim(anim->proxy_anim[i]);
@@ -1312,6 +1675,9 @@ struct anim *IMB_anim_open_proxy(
 
 	/* proxies are generated in the same color space as animation itself */
 	anim->proxy_anim[i] = IMB_open_anim(fname, 0, 0, anim->colorspace);
+	if (anim->proxy_anim[i]) {
+		IMB_anim_set_readahead(anim->proxy_anim[i], anim->readahead);
+	}
 	
 	anim->proxies_tried |= preview_size;
 
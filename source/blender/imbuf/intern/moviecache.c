@@ -425,15 +425,18 @@ ImBuf *IMB_moviecache_get(MovieCache *cache, void *userkey)
 	item = (MovieCacheItem *)BLI_ghash_lookup(cache->hash, &key);
 
 	if (item) {
+		ImBuf *ibuf = NULL;
+
+		/* the limiter may free the buffer from another thread, reference it while it's locked */
+		BLI_mutex_lock(&limitor_lock);
 		if (item->ibuf) {
-			BLI_mutex_lock(&limitor_lock);
 			MEM_CacheLimiter_touch(item->c_handle);
-			BLI_mutex_unlock(&limitor_lock);
-
 			IMB_refImBuf(item->ibuf);
-
-			return item->ibuf;
+			ibuf = item->ibuf;
 		}
+		BLI_mutex_unlock(&limitor_lock);
+
+		return ibuf;
 	}
 
 	return NULL;
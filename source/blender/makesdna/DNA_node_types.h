@@ -347,7 +347,8 @@ typedef struct bNodeTree {
 	int update;						/* update flags */
 	short is_updating;				/* flag to prevent reentrant update calls */
 	short done;						/* generic temporary flag for recursion check (DFS/BFS) */
-	int pad2;
+	short progressive_divider;		/* compositor first pass at 1/divider resolution when editing, 0 disables */
+	short pad2;
 	
 	int nodetype DNA_DEPRECATED;	/* specific node type this tree is used for */
 
@@ -371,7 +372,7 @@ typedef struct bNodeTree {
 	 * in case multiple different editors are used and make context ambiguous.
 	 */
 	bNodeInstanceKey active_viewer_key;
-	int pad;
+	int cache_size;			/* compositor result cache limit in MB */
 	
 	/* execution data */
 	/* XXX It would be preferable to completely move this data out of the underlying node tree,
@@ -410,6 +411,7 @@ typedef struct bNodeTree {
 #define NTREE_COM_GROUPNODE_BUFFER	8	/* use groupnode buffers */
 #define NTREE_VIEWER_BORDER			16	/* use a border for viewer nodes */
 #define NTREE_IS_LOCALIZED			32	/* tree is localized copy, free when deleting node groups */
+#define NTREE_COM_RESULT_CACHE		64	/* keep compositor results between executions */
 
 /* XXX not nice, but needed as a temporary flags
  * for group updates after library linking.
@@ -99,6 +99,14 @@ static EnumPropertyItem node_chunksize_items[] = {
 	{NTREE_CHUNCKSIZE_1024, "1024",   0,    "1024x1024", "Chunksize of 1024x1024"},
 	{0, NULL, 0, NULL, NULL}
 };
+
+static EnumPropertyItem node_progressive_items[] = {
+	{0, "NONE",    0, "None",   "Only calculate at full resolution"},
+	{2, "HALF",    0, "1/2",    "First calculate at half resolution"},
+	{4, "QUARTER", 0, "1/4",    "First calculate at a quarter of the resolution"},
+	{8, "EIGHTH",  0, "1/8",    "First calculate at an eighth of the resolution"},
+	{0, NULL, 0, NULL, NULL}
+};
 #endif
 
 #define DEF_ICON_BLANK_SKIP
@@ -8169,10 +8177,28 @@ static void rna_def_composite_nodetree(BlenderRNA *brna)
 	RNA_def_property_ui_text(prop, "Two Pass", "Use two pass execution during editing: first calculate fast nodes, "
 	                                           "second pass calculate all nodes");
 
+	prop = RNA_def_property(srna, "progressive_preview", PROP_ENUM, PROP_NONE);
+	RNA_def_property_enum_sdna(prop, NULL, "progressive_divider");
+	RNA_def_property_enum_items(prop, node_progressive_items);
+	RNA_def_property_ui_text(prop, "Progressive Preview", "Resolution of a first pass during editing, "
+	                                                      "shown while the full resolution is calculated");
+
 	prop = RNA_def_property(srna, "use_viewer_border", PROP_BOOLEAN, PROP_NONE);
 	RNA_def_property_boolean_sdna(prop, NULL, "flag", NTREE_VIEWER_BORDER);
 	RNA_def_property_ui_text(prop, "Viewer Border", "Use boundaries for viewer nodes and composite backdrop");
 	RNA_def_property_update(prop, NC_NODE | ND_DISPLAY, "rna_NodeTree_update");
+
+	prop = RNA_def_property(srna, "use_result_cache", PROP_BOOLEAN, PROP_NONE);
+	RNA_def_property_boolean_sdna(prop, NULL, "flag", NTREE_COM_RESULT_CACHE);
+	RNA_def_property_ui_text(prop, "Result Cache", "Keep results of nodes between executions, "
+	                                               "only nodes affected by a change are calculated again");
+
+	prop = RNA_def_property(srna, "cache_size", PROP_INT, PROP_NONE);
+	RNA_def_property_int_sdna(prop, NULL, "cache_size");
+	RNA_def_property_range(prop, 0, 65536);
+	RNA_def_property_ui_range(prop, 64, 16384, 64, -1);
+	RNA_def_property_ui_text(prop, "Cache Size", "Memory budget in MB for the node results kept between executions, "
+	                                             "results are freed first to make room for the buffers of an execution");
 }
 
 static void rna_def_shader_nodetree(BlenderRNA *brna)
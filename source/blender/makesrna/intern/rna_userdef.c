@@ -115,6 +115,8 @@ EnumPropertyItem rna_enum_navigation_mode_items[] = {
 #include "MEM_guardedalloc.h"
 #include "MEM_CacheLimiterC-Api.h"
 
+#include "IMB_colormanagement.h"
+
 #include "UI_interface.h"
 
 #include "CCL_api.h"
@@ -233,6 +235,12 @@ static void rna_userdef_gl_use_16bit_textures(Main *bmain, Scene *scene, Pointer
 	rna_userdef_update(bmain, scene, ptr);
 }
 
+static void rna_userdef_display_lut_update(Main *bmain, Scene *scene, PointerRNA *ptr)
+{
+	IMB_colormanagement_display_lut_set(U.use_display_lut != 0);
+	rna_userdef_update(bmain, scene, ptr);
+}
+
 static void rna_userdef_undo_steps_set(PointerRNA *ptr, int value)
 {
 	UserDef *userdef = (UserDef *)ptr->data;
@@ -4141,6 +4149,13 @@ static void rna_def_userdef_system(BlenderRNA *brna)
 	RNA_def_property_ui_text(prop, "Image Draw Method", "Method used for displaying images on the screen");
 	RNA_def_property_update(prop, 0, "rna_userdef_update");
 
+	prop = RNA_def_property(srna, "use_display_lut", PROP_BOOLEAN, PROP_NONE);
+	RNA_def_property_boolean_sdna(prop, NULL, "use_display_lut", 1);
+	RNA_def_property_ui_text(prop, "Baked Display Transform",
+	                         "Approximate the color management display transform of images with a baked 3D LUT "
+	                         "(faster drawing, values above 64 are clamped)");
+	RNA_def_property_update(prop, 0, "rna_userdef_display_lut_update");
+
 	prop = RNA_def_property(srna, "anisotropic_filter", PROP_ENUM, PROP_NONE);
 	RNA_def_property_enum_sdna(prop, NULL, "anisotropic_filter");
 	RNA_def_property_enum_items(prop, anisotropic_items);
@@ -367,6 +367,7 @@ static int print_help(int UNUSED(argc), const char **UNUSED(argv), void *data)
 	printf("\n");
 	printf("Experimental features:\n");
 	BLI_argsPrintArgDoc(ba, "--enable-new-depsgraph");
+	BLI_argsPrintArgDoc(ba, "--enable-alloc-cache");
 
 	printf("Argument Parsing:\n");
 	printf("\tArguments must be separated by white space, eg:\n");
@@ -1066,6 +1067,12 @@ static int depsgraph_use_new(int UNUSED(argc), const char **UNUSED(argv), void *
 	return 0;
 }
 
+static int alloc_cache_use(int UNUSED(argc), const char **UNUSED(argv), void *UNUSED(data))
+{
+	/* Handled in main(), before any allocation happened. */
+	return 0;
+}
+
 static int set_verbosity(int argc, const char **argv, void *UNUSED(data))
 {
 	const char *arg_id = "--verbose";
@@ -1722,6 +1729,7 @@ static void setupArguments(bContext *C, bArgs *ba, SYS_SystemHandle *syshandle)
 	BLI_argsAdd(ba, 1, NULL, "--debug-gpumem", "\n\tEnable GPU memory stats in status bar", debug_mode_generic, (void *)G_DEBUG_GPU_MEM);
 
 	BLI_argsAdd(ba, 1, NULL, "--enable-new-depsgraph", "\n\tUse new dependency graph", depsgraph_use_new, NULL);
+	BLI_argsAdd(ba, 1, NULL, "--enable-alloc-cache", "\n\tKeep small memory blocks in per-thread caches (ignored with memory debugging)", alloc_cache_use, NULL);
 
 	BLI_argsAdd(ba, 1, NULL, "--verbose", "<verbose>\n\tSet logging verbosity level.", set_verbosity, NULL);
 
@@ -1840,19 +1848,29 @@ int main(
 	 *       guarded allocator before any allocation happened.
 	 */
 	{
+		bool use_guarded = false, use_small_cache = false;
 		int i;
 		for (i = 0; i < argc; i++) {
 			if (STREQ(argv[i], "--debug") || STREQ(argv[i], "-d") ||
 			    STREQ(argv[i], "--debug-memory") || STREQ(argv[i], "--debug-all"))
 			{
-				printf("Switching to fully guarded memory allocator.\n");
-				MEM_use_guarded_allocator();
-				break;
+				use_guarded = true;
+			}
+			else if (STREQ(argv[i], "--enable-alloc-cache")) {
+				use_small_cache = true;
 			}
 			else if (STREQ(argv[i], "--")) {
 				break;
 			}
 		}
+
+		if (use_guarded) {
+			printf("Switching to fully guarded memory allocator.\n");
+			MEM_use_guarded_allocator();
+		}
+		else if (use_small_cache) {
+			MEM_use_lockfree_small_cache();
+		}
 	}
 
 #ifdef BUILD_DATE
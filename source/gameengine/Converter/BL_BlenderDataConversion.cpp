@@ -1877,6 +1877,7 @@ static void bl_ConvertBlenderObject_Single(
 		//tf.Add(gameobj->GetSGNode());
 
 		gameobj->NodeUpdateGS(0);
+		kxscene->GetObjectGrid()->AddObject(gameobj);
 		gameobj->AddMeshUser();
 	}
 	else
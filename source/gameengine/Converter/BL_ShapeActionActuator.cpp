@@ -397,11 +397,12 @@ bool BL_ShapeActionActuator::Update(double curtime, bool frame)
 	
 	/* Set the property if its defined */
 	if (m_framepropname[0] != '\0') {
-		CValue* propowner = GetParent();
+		SCA_IObject* propowner = GetParent();
 		CValue* oldprop = propowner->GetProperty(m_framepropname);
 		CValue* newval = new CFloatValue(m_localtime);
 		if (oldprop) {
 			oldprop->SetValue(newval);
+			propowner->PropertyChanged();
 		} else {
 			propowner->SetProperty(m_framepropname, newval);
 		}
@@ -33,9 +33,9 @@
 #  pragma warning (disable:4786)
 #endif
 
-// Eigen3 stuff used for BGEDeformVerts
-#include <Eigen/Core>
-#include <Eigen/LU>
+#ifdef __SSE__
+#  include <xmmintrin.h>
+#endif
 
 #include "BL_SkinDeformer.h"
 #include "CTR_Map.h"
@@ -62,10 +62,18 @@ extern "C"{
 
 #include "BLI_blenlib.h"
 #include "BLI_math.h"
+#include "BLI_task.h"
 
 #define __NLA_DEFNORMALS
 //#undef __NLA_DEFNORMALS
 
+/* Meshes with at least this many vertices are skinned in parallel, in chunks of this size. */
+#ifdef DEBUG
+#  define BL_SKIN_THREAD_CHUNK 64
+#else
+#  define BL_SKIN_THREAD_CHUNK 2048
+#endif
+
 static short get_deformflags(struct Object *bmeshobj)
 {
 	short flags = ARM_DEF_VGROUP;
@@ -96,7 +104,7 @@ BL_SkinDeformer::BL_SkinDeformer(BL_DeformableGameObject *gameobj,
 							m_poseApplied(false),
 							m_recalcNormal(true),
 							m_copyNormals(false),
-							m_dfnrToPC(NULL)
+							m_skinBuilt(false)
 {
 	copy_m4_m4(m_obmat, bmeshobj->obmat);
 	m_deformflags = get_deformflags(bmeshobj);
@@ -117,7 +125,7 @@ BL_SkinDeformer::BL_SkinDeformer(
 		m_releaseobject(release_object),
 		m_recalcNormal(recalc_normal),
 		m_copyNormals(false),
-		m_dfnrToPC(NULL)
+		m_skinBuilt(false)
 	{
 		// this is needed to ensure correct deformation of mesh:
 		// the deformation is done with Blender's armature_deform_verts() function
@@ -132,8 +140,6 @@ BL_SkinDeformer::~BL_SkinDeformer()
 {
 	if (m_releaseobject && m_armobj)
 		m_armobj->Release();
-	if (m_dfnrToPC)
-		delete [] m_dfnrToPC;
 }
 
 void BL_SkinDeformer::Relink(CTR_Map<class CTR_HashedPtr, void*>*map)
@@ -145,6 +151,7 @@ void BL_SkinDeformer::Relink(CTR_Map<class CTR_HashedPtr, void*>*map)
 			m_armobj = (BL_ArmatureObject*)(*h_obj);
 		else
 			m_armobj=NULL;
+		m_skinBuilt = false;
 	}
 
 	BL_MeshDeformer::Relink(map);
@@ -171,7 +178,8 @@ void BL_SkinDeformer::ProcessReplica()
 	BL_MeshDeformer::ProcessReplica();
 	m_lastArmaUpdate = -1;
 	m_releaseobject = false;
-	m_dfnrToPC = NULL;
+	/* channels belong to the pose of the replica armature, see Relink() */
+	m_skinBuilt = false;
 }
 
 void BL_SkinDeformer::BlenderDeformVerts()
@@ -195,97 +203,153 @@ void BL_SkinDeformer::BlenderDeformVerts()
 #endif
 }
 
-void BL_SkinDeformer::BGEDeformVerts()
+void BL_SkinDeformer::BuildSkinWeights(Object *par_arma)
 {
-	Object *par_arma = m_armobj->GetArmatureObject();
-	MDeformVert *dverts = m_bmesh->dvert;
+	MDeformVert *dv = m_bmesh->dvert;
+	const int defbase_tot = BLI_listbase_count(&m_objMesh->defbase);
+	std::vector<int> dfnr_to_channel(defbase_tot, -1);
 	bDeformGroup *dg;
-	int defbase_tot;
-	Eigen::Matrix4f pre_mat, post_mat, chan_mat, norm_chan_mat;
-
-	if (!dverts)
-		return;
+	int i;
 
-	defbase_tot = BLI_listbase_count(&m_objMesh->defbase);
+	m_skinBuilt = true;
+	m_skinChannels.clear();
+	m_skinOffsets.resize(m_bmesh->totvert + 1);
+	m_skinNormalChannels.resize(m_bmesh->totvert);
+	m_skinWeights.clear();
 
-	if (m_dfnrToPC == NULL)
-	{
-		m_dfnrToPC = new bPoseChannel*[defbase_tot];
-		int i;
-		for (i=0, dg=(bDeformGroup*)m_objMesh->defbase.first;
-			dg;
-			++i, dg = dg->next)
-		{
-			m_dfnrToPC[i] = BKE_pose_channel_find_name(par_arma->pose, dg->name);
+	for (i = 0, dg = (bDeformGroup *)m_objMesh->defbase.first; dg; ++i, dg = dg->next) {
+		bPoseChannel *pchan = BKE_pose_channel_find_name(par_arma->pose, dg->name);
 
-			if (m_dfnrToPC[i] && m_dfnrToPC[i]->bone->flag & BONE_NO_DEFORM)
-				m_dfnrToPC[i] = NULL;
+		if (pchan && !(pchan->bone->flag & BONE_NO_DEFORM)) {
+			dfnr_to_channel[i] = m_skinChannels.size();
+			m_skinChannels.push_back(pchan);
 		}
 	}
 
-	post_mat = Eigen::Matrix4f::Map((float*)m_obmat).inverse() * Eigen::Matrix4f::Map((float*)m_armobj->GetArmatureObject()->obmat);
-	pre_mat = post_mat.inverse();
+	for (i = 0; i < m_bmesh->totvert; ++i, dv++) {
+		const unsigned int first = m_skinWeights.size();
+		float contrib = 0.0f, max_weight = -1.0f;
+		MDeformWeight *dw = dv->dw;
 
-	MDeformVert *dv= dverts;
-	MDeformWeight *dw;
+		m_skinOffsets[i] = first;
+		m_skinNormalChannels[i] = -1;
 
-	for (int i=0; i<m_bmesh->totvert; ++i, dv++)
-	{
-		float contrib = 0.f, weight, max_weight=-1.f;
-		bPoseChannel *pchan=NULL;
-		Eigen::Map<Eigen::Vector3f> norm = Eigen::Vector3f::Map(m_transnors[i]);
-		Eigen::Vector4f vec(0, 0, 0, 1);
-		Eigen::Vector4f co(m_transverts[i][0],
-							m_transverts[i][1],
-							m_transverts[i][2],
-							1.f);
-
-		if (!dv->totweight)
-			continue;
+		for (unsigned int j = dv->totweight; j != 0; j--, dw++) {
+			const int channel = (dw->def_nr < defbase_tot) ? dfnr_to_channel[dw->def_nr] : -1;
 
-		co = pre_mat * co;
+			if (channel != -1 && dw->weight) {
+				SkinWeight weight = {channel, dw->weight};
+				m_skinWeights.push_back(weight);
 
-		dw= dv->dw;
+				// Save the most influential channel so we can use it to update the vertex normal
+				if (dw->weight > max_weight) {
+					max_weight = dw->weight;
+					m_skinNormalChannels[i] = channel;
+				}
+				contrib += dw->weight;
+			}
+		}
 
-		for (unsigned int j= dv->totweight; j != 0; j--, dw++)
-		{
-			const int index = dw->def_nr;
+		if (contrib == 0.0f) {
+			/* Not deformed, leave the vertex as is. */
+			m_skinWeights.resize(first);
+			m_skinNormalChannels[i] = -1;
+		}
+		else {
+			for (unsigned int j = first; j < m_skinWeights.size(); j++) {
+				m_skinWeights[j].m_weight /= contrib;
+			}
+		}
+	}
+	m_skinOffsets[m_bmesh->totvert] = m_skinWeights.size();
+	m_skinMatrices.resize(m_skinChannels.size() * 16);
+}
 
-			if (index < defbase_tot && (pchan=m_dfnrToPC[index]))
-			{
-				weight = dw->weight;
+void BL_SkinDeformer::BGEDeformVertsRange(int start, int end)
+{
+	const float (*mats)[4][4] = (const float (*)[4][4])&m_skinMatrices[0];
+	const SkinWeight *weights = &m_skinWeights[0];
+
+	for (int i = start; i < end; ++i) {
+		const unsigned int first = m_skinOffsets[i], last = m_skinOffsets[i + 1];
+		float *co = m_transverts[i];
 
-				if (weight)
-				{
-					chan_mat = Eigen::Matrix4f::Map((float*)pchan->chan_mat);
+		if (first == last)
+			continue;
 
-					// Update Vertex Position
-					vec.noalias() += (chan_mat*co - co)*weight;
+		/* The weights are normalized, blending the matrices gives the same
+		 * result as blending the deformed positions. */
+#ifdef __SSE__
+		__m128 col0 = _mm_setzero_ps(), col1 = _mm_setzero_ps();
+		__m128 col2 = _mm_setzero_ps(), col3 = _mm_setzero_ps();
 
-					// Save the most influential channel so we can use it to update the vertex normal
-					if (weight > max_weight)
-					{
-						max_weight = weight;
-						norm_chan_mat = chan_mat;
-					}
+		for (unsigned int j = first; j < last; j++) {
+			const float *mat = &mats[weights[j].m_channel][0][0];
+			const __m128 weight = _mm_set1_ps(weights[j].m_weight);
 
-					contrib += weight;
-				}
+			col0 = _mm_add_ps(col0, _mm_mul_ps(weight, _mm_loadu_ps(mat)));
+			col1 = _mm_add_ps(col1, _mm_mul_ps(weight, _mm_loadu_ps(mat + 4)));
+			col2 = _mm_add_ps(col2, _mm_mul_ps(weight, _mm_loadu_ps(mat + 8)));
+			col3 = _mm_add_ps(col3, _mm_mul_ps(weight, _mm_loadu_ps(mat + 12)));
+		}
+
+		float result[4];
+		_mm_storeu_ps(result, _mm_add_ps(_mm_add_ps(_mm_mul_ps(col0, _mm_set1_ps(co[0])),
+		                                            _mm_mul_ps(col1, _mm_set1_ps(co[1]))),
+		                                 _mm_add_ps(_mm_mul_ps(col2, _mm_set1_ps(co[2])), col3)));
+		copy_v3_v3(co, result);
+#else
+		float blend[4][4];
+
+		zero_m4(blend);
+		for (unsigned int j = first; j < last; j++) {
+			const float *mat = &mats[weights[j].m_channel][0][0];
+			for (int k = 0; k < 16; k++) {
+				(&blend[0][0])[k] += mat[k] * weights[j].m_weight;
 			}
 		}
-		
+		mul_m4_v3(blend, co);
+#endif
+
 		// Update Vertex Normal
-		norm = norm_chan_mat.topLeftCorner<3, 3>()*norm;
+		mul_mat3_m4_v3(m_skinChannels[m_skinNormalChannels[i]]->chan_mat, m_transnors[i]);
+	}
+}
 
-		co.noalias() += vec/contrib;
-		co[3] = 1.f; // Make sure we have a 1 for the w component!
+void BL_SkinDeformer::BGEDeformVertsChunk(void *userdata, const int chunk)
+{
+	BL_SkinDeformer *deformer = (BL_SkinDeformer *)userdata;
+	const int start = chunk * BL_SKIN_THREAD_CHUNK;
 
-		co = post_mat * co;
+	deformer->BGEDeformVertsRange(start, min_ii(start + BL_SKIN_THREAD_CHUNK, deformer->m_bmesh->totvert));
+}
 
-		m_transverts[i][0] = co[0];
-		m_transverts[i][1] = co[1];
-		m_transverts[i][2] = co[2];
+void BL_SkinDeformer::BGEDeformVerts()
+{
+	Object *par_arma = m_armobj->GetArmatureObject();
+	float imat[4][4], pre_mat[4][4], post_mat[4][4];
+
+	if (!m_bmesh->dvert)
+		return;
+
+	if (!m_skinBuilt)
+		BuildSkinWeights(par_arma);
+
+	if (m_skinChannels.empty())
+		return;
+
+	invert_m4_m4(imat, m_obmat);
+	mul_m4_m4m4(post_mat, imat, par_arma->obmat);
+	invert_m4_m4(pre_mat, post_mat);
+
+	for (unsigned int i = 0; i < m_skinChannels.size(); i++) {
+		mul_m4_series((float (*)[4])&m_skinMatrices[i * 16], post_mat, m_skinChannels[i]->chan_mat, pre_mat);
 	}
+
+	/* Small meshes are skinned in the calling animation task only. */
+	BLI_task_parallel_range(0, (m_bmesh->totvert + BL_SKIN_THREAD_CHUNK - 1) / BL_SKIN_THREAD_CHUNK, this,
+	                        BGEDeformVertsChunk, m_bmesh->totvert >= BL_SKIN_THREAD_CHUNK * 2);
+
 	m_copyNormals = true;
 }
 
@@ -376,4 +440,5 @@ void BL_SkinDeformer::SetArmature(BL_ArmatureObject *armobj)
 {
 	// only used to set the object now
 	m_armobj = armobj;
+	m_skinBuilt = false;
 }
@@ -47,6 +47,8 @@
 
 #include "RAS_Deformer.h"
 
+#include <vector>
+
 
 class BL_SkinDeformer : public BL_MeshDeformer  
 {
@@ -108,11 +110,27 @@ protected:
 	bool					m_poseApplied;
 	bool					m_recalcNormal;
 	bool					m_copyNormals; // dirty flag so we know if Apply() needs to copy normal information (used for BGEDeformVerts())
-	struct bPoseChannel**	m_dfnrToPC;
+	bool					m_skinBuilt; // the weight table below matches the current armature, may have no channels
 	short					m_deformflags;
 
+	/* Compact weight table for BGEDeformVerts(), built on first use. Weights of
+	 * vertex i are m_skinWeights[m_skinOffsets[i] .. m_skinOffsets[i + 1]], normalized
+	 * and only referencing deforming channels, in m_skinChannels order. */
+	struct SkinWeight {
+		int m_channel;
+		float m_weight;
+	};
+	std::vector<unsigned int>			m_skinOffsets;
+	std::vector<SkinWeight>				m_skinWeights;
+	std::vector<int>					m_skinNormalChannels;	// most influential channel, rotates the normal
+	std::vector<struct bPoseChannel *>	m_skinChannels;
+	std::vector<float>					m_skinMatrices;	// per channel 4x4, reference space deform matrix
+
 	void BlenderDeformVerts();
+	void BuildSkinWeights(struct Object *par_arma);
 	void BGEDeformVerts();
+	void BGEDeformVertsRange(int start, int end);
+	static void BGEDeformVertsChunk(void *userdata, const int chunk);
 
 	void UpdateTransverts();
 
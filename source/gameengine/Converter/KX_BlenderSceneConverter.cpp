@@ -114,8 +114,33 @@ extern "C" {
 typedef struct ThreadInfo {
 	TaskPool *m_pool;
 	ThreadMutex m_mutex;
+	/* The converter lookups are shared by all conversions, scenes are converted
+	 * one at a time and the main thread locks it to merge or free converted data. */
+	ThreadMutex m_convertmutex;
 } ThreadInfo;
 
+/* Asynchronous library load: read, linked and converted in a task of the
+ * converter pool, then merged by the main thread over several frames. */
+typedef struct AsyncLibLoad {
+	BlendHandle *m_openlib; /* NULL when the task reads the file */
+	void *m_blenddata; /* copy of the memory m_openlib reads from, freed once linked */
+	STR_String m_path;
+	Main *m_maggie;
+	int m_idcode;
+	short m_options;
+	/* converted scenes, merged one after the other */
+	vector<KX_Scene *> m_scenes;
+	unsigned int m_scene;
+	unsigned int m_numobjects;
+	bool m_merging;
+	bool m_registered;
+} AsyncLibLoad;
+
+/* Time per frame spent merging asynchronously loaded objects, in seconds */
+#define LIB_LOAD_MERGE_TIME 0.002
+/* Objects merged between two time checks */
+#define LIB_LOAD_MERGE_OBJECTS 16
+
 KX_BlenderSceneConverter::KX_BlenderSceneConverter(
 							Main *maggie,
 							KX_KetsjiEngine *engine)
@@ -131,6 +156,7 @@ KX_BlenderSceneConverter::KX_BlenderSceneConverter(
 	m_threadinfo = new ThreadInfo();
 	m_threadinfo->m_pool = BLI_task_pool_create(engine->GetTaskScheduler(), NULL);
 	BLI_mutex_init(&m_threadinfo->m_mutex);
+	BLI_mutex_init(&m_threadinfo->m_convertmutex);
 }
 
 KX_BlenderSceneConverter::~KX_BlenderSceneConverter()
@@ -187,6 +213,7 @@ KX_BlenderSceneConverter::~KX_BlenderSceneConverter()
 		in the scene converter destructor. */
 		BLI_task_pool_free(m_threadinfo->m_pool);
 		BLI_mutex_end(&m_threadinfo->m_mutex);
+		BLI_mutex_end(&m_threadinfo->m_convertmutex);
 		delete m_threadinfo;
 	}
 }
@@ -232,6 +259,9 @@ void KX_BlenderSceneConverter::ConvertScene(KX_Scene *destinationscene, RAS_IRas
 	PHY_IPhysicsEnvironment *phy_env = NULL;
 
 	e_PhysicsEngine physics_engine = UseBullet;
+
+	BLI_mutex_lock(&m_threadinfo->m_convertmutex);
+
 	// hook for registration function during conversion.
 	m_currentScene = destinationscene;
 	destinationscene->SetSceneConverter(this);
@@ -285,6 +315,8 @@ void KX_BlenderSceneConverter::ConvertScene(KX_Scene *destinationscene, RAS_IRas
 	//This cache mecanism is buggy so I leave it disable and the memory leak
 	//that would result from this is fixed in RemoveScene()
 	m_map_mesh_to_gamemesh.clear();
+
+	BLI_mutex_unlock(&m_threadinfo->m_convertmutex);
 }
 
 // This function removes all entities stored in the converter for that scene
@@ -296,6 +328,17 @@ void KX_BlenderSceneConverter::ConvertScene(KX_Scene *destinationscene, RAS_IRas
 void KX_BlenderSceneConverter::RemoveScene(KX_Scene *scene)
 {
 	int i, size;
+
+	// libraries still merging into the scene are finished first
+	for (map<char *, KX_LibLoadStatus *>::iterator it = m_status_map.begin(); it != m_status_map.end(); ++it) {
+		if (!it->second->IsFinished() && it->second->GetMergeScene() == scene) {
+			FinalizeAsyncLoads();
+			break;
+		}
+	}
+
+	BLI_mutex_lock(&m_threadinfo->m_convertmutex);
+
 	// delete the scene first as it will stop the use of entities
 	delete scene;
 	// delete the entities of this scene
@@ -364,6 +407,8 @@ void KX_BlenderSceneConverter::RemoveScene(KX_Scene *scene)
 			meshit++;
 		}
 	}
+
+	BLI_mutex_unlock(&m_threadinfo->m_convertmutex);
 }
 
 // use blender materials
@@ -781,30 +826,7 @@ Main *KX_BlenderSceneConverter::GetMainDynamicPath(const char *path)
 
 void KX_BlenderSceneConverter::MergeAsyncLoads()
 {
-	vector<KX_Scene *> *merge_scenes;
-
-	vector<KX_LibLoadStatus *>::iterator mit;
-	vector<KX_Scene *>::iterator sit;
-
-	BLI_mutex_lock(&m_threadinfo->m_mutex);
-
-	for (mit = m_mergequeue.begin(); mit != m_mergequeue.end(); ++mit) {
-		merge_scenes = (vector<KX_Scene *> *)(*mit)->GetData();
-
-		for (sit=merge_scenes->begin(); sit!=merge_scenes->end(); ++sit) {
-			(*mit)->GetMergeScene()->MergeScene(*sit);
-			delete (*sit);
-		}
-
-		delete merge_scenes;
-		(*mit)->SetData(NULL);
-
-		(*mit)->Finish();
-	}
-
-	m_mergequeue.clear();
-
-	BLI_mutex_unlock(&m_threadinfo->m_mutex);
+	MergeLibLoads(LIB_LOAD_MERGE_TIME);
 }
 
 void KX_BlenderSceneConverter::FinalizeAsyncLoads()
@@ -814,7 +836,7 @@ void KX_BlenderSceneConverter::FinalizeAsyncLoads()
 		BLI_task_pool_work_and_wait(m_threadinfo->m_pool);
 	}
 	// Merge all libraries data in the current scene, to avoid memory leak of unmerged scenes.
-	MergeAsyncLoads();
+	MergeLibLoads(-1.0);
 }
 
 void KX_BlenderSceneConverter::AddScenesToMergeQueue(KX_LibLoadStatus *status)
@@ -824,42 +846,105 @@ void KX_BlenderSceneConverter::AddScenesToMergeQueue(KX_LibLoadStatus *status)
 	BLI_mutex_unlock(&m_threadinfo->m_mutex);
 }
 
-static void async_convert(TaskPool *pool, void *ptr, int UNUSED(threadid))
+void KX_BlenderSceneConverter::MergeLibLoads(double budget)
 {
-	KX_Scene *new_scene = NULL;
-	KX_LibLoadStatus *status = (KX_LibLoadStatus *)ptr;
-	vector<Scene *> *scenes = (vector<Scene *> *)status->GetData();
-	vector<KX_Scene *> *merge_scenes = new vector<KX_Scene *>(); // Deleted in MergeAsyncLoads
+	BLI_mutex_lock(&m_threadinfo->m_mutex);
+	m_libloads.insert(m_libloads.end(), m_mergequeue.begin(), m_mergequeue.end());
+	m_mergequeue.clear();
+	BLI_mutex_unlock(&m_threadinfo->m_mutex);
 
-	for (unsigned int i = 0; i < scenes->size(); ++i) {
-		new_scene = status->GetEngine()->CreateScene((*scenes)[i], true);
+	const double endtime = (budget < 0.0) ? -1.0 : PIL_check_seconds_timer() + budget;
 
-		if (new_scene)
-			merge_scenes->push_back(new_scene);
+	// Libraries are merged in the order they finished loading.
+	while (!m_libloads.empty()) {
+		KX_LibLoadStatus *status = m_libloads.front();
 
-		status->AddProgress((1.0f / scenes->size()) * 0.9f); // We'll call conversion 90% and merging 10% for now
-	}
+		// Don't wait for a loading thread converting a scene during a frame.
+		if (budget < 0.0) {
+			BLI_mutex_lock(&m_threadinfo->m_convertmutex);
+		}
+		else if (!BLI_mutex_trylock(&m_threadinfo->m_convertmutex)) {
+			break;
+		}
 
-	delete scenes;
-	status->SetData(merge_scenes);
+		const bool finished = MergeLibLoad(status, endtime);
 
-	status->GetConverter()->AddScenesToMergeQueue(status);
-}
+		BLI_mutex_unlock(&m_threadinfo->m_convertmutex);
 
-KX_LibLoadStatus *KX_BlenderSceneConverter::LinkBlendFileMemory(void *data, int length, const char *path, char *group, KX_Scene *scene_merge, char **err_str, short options)
-{
-	BlendHandle *bpy_openlib = BLO_blendhandle_from_memory(data, length);
+		if (!finished) {
+			break;
+		}
 
-	// Error checking is done in LinkBlendFile
-	return LinkBlendFile(bpy_openlib, path, group, scene_merge, err_str, options);
+		m_libloads.erase(m_libloads.begin());
+		// The callbacks may load libraries, run them unlocked.
+		status->Finish();
+	}
+
+	// Progress callbacks are only run here, in the main thread.
+	for (map<char *, KX_LibLoadStatus *>::iterator it = m_status_map.begin(); it != m_status_map.end(); ++it) {
+		if (!it->second->IsFinished()) {
+			it->second->RunProgressCallback();
+		}
+	}
 }
 
-KX_LibLoadStatus *KX_BlenderSceneConverter::LinkBlendFilePath(const char *filepath, char *group, KX_Scene *scene_merge, char **err_str, short options)
+bool KX_BlenderSceneConverter::MergeLibLoad(KX_LibLoadStatus *status, double endtime)
 {
-	BlendHandle *bpy_openlib = BLO_blendhandle_from_file(filepath, NULL);
+	AsyncLibLoad *libload = (AsyncLibLoad *)status->GetData();
+	KX_Scene *scene_merge = status->GetMergeScene();
+
+	if (!libload->m_registered) {
+		/* needed for lookups*/
+		GetMainDynamic().push_back(libload->m_maggie);
+		MergeLibraryData(libload->m_maggie, scene_merge, libload->m_idcode, libload->m_options);
+		libload->m_registered = true;
+	}
 
-	// Error checking is done in LinkBlendFile
-	return LinkBlendFile(bpy_openlib, filepath, group, scene_merge, err_str, options);
+	const unsigned int numscenes = libload->m_scenes.size();
+
+	while (libload->m_scene < numscenes) {
+		KX_Scene *other = libload->m_scenes[libload->m_scene];
+
+		if (!libload->m_merging) {
+			if (!scene_merge->MergeSceneBegin(other)) {
+				delete other;
+				libload->m_scene++;
+				continue;
+			}
+
+			libload->m_numobjects = other->GetObjectList()->GetCount();
+			libload->m_merging = true;
+		}
+
+		/* objects are published by whole hierarchies, until the frame time is spent */
+		unsigned int numleft;
+		do {
+			numleft = scene_merge->MergeSceneObjects(other, LIB_LOAD_MERGE_OBJECTS);
+		} while (numleft > 0 && (endtime < 0.0 || PIL_check_seconds_timer() < endtime));
+
+		const float merged = (libload->m_numobjects) ? 1.0f - (float)numleft / libload->m_numobjects : 1.0f;
+		status->SetProgress(0.8f + 0.2f * (libload->m_scene + merged) / numscenes);
+
+		if (numleft > 0) {
+			return false;
+		}
+
+		scene_merge->MergeSceneEnd(other);
+		// RemoveScene(other); // Don't run this, it frees the entire scene converter data, just delete the scene
+		delete other;
+
+		libload->m_merging = false;
+		libload->m_scene++;
+
+		if (endtime >= 0.0 && PIL_check_seconds_timer() >= endtime && libload->m_scene < numscenes) {
+			return false;
+		}
+	}
+
+	delete libload;
+	status->SetData(NULL);
+
+	return true;
 }
 
 static void load_datablocks(Main *main_tmp, BlendHandle *bpy_openlib, const char *path, int idcode)
@@ -879,75 +964,117 @@ static void load_datablocks(Main *main_tmp, BlendHandle *bpy_openlib, const char
 	BLI_linklist_free(names, free);	/* free linklist *and* each node's data */
 }
 
-KX_LibLoadStatus *KX_BlenderSceneConverter::LinkBlendFile(BlendHandle *bpy_openlib, const char *path, char *group, KX_Scene *scene_merge, char **err_str, short options)
+/* Link all the datablocks of a type into a new main and close the blend file,
+ * only touches the new main so it can run in a loading thread. */
+static void link_blend_file(Main *main_newlib, BlendHandle *bpy_openlib, const char *path, int idcode, short options)
 {
-	Main *main_newlib; /* stored as a dynamic 'main' until we free it */
-	const int idcode = BKE_idcode_from_name(group);
-	ReportList reports;
-	static char err_local[255];
-
-//	TIMEIT_START(bge_link_blend_file);
-
-	KX_LibLoadStatus *status;
-
-	/* only scene and mesh supported right now */
-	if (idcode != ID_SCE && idcode != ID_ME && idcode != ID_AC) {
-		snprintf(err_local, sizeof(err_local), "invalid ID type given \"%s\"\n", group);
-		*err_str = err_local;
-		BLO_blendhandle_close(bpy_openlib);
-		return NULL;
-	}
-	
-	if (GetMainDynamicPath(path)) {
-		snprintf(err_local, sizeof(err_local), "blend file already open \"%s\"\n", path);
-		*err_str = err_local;
-		BLO_blendhandle_close(bpy_openlib);
-		return NULL;
-	}
-
-	if (bpy_openlib == NULL) {
-		snprintf(err_local, sizeof(err_local), "could not open blendfile \"%s\"\n", path);
-		*err_str = err_local;
-		return NULL;
-	}
-
-	main_newlib = BKE_main_new();
-	BKE_reports_init(&reports, RPT_STORE);
-
 	short flag = 0; /* don't need any special options */
 	/* created only for linking, then freed */
 	Main *main_tmp = BLO_library_link_begin(main_newlib, &bpy_openlib, (char *)path);
 
 	load_datablocks(main_tmp, bpy_openlib, path, idcode);
 
-	if (idcode == ID_SCE && options & LIB_LOAD_LOAD_SCRIPTS) {
+	if (idcode == ID_SCE && options & KX_BlenderSceneConverter::LIB_LOAD_LOAD_SCRIPTS) {
 		load_datablocks(main_tmp, bpy_openlib, path, ID_TXT);
 	}
 
 	/* now do another round of linking for Scenes so all actions are properly loaded */
-	if (idcode == ID_SCE && options & LIB_LOAD_LOAD_ACTIONS) {
+	if (idcode == ID_SCE && options & KX_BlenderSceneConverter::LIB_LOAD_LOAD_ACTIONS) {
 		load_datablocks(main_tmp, bpy_openlib, path, ID_AC);
 	}
 
 	BLO_library_link_end(main_tmp, &bpy_openlib, flag, NULL, NULL);
 
 	BLO_blendhandle_close(bpy_openlib);
+}
 
-	BKE_reports_clear(&reports);
-	/* done linking */
-	
-	/* needed for lookups*/
-	GetMainDynamic().push_back(main_newlib);
-	BLI_strncpy(main_newlib->name, path, sizeof(main_newlib->name));
-	
-	
-	status = new KX_LibLoadStatus(this, m_ketsjiEngine, scene_merge, path);
+static void async_libload(TaskPool *pool, void *ptr, int UNUSED(threadid))
+{
+	KX_LibLoadStatus *status = (KX_LibLoadStatus *)ptr;
+	AsyncLibLoad *libload = (AsyncLibLoad *)status->GetData();
+	const char *path = libload->m_path.ReadPtr();
+
+	if (libload->m_openlib == NULL) {
+		libload->m_openlib = BLO_blendhandle_from_file(path, NULL);
+	}
+
+	if (libload->m_openlib) {
+		link_blend_file(libload->m_maggie, libload->m_openlib, path, libload->m_idcode, libload->m_options);
+		libload->m_openlib = NULL;
 
+		if (libload->m_blenddata) {
+			MEM_freeN(libload->m_blenddata);
+			libload->m_blenddata = NULL;
+		}
+	}
+	else {
+		// The library stays empty, it's still registered to be freed by the user.
+		printf("could not open blendfile \"%s\"\n", path);
+	}
+
+	status->SetProgress(0.2f);
+
+	if (libload->m_idcode == ID_SCE) {
+		const int numscenes = BLI_listbase_count(&libload->m_maggie->scene);
+
+		for (ID *scene = (ID *)libload->m_maggie->scene.first; scene; scene = (ID *)scene->next) {
+			if (libload->m_options & KX_BlenderSceneConverter::LIB_LOAD_VERBOSE)
+				printf("SceneName: %s\n", scene->name + 2);
+
+			// Deleted by the main thread once merged, see MergeLibLoad().
+			KX_Scene *new_scene = status->GetEngine()->CreateScene((Scene *)scene, true);
+
+			if (new_scene)
+				libload->m_scenes.push_back(new_scene);
+
+			status->AddProgress(0.6f / numscenes); // We'll call reading 20%, conversion 60% and merging 20%
+		}
+	}
+
+	status->SetProgress(0.8f);
+
+	status->GetConverter()->AddScenesToMergeQueue(status);
+}
+
+KX_LibLoadStatus *KX_BlenderSceneConverter::LinkBlendFileMemory(void *data, int length, const char *path, char *group, KX_Scene *scene_merge, char **err_str, short options)
+{
+	void *blenddata = NULL;
+
+	// The handle doesn't own the memory and the caller releases it once this returns,
+	// the loading thread reads from a copy
+	if (options & LIB_LOAD_ASYNC) {
+		blenddata = MEM_mallocN(length, "LinkBlendFileMemory");
+		memcpy(blenddata, data, length);
+		data = blenddata;
+	}
+
+	BlendHandle *bpy_openlib = BLO_blendhandle_from_memory(data, length);
+
+	// Error checking is done in LinkBlendFile, only a path is read by the loading thread
+	if (bpy_openlib == NULL)
+		options &= ~LIB_LOAD_ASYNC;
+
+	return LinkBlendFile(bpy_openlib, blenddata, path, group, scene_merge, err_str, options);
+}
+
+KX_LibLoadStatus *KX_BlenderSceneConverter::LinkBlendFilePath(const char *filepath, char *group, KX_Scene *scene_merge, char **err_str, short options)
+{
+	// Asynchronous loads read the file in the loading thread
+	BlendHandle *bpy_openlib = (options & LIB_LOAD_ASYNC) ? NULL : BLO_blendhandle_from_file(filepath, NULL);
+
+	// Error checking is done in LinkBlendFile
+	return LinkBlendFile(bpy_openlib, NULL, filepath, group, scene_merge, err_str, options);
+}
+
+void KX_BlenderSceneConverter::MergeLibraryData(Main *maggie, KX_Scene *scene_merge, int idcode, short options)
+{
 	if (idcode == ID_ME) {
 		/* Convert all new meshes into BGE meshes */
 		ID *mesh;
-	
-		for (mesh = (ID *)main_newlib->mesh.first; mesh; mesh = (ID *)mesh->next ) {
+
+		m_currentScene = scene_merge;
+
+		for (mesh = (ID *)maggie->mesh.first; mesh; mesh = (ID *)mesh->next ) {
 			if (options & LIB_LOAD_VERBOSE)
 				printf("MeshName: %s\n", mesh->name + 2);
 			RAS_MeshObject *meshobj = BL_ConvertMesh((Mesh *)mesh, NULL, scene_merge, this, false); // For now only use the libloading option for scenes, which need to handle materials/shaders
@@ -958,64 +1085,139 @@ KX_LibLoadStatus *KX_BlenderSceneConverter::LinkBlendFile(BlendHandle *bpy_openl
 		/* Convert all actions */
 		ID *action;
 
-		for (action= (ID *)main_newlib->action.first; action; action = (ID *)action->next) {
+		for (action= (ID *)maggie->action.first; action; action = (ID *)action->next) {
 			if (options & LIB_LOAD_VERBOSE)
 				printf("ActionName: %s\n", action->name + 2);
 			scene_merge->GetLogicManager()->RegisterActionName(action->name + 2, action);
 		}
 	}
 	else if (idcode == ID_SCE) {
-		/* Merge all new linked in scene into the existing one */
-		ID *scene;
-		// scenes gets deleted by the thread when it's done using it (look in async_convert())
-		vector<Scene *> *scenes = (options & LIB_LOAD_ASYNC) ? new vector<Scene *>() : NULL;
-
-		for (scene = (ID *)main_newlib->scene.first; scene; scene = (ID *)scene->next ) {
-			if (options & LIB_LOAD_VERBOSE)
-				printf("SceneName: %s\n", scene->name + 2);
-			
-			if (options & LIB_LOAD_ASYNC) {
-				scenes->push_back((Scene *)scene);
-			} 
-			else {
-				/* merge into the base  scene */
-				KX_Scene* other = m_ketsjiEngine->CreateScene((Scene *)scene, true);
-				scene_merge->MergeScene(other);
-			
-				// RemoveScene(other); // Don't run this, it frees the entire scene converter data, just delete the scene
-				delete other;
-			}
-		}
-
-		if (options & LIB_LOAD_ASYNC) {
-			status->SetData(scenes);
-			BLI_task_pool_push(m_threadinfo->m_pool, async_convert, (void *)status, false, TASK_PRIORITY_LOW);
-		}
-
 #ifdef WITH_PYTHON
 		/* Handle any text datablocks */
 		if (options & LIB_LOAD_LOAD_SCRIPTS)
-			addImportMain(main_newlib);
+			addImportMain(maggie);
 #endif
 
 		/* Now handle all the actions */
 		if (options & LIB_LOAD_LOAD_ACTIONS) {
 			ID *action;
 
-			for (action = (ID *)main_newlib->action.first; action; action = (ID *)action->next) {
+			for (action = (ID *)maggie->action.first; action; action = (ID *)action->next) {
 				if (options & LIB_LOAD_VERBOSE)
 					printf("ActionName: %s\n", action->name + 2);
 				scene_merge->GetLogicManager()->RegisterActionName(action->name + 2, action);
 			}
 		}
 	}
+}
 
-	if (!(options & LIB_LOAD_ASYNC))
-		status->Finish();
+KX_LibLoadStatus *KX_BlenderSceneConverter::LinkBlendFile(BlendHandle *bpy_openlib, void *blenddata, const char *path, char *group, KX_Scene *scene_merge, char **err_str, short options)
+{
+	Main *main_newlib; /* stored as a dynamic 'main' until we free it */
+	const int idcode = BKE_idcode_from_name(group);
+	static char err_local[255];
 
-//	TIMEIT_END(bge_link_blend_file);
+//	TIMEIT_START(bge_link_blend_file);
+
+	KX_LibLoadStatus *status;
 
+	/* only scene and mesh supported right now */
+	if (idcode != ID_SCE && idcode != ID_ME && idcode != ID_AC) {
+		snprintf(err_local, sizeof(err_local), "invalid ID type given \"%s\"\n", group);
+		*err_str = err_local;
+		BLO_blendhandle_close(bpy_openlib);
+		if (blenddata)
+			MEM_freeN(blenddata);
+		return NULL;
+	}
+
+	bool loading = (GetMainDynamicPath(path) != NULL);
+	for (map<char *, KX_LibLoadStatus *>::iterator it = m_status_map.begin(); !loading && it != m_status_map.end(); ++it) {
+		// asynchronous loads are registered once merged
+		loading = (!it->second->IsFinished() && BLI_path_cmp(it->second->GetLibName(), path) == 0);
+	}
+
+	if (loading) {
+		snprintf(err_local, sizeof(err_local), "blend file already open \"%s\"\n", path);
+		*err_str = err_local;
+		BLO_blendhandle_close(bpy_openlib);
+		if (blenddata)
+			MEM_freeN(blenddata);
+		return NULL;
+	}
+
+	/* asynchronous loads from a path open the file in the loading thread */
+	if (bpy_openlib == NULL && !((options & LIB_LOAD_ASYNC) && BLI_is_file(path))) {
+		snprintf(err_local, sizeof(err_local), "could not open blendfile \"%s\"\n", path);
+		*err_str = err_local;
+		if (blenddata)
+			MEM_freeN(blenddata);
+		return NULL;
+	}
+
+	main_newlib = BKE_main_new();
+	BLI_strncpy(main_newlib->name, path, sizeof(main_newlib->name));
+
+	status = new KX_LibLoadStatus(this, m_ketsjiEngine, scene_merge, path);
 	m_status_map[main_newlib->name] = status;
+
+	if (options & LIB_LOAD_ASYNC) {
+		// deleted by the main thread when it's done merging (look in MergeLibLoad())
+		AsyncLibLoad *libload = new AsyncLibLoad();
+		libload->m_openlib = bpy_openlib;
+		libload->m_blenddata = blenddata;
+		libload->m_path = path;
+		libload->m_maggie = main_newlib;
+		libload->m_idcode = idcode;
+		libload->m_options = options;
+		libload->m_scene = 0;
+		libload->m_numobjects = 0;
+		libload->m_merging = false;
+		libload->m_registered = false;
+
+		status->SetData(libload);
+		BLI_task_pool_push(m_threadinfo->m_pool, async_libload, (void *)status, false, TASK_PRIORITY_LOW);
+
+		return status;
+	}
+
+	link_blend_file(main_newlib, bpy_openlib, path, idcode, options);
+	/* done linking */
+
+	if (blenddata)
+		MEM_freeN(blenddata);
+
+	/* needed for lookups*/
+	GetMainDynamic().push_back(main_newlib);
+
+	BLI_mutex_lock(&m_threadinfo->m_convertmutex);
+	MergeLibraryData(main_newlib, scene_merge, idcode, options);
+	BLI_mutex_unlock(&m_threadinfo->m_convertmutex);
+
+	if (idcode == ID_SCE) {
+		/* Merge all new linked in scene into the existing one */
+		ID *scene;
+
+		for (scene = (ID *)main_newlib->scene.first; scene; scene = (ID *)scene->next ) {
+			if (options & LIB_LOAD_VERBOSE)
+				printf("SceneName: %s\n", scene->name + 2);
+
+			/* merge into the base  scene */
+			KX_Scene* other = m_ketsjiEngine->CreateScene((Scene *)scene, true);
+
+			BLI_mutex_lock(&m_threadinfo->m_convertmutex);
+			scene_merge->MergeScene(other);
+			BLI_mutex_unlock(&m_threadinfo->m_convertmutex);
+
+			// RemoveScene(other); // Don't run this, it frees the entire scene converter data, just delete the scene
+			delete other;
+		}
+	}
+
+	status->Finish();
+
+//	TIMEIT_END(bge_link_blend_file);
+
 	return status;
 }
 
@@ -1041,6 +1243,8 @@ bool KX_BlenderSceneConverter::FreeBlendFile(Main *maggie)
 		}
 	}
 
+	BLI_mutex_lock(&m_threadinfo->m_convertmutex);
+
 	/* tag all false except the one we remove */
 	for (vector<Main *>::iterator it = m_DynamicMaggie.begin(); !(it == m_DynamicMaggie.end()); it++) {
 		Main *main = *it;
@@ -1054,8 +1258,10 @@ bool KX_BlenderSceneConverter::FreeBlendFile(Main *maggie)
 	}
 
 	/* should never happen but just to be safe */
-	if (maggie_index == -1)
+	if (maggie_index == -1) {
+		BLI_mutex_unlock(&m_threadinfo->m_convertmutex);
 		return false;
+	}
 
 	m_DynamicMaggie.erase(m_DynamicMaggie.begin() + maggie_index);
 	BKE_main_id_tag_all(maggie, true);
@@ -1326,6 +1532,8 @@ bool KX_BlenderSceneConverter::FreeBlendFile(Main *maggie)
 
 	BKE_main_free(maggie);
 
+	BLI_mutex_unlock(&m_threadinfo->m_convertmutex);
+
 	return true;
 }
 
@@ -1420,6 +1628,8 @@ RAS_MeshObject *KX_BlenderSceneConverter::ConvertMeshSpecial(KX_Scene *kx_scene,
 		return NULL;
 	}
 
+	BLI_mutex_lock(&m_threadinfo->m_convertmutex);
+
 	/* Watch this!, if its used in the original scene can cause big troubles */
 	if (me->us > 0) {
 #ifdef DEBUG
@@ -1473,5 +1683,8 @@ RAS_MeshObject *KX_BlenderSceneConverter::ConvertMeshSpecial(KX_Scene *kx_scene,
 	RAS_MeshObject *meshobj = BL_ConvertMesh((Mesh *)me, NULL, kx_scene, this, false);
 	kx_scene->GetLogicManager()->RegisterMeshName(meshobj->GetName(),meshobj);
 	m_map_mesh_to_gamemesh.clear(); /* This is at runtime so no need to keep this, BL_ConvertMesh adds */
+
+	BLI_mutex_unlock(&m_threadinfo->m_convertmutex);
+
 	return meshobj;
 }
@@ -67,6 +67,8 @@ class KX_BlenderSceneConverter : public KX_ISceneConverter
 	vector<pair<KX_Scene*,BL_Material *> >	m_materials;
 
 	vector<class KX_LibLoadStatus*> m_mergequeue;
+	// Asynchronous loads taken from the merge queue, merged over several frames by the main thread
+	vector<class KX_LibLoadStatus*> m_libloads;
 	ThreadInfo	*m_threadinfo;
 
 	// Cached material conversions
@@ -97,6 +99,13 @@ class KX_BlenderSceneConverter : public KX_ISceneConverter
 	bool					m_useglslmat;
 	bool					m_use_mat_cache;
 
+	/// Convert the meshes and register the actions and scripts of a linked library, with the conversion lock owned.
+	void MergeLibraryData(struct Main *maggie, class KX_Scene *scene_merge, int idcode, short options);
+	/// Merge one asynchronous load until \a endtime with the conversion lock owned, returns true when it is merged.
+	bool MergeLibLoad(class KX_LibLoadStatus *status, double endtime);
+	/// Merge the asynchronous loads for \a budget seconds, all of them when \a budget is negative.
+	void MergeLibLoads(double budget);
+
 public:
 	KX_BlenderSceneConverter(
 		Main* maggie,
@@ -115,6 +124,7 @@ public:
 						class RAS_ICanvas* canvas,
 						bool libloading=false
 					);
+	/* Waits for a scene being converted by an asynchronous LibLoad, see ThreadInfo. */
 	virtual void RemoveScene(class KX_Scene *scene);
 
 	void SetNewFileName(const STR_String& filename);
@@ -177,8 +187,11 @@ public:
 	
 	class KX_LibLoadStatus *LinkBlendFileMemory(void *data, int length, const char *path, char *group, KX_Scene *scene_merge, char **err_str, short options);
 	class KX_LibLoadStatus *LinkBlendFilePath(const char *path, char *group, KX_Scene *scene_merge, char **err_str, short options);
-	class KX_LibLoadStatus *LinkBlendFile(struct BlendHandle *bpy_openlib, const char *path, char *group, KX_Scene *scene_merge, char **err_str, short options);
+	/* blenddata is the memory bpy_openlib reads from if it has to be freed by the load (MEM_freeN), or NULL */
+	class KX_LibLoadStatus *LinkBlendFile(struct BlendHandle *bpy_openlib, void *blenddata, const char *path, char *group, KX_Scene *scene_merge, char **err_str, short options);
 	bool MergeScene(KX_Scene *to, KX_Scene *from);
+	/* These wait for a scene being converted by an asynchronous LibLoad, the
+	 * conversion of a scene isn't split and can take several frames. */
 	RAS_MeshObject *ConvertMeshSpecial(KX_Scene* kx_scene, Main *maggie, const char *name);
 	bool FreeBlendFile(struct Main *maggie);
 	bool FreeBlendFile(const char *path);
@@ -37,6 +37,7 @@ KX_LibLoadStatus::KX_LibLoadStatus(class KX_BlenderSceneConverter* kx_converter,
 			m_data(NULL),
 			m_libname(path),
 			m_progress(0.0f),
+			m_reportedprogress(0.0f),
 			m_finished(false)
 #ifdef WITH_PYTHON
 			,
@@ -45,12 +46,18 @@ KX_LibLoadStatus::KX_LibLoadStatus(class KX_BlenderSceneConverter* kx_converter,
 #endif
 {
 	m_endtime = m_starttime = PIL_check_seconds_timer();
+	BLI_spin_init(&m_progresslock);
+}
+
+KX_LibLoadStatus::~KX_LibLoadStatus()
+{
+	BLI_spin_end(&m_progresslock);
 }
 
 void KX_LibLoadStatus::Finish()
 {
 	m_finished = true;
-	m_progress = 1.f;
+	SetProgress(1.f);
 	m_endtime = PIL_check_seconds_timer();
 
 	RunFinishCallback();
@@ -75,11 +82,12 @@ void KX_LibLoadStatus::RunFinishCallback()
 
 void KX_LibLoadStatus::RunProgressCallback()
 {
-// Progess callbacks are causing threading problems with Python, so they're disabled for now
-#if 0
 #ifdef WITH_PYTHON
-	if (m_progress_cb) {
-		//PyGILState_STATE gstate = PyGILState_Ensure();
+	// Only run from the main thread, the loading threads just store the progress.
+	const float progress = GetProgress();
+	if (m_progress_cb && progress != m_reportedprogress) {
+		m_reportedprogress = progress;
+
 		PyObject* args = Py_BuildValue("(O)", GetProxy());
 
 		if (!PyObject_Call(m_progress_cb, args, NULL)) {
@@ -88,10 +96,8 @@ void KX_LibLoadStatus::RunProgressCallback()
 		}
 
 		Py_DECREF(args);
-		//PyGILState_Release(gstate);
 	}
 #endif
-#endif
 }
 
 class KX_BlenderSceneConverter *KX_LibLoadStatus::GetConverter()
@@ -131,19 +137,24 @@ void *KX_LibLoadStatus::GetData()
 
 void KX_LibLoadStatus::SetProgress(float progress)
 {
+	BLI_spin_lock(&m_progresslock);
 	m_progress = progress;
-	RunProgressCallback();
+	BLI_spin_unlock(&m_progresslock);
 }
 
 float KX_LibLoadStatus::GetProgress()
 {
-	return m_progress;
+	BLI_spin_lock(&m_progresslock);
+	const float progress = m_progress;
+	BLI_spin_unlock(&m_progresslock);
+	return progress;
 }
 
 void KX_LibLoadStatus::AddProgress(float progress)
 {
+	BLI_spin_lock(&m_progresslock);
 	m_progress += progress;
-	RunProgressCallback();
+	BLI_spin_unlock(&m_progresslock);
 }
 
 #ifdef WITH_PYTHON
@@ -155,8 +166,8 @@ PyMethodDef KX_LibLoadStatus::Methods[] =
 
 PyAttributeDef KX_LibLoadStatus::Attributes[] = {
 	KX_PYATTRIBUTE_RW_FUNCTION("onFinish", KX_LibLoadStatus, pyattr_get_onfinish, pyattr_set_onfinish),
-	// KX_PYATTRIBUTE_RW_FUNCTION("onProgress", KX_LibLoadStatus, pyattr_get_onprogress, pyattr_set_onprogress),
-	KX_PYATTRIBUTE_FLOAT_RO("progress", KX_LibLoadStatus, m_progress),
+	KX_PYATTRIBUTE_RW_FUNCTION("onProgress", KX_LibLoadStatus, pyattr_get_onprogress, pyattr_set_onprogress),
+	KX_PYATTRIBUTE_RO_FUNCTION("progress", KX_LibLoadStatus, pyattr_get_progress),
 	KX_PYATTRIBUTE_STRING_RO("libraryName", KX_LibLoadStatus, m_libname),
 	KX_PYATTRIBUTE_RO_FUNCTION("timeTaken", KX_LibLoadStatus, pyattr_get_timetaken),
 	KX_PYATTRIBUTE_BOOL_RO("finished", KX_LibLoadStatus, m_finished),
@@ -252,4 +263,11 @@ PyObject* KX_LibLoadStatus::pyattr_get_timetaken(void *self_v, const KX_PYATTRIB
 
 	return PyFloat_FromDouble(self->m_endtime - self->m_starttime);
 }
+
+PyObject* KX_LibLoadStatus::pyattr_get_progress(void *self_v, const KX_PYATTRIBUTE_DEF *attrdef)
+{
+	KX_LibLoadStatus* self = static_cast<KX_LibLoadStatus*>(self_v);
+
+	return PyFloat_FromDouble(self->GetProgress());
+}
 #endif // WITH_PYTHON
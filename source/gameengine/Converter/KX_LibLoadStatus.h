@@ -28,6 +28,7 @@
 #define __KX_LIBLOADSTATUS_H__
 
 #include "EXP_PyObjectPlus.h"
+#include "BLI_threads.h"
 
 class KX_LibLoadStatus : public PyObjectPlus
 {
@@ -39,7 +40,11 @@ private:
 	void*							m_data;
 	STR_String						m_libname;
 
+	// Written by the loading thread, read by the main thread.
 	float	m_progress;
+	SpinLock	m_progresslock;
+	// The progress last given to the progress callback.
+	float	m_reportedprogress;
 	double	m_starttime;
 	double	m_endtime;
 
@@ -56,10 +61,11 @@ public:
 						class KX_KetsjiEngine* kx_engine,
 						class KX_Scene* merge_scene,
 						const char *path);
+	virtual ~KX_LibLoadStatus();
 
 	void Finish(); // Called when the libload is done
 	void RunFinishCallback();
-	void RunProgressCallback();
+	void RunProgressCallback(); // Called from the main thread when the progress changed
 
 	class KX_BlenderSceneConverter *GetConverter();
 	class KX_KetsjiEngine *GetEngine();
@@ -87,6 +93,7 @@ public:
 	static int			pyattr_set_onprogress(void *self_v, const KX_PYATTRIBUTE_DEF *attrdef, PyObject *value);
 
 	static PyObject*	pyattr_get_timetaken(void *self_v, const KX_PYATTRIBUTE_DEF *attrdef);
+	static PyObject*	pyattr_get_progress(void *self_v, const KX_PYATTRIBUTE_DEF *attrdef);
 #endif
 };
 
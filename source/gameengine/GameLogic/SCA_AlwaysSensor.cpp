@@ -84,6 +84,13 @@ bool SCA_AlwaysSensor::IsPositiveTrigger()
 
 
 
+bool SCA_AlwaysSensor::HasInput()
+{
+	return m_alwaysresult;
+}
+
+
+
 bool SCA_AlwaysSensor::Evaluate()
 {
 	/* Nice! :) */
@@ -46,6 +46,8 @@ public:
 	virtual ~SCA_AlwaysSensor();
 	virtual CValue* GetReplica();
 	virtual bool Evaluate();
+	/// Only true on the first frame, later frames rely on the pulse modes.
+	virtual bool HasInput();
 	virtual bool IsPositiveTrigger();
 	virtual void Init();
 };
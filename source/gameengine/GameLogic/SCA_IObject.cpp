@@ -46,12 +46,18 @@ SCA_IObject::SCA_IObject():
 	CValue(),
 	m_initState(0),
 	m_state(0),
-	m_firstState(NULL)
+	m_firstState(NULL),
+	m_propertyVersion(0)
 {
 	m_suspended = false;
 }
 
 SCA_IObject::~SCA_IObject()
+{
+	ClearLogic();
+}
+
+void SCA_IObject::ClearLogic()
 {
 	SCA_SensorList::iterator its;
 	for (its = m_sensors.begin(); !(its == m_sensors.end()); ++its)
@@ -87,6 +93,20 @@ SCA_IObject::~SCA_IObject()
 	//for (i = m_interpolators.begin(); !(i == m_interpolators.end()); ++i) {
 	//	delete *i;
 	//}
+
+	m_sensors.clear();
+	m_controllers.clear();
+	m_actuators.clear();
+	m_registeredActuators.clear();
+	m_registeredObjects.clear();
+}
+
+void SCA_IObject::CopyLogic(SCA_IObject *orgobj)
+{
+	// same as the copy constructor, the bricks are replicated in ReParentLogic()
+	m_sensors = orgobj->m_sensors;
+	m_controllers = orgobj->m_controllers;
+	m_actuators = orgobj->m_actuators;
 }
 
 void SCA_IObject::AddSensor(SCA_ISensor* act)
@@ -307,6 +327,30 @@ void SCA_IObject::SetState(unsigned int state)
 	}
 }
 
+void SCA_IObject::SetProperty(const STR_String& name, CValue *ioProperty)
+{
+	CValue::SetProperty(name, ioProperty);
+	m_propertyVersion++;
+}
+
+void SCA_IObject::SetProperty(const char *name, CValue *ioProperty)
+{
+	CValue::SetProperty(name, ioProperty);
+	m_propertyVersion++;
+}
+
+bool SCA_IObject::RemoveProperty(const char *inName)
+{
+	m_propertyVersion++;
+	return CValue::RemoveProperty(inName);
+}
+
+void SCA_IObject::ClearProperties()
+{
+	m_propertyVersion++;
+	CValue::ClearProperties();
+}
+
 #ifdef WITH_PYTHON
 
 /* ------------------------------------------------------------------------- */
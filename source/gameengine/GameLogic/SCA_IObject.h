@@ -109,6 +109,11 @@ protected:
 	 */
 	SG_QList*				m_firstState;
 
+	/**
+	 * incremented each time a property is set, replaced or removed
+	 */
+	unsigned int			m_propertyVersion;
+
 public:
 	
 	SCA_IObject();
@@ -165,6 +170,17 @@ public:
 	void SetCurrentTime(float currentTime) {}
 
 	virtual void ReParentLogic();
+
+	/**
+	 * Release all logic bricks and unlink the objects referring to this one.
+	 * The bricks must already be removed from the logic manager.
+	 */
+	void ClearLogic();
+	/**
+	 * Take the logic bricks of \a orgobj, to be replicated by ReParentLogic(),
+	 * used to give fresh logic to a recycled object.
+	 */
+	void CopyLogic(SCA_IObject *orgobj);
 	
 	/**
 	 * Set whether or not to ignore activity culling requests
@@ -213,6 +229,21 @@ public:
 	 */
 	unsigned int GetState(void)	{ return m_state; }
 
+	/**
+	 * Notify the property sensors that a property value was modified in place.
+	 */
+	void PropertyChanged() { m_propertyVersion++; }
+
+	/**
+	 * Get a number changing each time a property of this object changes
+	 */
+	unsigned int GetPropertyVersion() const { return m_propertyVersion; }
+
+	virtual void SetProperty(const STR_String& name, CValue *ioProperty);
+	virtual void SetProperty(const char *name, CValue *ioProperty);
+	virtual bool RemoveProperty(const char *inName);
+	virtual void ClearProperties();
+
 //	const class MT_Point3&	ConvertPythonPylist(PyObject *pylist);
 
 	virtual int GetGameObjectType() {return -1;}
@@ -235,12 +235,40 @@ void SCA_ISensor::ActivateControllers(class SCA_LogicManager* logicmgr)
 	}
 }
 
+bool SCA_ISensor::NeedsActivation()
+{
+	if ((m_pos_pulsemode && m_state) || (m_neg_pulsemode && !m_tap && !m_state)) {
+		return true;
+	}
+	// tap mode sends a negative pulse the frame after a positive one
+	if (m_tap && m_state) {
+		return true;
+	}
+	if (m_level) {
+		for (vector<SCA_IController*>::const_iterator c = m_linkedcontrollers.begin();
+		     c != m_linkedcontrollers.end(); ++c)
+		{
+			if ((*c)->IsJustActivated())
+				return true;
+		}
+	}
+	return false;
+}
+
 void SCA_ISensor::Activate(class SCA_LogicManager* logicmgr)
 {
 	
 	// calculate if a __triggering__ is wanted
 	// don't evaluate a sensor that is not connected to any controller
 	if (m_links && !m_suspended) {
+		if (!HasInput() && !NeedsActivation()) {
+			// Evaluate() would return false and leave the state unchanged.
+			m_prev_state = m_state;
+			logicmgr->CountSensor(false);
+			return;
+		}
+		logicmgr->CountSensor(true);
+
 		bool result = this->Evaluate();
 		// store the state for the rest of the logic system
 		m_prev_state = m_state;
@@ -113,6 +113,12 @@ public:
 	/* The IsPosTrig() also has to change, to keep things consistent.        */
 	void Activate(class SCA_LogicManager* logicmgr);
 	virtual bool Evaluate() = 0;
+	/**
+	 * Could Evaluate() report a change this frame? Sensors notified of the changes
+	 * of their input return false when nothing happened, they keep their state and
+	 * are only activated when their pulse, tap or level settings need it.
+	 */
+	virtual bool HasInput() { return true; }
 	virtual bool IsPositiveTrigger();
 	virtual void Init();
 
@@ -144,6 +150,8 @@ public:
 	void UnlinkController(SCA_IController* controller);
 	void UnlinkAllControllers();
 	void ActivateControllers(class SCA_LogicManager* logicmgr);
+	/** Must Activate() run even though the sensor has no new input? */
+	bool NeedsActivation();
 
 	virtual void ProcessReplica();
 
@@ -42,7 +42,8 @@
 SCA_KeyboardManager::SCA_KeyboardManager(SCA_LogicManager* logicmgr,
 										 SCA_IInputDevice* inputdev)
 	:	SCA_EventManager(logicmgr, KEYBOARD_EVENTMGR),
-		m_inputDevice(inputdev)
+		m_inputDevice(inputdev),
+		m_hasInput(false)
 {
 }
 
@@ -65,6 +66,15 @@ void SCA_KeyboardManager::NextFrame()
 {
 	//const SCA_InputEvent& event =	GetEventValue(SCA_IInputDevice::KX_EnumInputs inputcode)=0;
 //	cerr << "SCA_KeyboardManager::NextFrame"<< endl;
+	m_hasInput = false;
+	for (int i = SCA_IInputDevice::KX_BEGINKEY; i <= SCA_IInputDevice::KX_ENDKEY; i++) {
+		const SCA_InputEvent& event = m_inputDevice->GetEventValue((SCA_IInputDevice::KX_EnumInputs)i);
+		if (event.m_status != SCA_InputEvent::KX_NO_INPUTSTATUS) {
+			m_hasInput = true;
+			break;
+		}
+	}
+
 	SG_DList::iterator<SCA_ISensor> it(m_sensors);
 	for (it.begin();!it.end();++it)
 	{
@@ -47,6 +47,8 @@ using namespace std;
 class SCA_KeyboardManager : public SCA_EventManager
 {
 	class	SCA_IInputDevice*				m_inputDevice;
+	/// A key is pressed, was pressed or released this frame.
+	bool									m_hasInput;
 	
 public:
 	SCA_KeyboardManager(class SCA_LogicManager* logicmgr,class SCA_IInputDevice* inputdev);
@@ -57,6 +59,15 @@ public:
 	virtual void 	NextFrame();
 	SCA_IInputDevice* GetInputDevice();
 
+	/**
+	 * False when no key is active, keyboard sensors which don't hold a key
+	 * down can skip their evaluation then.
+	 */
+	bool HasInput() const
+	{
+		return m_hasInput;
+	}
+
 
 #ifdef WITH_CXX_GUARDEDALLOC
 	MEM_CXX_CLASS_ALLOC_FUNCS("GE:SCA_KeyboardManager")
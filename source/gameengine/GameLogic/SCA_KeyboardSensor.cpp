@@ -124,6 +124,12 @@ bool SCA_KeyboardSensor::TriggerOnAllKeys()
 
 
 
+bool SCA_KeyboardSensor::HasInput()
+{
+	return (m_reset || m_val != 0 || !m_toggleprop.IsEmpty() ||
+	        ((SCA_KeyboardManager *)m_eventmgr)->HasInput());
+}
+
 bool SCA_KeyboardSensor::Evaluate()
 {
 	bool result    = false;
@@ -103,6 +103,8 @@ public:
 
 	short int GetHotkey();
 	virtual bool Evaluate();
+	/// Only true when a key is active or the sensor has to release its key or log keystrokes.
+	virtual bool HasInput();
 	virtual bool IsPositiveTrigger();
 	bool	TriggerOnAllKeys();
 
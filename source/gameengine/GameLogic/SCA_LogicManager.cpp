@@ -199,6 +199,7 @@ void SCA_LogicManager::BeginFrame(double curtime, double fixedtime)
 		{
 			contr->Trigger(this);
 			contr->ClrJustActivated();
+			m_stats.m_triggeredControllers++;
 		}
 	}
 }
@@ -222,6 +223,7 @@ void SCA_LogicManager::UpdateFrame(double curtime, bool frame)
 			SCA_IActuator* actua = *ia;
 			// increment first to allow removal of inactive actuators.
 			++ia;
+			m_stats.m_updatedActuators++;
 			if (!actua->Update(curtime, frame))
 			{
 				// this actuator is not active anymore, remove
@@ -69,6 +69,34 @@ typedef std::map<class SCA_ISensor*,controllerlist > sensormap_t;
 #include "SCA_IActuator.h"
 #include "SCA_EventManager.h"
 
+/**
+ * Number of logic bricks run by a logic manager, sensors without new input
+ * are skipped, controllers only run when triggered and actuators while active.
+ */
+struct SCA_LogicStats
+{
+	unsigned int m_evaluatedSensors;
+	unsigned int m_skippedSensors;
+	unsigned int m_triggeredControllers;
+	unsigned int m_updatedActuators;
+
+	SCA_LogicStats()
+		:m_evaluatedSensors(0),
+		m_skippedSensors(0),
+		m_triggeredControllers(0),
+		m_updatedActuators(0)
+	{
+	}
+
+	SCA_LogicStats& operator+=(const SCA_LogicStats& other)
+	{
+		m_evaluatedSensors += other.m_evaluatedSensors;
+		m_skippedSensors += other.m_skippedSensors;
+		m_triggeredControllers += other.m_triggeredControllers;
+		m_updatedActuators += other.m_updatedActuators;
+		return *this;
+	}
+};
 
 class SCA_LogicManager
 {
@@ -89,6 +117,8 @@ class SCA_LogicManager
 
 	CTR_Map<STR_HashedString,void*>		m_map_gamemeshname_to_blendobj;
 	CTR_Map<CHashedPtr,void*>			m_map_blendobj_to_gameobj;
+
+	SCA_LogicStats						m_stats;
 public:
 	SCA_LogicManager();
 	virtual ~SCA_LogicManager();
@@ -111,6 +141,23 @@ public:
 	}
 
 	void	AddTriggeredController(SCA_IController* controller, SCA_ISensor* sensor);
+
+	/**
+	 * Count a sensor evaluated or skipped because it had no new input.
+	 */
+	void	CountSensor(bool evaluated)
+	{
+		if (evaluated)
+			m_stats.m_evaluatedSensors++;
+		else
+			m_stats.m_skippedSensors++;
+	}
+	/**
+	 * Logic bricks run since the last ResetStats().
+	 */
+	const SCA_LogicStats&	GetStats() const { return m_stats; }
+	void	ResetStats() { m_stats = SCA_LogicStats(); }
+
 	SCA_EventManager*	FindEventManager(int eventmgrtype);
 	vector<class SCA_EventManager*>	GetEventManagers() { return m_eventmanagers; }
 	
@@ -69,7 +69,7 @@ bool SCA_PropertyActuator::Update()
 
 	bool bNegativeEvent = IsNegativeEvent();
 	RemoveAllEvents();
-	CValue* propowner = GetParent();
+	SCA_IObject* propowner = GetParent();
 
 	if (bNegativeEvent)
 	{
@@ -80,6 +80,7 @@ bool SCA_PropertyActuator::Update()
 			if (oldprop)
 			{
 				oldprop->SetValue(newval);
+				propowner->PropertyChanged();
 			}
 			newval->Release();
 		}
@@ -101,6 +102,7 @@ bool SCA_PropertyActuator::Update()
 		{
 			newval = new CBoolValue((oldprop->GetNumber()==0.0) ? true:false);
 			oldprop->SetValue(newval);
+			propowner->PropertyChanged();
 		} else
 		{	/* as not been assigned, evaluate as false, so assign true */
 			newval = new CBoolValue(true);
@@ -115,6 +117,7 @@ bool SCA_PropertyActuator::Update()
 		if (oldprop)
 		{
 			oldprop->SetValue(newval);
+			propowner->PropertyChanged();
 		} else
 		{
 			propowner->SetProperty(m_propname,newval);
@@ -133,6 +136,7 @@ bool SCA_PropertyActuator::Update()
 				if (oldprop)
 				{
 					oldprop->SetValue(newval);
+					propowner->PropertyChanged();
 				} else
 				{
 					propowner->SetProperty(m_propname,newval);
@@ -151,6 +155,7 @@ bool SCA_PropertyActuator::Update()
 
 					CValue* newprop = expr->Calculate();
 					oldprop->SetValue(newprop);
+					propowner->PropertyChanged();
 					newprop->Release();
 					expr->Release();
 
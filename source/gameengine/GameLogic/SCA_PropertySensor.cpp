@@ -43,6 +43,7 @@
 #include "EXP_StringValue.h"
 #include "SCA_EventManager.h"
 #include "SCA_LogicManager.h"
+#include "SCA_TimeEventManager.h"
 #include "EXP_BoolValue.h"
 #include "EXP_FloatValue.h"
 #include <stdio.h>
@@ -57,7 +58,10 @@ SCA_PropertySensor::SCA_PropertySensor(SCA_EventManager* eventmgr,
 	  m_checktype(checktype),
 	  m_checkpropval(propval),
 	  m_checkpropmaxval(propmaxval),
-	  m_checkpropname(propname)
+	  m_checkpropname(propname),
+	  m_propertyVersion(0),
+	  m_timerProperty(false),
+	  m_settingsChanged(false)
 {
 	//CParser pars;
 	//pars.SetContext(this->AddRef());
@@ -109,8 +113,24 @@ SCA_PropertySensor::~SCA_PropertySensor()
 
 
 
+bool SCA_PropertySensor::HasInput()
+{
+	/* A positive changed pulse must be evaluated again to go back to negative. */
+	return (m_reset || m_timerProperty || m_settingsChanged ||
+	        (m_checktype == KX_PROPSENSOR_CHANGED && m_lastresult) ||
+	        GetParent()->GetPropertyVersion() != m_propertyVersion);
+}
+
 bool SCA_PropertySensor::Evaluate()
 {
+	SCA_IObject *parent = GetParent();
+	if (m_reset || m_settingsChanged || parent->GetPropertyVersion() != m_propertyVersion) {
+		CValue *prop = parent->GetProperty(m_checkpropname);
+		m_timerProperty = (prop && SCA_TimeEventManager::IsTimeProperty(prop));
+		m_propertyVersion = parent->GetPropertyVersion();
+		m_settingsChanged = false;
+	}
+
 	bool result = CheckPropertyCondition();
 	bool reset = m_reset && m_level;
 	
@@ -288,6 +308,19 @@ int SCA_PropertySensor::validValueForProperty(void *self, const PyAttributeDef*)
 	 * function directly */
 
 	/*  There is no type checking at this moment, unfortunately...           */
+	static_cast<SCA_PropertySensor *>(self)->m_settingsChanged = true;
+	return 0;
+}
+
+int SCA_PropertySensor::CheckPropertyName(void *self, const PyAttributeDef *attrdef)
+{
+	static_cast<SCA_PropertySensor *>(self)->m_settingsChanged = true;
+	return CheckProperty(self, attrdef);
+}
+
+int SCA_PropertySensor::CheckMode(void *self, const PyAttributeDef *)
+{
+	static_cast<SCA_PropertySensor *>(self)->m_settingsChanged = true;
 	return 0;
 }
 
@@ -319,8 +352,8 @@ PyMethodDef SCA_PropertySensor::Methods[] = {
 };
 
 PyAttributeDef SCA_PropertySensor::Attributes[] = {
-	KX_PYATTRIBUTE_INT_RW("mode",KX_PROPSENSOR_NODEF,KX_PROPSENSOR_MAX-1,false,SCA_PropertySensor,m_checktype),
-	KX_PYATTRIBUTE_STRING_RW_CHECK("propName",0,MAX_PROP_NAME,false,SCA_PropertySensor,m_checkpropname,CheckProperty),
+	KX_PYATTRIBUTE_INT_RW_CHECK("mode",KX_PROPSENSOR_NODEF,KX_PROPSENSOR_MAX-1,false,SCA_PropertySensor,m_checktype,CheckMode),
+	KX_PYATTRIBUTE_STRING_RW_CHECK("propName",0,MAX_PROP_NAME,false,SCA_PropertySensor,m_checkpropname,CheckPropertyName),
 	KX_PYATTRIBUTE_STRING_RW_CHECK("value",0,100,false,SCA_PropertySensor,m_checkpropval,validValueForProperty),
 	KX_PYATTRIBUTE_STRING_RW_CHECK("min",0,100,false,SCA_PropertySensor,m_checkpropval,validValueForProperty),
 	KX_PYATTRIBUTE_STRING_RW_CHECK("max",0,100,false,SCA_PropertySensor,m_checkpropmaxval,validValueForProperty),
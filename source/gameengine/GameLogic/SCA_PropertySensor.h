@@ -46,6 +46,12 @@ class SCA_PropertySensor : public SCA_ISensor
 	STR_String		m_previoustext;
 	bool			m_lastresult;
 	bool			m_recentresult;
+	/// Version of the parent properties at the last evaluation.
+	unsigned int	m_propertyVersion;
+	/// The checked property is a timer, its value changes every frame.
+	bool			m_timerProperty;
+	/// The sensor settings were changed from python since the last evaluation.
+	bool			m_settingsChanged;
 
  protected:
 
@@ -77,6 +83,8 @@ public:
 	bool	CheckPropertyCondition();
 
 	virtual bool Evaluate();
+	/// Only true when a property of the parent changed since the last evaluation.
+	virtual bool HasInput();
 	virtual bool	IsPositiveTrigger();
 	virtual CValue*		FindIdentifier(const STR_String& identifiername);
 
@@ -90,6 +98,8 @@ public:
 	 * Test whether this is a sensible value (type check)
 	 */
 	static int validValueForProperty(void* self, const PyAttributeDef*);
+	static int CheckPropertyName(void *self, const PyAttributeDef *attrdef);
+	static int CheckMode(void *self, const PyAttributeDef *attrdef);
 
 #endif
 };
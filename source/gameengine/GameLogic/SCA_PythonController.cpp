@@ -51,6 +51,8 @@
 
 // initialize static member variables
 SCA_PythonController* SCA_PythonController::m_sCurrentController = NULL;
+void (*SCA_PythonController::m_sProfileFunc)(void *data, bool begin) = NULL;
+void *SCA_PythonController::m_sProfileData = NULL;
 
 
 SCA_PythonController::SCA_PythonController(SCA_IObject* gameobj, int mode)
@@ -420,7 +422,11 @@ void SCA_PythonController::Trigger(SCA_LogicManager* logicmgr)
 
 			excdict= PyDict_Copy(m_pythondictionary);
 
+			if (m_sProfileFunc)
+				m_sProfileFunc(m_sProfileData, true);
 			resultobj = PyEval_EvalCode((PyObject *)m_bytecode, excdict, excdict);
+			if (m_sProfileFunc)
+				m_sProfileFunc(m_sProfileData, false);
 
 			/* PyRun_SimpleString(m_scriptText.Ptr()); */
 			break;
@@ -440,7 +446,11 @@ void SCA_PythonController::Trigger(SCA_LogicManager* logicmgr)
 				PyTuple_SET_ITEM(args, 0, GetProxy());
 			}
 
+			if (m_sProfileFunc)
+				m_sProfileFunc(m_sProfileData, true);
 			resultobj = PyObject_CallObject(m_function, args);
+			if (m_sProfileFunc)
+				m_sProfileFunc(m_sProfileData, false);
 			Py_XDECREF(args);
 			break;
 		}
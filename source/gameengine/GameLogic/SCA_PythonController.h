@@ -72,6 +72,10 @@ class SCA_PythonController : public SCA_IController
 
 	static SCA_PythonController* m_sCurrentController; // protected !!!
 
+	/// Called with begin true before and false after running a python controller, for profiling.
+	static void (*m_sProfileFunc)(void *data, bool begin);
+	static void *m_sProfileData;
+
 	//for debugging
 	//virtual	CValue*		AddRef();
 	//virtual int			Release();  // Release a reference to this value (when reference count reaches 0, the value is removed from the heap)
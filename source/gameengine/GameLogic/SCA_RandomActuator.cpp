@@ -246,6 +246,7 @@ bool SCA_RandomActuator::Update()
 	CValue *prop = GetParent()->GetProperty(m_propname);
 	if (prop) {
 		prop->SetValue(tmpval);
+		GetParent()->PropertyChanged();
 	}
 	tmpval->Release();
 
@@ -94,6 +94,8 @@ void SCA_TimeEventManager::NextFrame(double curtime, double fixedtime)
 void SCA_TimeEventManager::AddTimeProperty(CValue* timeval)
 {
 	timeval->AddRef();
+	// Flag kept by the replicas of the timer, which are registered as well.
+	timeval->SetCustomFlag2(true);
 	m_timevalues.push_back(timeval);
 }
 
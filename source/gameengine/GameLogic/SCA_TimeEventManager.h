@@ -51,6 +51,11 @@ public:
 	virtual void	RemoveSensor(class SCA_ISensor* sensor);
 	void			AddTimeProperty(CValue* timeval);
 	void			RemoveTimeProperty(CValue* timeval);
+	/**
+	 * Is this value updated every frame by a time event manager? Timer values
+	 * are changed in place without notifying the property owner.
+	 */
+	static bool		IsTimeProperty(CValue* value) { return value->IsCustomFlag2(); }
 
 	vector<CValue*>	GetTimeValues();
 
@@ -84,6 +84,7 @@ extern "C"
 
 #include "KX_BlenderSceneConverter.h"
 #include "NG_LoopBackNetworkDeviceInterface.h"
+#include "NG_UdpNetworkDeviceInterface.h"
 
 #include "GPC_MouseDevice.h"
 #include "GPG_Canvas.h" 
@@ -636,8 +637,24 @@ bool GPG_Application::initEngine(GHOST_IWindow* window, const int stereoMode)
 		if (!m_mouse)
 			goto initFailed;
 			
-		// create a networkdevice
-		m_networkdevice = new NG_LoopBackNetworkDeviceInterface();
+		// create a networkdevice, talking to another player when a port is given
+		int netport = SYS_GetCommandLineInt(syshandle, "net_port", 0);
+		if (netport > 0) {
+			NG_UdpNetworkDeviceInterface *udpdevice = new NG_UdpNetworkDeviceInterface();
+			STR_String netaddress = SYS_GetCommandLineString(syshandle, "net_address", "");
+			STR_String netpassword = SYS_GetCommandLineString(syshandle, "net_password", "");
+			int netlocalport = SYS_GetCommandLineInt(syshandle, "net_localport", netport);
+
+			if (udpdevice->Connect(netaddress.Ptr(), netport, netpassword.Ptr(), netlocalport, 0)) {
+				m_networkdevice = udpdevice;
+			}
+			else {
+				printf("Network: falling back to local messages only\n");
+				delete udpdevice;
+			}
+		}
+		if (!m_networkdevice)
+			m_networkdevice = new NG_LoopBackNetworkDeviceInterface();
 		if (!m_networkdevice)
 			goto initFailed;
 			
@@ -843,6 +860,26 @@ void GPG_Application::EngineNextFrame()
 	m_exitString = m_ketsjiengine->GetExitString();
 }
 
+void GPG_Application::StartBenchmark(int frames)
+{
+	m_ketsjiengine->StartBenchmark(frames);
+}
+
+void GPG_Application::EngineBenchmarkFrame()
+{
+	if (m_kxsystem && !m_exitRequested)
+	{
+		m_exitRequested = m_ketsjiengine->GetExitCode();
+		m_ketsjiengine->BenchmarkFrame();
+	}
+	m_exitString = m_ketsjiengine->GetExitString();
+}
+
+bool GPG_Application::WriteBenchmark(const char *filepath)
+{
+	return m_ketsjiengine->WriteBenchmark(filepath);
+}
+
 void GPG_Application::exitEngine()
 {
 	// We only want to kill the engine if it has been initialized
@@ -42,7 +42,7 @@
 class KX_KetsjiEngine;
 class KX_Scene;
 class KX_ISceneConverter;
-class NG_LoopBackNetworkDeviceInterface;
+class NG_NetworkDeviceInterface;
 class RAS_IRasterizer;
 class GHOST_IEvent;
 class GHOST_ISystem;
@@ -94,6 +94,11 @@ public:
 	void StopGameEngine();
 	void EngineNextFrame();
 
+	/* Headless benchmark, run the logic without rendering. */
+	void StartBenchmark(int frames);
+	void EngineBenchmarkFrame();
+	bool WriteBenchmark(const char *filepath);
+
 protected:
 	bool	handleWheel(GHOST_IEvent* event);
 	bool	handleButton(GHOST_IEvent* event, bool isDown);
@@ -163,7 +168,7 @@ protected:
 	/** Converts Blender data files. */
 	KX_ISceneConverter* m_sceneconverter;
 	/** Network interface. */
-	NG_LoopBackNetworkDeviceInterface* m_networkdevice;
+	NG_NetworkDeviceInterface* m_networkdevice;
 
 	bool m_blendermat;
 	bool m_blenderglslmat;
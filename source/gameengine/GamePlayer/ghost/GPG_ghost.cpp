@@ -269,6 +269,11 @@ static void usage(const char* program, bool isBlenderPlayer)
 	printf("  -c: keep console window open\n\n");
 #endif
 	printf("  -d: turn debugging on\n\n");
+	printf("  -b: run the game logic for a number of frames without rendering, then quit\n");
+	printf("       and write the time spent per category as JSON\n");
+	printf("       --Optional parameters--\n");
+	printf("       output = JSON file path (default: standard output)\n");
+	printf("       Example: -b 1000  or  -b 1000 /tmp/benchmark.json\n\n");
 	printf("  -g: game engine options:\n\n");
 	printf("       Name                       Default      Description\n");
 	printf("       ------------------------------------------------------------------------\n");
@@ -279,11 +284,17 @@ static void usage(const char* program, bool isBlenderPlayer)
 	printf("       show_profile                   0         Show profiling information\n");
 	printf("       blender_material               0         Enable material settings\n");
 	printf("       ignore_deprecation_warnings    1         Ignore deprecation warnings\n");
+	printf("       net_port                       0         UDP port of the other player, enables the network\n");
+	printf("       net_address                              Address of the other player, wait for it when empty\n");
+	printf("       net_localport               net_port     UDP port to listen on\n");
+	printf("       net_password                             Ignore players started with another password\n");
 	printf("\n");
 	printf("  - : all arguments after this are ignored, allowing python to access them from sys.argv\n");
 	printf("\n");
 	printf("example: %s -w 320 200 10 10 -g noaudio %s%s\n", program, example_pathname, example_filename);
 	printf("example: %s -g show_framerate = 0 %s%s\n", program, example_pathname, example_filename);
+	printf("example: %s -g net_port = 7000 -g net_address = localhost -g net_localport = 7001 %s%s\n",
+	       program, example_pathname, example_filename);
 	printf("example: %s -i 232421 -m 16 %s%s\n\n", program, example_pathname, example_filename);
 }
 
@@ -433,6 +444,8 @@ int main(int argc, char** argv)
 	int validArguments=0;
 	bool samplesParFound = false;
 	GHOST_TUns16 aasamples = 0;
+	int benchmarkFrames = 0;
+	const char *benchmarkOutput = NULL;
 	
 #ifdef __linux__
 #ifdef __alpha__
@@ -691,6 +704,20 @@ int main(int argc, char** argv)
 				}
 				break;
 			}
+			case 'b': //benchmark
+			{
+				i++;
+				if ((i + 1) <= validArguments && argv[i][0] != '-') {
+					benchmarkFrames = atoi(argv[i++]);
+					if ((i + 1) <= validArguments && argv[i][0] != '-')
+						benchmarkOutput = argv[i++];
+				}
+				if (benchmarkFrames <= 0) {
+					error = true;
+					printf("error: No number of frames supplied for -b\n");
+				}
+				break;
+			}
 			case 'c': //keep console (windows only)
 			{
 				i++;
@@ -923,8 +950,14 @@ int main(int argc, char** argv)
 						
 						titlename = maggie->name;
 						
+						// Benchmarks don't render, a small window is only needed for the GL context
+						if (benchmarkFrames > 0 && (!fullScreenParFound) && (!windowParFound)) {
+							fullScreen = false;
+							windowWidth = 64;
+							windowHeight = 64;
+						}
 						// Check whether the game should be displayed full-screen
-						if ((!fullScreenParFound) && (!windowParFound)) {
+						else if ((!fullScreenParFound) && (!windowParFound)) {
 							// Only use file settings when command line did not override
 							if ((scene->gm.playerflag & GAME_PLAYER_FULLSCREEN)) {
 								//printf("fullscreen option found in Blender file\n");
@@ -1076,7 +1109,18 @@ int main(int argc, char** argv)
 #ifdef WITH_PYTHON
 						python_main = KX_GetPythonMain(scene);
 #endif // WITH_PYTHON
-						if (python_main) {
+						if (benchmarkFrames > 0) {
+							app.StartBenchmark(benchmarkFrames);
+							for (int frame = 0; frame < benchmarkFrames && !app.getExitRequested(); frame++) {
+								system->processEvents(false);
+								system->dispatchEvents();
+								app.EngineBenchmarkFrame();
+							}
+							if (!app.WriteBenchmark(benchmarkOutput))
+								error = true;
+							exitcode = KX_EXIT_REQUEST_QUIT_GAME;
+						}
+						else if (python_main) {
 							char *python_code = KX_GetPythonCode(maggie, python_main);
 							if (python_code) {
 #ifdef WITH_PYTHON
@@ -97,6 +97,7 @@ KX_GameObject::KX_GameObject(
       m_layer(0),
       m_currentLodLevel(0),
       m_previousLodLevel(0),
+      m_objectpool(NULL),
       m_pBlenderObject(NULL),
       m_pBlenderGroupObject(NULL),
       m_bUseObjectColor(false),
@@ -105,6 +106,8 @@ KX_GameObject::KX_GameObject(
       m_bVisible(true),
       m_bCulled(true),
       m_bOccluder(false),
+      m_bReplicated(false),
+      m_networkId(0),
       m_pPhysicsController(NULL),
       m_pGraphicController(NULL),
       m_pObstacleSimulation(NULL),
@@ -150,6 +153,9 @@ KX_GameObject::~KX_GameObject()
 
 	RemoveMeshes();
 
+	if (m_gridentry.m_grid)
+		m_gridentry.m_grid->RemoveObject(this);
+
 	// is this delete somewhere ?
 	//if (m_sumoObj)
 	//	delete m_sumoObj;
@@ -527,6 +533,10 @@ void KX_GameObject::ProcessReplica()
 	m_pClient_info->m_gameobject = this;
 	m_actionManager = NULL;
 	m_state = 0;
+	/* Added to the grid by the scene. */
+	m_gridentry = KX_ObjectGridEntry();
+	/* Set by the scene for replicas of pooled objects. */
+	m_objectpool = NULL;
 
 	KX_Scene* scene = KX_GetActiveScene();
 	KX_ObstacleSimulation* obssimulation = scene->GetObstacleSimulation();
@@ -543,6 +553,55 @@ void KX_GameObject::ProcessReplica()
 		
 }
 
+void KX_GameObject::ResetReplica(KX_GameObject *orgobj)
+{
+	ClearProperties();
+	std::vector<STR_String> propnames = orgobj->GetPropertyNames();
+	for (std::vector<STR_String>::iterator it = propnames.begin(); it != propnames.end(); ++it) {
+		CValue *prop = orgobj->GetProperty(*it)->GetReplica();
+		SetProperty(*it, prop);
+		prop->Release();
+	}
+
+	m_bUseObjectColor = orgobj->m_bUseObjectColor;
+	m_objectColor = orgobj->m_objectColor;
+	m_bVisible = orgobj->m_bVisible;
+	m_bOccluder = orgobj->m_bOccluder;
+	m_bReplicated = orgobj->m_bReplicated;
+	m_bRecordAnimation = orgobj->m_bRecordAnimation;
+	m_ignore_activity_culling = orgobj->m_ignore_activity_culling;
+
+	if (m_userCollisionGroup != orgobj->m_userCollisionGroup || m_userCollisionMask != orgobj->m_userCollisionMask) {
+		m_userCollisionGroup = orgobj->m_userCollisionGroup;
+		m_userCollisionMask = orgobj->m_userCollisionMask;
+		if (m_pPhysicsController)
+			m_pPhysicsController->RefreshCollisions();
+	}
+
+	if (m_actionManager) {
+		delete m_actionManager;
+		m_actionManager = NULL;
+	}
+
+	/* The logic bricks are replicated again on reuse, ResetState() must apply the
+	 * initial state to them as for a new replica. */
+	m_state = 0;
+
+#ifdef WITH_PYTHON
+	if (m_attr_dict) {
+		PyDict_Clear(m_attr_dict);
+		Py_CLEAR(m_attr_dict);
+	}
+	if (orgobj->m_attr_dict)
+		m_attr_dict = PyDict_Copy(orgobj->m_attr_dict);
+
+	if (m_collisionCallbacks) {
+		UnregisterCollisionCallbacks();
+		Py_CLEAR(m_collisionCallbacks);
+	}
+#endif  /* WITH_PYTHON */
+}
+
 static void setGraphicController_recursive(SG_Node* node)
 {
 	NodeList& children = node->GetSGChildren();
@@ -784,6 +843,7 @@ void KX_GameObject::UpdateBuckets( bool recursive )
 			ms = *mit;
 			ms->m_bObjectColor = m_bUseObjectColor;
 			ms->m_RGBAcolor = m_objectColor;
+			ms->m_layer = m_layer;
 			ms->m_bVisible = m_bVisible;
 			ms->m_bCulled = m_bCulled || !m_bVisible;
 			if (!ms->m_bCulled) 
@@ -887,8 +947,38 @@ void KX_GameObject::UpdateLod(MT_Vector3 &cam_pos)
 	}
 }
 
+void KX_GameObject::GetLodRange(float distance2, float &r_min, float &r_max)
+{
+	r_min = -FLT_MAX;
+	r_max = FLT_MAX;
+
+	if (m_lodmeshes.empty())
+		return;
+
+	/* The level only changes when the distance crosses one of the thresholds,
+	 * with or without hysteresis depending on the previous level. */
+	KX_Scene *kxscene = GetScene();
+	LodLevel *lod = (LodLevel *)GetBlenderObject()->lodlevels.first;
+
+	for (; lod && lod->next; lod = lod->next) {
+		const float hystvariance = calcHysteresis(kxscene, lod);
+		const float thresholds[2] = {lod->next->distance - hystvariance, lod->next->distance + hystvariance};
+
+		for (int i = 0; i < 2; i++) {
+			const float threshold2 = thresholds[i] * thresholds[i];
+			if (threshold2 > distance2)
+				r_max = min_ff(r_max, threshold2);
+			else
+				r_min = max_ff(r_min, threshold2);
+		}
+	}
+}
+
 void KX_GameObject::UpdateTransform()
 {
+	if (m_gridentry.m_grid)
+		m_gridentry.m_grid->ObjectMoved(this);
+
 	// HACK: saves function call for dynamic object, they are handled differently
 	if (m_pPhysicsController && !m_pPhysicsController->IsDynamic())
 		m_pPhysicsController->SetTransform();
@@ -1991,6 +2081,7 @@ PyAttributeDef KX_GameObject::Attributes[] = {
 	KX_PYATTRIBUTE_RW_FUNCTION("visible",	KX_GameObject, pyattr_get_visible,	pyattr_set_visible),
 	KX_PYATTRIBUTE_RW_FUNCTION("record_animation",	KX_GameObject, pyattr_get_record_animation,	pyattr_set_record_animation),
 	KX_PYATTRIBUTE_BOOL_RW    ("occlusion", KX_GameObject, m_bOccluder),
+	KX_PYATTRIBUTE_BOOL_RW    ("replicated", KX_GameObject, m_bReplicated),
 	KX_PYATTRIBUTE_RW_FUNCTION("position",	KX_GameObject, pyattr_get_worldPosition,	pyattr_set_localPosition),
 	KX_PYATTRIBUTE_RO_FUNCTION("localInertia",	KX_GameObject, pyattr_get_localInertia),
 	KX_PYATTRIBUTE_RW_FUNCTION("orientation",KX_GameObject,pyattr_get_worldOrientation,pyattr_set_localOrientation),
@@ -2157,8 +2248,10 @@ static int Map_SetItem(PyObject *self_v, PyObject *key, PyObject *val)
 			if (vallie) {
 				CValue* oldprop = self->GetProperty(attr_str);
 				
-				if (oldprop)
+				if (oldprop) {
 					oldprop->SetValue(vallie);
+					self->PropertyChanged();
+				}
 				else
 					self->SetProperty(attr_str, vallie);
 				
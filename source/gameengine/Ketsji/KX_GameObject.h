@@ -48,6 +48,7 @@
 #include "CTR_Map.h"
 #include "CTR_HashedPtr.h"
 #include "KX_Scene.h"
+#include "KX_ObjectGrid.h"
 #include "KX_KetsjiEngine.h" /* for m_anim_framerate */
 #include "DNA_constraint_types.h" /* for constraint replication */
 #include "DNA_object_types.h"
@@ -57,6 +58,7 @@
 struct KX_ClientObjectInfo;
 class KX_RayCast;
 class RAS_MeshObject;
+class KX_ObjectPool;
 class PHY_IGraphicController;
 class PHY_IPhysicsEnvironment;
 class PHY_IPhysicsController;
@@ -91,6 +93,8 @@ protected:
 	std::vector<RAS_MeshObject*>		m_lodmeshes;
 	int                                 m_currentLodLevel;
 	short								m_previousLodLevel;
+	KX_ObjectGridEntry					m_gridentry;
+	KX_ObjectPool*						m_objectpool;
 	SG_QList							m_meshSlots;	// head of mesh slots of this 
 	struct Object*						m_pBlenderObject;
 	struct Object*						m_pBlenderGroupObject;
@@ -108,6 +112,10 @@ protected:
 	bool       							m_bVisible; 
 	bool       							m_bCulled; 
 	bool								m_bOccluder;
+	/// The world transform is sent to the other players by the network device.
+	bool								m_bReplicated;
+	/// Spawn order among the objects of the same name, tells replicas apart on the network.
+	unsigned int						m_networkId;
 
 	PHY_IPhysicsController*				m_pPhysicsController;
 	PHY_IGraphicController*				m_pGraphicController;
@@ -835,6 +843,51 @@ public:
 		MT_Vector3 &cam_pos
 	);
 
+	/**
+	 * Get the range of squared camera distances around \a distance2
+	 * for which UpdateLod keeps the current lod level.
+	 */
+		void
+	GetLodRange(
+		float distance2,
+		float &r_min,
+		float &r_max
+	);
+
+	/**
+	 * Data of the scene object grid, used for activity culling and lod updates.
+	 */
+		KX_ObjectGridEntry&
+	GetGridEntry(
+	) {
+		return m_gridentry;
+	}
+
+	/**
+	 * Pool of the ended replicas, for the template object and its pooled replicas.
+	 */
+		KX_ObjectPool*
+	GetObjectPool(
+	) {
+		return m_objectpool;
+	}
+
+		void
+	SetObjectPool(
+		KX_ObjectPool *pool
+	) {
+		m_objectpool = pool;
+	}
+
+	/**
+	 * Restore the properties, color, visibility and python data of
+	 * \a orgobj and stop all actions, used when recycling a replica.
+	 */
+		void
+	ResetReplica(
+		KX_GameObject *orgobj
+	);
+
 	/**
 	 * Pick out a mesh associated with the integer 'num'.
 	 */
@@ -921,6 +974,24 @@ public:
 		bool v,
 		bool recursive
 	);
+
+	/**
+	 * Is the transform of this object sent over the network?
+	 */
+	bool IsReplicated() const
+	{
+		return m_bReplicated;
+	}
+
+	unsigned int GetNetworkId() const
+	{
+		return m_networkId;
+	}
+
+	void SetNetworkId(unsigned int id)
+	{
+		m_networkId = id;
+	}
 	
 	/**
 	 * Change the layer of the object (when it is added in another layer
@@ -76,6 +76,7 @@
 #include "KX_NavMeshObject.h"
 
 #include "BL_Action.h" // For managing action lock.
+#include "SCA_PythonController.h" // For benchmark python timing.
 
 #define DEFAULT_LOGIC_TIC_RATE 60.0
 //#define DEFAULT_PHYSICS_TIC_RATE 60.0
@@ -89,6 +90,7 @@
 const char KX_KetsjiEngine::m_profileLabels[tc_numCategories][15] = {
 	"Physics:",		// tc_physics
 	"Logic:",		// tc_logic
+	"Python:",		// tc_python
 	"Animations:",	// tc_animations
 	"Network:",		// tc_network
 	"Scenegraph:",	// tc_scenegraph
@@ -174,7 +176,10 @@ KX_KetsjiEngine::KX_KetsjiEngine(KX_ISystem* system)
 	m_overrideFrameColorG(0.0f),
 	m_overrideFrameColorB(0.0f),
 
-	m_usedome(false)
+	m_usedome(false),
+
+	m_benchmarkFrames(0),
+	m_benchmarkStartTime(0.0)
 {
 	// Initialize the time logger
 	m_logger = new KX_TimeCategoryLogger (25);
@@ -182,6 +187,9 @@ KX_KetsjiEngine::KX_KetsjiEngine(KX_ISystem* system)
 	for (int i = tc_first; i < tc_numCategories; i++)
 		m_logger->AddCategory((KX_TimeCategory)i);
 
+	SCA_PythonController::m_sProfileFunc = ProfilePythonController;
+	SCA_PythonController::m_sProfileData = this;
+
 #ifdef WITH_PYTHON
 	m_pyprofiledict = PyDict_New();
 #endif
@@ -198,6 +206,11 @@ KX_KetsjiEngine::KX_KetsjiEngine(KX_ISystem* system)
  */
 KX_KetsjiEngine::~KX_KetsjiEngine()
 {
+	if (SCA_PythonController::m_sProfileData == this) {
+		SCA_PythonController::m_sProfileFunc = NULL;
+		SCA_PythonController::m_sProfileData = NULL;
+	}
+
 	delete m_logger;
 	if (m_usedome)
 		delete m_dome;
@@ -519,6 +532,7 @@ void KX_KetsjiEngine::EndFrame()
 	{
 		RenderDebugProperties();
 	}
+	m_rasterizer->ResetDrawStats();
 
 	double tottime = m_logger->GetAverage();
 	if (tottime < 1e-6)
@@ -645,6 +659,7 @@ bool KX_KetsjiEngine::NextFrame()
 	
 
 		m_frameTime += framestep;
+		m_frameLogicStats = SCA_LogicStats();
 		
 		m_sceneconverter->MergeAsyncLoads();
 
@@ -675,6 +690,7 @@ bool KX_KetsjiEngine::NextFrame()
 				m_logger->StartLog(tc_network, m_kxsystem->GetTimeInSeconds(), true);
 				SG_SetActiveStage(SG_STAGE_NETWORK);
 				scene->GetNetworkScene()->proceed(m_frameTime);
+				scene->UpdateNetworkObjects();
 	
 				//m_logger->StartLog(tc_scenegraph, m_kxsystem->GetTimeInSeconds(), true);
 				//SG_SetActiveStage(SG_STAGE_NETWORK_UPDATE);
@@ -715,6 +731,11 @@ bool KX_KetsjiEngine::NextFrame()
 				scene->LogicUpdateFrame(m_frameTime, true);
 				
 				scene->LogicEndFrame();
+
+				SCA_LogicManager *logicmgr = scene->GetLogicManager();
+				m_frameLogicStats += logicmgr->GetStats();
+				m_logicStats += logicmgr->GetStats();
+				logicmgr->ResetStats();
 	
 				// Actuators can affect the scenegraph
 				m_logger->StartLog(tc_scenegraph, m_kxsystem->GetTimeInSeconds(), true);
@@ -776,6 +797,97 @@ bool KX_KetsjiEngine::NextFrame()
 
 
 
+void KX_KetsjiEngine::ProfilePythonController(void *data, bool begin)
+{
+	KX_KetsjiEngine *engine = (KX_KetsjiEngine *)data;
+
+	// Python controllers are only run by the logic.
+	engine->m_logger->StartLog((begin) ? tc_python : tc_logic, engine->m_kxsystem->GetTimeInSeconds(), true);
+}
+
+void KX_KetsjiEngine::StartBenchmark(int frames)
+{
+	SetUseFixedTime(true);
+
+	// Drop the measurements of the previous frames, keep one per benchmark frame.
+	m_logger->SetMaxNumMeasurements(1);
+	m_logger->NextMeasurement(m_kxsystem->GetTimeInSeconds());
+	m_logger->SetMaxNumMeasurements(frames + 1);
+
+	m_benchmarkFrames = 0;
+	m_benchmarkStartTime = m_kxsystem->GetTimeInSeconds();
+	m_logicStats = SCA_LogicStats();
+}
+
+void KX_KetsjiEngine::BenchmarkFrame()
+{
+	KX_SceneList::iterator sceneit;
+
+	NextFrame();
+
+	// Animations are updated in RenderFrame() otherwise.
+	m_logger->StartLog(tc_animations, m_kxsystem->GetTimeInSeconds(), true);
+	SG_SetActiveStage(SG_STAGE_ANIMATION_UPDATE);
+	for (sceneit = m_scenes.begin(); sceneit != m_scenes.end(); ++sceneit) {
+		// Culling is done while rendering, update the armatures of the whole scene instead.
+		(*sceneit)->SetIgnoreCulling(true);
+		UpdateAnimations(*sceneit);
+	}
+
+	m_logger->NextMeasurement(m_kxsystem->GetTimeInSeconds());
+	m_benchmarkFrames++;
+}
+
+bool KX_KetsjiEngine::WriteBenchmark(const char *filepath)
+{
+	FILE *fp = (filepath) ? fopen(filepath, "w") : stdout;
+
+	if (!fp) {
+		printf("Error: cannot write benchmark to '%s'\n", filepath);
+		return false;
+	}
+
+	const double totaltime = m_kxsystem->GetTimeInSeconds() - m_benchmarkStartTime;
+	const int frames = (m_benchmarkFrames > 0) ? m_benchmarkFrames : 1;
+
+	const struct {
+		const char *name;
+		double time;
+	} categories[] = {
+		{"logic", m_logger->GetAverage(tc_logic) * frames},
+		{"python", m_logger->GetAverage(tc_python) * frames},
+		{"physics", m_logger->GetAverage(tc_physics) * frames},
+		{"animations", m_logger->GetAverage(tc_animations) * frames},
+		{"scenegraph", m_logger->GetAverage(tc_scenegraph) * frames},
+		{"network", m_logger->GetAverage(tc_network) * frames},
+		{"services", m_logger->GetAverage(tc_services) * frames},
+	};
+	const int numcategories = sizeof(categories) / sizeof(*categories);
+
+	fprintf(fp, "{\n");
+	fprintf(fp, "\t\"frames\": %d,\n", m_benchmarkFrames);
+	fprintf(fp, "\t\"tic_rate\": %g,\n", m_ticrate);
+	fprintf(fp, "\t\"threads\": %d,\n", BLI_task_scheduler_num_threads(m_taskscheduler));
+	fprintf(fp, "\t\"total_ms\": %.3f,\n", totaltime * 1000.0);
+	fprintf(fp, "\t\"categories\": {\n");
+	for (int i = 0; i < numcategories; i++) {
+		fprintf(fp, "\t\t\"%s\": {\"total_ms\": %.3f, \"frame_ms\": %.4f}%s\n",
+		        categories[i].name, categories[i].time * 1000.0, categories[i].time * 1000.0 / frames,
+		        (i + 1 < numcategories) ? "," : "");
+	}
+	fprintf(fp, "\t},\n");
+	fprintf(fp, "\t\"logic_bricks\": {\"evaluated_sensors\": %u, \"skipped_sensors\": %u, "
+	        "\"controllers\": %u, \"actuators\": %u}\n",
+	        m_logicStats.m_evaluatedSensors, m_logicStats.m_skippedSensors,
+	        m_logicStats.m_triggeredControllers, m_logicStats.m_updatedActuators);
+	fprintf(fp, "}\n");
+
+	if (fp != stdout)
+		fclose(fp);
+
+	return true;
+}
+
 void KX_KetsjiEngine::Render()
 {
 	if (m_usedome) {
@@ -1385,6 +1497,7 @@ void KX_KetsjiEngine::PostProcessScene(KX_Scene* scene)
 		scene->AddCamera(activecam);
 		scene->SetActiveCamera(activecam);
 		scene->GetObjectList()->Add(activecam->AddRef());
+		scene->GetObjectGrid()->AddObject(activecam);
 		scene->GetRootParentList()->Add(activecam->AddRef());
 		// done with activecam
 		activecam->Release();
@@ -1476,6 +1589,42 @@ void KX_KetsjiEngine::RenderDebugProperties()
 			m_rasterizer->RenderBox2D(xcoord + (int)(2.2f * profile_indent), ycoord, m_canvas->GetWidth(), m_canvas->GetHeight(), (float)time/tottime);
 			ycoord += const_ysize;
 		}
+
+		m_rasterizer->RenderText2D(RAS_IRasterizer::RAS_TEXT_PADDED,
+		                            "Logic bricks:",
+		                            xcoord + const_xindent,
+		                            ycoord,
+		                            m_canvas->GetWidth(),
+		                            m_canvas->GetHeight());
+
+		debugtxt.Format("%u sensors | %u skipped | %u contr. | %u act.",
+		                m_frameLogicStats.m_evaluatedSensors, m_frameLogicStats.m_skippedSensors,
+		                m_frameLogicStats.m_triggeredControllers, m_frameLogicStats.m_updatedActuators);
+		m_rasterizer->RenderText2D(RAS_IRasterizer::RAS_TEXT_PADDED,
+		                            debugtxt.ReadPtr(),
+		                            xcoord + const_xindent + profile_indent, ycoord,
+		                            m_canvas->GetWidth(),
+		                            m_canvas->GetHeight());
+		ycoord += const_ysize;
+
+		// Draw calls of this frame, the debug text itself is not counted.
+		const RAS_DrawStats& drawstats = m_rasterizer->GetDrawStats();
+		m_rasterizer->RenderText2D(RAS_IRasterizer::RAS_TEXT_PADDED,
+		                            "Draw calls:",
+		                            xcoord + const_xindent,
+		                            ycoord,
+		                            m_canvas->GetWidth(),
+		                            m_canvas->GetHeight());
+
+		debugtxt.Format("%u draws | %u arrays | %u mat. | %u batched",
+		                drawstats.m_drawCalls, drawstats.m_arrayBinds,
+		                drawstats.m_materialBinds, drawstats.m_batchedSlots);
+		m_rasterizer->RenderText2D(RAS_IRasterizer::RAS_TEXT_PADDED,
+		                            debugtxt.ReadPtr(),
+		                            xcoord + const_xindent + profile_indent, ycoord,
+		                            m_canvas->GetWidth(),
+		                            m_canvas->GetHeight());
+		ycoord += const_ysize;
 	}
 	// Add the ymargin for titles below the other section of debug info
 	ycoord += title_y_top_margin;
@@ -40,6 +40,7 @@
 #include "KX_Scene.h"
 #include "EXP_Python.h"
 #include "KX_WorldInfo.h"
+#include "SCA_LogicManager.h"
 #include <vector>
 
 struct TaskScheduler;
@@ -154,6 +155,7 @@ private:
 		tc_first = 0,
 		tc_physics = 0,
 		tc_logic,
+		tc_python,		// python controllers, part of the logic
 		tc_animations,
 		tc_network,
 		tc_scenegraph,
@@ -206,6 +208,17 @@ private:
 	/** Task scheduler for multi-threading */
 	TaskScheduler* m_taskscheduler;
 
+	/** Number of frames run by BenchmarkFrame() and time at StartBenchmark(). */
+	int						m_benchmarkFrames;
+	double					m_benchmarkStartTime;
+
+	/** Logic bricks run since StartBenchmark() and during the last logic frame. */
+	SCA_LogicStats			m_logicStats;
+	SCA_LogicStats			m_frameLogicStats;
+
+	/** Switch between the logic and python categories around python controllers. */
+	static void				ProfilePythonController(void *data, bool begin);
+
 	void					RenderFrame(KX_Scene* scene, KX_Camera* cam);
 	void					PostRenderScene(KX_Scene* scene);
 	void					RenderDebugProperties();
@@ -249,6 +262,22 @@ public:
 	///returns true if an update happened to indicate -> Render
 	bool			NextFrame();
 	void			Render();
+
+	/**
+	 * Prepare to run \a frames logic frames with BenchmarkFrame(), the profiling
+	 * measurements of all these frames are kept for WriteBenchmark().
+	 */
+	void			StartBenchmark(int frames);
+	/**
+	 * Run one logic frame at the fixed tic rate and update the animations,
+	 * without rendering.
+	 */
+	void			BenchmarkFrame();
+	/**
+	 * Write the time spent in each category since StartBenchmark() as JSON.
+	 * \param filepath	The output file, stdout when NULL.
+	 */
+	bool			WriteBenchmark(const char *filepath);
 	
 	void			StartEngine(bool clearIpo);
 	void			StopEngine();
@@ -0,0 +1,501 @@
+/*
+ * ***** BEGIN GPL LICENSE BLOCK *****
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ * Contributor(s): none yet.
+ *
+ * ***** END GPL LICENSE BLOCK *****
+ */
+
+/** \file gameengine/Ketsji/KX_ObjectGrid.cpp
+ *  \ingroup ketsji
+ */
+
+#include <algorithm>
+#include <float.h>
+#include <math.h>
+
+#include "KX_ObjectGrid.h"
+#include "KX_GameObject.h"
+
+/* Cell coordinates are packed in 21 bits each. */
+#define CELL_CO_BITS 21
+#define CELL_CO_OFFSET (1 << (CELL_CO_BITS - 1))
+
+enum {
+	KX_GRID_MOVED           = (1 << 0),
+	KX_GRID_ACTIVITY_DIRTY  = (1 << 1),
+};
+
+KX_ObjectGridEntry::KX_ObjectGridEntry()
+	:m_grid(NULL),
+	m_cell(NULL),
+	m_index(0),
+	m_flag(0),
+	m_lodmin(FLT_MAX),
+	m_lodmax(-FLT_MAX)
+{
+}
+
+static int cell_co_clamp(float f)
+{
+	f = floorf(f);
+	if (f < (float)-CELL_CO_OFFSET)
+		return -CELL_CO_OFFSET;
+	if (f > (float)(CELL_CO_OFFSET - 1))
+		return CELL_CO_OFFSET - 1;
+	return (int)f;
+}
+
+static unsigned long long cell_key(int x, int y, int z)
+{
+	return (((unsigned long long)(x + CELL_CO_OFFSET)) << (CELL_CO_BITS * 2)) |
+	       (((unsigned long long)(y + CELL_CO_OFFSET)) << CELL_CO_BITS) |
+	       ((unsigned long long)(z + CELL_CO_OFFSET));
+}
+
+static bool point_equals(const MT_Point3& a, const MT_Point3& b)
+{
+	return (a[0] == b[0] && a[1] == b[1] && a[2] == b[2]);
+}
+
+KX_ObjectGrid::KX_ObjectGrid(float cellsize)
+	:m_cellsize(cellsize),
+	m_activityvalid(false),
+	m_activitycamloc(0.0f, 0.0f, 0.0f),
+	m_activityradius(0.0f),
+	m_lodvalid(false),
+	m_lodcamloc(0.0f, 0.0f, 0.0f),
+	m_lodtravel(0.0)
+{
+}
+
+KX_ObjectGrid::~KX_ObjectGrid()
+{
+	for (CellMap::iterator it = m_cells.begin(); it != m_cells.end(); ++it) {
+		KX_ObjectGridCell *cell = it->second;
+		for (std::vector<KX_GameObject *>::iterator oit = cell->m_objects.begin(); oit != cell->m_objects.end(); ++oit) {
+			(*oit)->GetGridEntry() = KX_ObjectGridEntry();
+		}
+		delete cell;
+	}
+}
+
+KX_ObjectGridCell *KX_ObjectGrid::FindCell(int x, int y, int z) const
+{
+	CellMap::const_iterator it = m_cells.find(cell_key(x, y, z));
+	return (it != m_cells.end()) ? it->second : NULL;
+}
+
+KX_ObjectGridCell *KX_ObjectGrid::EnsureCell(const MT_Point3& pos)
+{
+	const int x = cell_co_clamp(pos[0] / m_cellsize);
+	const int y = cell_co_clamp(pos[1] / m_cellsize);
+	const int z = cell_co_clamp(pos[2] / m_cellsize);
+	KX_ObjectGridCell *&cell = m_cells[cell_key(x, y, z)];
+
+	if (!cell) {
+		cell = new KX_ObjectGridCell();
+		cell->m_co[0] = x;
+		cell->m_co[1] = y;
+		cell->m_co[2] = z;
+		cell->m_lodmin = FLT_MAX;
+		cell->m_lodmax = -FLT_MAX;
+		cell->m_loddirty = false;
+		cell->m_loddeadline = DBL_MAX;
+	}
+	return cell;
+}
+
+void KX_ObjectGrid::InsertInCell(KX_GameObject *gameobj, KX_ObjectGridCell *cell)
+{
+	KX_ObjectGridEntry& entry = gameobj->GetGridEntry();
+
+	entry.m_cell = cell;
+	entry.m_index = cell->m_objects.size();
+	cell->m_objects.push_back(gameobj);
+
+	/* The cell LOD range doesn't account for the new object yet. */
+	cell->m_lodmin = FLT_MAX;
+	cell->m_lodmax = -FLT_MAX;
+	TagLodDirty(cell);
+}
+
+void KX_ObjectGrid::RemoveFromCell(KX_GameObject *gameobj)
+{
+	KX_ObjectGridEntry& entry = gameobj->GetGridEntry();
+	std::vector<KX_GameObject *>& objects = entry.m_cell->m_objects;
+
+	/* Swap with the last object of the cell, empty cells are kept for reuse. */
+	KX_GameObject *last = objects.back();
+	objects[entry.m_index] = last;
+	last->GetGridEntry().m_index = entry.m_index;
+	objects.pop_back();
+
+	entry.m_cell = NULL;
+}
+
+void KX_ObjectGrid::TagActivityDirty(KX_GameObject *gameobj)
+{
+	KX_ObjectGridEntry& entry = gameobj->GetGridEntry();
+
+	if (!(entry.m_flag & KX_GRID_ACTIVITY_DIRTY)) {
+		entry.m_flag |= KX_GRID_ACTIVITY_DIRTY;
+		m_activitydirty.push_back(gameobj);
+	}
+}
+
+void KX_ObjectGrid::TagLodDirty(KX_ObjectGridCell *cell)
+{
+	if (!cell->m_loddirty) {
+		cell->m_loddirty = true;
+		m_loddirty.push_back(cell);
+	}
+}
+
+void KX_ObjectGrid::AddObject(KX_GameObject *gameobj)
+{
+	KX_ObjectGridEntry& entry = gameobj->GetGridEntry();
+
+	if (entry.m_grid) {
+		if (entry.m_grid == this)
+			return;
+		entry.m_grid->RemoveObject(gameobj);
+	}
+
+	entry = KX_ObjectGridEntry();
+	entry.m_grid = this;
+	InsertInCell(gameobj, EnsureCell(gameobj->NodeGetWorldPosition()));
+	TagActivityDirty(gameobj);
+}
+
+void KX_ObjectGrid::RemoveObject(KX_GameObject *gameobj)
+{
+	KX_ObjectGridEntry& entry = gameobj->GetGridEntry();
+
+	if (entry.m_grid != this)
+		return;
+
+	RemoveFromCell(gameobj);
+
+	if (entry.m_flag & KX_GRID_MOVED) {
+		m_moved.erase(std::find(m_moved.begin(), m_moved.end(), gameobj));
+	}
+	if (entry.m_flag & KX_GRID_ACTIVITY_DIRTY) {
+		m_activitydirty.erase(std::find(m_activitydirty.begin(), m_activitydirty.end(), gameobj));
+	}
+
+	entry = KX_ObjectGridEntry();
+}
+
+void KX_ObjectGrid::ObjectMoved(KX_GameObject *gameobj)
+{
+	KX_ObjectGridEntry& entry = gameobj->GetGridEntry();
+
+	if (!(entry.m_flag & KX_GRID_MOVED)) {
+		entry.m_flag |= KX_GRID_MOVED;
+		m_moved.push_back(gameobj);
+	}
+}
+
+void KX_ObjectGrid::SetCellSize(float cellsize)
+{
+	if (cellsize == m_cellsize)
+		return;
+
+	std::vector<KX_GameObject *> objects;
+
+	for (CellMap::iterator it = m_cells.begin(); it != m_cells.end(); ++it) {
+		objects.insert(objects.end(), it->second->m_objects.begin(), it->second->m_objects.end());
+		delete it->second;
+	}
+	m_cells.clear();
+	m_loddirty.clear();
+	m_lodqueue = LodQueue();
+	m_cellsize = cellsize;
+
+	for (std::vector<KX_GameObject *>::iterator it = objects.begin(); it != objects.end(); ++it) {
+		InsertInCell(*it, EnsureCell((*it)->NodeGetWorldPosition()));
+	}
+
+	InvalidateActivity();
+	InvalidateLods();
+}
+
+void KX_ObjectGrid::InvalidateActivity()
+{
+	m_activityvalid = false;
+}
+
+void KX_ObjectGrid::InvalidateLods()
+{
+	m_lodvalid = false;
+}
+
+void KX_ObjectGrid::Flush()
+{
+	for (std::vector<KX_GameObject *>::iterator it = m_moved.begin(); it != m_moved.end(); ++it) {
+		KX_GameObject *gameobj = *it;
+		KX_ObjectGridEntry& entry = gameobj->GetGridEntry();
+		KX_ObjectGridCell *cell = EnsureCell(gameobj->NodeGetWorldPosition());
+
+		entry.m_flag &= ~KX_GRID_MOVED;
+
+		/* Moving inside a cell keeps the cell LOD range valid,
+		 * but the activity box may cut through the cell. */
+		if (cell != entry.m_cell) {
+			RemoveFromCell(gameobj);
+			InsertInCell(gameobj, cell);
+		}
+		TagActivityDirty(gameobj);
+	}
+	m_moved.clear();
+}
+
+void KX_ObjectGrid::UpdateObjectActivity(KX_GameObject *gameobj, const MT_Point3& camloc, float radius)
+{
+	if (gameobj->GetIgnoreActivityCulling())
+		return;
+
+	/* Simple test: more than radius away from the camera, count
+	 * Manhattan distance. */
+	const MT_Point3& obpos = gameobj->NodeGetWorldPosition();
+
+	if ((fabsf(camloc[0] - obpos[0]) > radius) ||
+	    (fabsf(camloc[1] - obpos[1]) > radius) ||
+	    (fabsf(camloc[2] - obpos[2]) > radius))
+	{
+		gameobj->Suspend();
+	}
+	else {
+		gameobj->Resume();
+	}
+}
+
+void KX_ObjectGrid::UpdateCellActivity(KX_ObjectGridCell *cell, const MT_Point3& camloc, float radius)
+{
+	for (std::vector<KX_GameObject *>::iterator it = cell->m_objects.begin(); it != cell->m_objects.end(); ++it) {
+		UpdateObjectActivity(*it, camloc, radius);
+	}
+}
+
+void KX_ObjectGrid::UpdateActivity(const MT_Point3& camloc, float radius)
+{
+	Flush();
+
+	if (!m_activityvalid || radius != m_activityradius) {
+		for (CellMap::iterator it = m_cells.begin(); it != m_cells.end(); ++it) {
+			UpdateCellActivity(it->second, camloc, radius);
+		}
+	}
+	else if (!point_equals(camloc, m_activitycamloc)) {
+		/* Cells fully inside both the previous and the new camera box keep their objects
+		 * active, cells outside both keep them suspended: only visit the cells in between. */
+		const MT_Vector3 extent(radius, radius, radius);
+		const MT_Point3 lo0 = m_activitycamloc - extent, hi0 = m_activitycamloc + extent;
+		const MT_Point3 lo1 = camloc - extent, hi1 = camloc + extent;
+		int min[3], max[3], imin[3], imax[3];
+		double num = 1.0, inum = 1.0;
+
+		for (int i = 0; i < 3; i++) {
+			min[i] = cell_co_clamp(std::min(lo0[i], lo1[i]) / m_cellsize);
+			max[i] = cell_co_clamp(std::max(hi0[i], hi1[i]) / m_cellsize);
+			/* Cells fully inside the intersection of both boxes. */
+			imin[i] = cell_co_clamp(std::max(lo0[i], lo1[i]) / m_cellsize) + 1;
+			imax[i] = cell_co_clamp(std::min(hi0[i], hi1[i]) / m_cellsize) - 1;
+			num *= (double)(max[i] - min[i] + 1);
+			inum *= (double)std::max(imax[i] - imin[i] + 1, 0);
+		}
+
+		if (num - inum > (double)m_cells.size()) {
+			/* Large camera jump, cheaper to test all existing cells. */
+			for (CellMap::iterator it = m_cells.begin(); it != m_cells.end(); ++it) {
+				const int *co = it->second->m_co;
+				if (co[0] >= imin[0] && co[0] <= imax[0] &&
+				    co[1] >= imin[1] && co[1] <= imax[1] &&
+				    co[2] >= imin[2] && co[2] <= imax[2])
+				{
+					continue;
+				}
+				UpdateCellActivity(it->second, camloc, radius);
+			}
+		}
+		else {
+			for (int x = min[0]; x <= max[0]; x++) {
+				for (int y = min[1]; y <= max[1]; y++) {
+					const bool inside = (x >= imin[0] && x <= imax[0] && y >= imin[1] && y <= imax[1] && imin[2] <= imax[2]);
+					for (int z = min[2]; z <= max[2]; z++) {
+						if (inside && z == imin[2]) {
+							z = imax[2];
+							continue;
+						}
+						KX_ObjectGridCell *cell = FindCell(x, y, z);
+						if (cell) {
+							UpdateCellActivity(cell, camloc, radius);
+						}
+					}
+				}
+			}
+		}
+	}
+
+	for (std::vector<KX_GameObject *>::iterator it = m_activitydirty.begin(); it != m_activitydirty.end(); ++it) {
+		(*it)->GetGridEntry().m_flag &= ~KX_GRID_ACTIVITY_DIRTY;
+		UpdateObjectActivity(*it, camloc, radius);
+	}
+	m_activitydirty.clear();
+
+	m_activityvalid = true;
+	m_activitycamloc = camloc;
+	m_activityradius = radius;
+}
+
+bool KX_ObjectGrid::UpdateCellLods(KX_ObjectGridCell *cell, const MT_Point3& camloc)
+{
+	/* Squared distance range from the camera to the cell box. */
+	float dmin2 = 0.0f, dmax2 = 0.0f;
+	for (int i = 0; i < 3; i++) {
+		const float lo = (float)cell->m_co[i] * m_cellsize - camloc[i];
+		const float hi = lo + m_cellsize;
+		const float dmin = (lo > 0.0f) ? lo : ((hi < 0.0f) ? -hi : 0.0f);
+		const float dmax = std::max(fabsf(lo), fabsf(hi));
+		dmin2 += dmin * dmin;
+		dmax2 += dmax * dmax;
+	}
+
+	if (dmin2 >= cell->m_lodmin && dmax2 < cell->m_lodmax) {
+		ScheduleCellLods(cell, dmin2, dmax2);
+		return false;
+	}
+
+	MT_Vector3 cam_pos = camloc;
+	bool outofrange = false;
+
+	cell->m_lodmin = -FLT_MAX;
+	cell->m_lodmax = FLT_MAX;
+
+	for (std::vector<KX_GameObject *>::iterator it = cell->m_objects.begin(); it != cell->m_objects.end(); ++it) {
+		KX_GameObject *gameobj = *it;
+		KX_ObjectGridEntry& entry = gameobj->GetGridEntry();
+		const float distance2 = (gameobj->NodeGetWorldPosition() - camloc).length2();
+
+		if (distance2 < entry.m_lodmin || distance2 >= entry.m_lodmax) {
+			if (gameobj->GetCulled()) {
+				/* Evaluated once visible again. */
+				outofrange = true;
+			}
+			else {
+				gameobj->UpdateLod(cam_pos);
+				gameobj->GetLodRange(distance2, entry.m_lodmin, entry.m_lodmax);
+			}
+		}
+
+		cell->m_lodmin = std::max(cell->m_lodmin, entry.m_lodmin);
+		cell->m_lodmax = std::min(cell->m_lodmax, entry.m_lodmax);
+	}
+
+	ScheduleCellLods(cell, dmin2, dmax2);
+
+	return outofrange;
+}
+
+void KX_ObjectGrid::ScheduleCellLods(KX_ObjectGridCell *cell, float dmin2, float dmax2)
+{
+	/* Distances to the camera change at most as much as the camera moves, so the cell
+	 * box stays in the LOD range until the camera traveled the distance to its bounds. */
+	double slack = DBL_MAX;
+
+	if (cell->m_lodmin > 0.0f) {
+		slack = std::min(slack, sqrt((double)dmin2) - sqrt((double)cell->m_lodmin));
+	}
+	if (cell->m_lodmax < FLT_MAX) {
+		slack = std::min(slack, sqrt((double)cell->m_lodmax) - sqrt((double)dmax2));
+	}
+
+	/* Empty cells and objects without LOD. */
+	const double deadline = (slack == DBL_MAX) ? DBL_MAX : m_lodtravel + std::max(slack, 0.0);
+
+	if (deadline == cell->m_loddeadline)
+		return;
+
+	cell->m_loddeadline = deadline;
+	if (deadline != DBL_MAX) {
+		m_lodqueue.push(LodDeadline(deadline, cell));
+		/* Drop the outdated entries of cells scheduled again before their deadline. */
+		if (m_lodqueue.size() > 2 * m_cells.size() + 64) {
+			RebuildLodQueue();
+		}
+	}
+}
+
+void KX_ObjectGrid::RebuildLodQueue()
+{
+	m_lodqueue = LodQueue();
+	for (CellMap::iterator it = m_cells.begin(); it != m_cells.end(); ++it) {
+		if (it->second->m_loddeadline != DBL_MAX) {
+			m_lodqueue.push(LodDeadline(it->second->m_loddeadline, it->second));
+		}
+	}
+}
+
+void KX_ObjectGrid::UpdateLods(const MT_Point3& camloc)
+{
+	Flush();
+
+	if (!m_lodvalid) {
+		for (CellMap::iterator it = m_cells.begin(); it != m_cells.end(); ++it) {
+			KX_ObjectGridCell *cell = it->second;
+			for (std::vector<KX_GameObject *>::iterator oit = cell->m_objects.begin(); oit != cell->m_objects.end(); ++oit) {
+				KX_ObjectGridEntry& entry = (*oit)->GetGridEntry();
+				entry.m_lodmin = FLT_MAX;
+				entry.m_lodmax = -FLT_MAX;
+			}
+			cell->m_lodmin = FLT_MAX;
+			cell->m_lodmax = -FLT_MAX;
+			TagLodDirty(cell);
+		}
+		m_lodvalid = true;
+	}
+
+	std::vector<KX_ObjectGridCell *> dirty;
+	dirty.swap(m_loddirty);
+	for (std::vector<KX_ObjectGridCell *>::iterator it = dirty.begin(); it != dirty.end(); ++it) {
+		(*it)->m_loddirty = false;
+	}
+
+	if (!point_equals(camloc, m_lodcamloc)) {
+		m_lodtravel += (camloc - m_lodcamloc).length();
+
+		/* Collect all due cells first, cells still straddling a LOD distance are scheduled
+		 * again for the next camera move. */
+		while (!m_lodqueue.empty() && m_lodqueue.top().first <= m_lodtravel) {
+			KX_ObjectGridCell *cell = m_lodqueue.top().second;
+			if (m_lodqueue.top().first == cell->m_loddeadline) {
+				cell->m_loddeadline = DBL_MAX;
+				dirty.push_back(cell);
+			}
+			m_lodqueue.pop();
+		}
+	}
+
+	for (std::vector<KX_ObjectGridCell *>::iterator it = dirty.begin(); it != dirty.end(); ++it) {
+		if (UpdateCellLods(*it, camloc)) {
+			TagLodDirty(*it);
+		}
+	}
+
+	m_lodcamloc = camloc;
+}
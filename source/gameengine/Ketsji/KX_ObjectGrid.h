@@ -0,0 +1,151 @@
+/*
+ * ***** BEGIN GPL LICENSE BLOCK *****
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ * Contributor(s): none yet.
+ *
+ * ***** END GPL LICENSE BLOCK *****
+ */
+
+/** \file KX_ObjectGrid.h
+ *  \ingroup ketsji
+ *
+ * Uniform grid of the active scene objects, keyed on their world positions.
+ * Used by activity culling and LOD selection to only visit objects whose
+ * state can have changed since the previous frame.
+ */
+
+#ifndef __KX_OBJECTGRID_H__
+#define __KX_OBJECTGRID_H__
+
+#include <functional>
+#include <map>
+#include <queue>
+#include <vector>
+
+#include "MT_Point3.h"
+
+class KX_GameObject;
+class KX_ObjectGrid;
+struct KX_ObjectGridCell;
+
+/**
+ * Per object data of the grid, stored in the game object.
+ */
+struct KX_ObjectGridEntry
+{
+	KX_ObjectGrid *m_grid;
+	KX_ObjectGridCell *m_cell;
+	/// Index in the cell object list.
+	unsigned int m_index;
+	short m_flag;
+	/// The LOD level doesn't change while the squared camera distance is in [m_lodmin, m_lodmax).
+	float m_lodmin;
+	float m_lodmax;
+
+	KX_ObjectGridEntry();
+};
+
+struct KX_ObjectGridCell
+{
+	int m_co[3];
+	std::vector<KX_GameObject *> m_objects;
+	/// Intersection of the LOD ranges of all objects in the cell.
+	float m_lodmin;
+	float m_lodmax;
+	bool m_loddirty;
+	/// Camera travel (see KX_ObjectGrid::m_lodtravel) after which the cell box may leave its LOD range.
+	double m_loddeadline;
+};
+
+class KX_ObjectGrid
+{
+	typedef std::map<unsigned long long, KX_ObjectGridCell *> CellMap;
+	typedef std::pair<double, KX_ObjectGridCell *> LodDeadline;
+	typedef std::priority_queue<LodDeadline, std::vector<LodDeadline>, std::greater<LodDeadline> > LodQueue;
+
+	float m_cellsize;
+	CellMap m_cells;
+
+	/// Objects moved since the last update, waiting for re-insertion.
+	std::vector<KX_GameObject *> m_moved;
+	/// Objects to re-test for activity culling regardless of their cell.
+	std::vector<KX_GameObject *> m_activitydirty;
+	/// Cells with objects out of their LOD range or not evaluated yet.
+	std::vector<KX_ObjectGridCell *> m_loddirty;
+
+	bool m_activityvalid;
+	MT_Point3 m_activitycamloc;
+	float m_activityradius;
+
+	bool m_lodvalid;
+	MT_Point3 m_lodcamloc;
+	/// Total distance moved by the camera, an upper bound of its displacement since any earlier update.
+	double m_lodtravel;
+	/// Cells ordered by LOD deadline, entries not matching the cell deadline are outdated.
+	LodQueue m_lodqueue;
+
+	KX_ObjectGridCell *EnsureCell(const MT_Point3& pos);
+	KX_ObjectGridCell *FindCell(int x, int y, int z) const;
+
+	void InsertInCell(KX_GameObject *gameobj, KX_ObjectGridCell *cell);
+	void RemoveFromCell(KX_GameObject *gameobj);
+
+	void TagActivityDirty(KX_GameObject *gameobj);
+	void TagLodDirty(KX_ObjectGridCell *cell);
+
+	/// Re-insert moved objects in their new cell.
+	void Flush();
+
+	void UpdateObjectActivity(KX_GameObject *gameobj, const MT_Point3& camloc, float radius);
+	void UpdateCellActivity(KX_ObjectGridCell *cell, const MT_Point3& camloc, float radius);
+	/// Returns true when some objects of the cell are left out of their LOD range.
+	bool UpdateCellLods(KX_ObjectGridCell *cell, const MT_Point3& camloc);
+	void ScheduleCellLods(KX_ObjectGridCell *cell, float dmin2, float dmax2);
+	void RebuildLodQueue();
+
+public:
+	KX_ObjectGrid(float cellsize);
+	~KX_ObjectGrid();
+
+	void AddObject(KX_GameObject *gameobj);
+	void RemoveObject(KX_GameObject *gameobj);
+	/// Called from the object transform callback, the object is re-inserted on the next update.
+	void ObjectMoved(KX_GameObject *gameobj);
+
+	/// Re-insert all objects, best kept at a fraction of the activity culling radius.
+	void SetCellSize(float cellsize);
+
+	/// Re-test all objects on the next activity update, after settings changes.
+	void InvalidateActivity();
+	/// Re-compute all LOD ranges on the next LOD update, after hysteresis settings changes.
+	void InvalidateLods();
+
+	/**
+	 * Suspend objects further than \a radius (Manhattan distance) from the camera
+	 * and resume the others. Only objects that moved and cells crossing the
+	 * boundary of the previous or new camera box are visited.
+	 */
+	void UpdateActivity(const MT_Point3& camloc, float radius);
+	/**
+	 * Update the LOD level of non culled objects. Cells whose camera distance range
+	 * is still inside the LOD range of all their objects are skipped: when the camera
+	 * moves only the cells it traveled enough to cross a LOD distance of are visited.
+	 */
+	void UpdateLods(const MT_Point3& camloc);
+};
+
+#endif  /* __KX_OBJECTGRID_H__ */
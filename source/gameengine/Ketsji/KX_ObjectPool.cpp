@@ -0,0 +1,99 @@
+/*
+ * ***** BEGIN GPL LICENSE BLOCK *****
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ * Contributor(s): none yet.
+ *
+ * ***** END GPL LICENSE BLOCK *****
+ */
+
+
+/** \file gameengine/Ketsji/KX_ObjectPool.cpp
+ *  \ingroup ketsji
+ */
+
+#include <assert.h>
+
+#include "KX_ObjectPool.h"
+#include "KX_GameObject.h"
+#include "KX_ClientObjectInfo.h"
+
+#include "DNA_object_types.h"
+
+KX_ObjectPool::KX_ObjectPool(KX_GameObject *templateobj, unsigned int size)
+	:m_template(templateobj),
+	m_size(size)
+{
+}
+
+KX_ObjectPool::~KX_ObjectPool()
+{
+	/* Pooled objects are freed by the scene, they are out of the scene lists. */
+	assert(m_objects.empty());
+}
+
+bool KX_ObjectPool::IsPoolable(KX_GameObject *templateobj)
+{
+	struct Object *blenderobject = templateobj->GetBlenderObject();
+
+	if (templateobj->GetGameObjectType() != -1 || !blenderobject)
+		return false;
+	if (blenderobject->gameflag & (OB_SOFT_BODY | OB_NAVMESH))
+		return false;
+	if (templateobj->IsDupliGroup() || templateobj->GetSGNode()->GetSGChildren().size() > 0)
+		return false;
+	if (templateobj->getClientInfo()->isSensor())
+		return false;
+
+	return true;
+}
+
+bool KX_ObjectPool::CanRecycle(KX_GameObject *gameobj)
+{
+	if (m_objects.size() >= m_size)
+		return false;
+
+	SG_Node *node = gameobj->GetSGNode();
+	if (!node || node->GetSGParent() || node->GetSGChildren().size() > 0)
+		return false;
+	if (gameobj->GetDupliGroupObject() || gameobj->GetInstanceObjects())
+		return false;
+
+	/* Replaced meshes would need new mesh slots and physics shapes. */
+	if (gameobj->GetMeshCount() != m_template->GetMeshCount())
+		return false;
+	for (int i = 0; i < gameobj->GetMeshCount(); i++) {
+		if (gameobj->GetMesh(i) != m_template->GetMesh(i))
+			return false;
+	}
+
+	return true;
+}
+
+void KX_ObjectPool::Push(KX_GameObject *gameobj)
+{
+	m_objects.push_back(gameobj);
+}
+
+KX_GameObject *KX_ObjectPool::Pop()
+{
+	if (m_objects.empty())
+		return NULL;
+
+	KX_GameObject *gameobj = m_objects.back();
+	m_objects.pop_back();
+	return gameobj;
+}
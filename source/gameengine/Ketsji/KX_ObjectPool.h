@@ -0,0 +1,91 @@
+/*
+ * ***** BEGIN GPL LICENSE BLOCK *****
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ * Contributor(s): none yet.
+ *
+ * ***** END GPL LICENSE BLOCK *****
+ */
+
+
+/** \file KX_ObjectPool.h
+ *  \ingroup ketsji
+ *
+ * Ended replicas of an added object kept for reuse by the next AddObject,
+ * instead of freeing them and replicating the object again.
+ */
+
+#ifndef __KX_OBJECTPOOL_H__
+#define __KX_OBJECTPOOL_H__
+
+#include <vector>
+
+class KX_GameObject;
+
+class KX_ObjectPool
+{
+	/// The inactive object the pooled replicas are made from.
+	KX_GameObject *m_template;
+	/// Maximum number of kept replicas.
+	unsigned int m_size;
+	/// Ended replicas ready for reuse, each holds a reference.
+	std::vector<KX_GameObject *> m_objects;
+
+public:
+	KX_ObjectPool(KX_GameObject *templateobj, unsigned int size);
+	~KX_ObjectPool();
+
+	KX_GameObject *GetTemplate() const
+	{
+		return m_template;
+	}
+
+	unsigned int GetSize() const
+	{
+		return m_size;
+	}
+
+	void SetSize(unsigned int size)
+	{
+		m_size = size;
+	}
+
+	unsigned int GetCount() const
+	{
+		return m_objects.size();
+	}
+
+	/**
+	 * Return true if \a templateobj is made of a single object that can be recycled,
+	 * hierarchies, groups, armatures, cameras, lights, texts, soft bodies and
+	 * sensor objects are always freed.
+	 */
+	static bool IsPoolable(KX_GameObject *templateobj);
+
+	/**
+	 * Return true if the ended replica \a gameobj can be kept, it must still
+	 * match the template (no parent, children or replaced meshes) and the pool
+	 * must not be full.
+	 */
+	bool CanRecycle(KX_GameObject *gameobj);
+
+	/// Keep \a gameobj, the pool takes the caller reference.
+	void Push(KX_GameObject *gameobj);
+	/// Return a kept replica with its reference or NULL if the pool is empty.
+	KX_GameObject *Pop();
+};
+
+#endif  /* __KX_OBJECTPOOL_H__ */
@@ -40,6 +40,8 @@
 #include "MT_Matrix3x3.h"
 
 #include "KX_GameObject.h" // ConvertPythonToGameObject()
+#include "KX_PythonInit.h" // KX_GetActiveEngine()
+#include "KX_KetsjiEngine.h"
 
 #include "EXP_PyObjectPlus.h" 
 
@@ -125,6 +127,11 @@ PyDoc_STRVAR(gPySetSolverType__doc__,
 "Very experimental, not recommended"
 );
 
+PyDoc_STRVAR(gPySetSolverThreads__doc__,
+"setSolverThreads(bool enable, bool deterministic=True)\n"
+"Solve independent simulation islands in the engine threads"
+);
+
 PyDoc_STRVAR(gPyCreateConstraint__doc__,
 "createConstraint(ob1,ob2,float restLength,float restitution,float damping)\n"
 ""
@@ -431,6 +438,27 @@ static PyObject *gPySetSolverType(PyObject *self,
 
 
 
+static PyObject *gPySetSolverThreads(PyObject *self,
+                                     PyObject *args,
+                                     PyObject *kwds)
+{
+	int enable;
+	int deterministic = 1;
+	static const char *kwlist[] = {"enable", "deterministic", NULL};
+
+	if (!PyArg_ParseTupleAndKeywords(args, kwds, "i|i:setSolverThreads", (char **)kwlist, &enable, &deterministic))
+		return NULL;
+
+	if (PHY_GetActiveEnvironment())
+	{
+		TaskScheduler *scheduler = enable ? KX_GetActiveEngine()->GetTaskScheduler() : NULL;
+		PHY_GetActiveEnvironment()->SetSolverThreads(scheduler, deterministic != 0);
+	}
+	Py_RETURN_NONE;
+}
+
+
+
 static PyObject *gPyGetVehicleConstraint(PyObject *self,
                                          PyObject *args,
                                          PyObject *kwds)
@@ -645,6 +673,8 @@ static struct PyMethodDef physicsconstraints_methods[] = {
 	 METH_VARARGS, (const char *)gPySetUseEpa__doc__},
 	{"setSolverType",(PyCFunction) gPySetSolverType,
 	 METH_VARARGS, (const char *)gPySetSolverType__doc__},
+	{"setSolverThreads",(PyCFunction) gPySetSolverThreads,
+	 METH_VARARGS|METH_KEYWORDS, (const char *)gPySetSolverThreads__doc__},
 
 
 	{"createConstraint",(PyCFunction) gPyCreateConstraint,
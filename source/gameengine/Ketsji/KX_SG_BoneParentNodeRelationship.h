@@ -79,6 +79,16 @@ public :
 	NewCopy(
 	);
 
+	/**
+	 * The armature pose is applied temporarily to get the bone matrix,
+	 * and it's shared by all replicas of the armature.
+	 */
+		bool
+	IsThreadSafe(
+	) {
+		return false;
+	}
+
 	~KX_BoneParentRelation(
 	);
 
@@ -36,6 +36,10 @@
 #endif
 
 #include <stdio.h>
+#include <algorithm>
+#include <climits>
+#include <map>
+#include <string>
 
 #include "KX_Scene.h"
 #include "KX_PythonInit.h"
@@ -79,11 +83,13 @@
 #include "DNA_group_types.h"
 #include "DNA_scene_types.h"
 #include "DNA_property_types.h"
+#include "DNA_constraint_types.h"
 
 #include "KX_SG_NodeRelationships.h"
 
 #include "KX_NetworkEventManager.h"
 #include "NG_NetworkScene.h"
+#include "NG_NetworkDeviceInterface.h"
 #include "PHY_IPhysicsEnvironment.h"
 #include "PHY_IGraphicController.h"
 #include "PHY_IPhysicsController.h"
@@ -94,6 +100,8 @@
 #include "BL_ShapeDeformer.h"
 #include "BL_DeformableGameObject.h"
 #include "KX_ObstacleSimulation.h"
+#include "KX_ObjectGrid.h"
+#include "KX_ObjectPool.h"
 
 #ifdef WITH_BULLET
 #  include "KX_SoftBodyDeformer.h"
@@ -126,12 +134,20 @@ static void *KX_SceneDestructionFunc(SG_IObject* node,void* gameobj,void* scene)
 
 bool KX_Scene::KX_ScenegraphUpdateFunc(SG_IObject* node,void* gameobj,void* scene)
 {
-	return ((SG_Node*)node)->Schedule(((KX_Scene*)scene)->m_sghead);
+	KX_Scene *kxscene = (KX_Scene*)scene;
+	BLI_spin_lock(&kxscene->m_sgheadlock);
+	bool scheduled = ((SG_Node*)node)->Schedule(kxscene->m_sghead);
+	BLI_spin_unlock(&kxscene->m_sgheadlock);
+	return scheduled;
 }
 
 bool KX_Scene::KX_ScenegraphRescheduleFunc(SG_IObject* node,void* gameobj,void* scene)
 {
-	return ((SG_Node*)node)->Reschedule(((KX_Scene*)scene)->m_sghead);
+	KX_Scene *kxscene = (KX_Scene*)scene;
+	BLI_spin_lock(&kxscene->m_sgheadlock);
+	bool scheduled = ((SG_Node*)node)->Reschedule(kxscene->m_sghead);
+	BLI_spin_unlock(&kxscene->m_sgheadlock);
+	return scheduled;
 }
 
 SG_Callbacks KX_Scene::m_callbacks = SG_Callbacks(
@@ -145,6 +161,9 @@ SG_Callbacks KX_Scene::m_callbacks = SG_Callbacks(
 // (defined in KX_PythonInit.cpp)
 extern bool gUseVisibilityTemp;
 
+/* Smallest cell size of the object grid, the grid is re-sized with the activity culling radius. */
+#define KX_OBJECTGRID_CELL_SIZE_MIN 4.0f
+
 KX_Scene::KX_Scene(class SCA_IInputDevice* keyboarddevice,
 				   class SCA_IInputDevice* mousedevice,
 				   class NG_NetworkDeviceInterface *ndi,
@@ -168,8 +187,11 @@ KX_Scene::KX_Scene(class SCA_IInputDevice* keyboarddevice,
 	m_suspendeddelta = 0.0;
 
 	m_dbvt_culling = false;
+	m_ignore_culling = false;
 	m_dbvt_occlusion_res = 0;
 	m_activity_culling = false;
+	m_objectgrid = new KX_ObjectGrid(KX_OBJECTGRID_CELL_SIZE_MIN);
+	m_merge = NULL;
 	m_suspend = false;
 	m_isclearingZbuffer = true;
 	m_tempObjectList = new CListValue();
@@ -180,6 +202,8 @@ KX_Scene::KX_Scene(class SCA_IInputDevice* keyboarddevice,
 	m_euthanasyobjects = new CListValue();
 	m_animatedlist = new CListValue();
 
+	BLI_spin_init(&m_sgheadlock);
+
 	m_logicmgr = new SCA_LogicManager();
 	
 	m_timemgr = new SCA_TimeEventManager(m_logicmgr);
@@ -254,6 +278,9 @@ KX_Scene::~KX_Scene()
 	// reference might be hanging and causing late release of objects
 	RemoveAllDebugProperties();
 
+	while (!m_objectpools.empty())
+		RemoveObjectPool(m_objectpools.back());
+
 	while (GetRootParentList()->GetCount() > 0) 
 	{
 		KX_GameObject* parentobj = (KX_GameObject*) GetRootParentList()->GetValue(0);
@@ -263,6 +290,9 @@ KX_Scene::~KX_Scene()
 	if (m_obstacleSimulation)
 		delete m_obstacleSimulation;
 
+	delete m_objectgrid;
+	delete m_merge;
+
 	if (m_objectlist)
 		m_objectlist->Release();
 
@@ -284,6 +314,8 @@ KX_Scene::~KX_Scene()
 	if (m_animatedlist)
 		m_animatedlist->Release();
 
+	BLI_spin_end(&m_sgheadlock);
+
 	if (m_logicmgr)
 		delete m_logicmgr;
 
@@ -430,6 +462,8 @@ void KX_Scene::Resume()
 
 void KX_Scene::SetActivityCulling(bool b)
 {
+	if (b && !m_activity_culling)
+		m_objectgrid->InvalidateActivity();
 	m_activity_culling = b;
 }
 
@@ -496,6 +530,7 @@ KX_GameObject* KX_Scene::AddNodeReplicaObject(class SG_IObject* node, class CVal
 	KX_GameObject* orgobj = (KX_GameObject*)gameobj;
 	KX_GameObject* newobj = (KX_GameObject*)orgobj->GetReplica();
 	m_map_gameobject_to_replica.insert(orgobj, newobj);
+	AssignNetworkId(newobj);
 
 	// also register 'timers' (time properties) of the replica
 	int numprops = newobj->GetPropertyCount();
@@ -537,6 +572,7 @@ KX_GameObject* KX_Scene::AddNodeReplicaObject(class SG_IObject* node, class CVal
 
 	// this is the list of object that are send to the graphics pipeline
 	m_objectlist->Add(newobj->AddRef());
+	m_objectgrid->AddObject(newobj);
 	if (newobj->GetGameObjectType()==SCA_IObject::OBJ_LIGHT)
 		m_lightlist->Add(newobj->AddRef());
 	else if (newobj->GetGameObjectType()==SCA_IObject::OBJ_TEXT)
@@ -887,8 +923,16 @@ SCA_IObject* KX_Scene::AddReplicaObject(class CValue* originalobject,
 
 	m_ueberExecutionPriority++;
 
-	// lets create a replica
-	KX_GameObject* replica = (KX_GameObject*) AddNodeReplicaObject(NULL,originalobj);
+	// lets create a replica, or reuse one of its ended replicas
+	KX_ObjectPool *pool = originalobj->GetObjectPool();
+	if (pool && pool->GetTemplate() != originalobj)
+		pool = NULL;
+
+	KX_GameObject* replica = (pool) ? AddRecycledObject(pool) : NULL;
+	if (!replica) {
+		replica = (KX_GameObject*) AddNodeReplicaObject(NULL,originalobj);
+		replica->SetObjectPool(pool);
+	}
 
 	// add a timebomb to this object
 	// lifespan of zero means 'this object lives forever'
@@ -1028,32 +1072,8 @@ void KX_Scene::DelayedRemoveObject(class CValue* gameobj)
 	}
 }
 
-int KX_Scene::NewRemoveObject(class CValue* gameobj)
+void KX_Scene::UnregisterObjectLogic(KX_GameObject *newobj)
 {
-	int ret;
-	KX_GameObject* newobj = (KX_GameObject*) gameobj;
-
-	/* remove property from debug list */
-	RemoveObjectDebugProperties(newobj);
-
-	/* Invalidate the python reference, since the object may exist in script lists
-	 * its possible that it wont be automatically invalidated, so do it manually here,
-	 * 
-	 * if for some reason the object is added back into the scene python can always get a new Proxy
-	 */
-	newobj->InvalidateProxy();
-
-	// keep the blender->game object association up to date
-	// note that all the replicas of an object will have the same
-	// blender object, that's why we need to check the game object
-	// as only the deletion of the original object must be recorded
-	m_logicmgr->UnregisterGameObj(newobj->GetBlenderObject(), gameobj);
-
-	//todo: look at this
-	//GetPhysicsEnvironment()->RemovePhysicsController(gameobj->getPhysicsController());
-
-	// remove all sensors/controllers/actuators from logicsystem...
-	
 	SCA_SensorList& sensors = newobj->GetSensors();
 	for (SCA_SensorList::iterator its = sensors.begin();
 		 !(its==sensors.end());its++)
@@ -1075,7 +1095,6 @@ int KX_Scene::NewRemoveObject(class CValue* gameobj)
 	{
 		m_logicmgr->RemoveActuator(*ita);
 	}
-	// the sensors/controllers/actuators must also be released, this is done in ~SCA_IObject
 
 	// now remove the timer properties from the time manager
 	int numprops = newobj->GetPropertyCount();
@@ -1088,6 +1107,40 @@ int KX_Scene::NewRemoveObject(class CValue* gameobj)
 			m_timemgr->RemoveTimeProperty(propval);
 		}
 	}
+}
+
+int KX_Scene::NewRemoveObject(class CValue* gameobj)
+{
+	int ret;
+	KX_GameObject* newobj = (KX_GameObject*) gameobj;
+
+	// replicas kept for this object are freed with it
+	KX_ObjectPool *pool = newobj->GetObjectPool();
+	if (pool && pool->GetTemplate() == newobj)
+		RemoveObjectPool(pool);
+
+	/* remove property from debug list */
+	RemoveObjectDebugProperties(newobj);
+
+	/* Invalidate the python reference, since the object may exist in script lists
+	 * its possible that it wont be automatically invalidated, so do it manually here,
+	 * 
+	 * if for some reason the object is added back into the scene python can always get a new Proxy
+	 */
+	newobj->InvalidateProxy();
+
+	// keep the blender->game object association up to date
+	// note that all the replicas of an object will have the same
+	// blender object, that's why we need to check the game object
+	// as only the deletion of the original object must be recorded
+	m_logicmgr->UnregisterGameObj(newobj->GetBlenderObject(), gameobj);
+
+	//todo: look at this
+	//GetPhysicsEnvironment()->RemovePhysicsController(gameobj->getPhysicsController());
+
+	// remove all sensors/controllers/actuators from logicsystem...
+	UnregisterObjectLogic(newobj);
+	// the sensors/controllers/actuators must also be released, this is done in ~SCA_IObject
 
 	// if the object is the dupligroup proxy, you have to cleanup all m_pDupliGroupObject's in all
 	// instances refering to this group
@@ -1117,6 +1170,7 @@ int KX_Scene::NewRemoveObject(class CValue* gameobj)
 	ret = 1;
 	if (newobj->GetGameObjectType()==SCA_IObject::OBJ_LIGHT && m_lightlist->RemoveValue(newobj))
 		ret = newobj->Release();
+	m_objectgrid->RemoveObject(newobj);
 	if (m_objectlist->RemoveValue(newobj))
 		ret = newobj->Release();
 	if (m_tempObjectList->RemoveValue(newobj))
@@ -1153,6 +1207,158 @@ int KX_Scene::NewRemoveObject(class CValue* gameobj)
 
 
 
+bool KX_Scene::RecycleObject(KX_GameObject *gameobj)
+{
+	KX_ObjectPool *pool = gameobj->GetObjectPool();
+
+	if (!pool || pool->GetTemplate() == gameobj || !pool->CanRecycle(gameobj))
+		return false;
+
+	// same as NewRemoveObject, except that the object, its scenegraph node,
+	// mesh slots and physics controller are kept
+	RemoveObjectDebugProperties(gameobj);
+	gameobj->InvalidateProxy();
+	m_logicmgr->UnregisterGameObj(gameobj->GetBlenderObject(), gameobj);
+
+	// restoring the dynamics needs the object in the physics world
+	gameobj->Resume();
+	PHY_IPhysicsController *ctrl = gameobj->GetPhysicsController();
+	if (ctrl) {
+		if (ctrl->IsSuspended())
+			ctrl->RestoreDynamics();
+		ctrl->SuspendPhysics();
+	}
+	if (gameobj->GetGraphicController())
+		gameobj->GetGraphicController()->Activate(false);
+	if (m_obstacleSimulation)
+		m_obstacleSimulation->DestroyObstacleForObj(gameobj);
+
+	// the logic bricks are replicated again on reuse, they hold too much state to be reset
+	UnregisterObjectLogic(gameobj);
+	gameobj->ClearLogic();
+	gameobj->ResetReplica(pool->GetTemplate());
+
+	// the pool keeps a reference, the scene lists release theirs
+	gameobj->AddRef();
+	pool->Push(gameobj);
+
+	m_objectgrid->RemoveObject(gameobj);
+	if (m_objectlist->RemoveValue(gameobj))
+		gameobj->Release();
+	if (m_tempObjectList->RemoveValue(gameobj))
+		gameobj->Release();
+	if (m_parentlist->RemoveValue(gameobj))
+		gameobj->Release();
+	if (m_euthanasyobjects->RemoveValue(gameobj))
+		gameobj->Release();
+	if (m_animatedlist->RemoveValue(gameobj))
+		gameobj->Release();
+
+	return true;
+}
+
+KX_GameObject *KX_Scene::AddRecycledObject(KX_ObjectPool *pool)
+{
+	KX_GameObject *newobj = pool->Pop();
+
+	if (!newobj)
+		return NULL;
+
+	KX_GameObject *orgobj = pool->GetTemplate();
+	m_map_gameobject_to_replica.insert(orgobj, newobj);
+	AssignNetworkId(newobj);
+
+	// also register 'timers' (time properties) of the replica
+	int numprops = newobj->GetPropertyCount();
+
+	for (int i = 0; i < numprops; i++)
+	{
+		CValue* prop = newobj->GetProperty(i);
+
+		if (prop->GetProperty("timer"))
+			this->m_timemgr->AddTimeProperty(prop);
+	}
+
+	// the physics is restored first so that the transform below is applied to it
+	PHY_IPhysicsController *ctrl = newobj->GetPhysicsController();
+	if (ctrl) {
+		ctrl->RestorePhysics();
+		ctrl->SetLinearVelocity(MT_Vector3(0.0f, 0.0f, 0.0f), false);
+		ctrl->SetAngularVelocity(MT_Vector3(0.0f, 0.0f, 0.0f), false);
+	}
+
+	SG_Node *orgnode = orgobj->GetSGNode();
+	newobj->NodeSetLocalScale(orgnode->GetLocalScale());
+	newobj->NodeSetLocalPosition(orgnode->GetLocalPosition());
+	newobj->NodeSetLocalOrientation(orgnode->GetLocalOrientation());
+
+	// the object list takes the pool reference
+	m_objectlist->Add(newobj);
+	m_objectgrid->AddObject(newobj);
+
+	if (m_obstacleSimulation && (newobj->GetBlenderObject()->gameflag & OB_HASOBSTACLE))
+		m_obstacleSimulation->AddObstacleForObj(newobj);
+
+	// fresh logic bricks are replicated from the template with the rest of the hierarchy
+	newobj->CopyLogic(orgobj);
+	m_logicHierarchicalGameObjects.push_back(newobj);
+
+	return newobj;
+}
+
+void KX_Scene::FreeRecycledObject(KX_GameObject *gameobj)
+{
+	// the object list takes the pool reference, so that NewRemoveObject frees the object
+	m_objectlist->Add(gameobj);
+	RemoveObject(gameobj);
+}
+
+bool KX_Scene::SetObjectPool(KX_GameObject *templateobj, unsigned int size)
+{
+	KX_ObjectPool *pool = templateobj->GetObjectPool();
+
+	if (size == 0) {
+		if (pool)
+			RemoveObjectPool(pool);
+		return true;
+	}
+
+	if (!KX_ObjectPool::IsPoolable(templateobj))
+		return false;
+
+	if (!pool) {
+		pool = new KX_ObjectPool(templateobj, size);
+		templateobj->SetObjectPool(pool);
+		m_objectpools.push_back(pool);
+	}
+	else {
+		pool->SetSize(size);
+		while (pool->GetCount() > size)
+			FreeRecycledObject(pool->Pop());
+	}
+
+	return true;
+}
+
+void KX_Scene::RemoveObjectPool(KX_ObjectPool *pool)
+{
+	KX_GameObject *gameobj;
+
+	while ((gameobj = pool->Pop()))
+		FreeRecycledObject(gameobj);
+
+	// the replicas still in the scene are freed when they end
+	for (int i = 0; i < m_objectlist->GetCount(); i++) {
+		gameobj = (KX_GameObject *)m_objectlist->GetValue(i);
+		if (gameobj->GetObjectPool() == pool)
+			gameobj->SetObjectPool(NULL);
+	}
+	pool->GetTemplate()->SetObjectPool(NULL);
+
+	m_objectpools.erase(std::find(m_objectpools.begin(), m_objectpools.end(), pool));
+	delete pool;
+}
+
 void KX_Scene::ReplaceMesh(class CValue* obj,void* meshobj, bool use_gfx, bool use_phys)
 {
 	KX_GameObject* gameobj = static_cast<KX_GameObject*>(obj);
@@ -1614,17 +1820,23 @@ void KX_Scene::AddAnimatedObject(CValue* gameobj)
 	m_animatedlist->Add(gameobj);
 }
 
+struct KX_AnimationUpdateData {
+	double curtime;
+	bool ignoreculling;
+};
+
 static void update_anim_thread_func(TaskPool *pool, void *taskdata, int UNUSED(threadid))
 {
 	KX_GameObject *gameobj, *child, *parent;
 	CListValue *children;
 	bool needs_update;
-	double curtime = *(double*)BLI_task_pool_userdata(pool);
+	const KX_AnimationUpdateData *data = (KX_AnimationUpdateData *)BLI_task_pool_userdata(pool);
+	double curtime = data->curtime;
 
 	gameobj = (KX_GameObject*)taskdata;
 
 	// Non-armature updates are fast enough, so just update them
-	needs_update = gameobj->GetGameObjectType() != SCA_IObject::OBJ_ARMATURE;
+	needs_update = gameobj->GetGameObjectType() != SCA_IObject::OBJ_ARMATURE || data->ignoreculling;
 
 	if (!needs_update) {
 		// If we got here, we're looking to update an armature, so check its children meshes
@@ -1681,7 +1893,8 @@ static void update_anim_thread_func(TaskPool *pool, void *taskdata, int UNUSED(t
 
 void KX_Scene::UpdateAnimations(double curtime)
 {
-	TaskPool *pool = BLI_task_pool_create(KX_GetActiveEngine()->GetTaskScheduler(), &curtime);
+	KX_AnimationUpdateData data = {curtime, m_ignore_culling};
+	TaskPool *pool = BLI_task_pool_create(KX_GetActiveEngine()->GetTaskScheduler(), &data);
 
 	for (int i=0; i<m_animatedlist->GetCount(); ++i) {
 		BLI_task_pool_push(pool, update_anim_thread_func, m_animatedlist->GetValue(i), false, TASK_PRIORITY_LOW);
@@ -1711,7 +1924,8 @@ void KX_Scene::LogicEndFrame()
 		obj = (KX_GameObject*)m_euthanasyobjects->GetValue(numobj-1);
 		m_euthanasyobjects->Remove(numobj-1);
 		obj->Release();
-		RemoveObject(obj);
+		if (!RecycleObject(obj))
+			RemoveObject(obj);
 	}
 
 	//prepare obstacle simulation for new frame
@@ -1721,6 +1935,49 @@ void KX_Scene::LogicEndFrame()
 
 
 
+/* Minimum number of scheduled hierarchies to update them in threads. */
+#ifdef DEBUG
+#  define KX_SG_THREAD_THRESHOLD 1
+#else
+#  define KX_SG_THREAD_THRESHOLD 256
+#endif
+
+void KX_Scene::UpdateParentsTask(TaskPool *UNUSED(pool), void *taskdata, int UNUSED(threadid))
+{
+	SGUpdateTask *task = (SGUpdateTask *)taskdata;
+	std::vector<std::pair<SG_Node *, SG_Node *> >& roots = task->m_scene->m_sgupdateroots;
+
+	task->m_nodes.clear();
+	task->m_serialnodes.clear();
+
+	size_t i = task->m_begin;
+	while (i < task->m_end) {
+		// all scheduled nodes of a hierarchy
+		const size_t first = task->m_nodes.size();
+		size_t end = i + 1;
+		bool threadsafe = true;
+
+		while (end < task->m_end && roots[end].first == roots[i].first) {
+			end++;
+		}
+		for (size_t j = i; j < end; j++) {
+			threadsafe &= roots[j].second->GetUpdateList(task->m_nodes);
+		}
+
+		if (threadsafe) {
+			SG_Node::UpdateWorldDataList(task->m_nodes, first, task->m_time);
+		}
+		else {
+			task->m_nodes.erase(task->m_nodes.begin() + first, task->m_nodes.end());
+			for (size_t j = i; j < end; j++) {
+				task->m_serialnodes.push_back(roots[j].second);
+			}
+		}
+
+		i = end;
+	}
+}
+
 /**
  * UpdateParents: SceneGraph transformation update.
  */
@@ -1729,6 +1986,66 @@ void KX_Scene::UpdateParents(double curtime)
 	// we use the SG dynamic list
 	SG_Node* node;
 
+	TaskScheduler *scheduler = KX_GetActiveEngine()->GetTaskScheduler();
+	const int num_threads = BLI_task_scheduler_num_threads(scheduler);
+
+	// Scheduled nodes without a scheduled parent are updated with all their children,
+	// hierarchies are independent from each other so they can be updated in parallel.
+	SG_DList::iterator<SG_Node> it(m_sghead);
+	m_sgupdateroots.clear();
+	for (it.begin(); num_threads > 1 && !it.end(); ++it) {
+		SG_Node *root = *it;
+		bool parentscheduled = false;
+
+		for (SG_Node *parent = root->GetSGParent(); parent; parent = parent->GetSGParent()) {
+			if (!parent->Empty()) {
+				parentscheduled = true;
+				break;
+			}
+			root = parent;
+		}
+		if (!parentscheduled) {
+			m_sgupdateroots.push_back(std::make_pair(root, *it));
+		}
+	}
+
+	if (m_sgupdateroots.size() >= KX_SG_THREAD_THRESHOLD) {
+		// keep hierarchies in a single task
+		std::sort(m_sgupdateroots.begin(), m_sgupdateroots.end());
+
+		const size_t num_tasks = std::min(m_sgupdateroots.size(), (size_t)num_threads * 4);
+		TaskPool *pool = BLI_task_pool_create(scheduler, NULL);
+
+		m_sgupdatetasks.resize(num_tasks);
+		size_t begin = 0;
+		for (size_t i = 0; i < num_tasks; i++) {
+			SGUpdateTask& task = m_sgupdatetasks[i];
+			size_t end = (i == num_tasks - 1) ? m_sgupdateroots.size() : std::max(begin, (m_sgupdateroots.size() * (i + 1)) / num_tasks);
+
+			while (end > begin && end < m_sgupdateroots.size() && m_sgupdateroots[end - 1].first == m_sgupdateroots[end].first) {
+				end++;
+			}
+
+			task.m_scene = this;
+			task.m_time = curtime;
+			task.m_begin = begin;
+			task.m_end = end;
+			BLI_task_pool_push(pool, UpdateParentsTask, &task, false, TASK_PRIORITY_HIGH);
+			begin = end;
+		}
+
+		BLI_task_pool_work_and_wait(pool);
+		BLI_task_pool_free(pool);
+
+		// physics and culling tree updates aren't thread safe
+		for (std::vector<SGUpdateTask>::iterator tit = m_sgupdatetasks.begin(); tit != m_sgupdatetasks.end(); ++tit) {
+			SG_Node::EndUpdateWorldDataList(tit->m_nodes);
+			for (NodeList::iterator nit = tit->m_serialnodes.begin(); nit != tit->m_serialnodes.end(); ++nit) {
+				(*nit)->UpdateWorldData(curtime);
+			}
+		}
+	}
+
 	while ((node = SG_Node::GetNextScheduled(m_sghead)) != NULL)
 	{
 		node->UpdateWorldData(curtime);
@@ -1775,24 +2092,18 @@ void KX_Scene::RenderFonts()
 
 void KX_Scene::UpdateObjectLods(void)
 {
-	KX_GameObject* gameobj;
-
 	if (!this->m_active_camera)
 		return;
 
-	MT_Vector3 cam_pos = this->m_active_camera->NodeGetWorldPosition();
+	MT_Point3 cam_pos = this->m_active_camera->NodeGetWorldPosition();
 
-	for (int i = 0; i < this->GetObjectList()->GetCount(); i++) {
-		gameobj = (KX_GameObject*) GetObjectList()->GetValue(i);
-		if (!gameobj->GetCulled()){
-			gameobj->UpdateLod(cam_pos);
-		}
-	}
+	m_objectgrid->UpdateLods(cam_pos);
 }
 
 void KX_Scene::SetLodHysteresis(bool active)
 {
 	m_isActivedHysteresis = active;
+	m_objectgrid->InvalidateLods();
 }
 
 bool KX_Scene::IsActivedLodHysteresis(void)
@@ -1803,6 +2114,7 @@ bool KX_Scene::IsActivedLodHysteresis(void)
 void KX_Scene::SetLodHysteresisValue(int hysteresisvalue)
 {
 	m_lodHysteresisValue = hysteresisvalue;
+	m_objectgrid->InvalidateLods();
 }
 
 int KX_Scene::GetLodHysteresisValue(void)
@@ -1814,30 +2126,9 @@ void KX_Scene::UpdateObjectActivity(void)
 {
 	if (m_activity_culling) {
 		/* determine the activity criterium and set objects accordingly */
-		int i=0;
-		
 		MT_Point3 camloc = GetActiveCamera()->NodeGetWorldPosition(); //GetCameraLocation();
-		
-		for (i=0;i<GetObjectList()->GetCount();i++)
-		{
-			KX_GameObject* ob = (KX_GameObject*) GetObjectList()->GetValue(i);
-			
-			if (!ob->GetIgnoreActivityCulling()) {
-				/* Simple test: more than 10 away from the camera, count
-				 * Manhattan distance. */
-				MT_Point3 obpos = ob->NodeGetWorldPosition();
-				
-				if ((fabsf(camloc[0] - obpos[0]) > m_activity_box_radius) ||
-				    (fabsf(camloc[1] - obpos[1]) > m_activity_box_radius) ||
-				    (fabsf(camloc[2] - obpos[2]) > m_activity_box_radius) )
-				{
-					ob->Suspend();
-				}
-				else {
-					ob->Resume();
-				}
-			}
-		}
+
+		m_objectgrid->UpdateActivity(camloc, m_activity_box_radius);
 	}
 }
 
@@ -1846,6 +2137,8 @@ void KX_Scene::SetActivityCullingRadius(float f)
 	if (f < 0.5f)
 		f = 0.5f;
 	m_activity_box_radius = f;
+	/* Keep the activity box a few cells wide. */
+	m_objectgrid->SetCellSize(std::max(f * 0.5f, KX_OBJECTGRID_CELL_SIZE_MIN));
 }
 	
 NG_NetworkDeviceInterface* KX_Scene::GetNetworkDeviceInterface()
@@ -1858,6 +2151,46 @@ NG_NetworkScene* KX_Scene::GetNetworkScene()
 	return m_networkScene;
 }
 
+void KX_Scene::UpdateNetworkObjects()
+{
+	if (!m_networkDeviceInterface->IsOnline() || !m_networkDeviceInterface->HasObjectReplication())
+		return;
+
+	float position[3];
+	float orientation[4];
+
+	for (int i = 0; i < m_objectlist->GetCount(); ++i) {
+		KX_GameObject *gameobj = (KX_GameObject *)m_objectlist->GetValue(i);
+
+		if (gameobj->IsReplicated()) {
+			gameobj->NodeGetWorldPosition().getValue(position);
+			gameobj->NodeGetWorldOrientation().getRotation().getValue(orientation);
+			m_networkDeviceInterface->SendObjectState(gameobj->GetName(), gameobj->GetNetworkId(), position, orientation);
+		}
+		else if (m_networkDeviceInterface->GetObjectState(gameobj->GetName(), gameobj->GetNetworkId(), position, orientation)) {
+			gameobj->NodeSetWorldPosition(MT_Point3(position));
+			gameobj->NodeSetGlobalOrientation(MT_Matrix3x3(MT_Quaternion(orientation)));
+
+			// The other player simulates the object, the physics only follows.
+			PHY_IPhysicsController *ctrl = gameobj->GetPhysicsController();
+			if (ctrl) {
+				gameobj->NodeUpdateGS(0.0f);
+				ctrl->SetTransform();
+				if (ctrl->IsDynamic()) {
+					ctrl->SetLinearVelocity(MT_Vector3(0.0f, 0.0f, 0.0f), false);
+					ctrl->SetAngularVelocity(MT_Vector3(0.0f, 0.0f, 0.0f), false);
+				}
+			}
+		}
+	}
+}
+
+void KX_Scene::AssignNetworkId(KX_GameObject *gameobj)
+{
+	// Converted objects have unique names and keep the id 0.
+	gameobj->SetNetworkId(++m_networkSpawnCount[gameobj->GetName()]);
+}
+
 void KX_Scene::SetNetworkDeviceInterface(NG_NetworkDeviceInterface* newInterface)
 {
 	m_networkDeviceInterface = newInterface;
@@ -2011,10 +2344,6 @@ static void MergeScene_GameObject(KX_GameObject* gameobj, KX_Scene *to, KX_Scene
 					children[i]->SetSGClientInfo(to);
 		}
 	}
-	/* If the object is a light, update it's scene */
-	if (gameobj->GetGameObjectType() == SCA_IObject::OBJ_LIGHT)
-		((KX_LightObject*)gameobj)->UpdateScene(to);
-
 	if (gameobj->GetGameObjectType() == SCA_IObject::OBJ_CAMERA)
 		to->AddCamera((KX_Camera*)gameobj);
 
@@ -2034,7 +2363,73 @@ static void MergeScene_GameObject(KX_GameObject* gameobj, KX_Scene *to, KX_Scene
 	}
 }
 
+/// Active objects of a scene merged over several steps.
+struct KX_SceneMerge
+{
+	/// Hierarchies and objects with linked logic bricks, added together by MergeSceneObjects().
+	std::vector<std::vector<KX_GameObject *> > m_units;
+	unsigned int m_nextunit;
+	/// Objects of the units using rigid body constraints, added by MergeSceneEnd().
+	std::vector<KX_GameObject *> m_deferred;
+	std::set<CValue *> m_added;
+	std::set<CValue *> m_roots;
+	std::set<CValue *> m_lights;
+	unsigned int m_numleft;
+};
+
+static int MergeScene_FindUnit(std::vector<int>& units, int i)
+{
+	while (units[i] != i) {
+		units[i] = units[units[i]];
+		i = units[i];
+	}
+	return i;
+}
+
+static void MergeScene_JoinUnits(std::vector<int>& units, int a, int b)
+{
+	a = MergeScene_FindUnit(units, a);
+	b = MergeScene_FindUnit(units, b);
+	// The first object of the list stays the unit root, units are added in list order.
+	if (a < b)
+		units[b] = a;
+	else
+		units[a] = b;
+}
+
+static void MergeScene_AddObject(KX_GameObject *gameobj, KX_Scene *to, KX_Scene *from, KX_SceneMerge *merge)
+{
+	MergeScene_GameObject(gameobj, to, from);
+	to->GetObjectGrid()->AddObject(gameobj);
+
+	/* add properties to debug list for LibLoad objects */
+	if (KX_GetActiveEngine()->GetAutoAddDebugProperties()) {
+		to->AddObjectDebugProperties(gameobj);
+	}
+
+	gameobj->UpdateBuckets(false); /* only for active objects */
+
+	to->GetObjectList()->Add(gameobj->AddRef());
+	if (merge->m_roots.count(gameobj))
+		to->GetRootParentList()->Add(gameobj->AddRef());
+	if (merge->m_lights.count(gameobj))
+		to->GetLightList()->Add(gameobj->AddRef());
+
+	merge->m_added.insert(gameobj);
+	merge->m_numleft--;
+}
+
 bool KX_Scene::MergeScene(KX_Scene *other)
+{
+	if (!MergeSceneBegin(other))
+		return false;
+
+	MergeSceneObjects(other, UINT_MAX);
+	MergeSceneEnd(other);
+	return true;
+}
+
+bool KX_Scene::MergeSceneBegin(KX_Scene *other)
 {
 	PHY_IPhysicsEnvironment *env = this->GetPhysicsEnvironment();
 	PHY_IPhysicsEnvironment *env_other = other->GetPhysicsEnvironment();
@@ -2052,21 +2447,158 @@ bool KX_Scene::MergeScene(KX_Scene *other)
 	}
 
 
-	GetBucketManager()->MergeBucketManager(other->GetBucketManager(), this);
+	// pooled replicas are out of the scene lists, free them before they can't be reached
+	while (!other->m_objectpools.empty())
+		other->RemoveObjectPool(other->m_objectpools.back());
 
+	GetBucketManager()->MergeBucketManager(other->GetBucketManager(), this);
 
 	/* active + inactive == all ??? - lets hope so */
-	for (int i = 0; i < other->GetObjectList()->GetCount(); i++)
-	{
-		KX_GameObject* gameobj = (KX_GameObject*)other->GetObjectList()->GetValue(i);
-		MergeScene_GameObject(gameobj, this, other);
+	CListValue *objects = other->GetObjectList();
+	const int numobjects = objects->GetCount();
+
+	std::map<SCA_IObject *, int> indices;
+	std::map<std::string, int> names;
+	std::vector<int> units(numobjects);
+	std::vector<bool> constrained(numobjects, false);
+
+	for (int i = 0; i < numobjects; ++i) {
+		KX_GameObject *gameobj = (KX_GameObject *)objects->GetValue(i);
+		indices[gameobj] = i;
+		names[gameobj->GetName().ReadPtr()] = i;
+		units[i] = i;
+	}
+
+	for (int i = 0; i < numobjects; ++i) {
+		KX_GameObject *gameobj = (KX_GameObject *)objects->GetValue(i);
+		std::map<SCA_IObject *, int>::iterator indexit;
+
+		// Children are added with their parent.
+		indexit = indices.find(gameobj->GetParent());
+		if (indexit != indices.end())
+			MergeScene_JoinUnits(units, i, indexit->second);
+
+		// Bricks can only run once the bricks they are linked to are merged.
+		SCA_ControllerList& controllers = gameobj->GetControllers();
+		for (SCA_ControllerList::iterator itc = controllers.begin(); itc != controllers.end(); ++itc) {
+			std::vector<SCA_ISensor *>& sensors = (*itc)->GetLinkedSensors();
+			for (std::vector<SCA_ISensor *>::iterator its = sensors.begin(); its != sensors.end(); ++its) {
+				indexit = indices.find((*its)->GetParent());
+				if (indexit != indices.end())
+					MergeScene_JoinUnits(units, i, indexit->second);
+			}
+
+			std::vector<SCA_IActuator *>& actuators = (*itc)->GetLinkedActuators();
+			for (std::vector<SCA_IActuator *>::iterator ita = actuators.begin(); ita != actuators.end(); ++ita) {
+				indexit = indices.find((*ita)->GetParent());
+				if (indexit != indices.end())
+					MergeScene_JoinUnits(units, i, indexit->second);
+			}
+		}
+
+		// Constraints are replicated between the objects added in MergeSceneEnd().
+		std::vector<bRigidBodyJointConstraint *> constraints = gameobj->GetConstraints();
+		for (std::vector<bRigidBodyJointConstraint *>::iterator consit = constraints.begin(); consit != constraints.end(); ++consit) {
+			bRigidBodyJointConstraint *dat = *consit;
+			constrained[i] = true;
+
+			if (dat->tar) {
+				std::map<std::string, int>::iterator nameit = names.find(dat->tar->id.name + 2);
+				if (nameit != names.end())
+					MergeScene_JoinUnits(units, i, nameit->second);
+			}
+		}
+	}
+
+	std::vector<bool> deferred(numobjects, false);
+	for (int i = 0; i < numobjects; ++i) {
+		if (constrained[i])
+			deferred[MergeScene_FindUnit(units, i)] = true;
+	}
+
+	KX_SceneMerge *merge = new KX_SceneMerge();
+	std::vector<int> unitindices(numobjects, -1);
+
+	for (int i = 0; i < numobjects; ++i) {
+		KX_GameObject *gameobj = (KX_GameObject *)objects->GetValue(i);
+		const int root = MergeScene_FindUnit(units, i);
+
+		if (deferred[root]) {
+			merge->m_deferred.push_back(gameobj);
+			continue;
+		}
 
-		/* add properties to debug list for LibLoad objects */
-		if (KX_GetActiveEngine()->GetAutoAddDebugProperties()) {
-			AddObjectDebugProperties(gameobj);
+		if (unitindices[root] == -1) {
+			unitindices[root] = merge->m_units.size();
+			merge->m_units.push_back(std::vector<KX_GameObject *>());
 		}
+		merge->m_units[unitindices[root]].push_back(gameobj);
+	}
+
+	for (int i = 0; i < other->GetRootParentList()->GetCount(); i++)
+		merge->m_roots.insert(other->GetRootParentList()->GetValue(i));
+	for (int i = 0; i < other->GetLightList()->GetCount(); i++)
+		merge->m_lights.insert(other->GetLightList()->GetValue(i));
+
+	merge->m_nextunit = 0;
+	merge->m_numleft = numobjects;
+
+	/* Lights are added to the blender scene before the materials are moved
+	 * across, so materials can use the lights in shaders */
+	CListValue *lists[2] = {objects, other->GetInactiveList()};
+	for (unsigned int l = 0; l < 2; ++l) {
+		for (int i = 0; i < lists[l]->GetCount(); ++i) {
+			KX_GameObject *gameobj = (KX_GameObject *)lists[l]->GetValue(i);
+			if (gameobj->GetGameObjectType() == SCA_IObject::OBJ_LIGHT)
+				((KX_LightObject *)gameobj)->UpdateScene(this);
+		}
+	}
+
+	/* move materials across, assume they both use the same scene-converters
+	 * The converter data is shared with the conversion threads, the caller
+	 * must own KX_BlenderSceneConverter's conversion lock.
+	 */
+	GetSceneConverter()->MergeScene(this, other);
+
+	delete other->m_merge;
+	other->m_merge = merge;
+
+	return true;
+}
+
+unsigned int KX_Scene::MergeSceneObjects(KX_Scene *other, unsigned int maxobjects)
+{
+	KX_SceneMerge *merge = other->m_merge;
+	unsigned int numadded = 0;
+
+	while (numadded < maxobjects && merge->m_nextunit < merge->m_units.size()) {
+		std::vector<KX_GameObject *>& unit = merge->m_units[merge->m_nextunit++];
+
+		for (std::vector<KX_GameObject *>::iterator it = unit.begin(); it != unit.end(); ++it)
+			MergeScene_AddObject(*it, this, other, merge);
 
-		gameobj->UpdateBuckets(false); /* only for active objects */
+		numadded += unit.size();
+	}
+
+	return merge->m_numleft;
+}
+
+void KX_Scene::MergeSceneEnd(KX_Scene *other)
+{
+	KX_SceneMerge *merge = other->m_merge;
+	PHY_IPhysicsEnvironment *env = this->GetPhysicsEnvironment();
+
+	MergeSceneObjects(other, UINT_MAX);
+
+	// List of all physics objects to merge (needed by ReplicateConstraints).
+	std::vector<KX_GameObject *> physicsObjects;
+	for (std::vector<KX_GameObject *>::iterator it = merge->m_deferred.begin(); it != merge->m_deferred.end(); ++it) {
+		KX_GameObject *gameobj = *it;
+		MergeScene_AddObject(gameobj, this, other, merge);
+
+		if (gameobj->GetPhysicsController()) {
+			physicsObjects.push_back(gameobj);
+		}
 	}
 
 	for (int i = 0; i < other->GetInactiveList()->GetCount(); i++)
@@ -2076,17 +2608,7 @@ bool KX_Scene::MergeScene(KX_Scene *other)
 	}
 
 	if (env) {
-		env->MergeEnvironment(env_other);
-		CListValue *otherObjects = other->GetObjectList();
-
-		// List of all physics objects to merge (needed by ReplicateConstraints).
-		std::vector<KX_GameObject *> physicsObjects;
-		for (unsigned int i = 0; i < otherObjects->GetCount(); ++i) {
-			KX_GameObject *gameobj = (KX_GameObject *)otherObjects->GetValue(i);
-			if (gameobj->GetPhysicsController()) {
-				physicsObjects.push_back(gameobj);
-			}
-		}
+		env->MergeEnvironment(other->GetPhysicsEnvironment());
 
 		for (unsigned int i = 0; i < physicsObjects.size(); ++i) {
 			KX_GameObject *gameobj = physicsObjects[i];
@@ -2100,23 +2622,26 @@ bool KX_Scene::MergeScene(KX_Scene *other)
 	GetTempObjectList()->MergeList(other->GetTempObjectList());
 	other->GetTempObjectList()->ReleaseAndRemoveAll();
 
-	GetObjectList()->MergeList(other->GetObjectList());
+	// Active objects were added to the lists one by one.
 	other->GetObjectList()->ReleaseAndRemoveAll();
 
 	GetInactiveList()->MergeList(other->GetInactiveList());
 	other->GetInactiveList()->ReleaseAndRemoveAll();
 
-	GetRootParentList()->MergeList(other->GetRootParentList());
+	for (int i = 0; i < other->GetRootParentList()->GetCount(); i++) {
+		CValue *value = other->GetRootParentList()->GetValue(i);
+		if (!merge->m_added.count(value))
+			GetRootParentList()->Add(value->AddRef());
+	}
 	other->GetRootParentList()->ReleaseAndRemoveAll();
 
-	GetLightList()->MergeList(other->GetLightList());
+	for (int i = 0; i < other->GetLightList()->GetCount(); i++) {
+		CValue *value = other->GetLightList()->GetValue(i);
+		if (!merge->m_added.count(value))
+			GetLightList()->Add(value->AddRef());
+	}
 	other->GetLightList()->ReleaseAndRemoveAll();
 
-	/* move materials across, assume they both use the same scene-converters
-	 * Do this after lights are merged so materials can use the lights in shaders
-	 */
-	GetSceneConverter()->MergeScene(this, other);
-
 	/* merge logic */
 	{
 		SCA_LogicManager *logicmgr=			GetLogicManager();
@@ -2147,7 +2672,9 @@ bool KX_Scene::MergeScene(KX_Scene *other)
 		}
 		
 	}
-	return true;
+
+	delete merge;
+	other->m_merge = NULL;
 }
 
 void KX_Scene::Update2DFilter(vector<STR_String>& propNames, void* gameObj, RAS_2DFilterManager::RAS_2DFILTER_MODE filtermode, int pass, STR_String& text)
@@ -2206,6 +2733,7 @@ PyMethodDef KX_Scene::Methods[] = {
 	KX_PYMETHODTABLE(KX_Scene, suspend),
 	KX_PYMETHODTABLE(KX_Scene, resume),
 	KX_PYMETHODTABLE(KX_Scene, drawObstacleSimulation),
+	KX_PYMETHODTABLE(KX_Scene, setObjectPool),
 
 	
 	/* dict style access */
@@ -2557,6 +3085,36 @@ KX_PYMETHODDEF_DOC(KX_Scene, addObject,
 	return replica->GetProxy();
 }
 
+KX_PYMETHODDEF_DOC(KX_Scene, setObjectPool,
+"setObjectPool(object, size)\n"
+"Keeps up to size ended replicas of object to reuse them in addObject, 0 frees them.\n")
+{
+	PyObject *pyob;
+	KX_GameObject *ob;
+	int size;
+
+	if (!PyArg_ParseTuple(args, "Oi:setObjectPool", &pyob, &size))
+		return NULL;
+
+	if (!ConvertPythonToGameObject(pyob, &ob, false, "scene.setObjectPool(object, size): KX_Scene (first argument)"))
+		return NULL;
+
+	if (size < 0) {
+		PyErr_SetString(PyExc_ValueError, "scene.setObjectPool(object, size): KX_Scene (second argument): size must be positive");
+		return NULL;
+	}
+	if (!m_inactivelist->SearchValue(ob)) {
+		PyErr_SetString(PyExc_ValueError, "scene.setObjectPool(object, size): KX_Scene (first argument): object must be in an inactive layer");
+		return NULL;
+	}
+	if (!SetObjectPool(ob, (unsigned int)size)) {
+		PyErr_SetString(PyExc_ValueError, "scene.setObjectPool(object, size): KX_Scene (first argument): object can't be pooled, it must be a single mesh or empty object, not a group instance, soft body or sensor");
+		return NULL;
+	}
+
+	Py_RETURN_NONE;
+}
+
 KX_PYMETHODDEF_DOC(KX_Scene, end,
 "end()\n"
 "Removes this scene from the game.\n")
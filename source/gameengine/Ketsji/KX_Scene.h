@@ -38,10 +38,12 @@
 #include <vector>
 #include <set>
 #include <list>
+#include <map>
 
 #include "CTR_Map.h"
 #include "CTR_HashedPtr.h"
 #include "SG_IObject.h"
+#include "SG_Node.h"
 #include "SCA_IScene.h"
 #include "MT_Transform.h"
 
@@ -52,6 +54,8 @@
 #include "EXP_PyObjectPlus.h"
 #include "RAS_2DFilterManager.h"
 
+#include "BLI_threads.h"
+
 /**
  * \section Forward declarations
  */
@@ -87,6 +91,8 @@ class btCollisionShape;
 class KX_BlenderSceneConverter;
 struct KX_ClientObjectInfo;
 class KX_ObstacleSimulation;
+class KX_ObjectGrid;
+class KX_ObjectPool;
 
 #ifdef WITH_CXX_GUARDEDALLOC
 #include "MEM_guardedalloc.h"
@@ -136,6 +142,24 @@ protected:
 										// the Dlist is not object that must be updated
 										// the Qlist is for objects that needs to be rescheduled
 										// for updates after udpate is over (slow parent, bone parent)
+	SpinLock			m_sgheadlock;	// scheduling happens from threads in UpdateParents()
+
+	/**
+	 * Threaded scenegraph update, each task updates whole hierarchies
+	 * (grouped by their top parent) from m_sgupdateroots.
+	 */
+	struct SGUpdateTask
+	{
+		KX_Scene *m_scene;
+		double m_time;
+		size_t m_begin, m_end;
+		SG_NodeUpdateList m_nodes;
+		NodeList m_serialnodes; // can't be updated from a thread
+	};
+	std::vector<std::pair<SG_Node *, SG_Node *> > m_sgupdateroots; // top parent, scheduled node
+	std::vector<SGUpdateTask> m_sgupdatetasks;
+
+	static void UpdateParentsTask(struct TaskPool *pool, void *taskdata, int threadid);
 
 
 	/**
@@ -190,6 +214,8 @@ protected:
 	 */
 	NG_NetworkDeviceInterface*	m_networkDeviceInterface;
 	NG_NetworkScene* m_networkScene;
+	/// Number of objects spawned per name, see AssignNetworkId().
+	std::map<STR_String, unsigned int> m_networkSpawnCount;
 
 	/**
 	 * A temporary variable used to parent objects together on
@@ -256,11 +282,32 @@ protected:
 	 * Toggle to enable or disable activity culling.
 	 */
 	bool m_activity_culling;
+
+	/**
+	 * Grid of the active objects, used to limit activity culling
+	 * and lod updates to the objects that can have changed.
+	 */
+	KX_ObjectGrid *m_objectgrid;
+
+	/**
+	 * Pools of ended replicas, reused by AddReplicaObject.
+	 */
+	std::vector<KX_ObjectPool *> m_objectpools;
+
+	/**
+	 * Objects left to add when this scene is merged in several steps, see MergeSceneBegin.
+	 */
+	struct KX_SceneMerge *m_merge;
 	
 	/**
 	 * Toggle to enable or disable culling via DBVT broadphase of Bullet.
 	 */
 	bool m_dbvt_culling;
+
+	/**
+	 * Update the armatures of culled objects too, for frames run without rendering.
+	 */
+	bool m_ignore_culling;
 	
 	/**
 	 * Occlusion culling resolution
@@ -302,6 +349,15 @@ protected:
 	bool m_isActivedHysteresis;
 	int m_lodHysteresisValue;
 
+	/// Remove the logic bricks and timer properties of \a gameobj from the managers.
+	void UnregisterObjectLogic(KX_GameObject *gameobj);
+	/// Move an ended replica in its object pool, return false if it must be freed instead.
+	bool RecycleObject(KX_GameObject *gameobj);
+	/// Add back a replica kept in \a pool, return NULL if the pool is empty.
+	KX_GameObject *AddRecycledObject(KX_ObjectPool *pool);
+	/// Free a replica taken out of its pool.
+	void FreeRecycledObject(KX_GameObject *gameobj);
+
 public:
 	KX_Scene(class SCA_IInputDevice* keyboarddevice,
 		class SCA_IInputDevice* mousedevice,
@@ -343,6 +399,15 @@ public:
 	void DelayedRemoveObject(CValue* gameobj);
 	
 	int NewRemoveObject(CValue* gameobj);
+
+	/**
+	 * Keep up to \a size ended replicas of the inactive object \a templateobj
+	 * to reuse them in AddReplicaObject, a size of 0 frees the pool.
+	 * Return false if the object can't be pooled, see KX_ObjectPool::IsPoolable.
+	 */
+	bool SetObjectPool(KX_GameObject *templateobj, unsigned int size);
+	void RemoveObjectPool(KX_ObjectPool *pool);
+
 	void ReplaceMesh(CValue* gameobj,
 	                 void* meshob, bool use_gfx, bool use_phys);
 
@@ -535,6 +600,16 @@ public:
 	KX_Camera* GetpCamera();
 	NG_NetworkDeviceInterface* GetNetworkDeviceInterface();
 	NG_NetworkScene* GetNetworkScene();
+	/**
+	 * Send the transform of the replicated objects to the network device
+	 * and move the other objects to the transform received for them, if any.
+	 */
+	void UpdateNetworkObjects();
+	/**
+	 * Give a spawned object the next network id of its name, players running the
+	 * same logic spawn objects in the same order and agree on the ids.
+	 */
+	void AssignNetworkId(KX_GameObject *gameobj);
 	KX_BlenderSceneConverter *GetSceneConverter() { return m_sceneConverter; }
 
 	/**
@@ -575,6 +650,8 @@ public:
 	// use of DBVT tree for camera culling
 	void SetDbvtCulling(bool b) { m_dbvt_culling = b; }
 	bool GetDbvtCulling() { return m_dbvt_culling; }
+	void SetIgnoreCulling(bool b) { m_ignore_culling = b; }
+	bool GetIgnoreCulling() { return m_ignore_culling; }
 	void SetDbvtOcclusionRes(int i) { m_dbvt_occlusion_res = i; }
 	int GetDbvtOcclusionRes() { return m_dbvt_occlusion_res; }
 	
@@ -605,6 +682,8 @@ public:
 
 	KX_ObstacleSimulation* GetObstacleSimulation() { return m_obstacleSimulation; }
 
+	KX_ObjectGrid *GetObjectGrid() { return m_objectgrid; }
+
 #ifdef WITH_PYTHON
 	/* --------------------------------------------------------------------- */
 	/* Python interface ---------------------------------------------------- */
@@ -618,6 +697,7 @@ public:
 	KX_PYMETHOD_DOC(KX_Scene, resume);
 	KX_PYMETHOD_DOC(KX_Scene, get);
 	KX_PYMETHOD_DOC(KX_Scene, drawObstacleSimulation);
+	KX_PYMETHOD_DOC(KX_Scene, setObjectPool);
 
 
 	/* attributes */
@@ -679,6 +759,19 @@ public:
 
 	bool MergeScene(KX_Scene *other);
 
+	/**
+	 * Merge \a other over several calls, used to publish asynchronously
+	 * loaded libraries without stalling a frame. MergeSceneBegin() moves the
+	 * materials and the buckets, MergeSceneObjects() adds whole hierarchies
+	 * of active objects until at least \a maxobjects are added and returns
+	 * the number of objects left, MergeSceneEnd() adds the objects left with
+	 * their physics constraints and the logic. \a other must not be used
+	 * between these calls.
+	 */
+	bool MergeSceneBegin(KX_Scene *other);
+	unsigned int MergeSceneObjects(KX_Scene *other, unsigned int maxobjects);
+	void MergeSceneEnd(KX_Scene *other);
+
 
 	//void PrintStats(int verbose_level) {
 	//	m_bucketmanager->PrintStats(verbose_level)
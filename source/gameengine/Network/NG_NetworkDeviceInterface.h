@@ -72,8 +72,26 @@ public:
 	 */
 	
 	virtual std::vector<NG_NetworkMessage*> RetrieveNetworkMessages()=0;
-	
-	
+
+	/**
+	 * Does the device replicate object transforms, when false the
+	 * object state functions aren't called.
+	 */
+	virtual bool HasObjectReplication() { return false; }
+	/**
+	 * Queue the world transform of a local object to be sent with this frame,
+	 * \a orientation is a (x, y, z, w) quaternion. Objects are identified by
+	 * their \a name and the \a id telling apart the objects of the same name.
+	 */
+	virtual void SendObjectState(const STR_String& /*name*/, unsigned int /*id*/,
+	                             const float /*position*/[3], const float /*orientation*/[4]) {}
+	/**
+	 * Get the transform received last frame for the object \a name and \a id,
+	 * false when nothing new arrived for it.
+	 */
+	virtual bool GetObjectState(const STR_String& /*name*/, unsigned int /*id*/,
+	                            float /*position*/[3], float /*orientation*/[4]) { return false; }
+
 #ifdef WITH_CXX_GUARDEDALLOC
 	MEM_CXX_CLASS_ALLOC_FUNCS("GE:NG_NetworkDeviceInterface")
 #endif
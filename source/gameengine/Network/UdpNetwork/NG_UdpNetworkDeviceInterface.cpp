@@ -0,0 +1,722 @@
+/*
+ * ***** BEGIN GPL LICENSE BLOCK *****
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ * Contributor(s): none yet.
+ *
+ * ***** END GPL LICENSE BLOCK *****
+ */
+
+/** \file gameengine/Network/UdpNetwork/NG_UdpNetworkDeviceInterface.cpp
+ *  \ingroup bgenetudp
+ *
+ * Datagram layout, all integers little endian:
+ *
+ * - Header: 'B' 'N' version flags, uint16 sequence, uint16 ack,
+ *   uint32 bits of the 32 sequences received before ack, uint32 key.
+ *   Ack and its bits are only meaningful with the UDP_FLAG_ACK flag.
+ * - Records until the end of the datagram, starting with their type:
+ *   - Message: to, from, subject and body, each as a varint length and the characters.
+ *   - Object: name, varint id, a byte with the mask of the components written and the delta flag,
+ *     the uint16 sequence of the baseline for deltas, then each component in the mask
+ *     as a zigzag varint of its difference to the baseline (or zero).
+ */
+
+#ifdef WIN32
+#  include <winsock2.h>
+#  include <ws2tcpip.h>
+#else
+#  include <sys/types.h>
+#  include <sys/socket.h>
+#  include <netinet/in.h>
+#  include <netdb.h>
+#  include <fcntl.h>
+#  include <unistd.h>
+#endif
+
+#include <math.h>
+#include <string.h>
+#include <stdio.h>
+
+#include "NG_UdpNetworkDeviceInterface.h"
+#include "NG_NetworkMessage.h"
+
+#ifdef WIN32
+typedef int socklen_t;
+#  define closesocket_udp(s) closesocket(s)
+#else
+#  define closesocket_udp(s) close(s)
+#endif
+
+/* Stay under the usual internet MTU to avoid IP fragmentation. */
+#define UDP_PACKET_SIZE 1200
+#define UDP_HEADER_SIZE 16
+#define UDP_VERSION 2
+
+#define UDP_FLAG_ACK 1
+
+#define UDP_RECORD_MESSAGE 1
+#define UDP_RECORD_OBJECT 2
+
+#define UDP_OBJECT_DELTA 0x80
+
+#define UDP_POSITION_SCALE 1024.0
+#define UDP_ORIENTATION_SCALE 32767.0
+
+/* True when sequence a is more recent than b, allowing wrapping. */
+static bool sequence_newer(unsigned short a, unsigned short b)
+{
+	return (a != b) && ((unsigned short)(a - b) < 0x8000);
+}
+
+/* FNV-1a, only used to tell apart peers started with different passwords. */
+static unsigned int hash_password(const char *password)
+{
+	unsigned int hash = 2166136261u;
+	for (const unsigned char *c = (const unsigned char *)password; c && *c; c++) {
+		hash = (hash ^ *c) * 16777619u;
+	}
+	return hash;
+}
+
+static void write_uint16(std::vector<unsigned char>& buf, unsigned int value)
+{
+	buf.push_back(value & 0xff);
+	buf.push_back((value >> 8) & 0xff);
+}
+
+static void write_uint32(std::vector<unsigned char>& buf, unsigned int value)
+{
+	write_uint16(buf, value & 0xffff);
+	write_uint16(buf, value >> 16);
+}
+
+static void write_varint(std::vector<unsigned char>& buf, unsigned int value)
+{
+	while (value >= 0x80) {
+		buf.push_back((value & 0x7f) | 0x80);
+		value >>= 7;
+	}
+	buf.push_back(value);
+}
+
+static void write_string(std::vector<unsigned char>& buf, const STR_String& str)
+{
+	write_varint(buf, str.Length());
+	buf.insert(buf.end(), str.ReadPtr(), str.ReadPtr() + str.Length());
+}
+
+/** Bounds checked reading of a received datagram. */
+class UdpReader
+{
+	const unsigned char *m_data;
+	unsigned int m_size;
+	unsigned int m_pos;
+	bool m_error;
+
+public:
+	UdpReader(const unsigned char *data, unsigned int size)
+		:m_data(data),
+		m_size(size),
+		m_pos(0),
+		m_error(false)
+	{
+	}
+
+	bool AtEnd() const
+	{
+		return m_error || m_pos >= m_size;
+	}
+
+	bool Error() const
+	{
+		return m_error;
+	}
+
+	unsigned int Byte()
+	{
+		if (m_pos + 1 > m_size) {
+			m_error = true;
+			return 0;
+		}
+		return m_data[m_pos++];
+	}
+
+	unsigned int Uint16()
+	{
+		unsigned int lo = Byte();
+		return lo | (Byte() << 8);
+	}
+
+	unsigned int Uint32()
+	{
+		unsigned int lo = Uint16();
+		return lo | (Uint16() << 16);
+	}
+
+	unsigned int Varint()
+	{
+		unsigned int value = 0;
+		for (unsigned int shift = 0; shift < 35; shift += 7) {
+			unsigned int byte = Byte();
+			value |= (byte & 0x7f) << shift;
+			if (!(byte & 0x80)) {
+				return value;
+			}
+		}
+		m_error = true;
+		return 0;
+	}
+
+	STR_String String()
+	{
+		unsigned int len = Varint();
+		if (m_error || len > m_size - m_pos) {
+			m_error = true;
+			return STR_String();
+		}
+		STR_String str((const char *)m_data + m_pos, len);
+		m_pos += len;
+		return str;
+	}
+};
+
+bool NG_UdpNetworkDeviceInterface::QuantState::operator==(const QuantState& other) const
+{
+	return memcmp(m_values, other.m_values, sizeof(m_values)) == 0;
+}
+
+NG_UdpNetworkDeviceInterface::ObjectReplica::ObjectReplica()
+	:m_sequence(0),
+	m_hasState(false),
+	m_dirty(false),
+	m_updateFrame(0),
+	m_fullFrame(0)
+{
+	memset(m_history, 0, sizeof(m_history));
+	memset(&m_state, 0, sizeof(m_state));
+}
+
+const NG_UdpNetworkDeviceInterface::SequencedState *NG_UdpNetworkDeviceInterface::ObjectReplica::Find(
+        unsigned short sequence) const
+{
+	const SequencedState& entry = m_history[sequence % STATE_HISTORY];
+	return (entry.m_valid && entry.m_sequence == sequence) ? &entry : NULL;
+}
+
+void NG_UdpNetworkDeviceInterface::ObjectReplica::Store(unsigned short sequence, const QuantState& state)
+{
+	SequencedState& entry = m_history[sequence % STATE_HISTORY];
+	entry.m_sequence = sequence;
+	entry.m_valid = true;
+	entry.m_state = state;
+}
+
+NG_UdpNetworkDeviceInterface::NG_UdpNetworkDeviceInterface()
+	:m_socket(-1),
+	m_peer(new sockaddr_in),
+	m_haspeer(false),
+	m_learnpeer(false),
+	m_key(0),
+	m_frame(0),
+	m_sequence(0),
+	m_remoteSequence(0),
+	m_remoteAckBits(0),
+	m_hasRemoteSequence(false)
+{
+	memset(m_peer, 0, sizeof(sockaddr_in));
+	memset(m_acked, 0, sizeof(m_acked));
+	memset(m_ackedValid, 0, sizeof(m_ackedValid));
+	m_packet.reserve(UDP_PACKET_SIZE);
+
+#ifdef WIN32
+	WSADATA wsadata;
+	WSAStartup(MAKEWORD(2, 2), &wsadata);
+#endif
+
+	Offline();
+}
+
+NG_UdpNetworkDeviceInterface::~NG_UdpNetworkDeviceInterface()
+{
+	Disconnect();
+
+	for (std::vector<NG_NetworkMessage *>::iterator it = m_messages.begin(); it != m_messages.end(); ++it) {
+		(*it)->Release();
+	}
+	for (std::deque<NG_NetworkMessage *>::iterator it = m_outgoing.begin(); it != m_outgoing.end(); ++it) {
+		(*it)->Release();
+	}
+
+	delete m_peer;
+
+#ifdef WIN32
+	WSACleanup();
+#endif
+}
+
+void NG_UdpNetworkDeviceInterface::CloseSocket()
+{
+	if (m_socket != -1) {
+		closesocket_udp(m_socket);
+		m_socket = -1;
+	}
+}
+
+bool NG_UdpNetworkDeviceInterface::Connect(char *address, unsigned int port, char *password,
+                                           unsigned int localport, unsigned int /*timeout*/)
+{
+	Disconnect();
+
+	m_socket = socket(AF_INET, SOCK_DGRAM, IPPROTO_UDP);
+	if (m_socket == -1) {
+		printf("Network: could not create UDP socket\n");
+		return false;
+	}
+
+	sockaddr_in local;
+	memset(&local, 0, sizeof(local));
+	local.sin_family = AF_INET;
+	local.sin_addr.s_addr = htonl(INADDR_ANY);
+	local.sin_port = htons(localport);
+	if (bind(m_socket, (sockaddr *)&local, sizeof(local)) != 0) {
+		printf("Network: could not bind UDP port %u\n", localport);
+		CloseSocket();
+		return false;
+	}
+
+#ifdef WIN32
+	u_long nonblocking = 1;
+	ioctlsocket(m_socket, FIONBIO, &nonblocking);
+#else
+	fcntl(m_socket, F_SETFL, fcntl(m_socket, F_GETFL, 0) | O_NONBLOCK);
+#endif
+
+	if (address && address[0]) {
+		addrinfo hints, *result = NULL;
+		memset(&hints, 0, sizeof(hints));
+		hints.ai_family = AF_INET;
+		hints.ai_socktype = SOCK_DGRAM;
+		if (getaddrinfo(address, NULL, &hints, &result) != 0 || !result) {
+			printf("Network: could not resolve \"%s\"\n", address);
+			CloseSocket();
+			return false;
+		}
+		memcpy(m_peer, result->ai_addr, sizeof(sockaddr_in));
+		m_peer->sin_port = htons(port);
+		freeaddrinfo(result);
+		m_haspeer = true;
+		m_learnpeer = false;
+	}
+	else {
+		m_learnpeer = true;
+	}
+
+	m_key = hash_password(password);
+	Online();
+	return true;
+}
+
+bool NG_UdpNetworkDeviceInterface::Disconnect(void)
+{
+	CloseSocket();
+	m_haspeer = false;
+	m_learnpeer = false;
+	m_hasRemoteSequence = false;
+	m_remoteAckBits = 0;
+	memset(m_ackedValid, 0, sizeof(m_ackedValid));
+	m_sentObjects.clear();
+	m_receivedObjects.clear();
+	Offline();
+	return true;
+}
+
+bool NG_UdpNetworkDeviceInterface::IsAcked(unsigned short sequence) const
+{
+	const unsigned int index = sequence % ACK_HISTORY;
+	return m_ackedValid[index] && m_acked[index] == sequence;
+}
+
+void NG_UdpNetworkDeviceInterface::BeginPacket()
+{
+	m_packet.clear();
+	m_packet.push_back('B');
+	m_packet.push_back('N');
+	m_packet.push_back(UDP_VERSION);
+	m_packet.push_back(m_hasRemoteSequence ? UDP_FLAG_ACK : 0);
+	write_uint16(m_packet, m_sequence);
+	write_uint16(m_packet, m_remoteSequence);
+	write_uint32(m_packet, m_remoteAckBits);
+	write_uint32(m_packet, m_key);
+
+	// This sequence is now in use, forget it was acknowledged a wrap ago.
+	m_ackedValid[m_sequence % ACK_HISTORY] = false;
+}
+
+void NG_UdpNetworkDeviceInterface::FlushPacket()
+{
+	sendto(m_socket, (const char *)&m_packet[0], (int)m_packet.size(), 0, (sockaddr *)m_peer, sizeof(sockaddr_in));
+	++m_sequence;
+}
+
+bool NG_UdpNetworkDeviceInterface::ReservePacket(unsigned int size)
+{
+	if (size > UDP_PACKET_SIZE - UDP_HEADER_SIZE) {
+		return false;
+	}
+	if (m_packet.size() + size > UDP_PACKET_SIZE) {
+		FlushPacket();
+		BeginPacket();
+	}
+	return true;
+}
+
+void NG_UdpNetworkDeviceInterface::WriteMessage(NG_NetworkMessage *msg)
+{
+	std::vector<unsigned char> record;
+	record.push_back(UDP_RECORD_MESSAGE);
+	write_string(record, msg->GetDestinationName());
+	write_string(record, msg->GetSenderName());
+	write_string(record, msg->GetSubject());
+	write_string(record, msg->GetMessageText());
+
+	if (!ReservePacket(record.size())) {
+		printf("Network: message \"%s\" is too large to be sent\n", msg->GetSubject().ReadPtr());
+		return;
+	}
+	m_packet.insert(m_packet.end(), record.begin(), record.end());
+}
+
+void NG_UdpNetworkDeviceInterface::WriteObject(const ObjectKey& key, ObjectReplica& replica)
+{
+	// Most recent state the peer acknowledged.
+	const SequencedState *baseline = NULL;
+	for (unsigned int i = 0; i < STATE_HISTORY; ++i) {
+		const SequencedState& entry = replica.m_history[i];
+		if (entry.m_valid && IsAcked(entry.m_sequence) &&
+		    (!baseline || sequence_newer(entry.m_sequence, baseline->m_sequence)))
+		{
+			baseline = &entry;
+		}
+	}
+
+	// Keep the object alive on the peer, as a full state in case it lost the baselines.
+	if (m_frame - replica.m_fullFrame >= OBJECT_KEEPALIVE_FRAMES) {
+		baseline = NULL;
+	}
+	else if (baseline && baseline->m_state == replica.m_state) {
+		return;
+	}
+
+	std::vector<unsigned char> record;
+	record.push_back(UDP_RECORD_OBJECT);
+	write_string(record, key.first);
+	write_varint(record, key.second);
+
+	int deltas[7];
+	unsigned int mask = 0;
+	for (unsigned int i = 0; i < 7; ++i) {
+		deltas[i] = replica.m_state.m_values[i] - (baseline ? baseline->m_state.m_values[i] : 0);
+		if (deltas[i] != 0) {
+			mask |= (1 << i);
+		}
+	}
+
+	record.push_back(mask | (baseline ? UDP_OBJECT_DELTA : 0));
+	if (baseline) {
+		write_uint16(record, baseline->m_sequence);
+	}
+	for (unsigned int i = 0; i < 7; ++i) {
+		if (mask & (1 << i)) {
+			// Zigzag encoding, small negative deltas take as few bytes as positive ones.
+			write_varint(record, ((unsigned int)deltas[i] << 1) ^ (unsigned int)(deltas[i] >> 31));
+		}
+	}
+
+	if (!ReservePacket(record.size())) {
+		return;
+	}
+	m_packet.insert(m_packet.end(), record.begin(), record.end());
+	// Stored under the sequence of the datagram it is written in, may have changed in ReservePacket.
+	replica.Store(m_sequence, replica.m_state);
+	if (!baseline) {
+		replica.m_fullFrame = m_frame;
+	}
+}
+
+void NG_UdpNetworkDeviceInterface::ExpireObjects(ObjectReplicaMap& objects)
+{
+	for (ObjectReplicaMap::iterator it = objects.begin(); it != objects.end();) {
+		if (m_frame - it->second.m_updateFrame > OBJECT_EXPIRE_FRAMES) {
+			objects.erase(it++);
+		}
+		else {
+			++it;
+		}
+	}
+}
+
+void NG_UdpNetworkDeviceInterface::NextFrame()
+{
+	// Release the messages of the frame just done.
+	for (std::vector<NG_NetworkMessage *>::iterator it = m_messages.begin(); it != m_messages.end(); ++it) {
+		(*it)->Release();
+	}
+	m_messages.clear();
+
+	++m_frame;
+	ExpireObjects(m_sentObjects);
+	ExpireObjects(m_receivedObjects);
+
+	if (m_socket != -1 && m_haspeer) {
+		// An empty datagram is still sent every frame to acknowledge the peer's ones.
+		BeginPacket();
+		for (std::deque<NG_NetworkMessage *>::iterator it = m_outgoing.begin(); it != m_outgoing.end(); ++it) {
+			WriteMessage(*it);
+		}
+		for (ObjectReplicaMap::iterator it = m_sentObjects.begin(); it != m_sentObjects.end(); ++it) {
+			if (it->second.m_dirty) {
+				WriteObject(it->first, it->second);
+				it->second.m_dirty = false;
+			}
+		}
+		FlushPacket();
+	}
+
+	// Messages are also delivered locally, as with the loopback device.
+	m_messages.insert(m_messages.end(), m_outgoing.begin(), m_outgoing.end());
+	m_outgoing.clear();
+
+	for (ObjectReplicaMap::iterator it = m_receivedObjects.begin(); it != m_receivedObjects.end(); ++it) {
+		it->second.m_dirty = false;
+	}
+
+	if (m_socket != -1) {
+		ReceivePackets();
+	}
+}
+
+void NG_UdpNetworkDeviceInterface::ReceivePackets()
+{
+	unsigned char buffer[65536];
+	sockaddr_in from;
+
+	while (true) {
+		socklen_t fromlen = sizeof(from);
+		int size = recvfrom(m_socket, (char *)buffer, sizeof(buffer), 0, (sockaddr *)&from, &fromlen);
+		if (size < 0) {
+			// Would block, or an ICMP error left by a peer not listening yet.
+			break;
+		}
+		if (size < UDP_HEADER_SIZE || buffer[0] != 'B' || buffer[1] != 'N' || buffer[2] != UDP_VERSION) {
+			continue;
+		}
+
+		UdpReader header(buffer + 4, UDP_HEADER_SIZE - 4);
+		const unsigned short sequence = header.Uint16();
+		const unsigned short ack = header.Uint16();
+		const unsigned int ackbits = header.Uint32();
+		if (header.Uint32() != m_key) {
+			continue;
+		}
+
+		// Ignore duplicated and very late datagrams.
+		if (m_hasRemoteSequence) {
+			if (sequence_newer(sequence, m_remoteSequence)) {
+				const unsigned short shift = sequence - m_remoteSequence;
+				m_remoteAckBits = (shift < 32) ? ((m_remoteAckBits << shift) | (1u << (shift - 1))) :
+				                  (shift == 32) ? 1u << 31 : 0;
+				m_remoteSequence = sequence;
+			}
+			else {
+				const unsigned short distance = m_remoteSequence - sequence;
+				if (distance == 0 || distance > 32 || (m_remoteAckBits & (1u << (distance - 1)))) {
+					continue;
+				}
+				m_remoteAckBits |= (1u << (distance - 1));
+			}
+		}
+		else {
+			m_remoteSequence = sequence;
+			m_remoteAckBits = 0;
+			m_hasRemoteSequence = true;
+		}
+
+		if (buffer[3] & UDP_FLAG_ACK) {
+			m_acked[ack % ACK_HISTORY] = ack;
+			m_ackedValid[ack % ACK_HISTORY] = true;
+			for (unsigned short i = 0; i < 32; ++i) {
+				if (ackbits & (1u << i)) {
+					const unsigned short acked = ack - 1 - i;
+					m_acked[acked % ACK_HISTORY] = acked;
+					m_ackedValid[acked % ACK_HISTORY] = true;
+				}
+			}
+		}
+
+		if (m_learnpeer) {
+			*m_peer = from;
+			m_haspeer = true;
+		}
+
+		ReadPacket(sequence, buffer + UDP_HEADER_SIZE, size - UDP_HEADER_SIZE);
+	}
+}
+
+void NG_UdpNetworkDeviceInterface::ReadPacket(unsigned short sequence, const unsigned char *data, unsigned int size)
+{
+	UdpReader reader(data, size);
+
+	while (!reader.AtEnd()) {
+		const unsigned int type = reader.Byte();
+
+		if (type == UDP_RECORD_MESSAGE) {
+			const STR_String to = reader.String();
+			const STR_String from = reader.String();
+			const STR_String subject = reader.String();
+			const STR_String body = reader.String();
+			if (reader.Error()) {
+				break;
+			}
+			m_messages.push_back(new NG_NetworkMessage(to, from, subject, body));
+		}
+		else if (type == UDP_RECORD_OBJECT) {
+			const STR_String name = reader.String();
+			const unsigned int id = reader.Varint();
+			const unsigned int flags = reader.Byte();
+			const unsigned short baseseq = (flags & UDP_OBJECT_DELTA) ? reader.Uint16() : 0;
+			int deltas[7];
+			for (unsigned int i = 0; i < 7; ++i) {
+				if (flags & (1 << i)) {
+					const unsigned int zigzag = reader.Varint();
+					deltas[i] = (int)(zigzag >> 1) ^ -(int)(zigzag & 1);
+				}
+				else {
+					deltas[i] = 0;
+				}
+			}
+			if (reader.Error()) {
+				break;
+			}
+
+			ObjectReplica& replica = m_receivedObjects[ObjectKey(name, id)];
+			replica.m_updateFrame = m_frame;
+			QuantState state;
+			if (flags & UDP_OBJECT_DELTA) {
+				const SequencedState *baseline = replica.Find(baseseq);
+				if (!baseline) {
+					// Baseline too old, the next full state or delta on a newer one will do.
+					continue;
+				}
+				state = baseline->m_state;
+			}
+			else {
+				memset(&state, 0, sizeof(state));
+			}
+			for (unsigned int i = 0; i < 7; ++i) {
+				state.m_values[i] += deltas[i];
+			}
+
+			replica.Store(sequence, state);
+			// States from datagrams arriving out of order are only kept as baselines.
+			if (!replica.m_hasState || sequence_newer(sequence, replica.m_sequence)) {
+				replica.m_state = state;
+				replica.m_sequence = sequence;
+				replica.m_hasState = true;
+				replica.m_dirty = true;
+			}
+		}
+		else {
+			// Unknown record, the rest of the datagram can't be parsed.
+			break;
+		}
+	}
+}
+
+void NG_UdpNetworkDeviceInterface::SendNetworkMessage(NG_NetworkMessage *msg)
+{
+	msg->AddRef();
+	m_outgoing.push_back(msg);
+}
+
+std::vector<NG_NetworkMessage *> NG_UdpNetworkDeviceInterface::RetrieveNetworkMessages()
+{
+	// As for the loopback device the references are kept until the next frame.
+	return m_messages;
+}
+
+void NG_UdpNetworkDeviceInterface::SendObjectState(const STR_String& name, unsigned int id, const float position[3],
+                                                   const float orientation[4])
+{
+	ObjectReplica& replica = m_sentObjects[ObjectKey(name, id)];
+	QuantizeState(position, orientation, replica.m_state);
+	replica.m_dirty = true;
+	replica.m_updateFrame = m_frame;
+}
+
+bool NG_UdpNetworkDeviceInterface::GetObjectState(const STR_String& name, unsigned int id, float position[3],
+                                                  float orientation[4])
+{
+	ObjectReplicaMap::const_iterator it = m_receivedObjects.find(ObjectKey(name, id));
+	if (it == m_receivedObjects.end() || !it->second.m_dirty) {
+		return false;
+	}
+	DequantizeState(it->second.m_state, position, orientation);
+	return true;
+}
+
+void NG_UdpNetworkDeviceInterface::QuantizeState(const float position[3], const float orientation[4],
+                                                 QuantState& r_state)
+{
+	for (unsigned int i = 0; i < 3; ++i) {
+		double value = floor(position[i] * UDP_POSITION_SCALE + 0.5);
+		// Clamp to the int range, about two million units.
+		value = (value > 2147483647.0) ? 2147483647.0 : (value < -2147483647.0) ? -2147483647.0 : value;
+		r_state.m_values[i] = (int)value;
+	}
+
+	// q and -q are the same rotation, keep w positive.
+	double len = sqrt(orientation[0] * orientation[0] + orientation[1] * orientation[1] +
+	                  orientation[2] * orientation[2] + orientation[3] * orientation[3]);
+	if (len == 0.0) {
+		r_state.m_values[3] = r_state.m_values[4] = r_state.m_values[5] = 0;
+		r_state.m_values[6] = (int)UDP_ORIENTATION_SCALE;
+		return;
+	}
+	if (orientation[3] < 0.0f) {
+		len = -len;
+	}
+	for (unsigned int i = 0; i < 4; ++i) {
+		r_state.m_values[3 + i] = (int)floor(orientation[i] / len * UDP_ORIENTATION_SCALE + 0.5);
+	}
+}
+
+void NG_UdpNetworkDeviceInterface::DequantizeState(const QuantState& state, float r_position[3],
+                                                   float r_orientation[4])
+{
+	for (unsigned int i = 0; i < 3; ++i) {
+		r_position[i] = (float)(state.m_values[i] / UDP_POSITION_SCALE);
+	}
+
+	double len = 0.0;
+	for (unsigned int i = 0; i < 4; ++i) {
+		len += (double)state.m_values[3 + i] * state.m_values[3 + i];
+	}
+	len = sqrt(len);
+	for (unsigned int i = 0; i < 4; ++i) {
+		r_orientation[i] = (len > 0.0) ? (float)(state.m_values[3 + i] / len) : (i == 3) ? 1.0f : 0.0f;
+	}
+}
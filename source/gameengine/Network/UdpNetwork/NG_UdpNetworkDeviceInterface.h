@@ -0,0 +1,181 @@
+/*
+ * ***** BEGIN GPL LICENSE BLOCK *****
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ * Contributor(s): none yet.
+ *
+ * ***** END GPL LICENSE BLOCK *****
+ */
+
+/** \file NG_UdpNetworkDeviceInterface.h
+ *  \ingroup bgenetudp
+ *  \brief Non blocking UDP device exchanging messages and object states with one peer.
+ */
+
+#ifndef __NG_UDPNETWORKDEVICEINTERFACE_H__
+#define __NG_UDPNETWORKDEVICEINTERFACE_H__
+
+#include <deque>
+#include <map>
+#include <vector>
+#include <stdint.h>
+
+#include "NG_NetworkDeviceInterface.h"
+
+struct sockaddr_in;
+
+/**
+ * All the messages and object states of a frame are batched in as few datagrams
+ * as possible when NextFrame() is called, then the datagrams received since the
+ * previous frame are decoded.
+ *
+ * Object states are quantised and sent as a delta to the last state the peer
+ * acknowledged, objects that didn't move since are not sent. Every object is sent
+ * as a full state from time to time, received objects that aren't sent anymore are forgotten.
+ * Nothing is resent: a lost message is lost, a lost state is superseded by the next one.
+ */
+class NG_UdpNetworkDeviceInterface : public NG_NetworkDeviceInterface
+{
+public:
+	/// Quantised transform, positions in 1/1024 units and unit quaternion components scaled to 16 bits.
+	struct QuantState
+	{
+		int m_values[7];
+
+		bool operator==(const QuantState& other) const;
+	};
+
+private:
+	enum {
+		/// Number of states remembered per object to decode or encode deltas.
+		STATE_HISTORY = 32,
+		/// Number of acknowledged sequences remembered.
+		ACK_HISTORY = 64,
+		/// Frames between full states of an object, keeping it alive on the peer.
+		OBJECT_KEEPALIVE_FRAMES = 60,
+		/// Frames after which an object not sent or received anymore is forgotten.
+		OBJECT_EXPIRE_FRAMES = 4 * OBJECT_KEEPALIVE_FRAMES
+	};
+
+	struct SequencedState
+	{
+		unsigned short m_sequence;
+		bool m_valid;
+		QuantState m_state;
+	};
+
+	/// Sent or received states of a replicated object.
+	struct ObjectReplica
+	{
+		SequencedState m_history[STATE_HISTORY];
+		/// Latest state, set from the engine for sent objects and from the peer for received ones.
+		QuantState m_state;
+		unsigned short m_sequence;
+		bool m_hasState;
+		/// Sent: m_state must be written this frame. Received: m_state arrived during the last NextFrame().
+		bool m_dirty;
+		/// Frame m_state was last set at, and for sent objects last written as a full state at.
+		unsigned int m_updateFrame;
+		unsigned int m_fullFrame;
+
+		ObjectReplica();
+		const SequencedState *Find(unsigned short sequence) const;
+		void Store(unsigned short sequence, const QuantState& state);
+	};
+
+	/// Object name and id.
+	typedef std::pair<STR_String, unsigned int> ObjectKey;
+	typedef std::map<ObjectKey, ObjectReplica> ObjectReplicaMap;
+
+	/// Socket handle, -1 when not connected.
+	intptr_t m_socket;
+	struct sockaddr_in *m_peer;
+	bool m_haspeer;
+	/// The peer is the sender of the last valid datagram.
+	bool m_learnpeer;
+	unsigned int m_key;
+	/// Number of NextFrame() calls.
+	unsigned int m_frame;
+
+	unsigned short m_sequence;
+	/// Latest sequence received from the peer and bitfield of the 32 previous ones.
+	unsigned short m_remoteSequence;
+	unsigned int m_remoteAckBits;
+	bool m_hasRemoteSequence;
+	/// Sequences of our datagrams acknowledged by the peer.
+	unsigned short m_acked[ACK_HISTORY];
+	bool m_ackedValid[ACK_HISTORY];
+
+	std::deque<NG_NetworkMessage *> m_outgoing;
+	std::vector<NG_NetworkMessage *> m_messages;
+
+	ObjectReplicaMap m_sentObjects;
+	ObjectReplicaMap m_receivedObjects;
+
+	std::vector<unsigned char> m_packet;
+
+	void CloseSocket();
+	bool IsAcked(unsigned short sequence) const;
+
+	void BeginPacket();
+	void FlushPacket();
+	/// Make sure the current packet has room for \a size bytes, flush it otherwise, false if it never will.
+	bool ReservePacket(unsigned int size);
+
+	void WriteMessage(NG_NetworkMessage *msg);
+	void WriteObject(const ObjectKey& key, ObjectReplica& replica);
+	void ExpireObjects(ObjectReplicaMap& objects);
+
+	void ReceivePackets();
+	void ReadPacket(unsigned short sequence, const unsigned char *data, unsigned int size);
+
+public:
+	NG_UdpNetworkDeviceInterface();
+	virtual ~NG_UdpNetworkDeviceInterface();
+
+	/**
+	 * Send this frame messages and object states, then read what the peer sent.
+	 */
+	virtual void NextFrame();
+
+	/**
+	 * Bind \a localport and send to \a address : \a port. With an empty address
+	 * the device waits for the peer to talk first and answers to it.
+	 * Datagrams not made with the same \a password are ignored, it is not encrypted.
+	 */
+	virtual bool Connect(char *address, unsigned int port, char *password,
+	                     unsigned int localport, unsigned int timeout);
+	virtual bool Disconnect(void);
+
+	virtual void SendNetworkMessage(NG_NetworkMessage *msg);
+	virtual std::vector<NG_NetworkMessage*> RetrieveNetworkMessages();
+
+	virtual bool HasObjectReplication()
+	{
+		return true;
+	}
+	virtual void SendObjectState(const STR_String& name, unsigned int id, const float position[3], const float orientation[4]);
+	virtual bool GetObjectState(const STR_String& name, unsigned int id, float position[3], float orientation[4]);
+
+	static void QuantizeState(const float position[3], const float orientation[4], QuantState& r_state);
+	static void DequantizeState(const QuantState& state, float r_position[3], float r_orientation[4]);
+
+#ifdef WITH_CXX_GUARDEDALLOC
+	MEM_CXX_CLASS_ALLOC_FUNCS("GE:NG_UdpNetworkDeviceInterface")
+#endif
+};
+
+#endif  /* __NG_UDPNETWORKDEVICEINTERFACE_H__ */
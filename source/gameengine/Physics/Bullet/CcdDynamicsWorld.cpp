@@ -0,0 +1,363 @@
+/** \file gameengine/Physics/Bullet/CcdDynamicsWorld.cpp
+ *  \ingroup physbullet
+ */
+/*
+Bullet Continuous Collision Detection and Physics Library
+Copyright (c) 2003-2006 Erwin Coumans  http://continuousphysics.com/Bullet/
+
+This software is provided 'as-is', without any express or implied warranty.
+In no event will the authors be held liable for any damages arising from the use of this software.
+Permission is granted to anyone to use this software for any purpose,
+including commercial applications, and to alter it and redistribute it freely,
+subject to the following restrictions:
+
+1. The origin of this software must not be misrepresented; you must not claim that you wrote the original software. If you use this software in a product, an acknowledgment in the product documentation would be appreciated but is not required.
+2. Altered source versions must be plainly marked as such, and must not be misrepresented as being the original software.
+3. This notice may not be removed or altered from any source distribution.
+*/
+
+#include "CcdDynamicsWorld.h"
+
+#include "BulletCollision/CollisionDispatch/btSimulationIslandManager.h"
+#include "BulletDynamics/ConstraintSolver/btSequentialImpulseConstraintSolver.h"
+#include "BulletDynamics/ConstraintSolver/btTypedConstraint.h"
+#include "BulletDynamics/Dynamics/btRigidBody.h"
+#include "LinearMath/btQuickprof.h"
+
+#include "BLI_utildefines.h"
+#include "BLI_task.h"
+
+#include <stdint.h>
+
+/* Number of non static bodies per integration task. */
+#ifdef DEBUG
+#  define CCD_BODY_CHUNK_SIZE 1
+#else
+#  define CCD_BODY_CHUNK_SIZE 256
+#endif
+
+/* Number of batches per thread aimed at when the solving isn't deterministic. */
+#define CCD_BATCHES_PER_THREAD 4
+
+static int GetConstraintIslandId(const btTypedConstraint *constraint)
+{
+	const btCollisionObject& rcolObj0 = constraint->getRigidBodyA();
+	const btCollisionObject& rcolObj1 = constraint->getRigidBodyB();
+	return (rcolObj0.getIslandTag() >= 0) ? rcolObj0.getIslandTag() : rcolObj1.getIslandTag();
+}
+
+class SortConstraintOnIslandPredicate
+{
+public:
+	bool operator()(const btTypedConstraint *lhs, const btTypedConstraint *rhs) const
+	{
+		return GetConstraintIslandId(lhs) < GetConstraintIslandId(rhs);
+	}
+};
+
+/// Copy the awake islands to the world flat arrays, islands are solved once all collected.
+class CcdDynamicsWorld::IslandCollector : public btSimulationIslandManager::IslandCallback
+{
+	CcdDynamicsWorld *m_world;
+	btTypedConstraint **m_sortedConstraints;
+	int m_numConstraints;
+
+public:
+	IslandCollector(CcdDynamicsWorld *world, btTypedConstraint **sortedConstraints, int numConstraints)
+		:m_world(world),
+		m_sortedConstraints(sortedConstraints),
+		m_numConstraints(numConstraints)
+	{
+	}
+
+	virtual void processIsland(btCollisionObject **bodies, int numBodies, btPersistentManifold **manifolds,
+	                           int numManifolds, int islandId)
+	{
+		// Only called with split islands, checked in solveConstraints().
+		btAssert(islandId >= 0);
+
+		Batch& island = m_world->m_islands.expand();
+		island.m_firstBody = m_world->m_islandBodies.size();
+		island.m_numBodies = numBodies;
+		island.m_firstManifold = m_world->m_islandManifolds.size();
+		island.m_numManifolds = numManifolds;
+		island.m_firstConstraint = m_world->m_islandConstraints.size();
+		island.m_numConstraints = 0;
+		island.m_kinematic = false;
+
+		for (int i = 0; i < numBodies; i++) {
+			m_world->m_islandBodies.push_back(bodies[i]);
+		}
+
+		for (int i = 0; i < numManifolds; i++) {
+			btPersistentManifold *manifold = manifolds[i];
+			m_world->m_islandManifolds.push_back(manifold);
+			island.m_kinematic |= (manifold->getBody0()->isKinematicObject() || manifold->getBody1()->isKinematicObject());
+		}
+
+		// First constraint of the island in the sorted constraints.
+		int lo = 0, hi = m_numConstraints;
+		while (lo < hi) {
+			const int mid = (lo + hi) / 2;
+			if (GetConstraintIslandId(m_sortedConstraints[mid]) < islandId) {
+				lo = mid + 1;
+			}
+			else {
+				hi = mid;
+			}
+		}
+
+		for (int i = lo; i < m_numConstraints && GetConstraintIslandId(m_sortedConstraints[i]) == islandId; i++) {
+			btTypedConstraint *constraint = m_sortedConstraints[i];
+			m_world->m_islandConstraints.push_back(constraint);
+			island.m_kinematic |= (constraint->getRigidBodyA().isKinematicObject() || constraint->getRigidBodyB().isKinematicObject());
+			island.m_numConstraints++;
+		}
+	}
+};
+
+CcdDynamicsWorld::CcdDynamicsWorld(btDispatcher *dispatcher, btBroadphaseInterface *pairCache,
+                                   btConstraintSolver *constraintSolver, btCollisionConfiguration *collisionConfiguration)
+	:btSoftRigidDynamicsWorld(dispatcher, pairCache, constraintSolver, collisionConfiguration),
+	m_scheduler(NULL),
+	m_deterministic(true),
+	m_batchSolverInfo(NULL),
+	m_integrateTimeStep(0.0f)
+{
+}
+
+CcdDynamicsWorld::~CcdDynamicsWorld()
+{
+	FreeThreadSolvers();
+}
+
+void CcdDynamicsWorld::FreeThreadSolvers()
+{
+	for (int i = 0; i < m_threadSolvers.size(); i++) {
+		delete m_threadSolvers[i];
+	}
+	m_threadSolvers.clear();
+}
+
+void CcdDynamicsWorld::SetTaskScheduler(TaskScheduler *scheduler, bool deterministic)
+{
+	m_deterministic = deterministic;
+
+	if (scheduler == m_scheduler) {
+		return;
+	}
+
+	FreeThreadSolvers();
+	m_scheduler = scheduler;
+
+	if (m_scheduler) {
+		// Worker thread ids start at 1, the main thread working on the pool uses 0.
+		const int num_solvers = BLI_task_scheduler_num_threads(m_scheduler) + 1;
+		for (int i = 0; i < num_solvers; i++) {
+			m_threadSolvers.push_back(new btSequentialImpulseConstraintSolver());
+		}
+	}
+}
+
+void CcdDynamicsWorld::BuildBatches(int minBatchSize)
+{
+	m_batches.resize(0);
+	m_kinematicBatches.resize(0);
+
+	Batch *batch = NULL;
+	for (int i = 0; i < m_islands.size(); i++) {
+		const Batch& island = m_islands[i];
+
+		if (batch) {
+			batch->m_numBodies += island.m_numBodies;
+			batch->m_numManifolds += island.m_numManifolds;
+			batch->m_numConstraints += island.m_numConstraints;
+			batch->m_kinematic |= island.m_kinematic;
+		}
+		else {
+			batch = &m_batches.expand();
+			*batch = island;
+		}
+
+		if (minBatchSize <= 1 || (batch->m_numConstraints + batch->m_numManifolds) > minBatchSize) {
+			batch = NULL;
+		}
+	}
+
+	for (int i = 0; i < m_batches.size(); i++) {
+		if (m_batches[i].m_kinematic) {
+			m_kinematicBatches.push_back(i);
+		}
+	}
+}
+
+void CcdDynamicsWorld::SolveBatch(const Batch& batch, btSequentialImpulseConstraintSolver *solver)
+{
+	btCollisionObject **bodies = batch.m_numBodies ? &m_islandBodies[batch.m_firstBody] : NULL;
+	btPersistentManifold **manifolds = batch.m_numManifolds ? &m_islandManifolds[batch.m_firstManifold] : NULL;
+	btTypedConstraint **constraints = batch.m_numConstraints ? &m_islandConstraints[batch.m_firstConstraint] : NULL;
+
+	if (m_deterministic) {
+		solver->setRandSeed(0);
+	}
+
+	solver->solveGroup(bodies, batch.m_numBodies, manifolds, batch.m_numManifolds, constraints, batch.m_numConstraints,
+	                   *m_batchSolverInfo, m_debugDrawer, m_dispatcher1);
+}
+
+void CcdDynamicsWorld::SolveBatchTask(TaskPool *__restrict pool, void *taskdata, int threadid)
+{
+	CcdDynamicsWorld *world = (CcdDynamicsWorld *)BLI_task_pool_userdata(pool);
+	const int index = (int)(intptr_t)taskdata;
+
+	world->SolveBatch(world->m_batches[index], world->m_threadSolvers[threadid]);
+}
+
+void CcdDynamicsWorld::SolveKinematicBatchesTask(TaskPool *__restrict pool, void *UNUSED(taskdata), int threadid)
+{
+	CcdDynamicsWorld *world = (CcdDynamicsWorld *)BLI_task_pool_userdata(pool);
+
+	for (int i = 0; i < world->m_kinematicBatches.size(); i++) {
+		world->SolveBatch(world->m_batches[world->m_kinematicBatches[i]], world->m_threadSolvers[threadid]);
+	}
+}
+
+void CcdDynamicsWorld::solveConstraints(btContactSolverInfo& solverInfo)
+{
+	if (!m_scheduler || !m_islandManager->getSplitIslands() ||
+	    m_constraintSolver->getSolverType() != BT_SEQUENTIAL_IMPULSE_SOLVER)
+	{
+		btSoftRigidDynamicsWorld::solveConstraints(solverInfo);
+		return;
+	}
+
+	BT_PROFILE("solveConstraints");
+
+	m_sortedConstraints.resize(m_constraints.size());
+	for (int i = 0; i < m_constraints.size(); i++) {
+		m_sortedConstraints[i] = m_constraints[i];
+	}
+	m_sortedConstraints.quickSort(SortConstraintOnIslandPredicate());
+
+	m_islandBodies.resize(0);
+	m_islandManifolds.resize(0);
+	m_islandConstraints.resize(0);
+	m_islands.resize(0);
+
+	btTypedConstraint **constraintsPtr = m_sortedConstraints.size() ? &m_sortedConstraints[0] : NULL;
+	IslandCollector collector(this, constraintsPtr, m_sortedConstraints.size());
+	m_islandManager->buildAndProcessIslands(getCollisionWorld()->getDispatcher(), getCollisionWorld(), &collector);
+
+	int minBatchSize = solverInfo.m_minimumSolverBatchSize;
+	if (!m_deterministic && minBatchSize > 1) {
+		// Bigger batches reduce the scheduling overhead while keeping enough of them for all threads.
+		const int num_batches = m_threadSolvers.size() * CCD_BATCHES_PER_THREAD;
+		minBatchSize = btMax(minBatchSize, (m_islandManifolds.size() + m_islandConstraints.size()) / num_batches);
+	}
+	BuildBatches(minBatchSize);
+
+	if (m_batches.size() == 0) {
+		return;
+	}
+
+	m_batchSolverInfo = &solverInfo;
+
+	if (m_batches.size() == 1) {
+		SolveBatch(m_batches[0], m_threadSolvers[0]);
+		return;
+	}
+
+	TaskPool *pool = BLI_task_pool_create(m_scheduler, this);
+
+	if (m_kinematicBatches.size()) {
+		BLI_task_pool_push(pool, SolveKinematicBatchesTask, NULL, false, TASK_PRIORITY_HIGH);
+	}
+	for (int i = 0; i < m_batches.size(); i++) {
+		if (!m_batches[i].m_kinematic) {
+			BLI_task_pool_push(pool, SolveBatchTask, (void *)(intptr_t)i, false, TASK_PRIORITY_HIGH);
+		}
+	}
+
+	BLI_task_pool_work_and_wait(pool);
+	BLI_task_pool_free(pool);
+}
+
+bool CcdDynamicsWorld::ParallelBodies(void (*func)(TaskPool *__restrict, void *, int), int numBodies)
+{
+	if (!m_scheduler || numBodies <= CCD_BODY_CHUNK_SIZE) {
+		return false;
+	}
+
+	TaskPool *pool = BLI_task_pool_create(m_scheduler, this);
+
+	for (int start = 0; start < numBodies; start += CCD_BODY_CHUNK_SIZE) {
+		BLI_task_pool_push(pool, func, (void *)(intptr_t)start, false, TASK_PRIORITY_HIGH);
+	}
+
+	BLI_task_pool_work_and_wait(pool);
+	BLI_task_pool_free(pool);
+
+	return true;
+}
+
+void CcdDynamicsWorld::PredictMotionTask(TaskPool *__restrict pool, void *taskdata, int UNUSED(threadid))
+{
+	CcdDynamicsWorld *world = (CcdDynamicsWorld *)BLI_task_pool_userdata(pool);
+	const int start = (int)(intptr_t)taskdata;
+	const int end = btMin(start + CCD_BODY_CHUNK_SIZE, world->m_nonStaticRigidBodies.size());
+	const btScalar timeStep = world->m_integrateTimeStep;
+
+	for (int i = start; i < end; i++) {
+		btRigidBody *body = world->m_nonStaticRigidBodies[i];
+		if (!body->isStaticOrKinematicObject()) {
+			body->applyDamping(timeStep);
+			body->predictIntegratedTransform(timeStep, body->getInterpolationWorldTransform());
+		}
+	}
+}
+
+void CcdDynamicsWorld::predictUnconstraintMotion(btScalar timeStep)
+{
+	m_integrateTimeStep = timeStep;
+
+	if (!ParallelBodies(PredictMotionTask, m_nonStaticRigidBodies.size())) {
+		btSoftRigidDynamicsWorld::predictUnconstraintMotion(timeStep);
+	}
+}
+
+void CcdDynamicsWorld::IntegrateTransformsTask(TaskPool *__restrict pool, void *taskdata, int UNUSED(threadid))
+{
+	CcdDynamicsWorld *world = (CcdDynamicsWorld *)BLI_task_pool_userdata(pool);
+	const int start = (int)(intptr_t)taskdata;
+	const int end = btMin(start + CCD_BODY_CHUNK_SIZE, world->m_nonStaticRigidBodies.size());
+	const btScalar timeStep = world->m_integrateTimeStep;
+	btTransform predictedTrans;
+
+	for (int i = start; i < end; i++) {
+		btRigidBody *body = world->m_nonStaticRigidBodies[i];
+		body->setHitFraction(1.0f);
+
+		if (body->isActive() && !body->isStaticOrKinematicObject()) {
+			body->predictIntegratedTransform(timeStep, predictedTrans);
+			body->proceedToTransform(predictedTrans);
+		}
+	}
+}
+
+void CcdDynamicsWorld::integrateTransforms(btScalar timeStep)
+{
+	// CCD motion clamping sweeps against the broadphase and the other bodies,
+	// keep the serial integration as soon as a body uses it.
+	bool serial = m_applySpeculativeContactRestitution;
+	if (getDispatchInfo().m_useContinuous) {
+		for (int i = 0; i < m_nonStaticRigidBodies.size() && !serial; i++) {
+			serial = (m_nonStaticRigidBodies[i]->getCcdSquareMotionThreshold() != 0.0f);
+		}
+	}
+
+	m_integrateTimeStep = timeStep;
+
+	if (serial || !ParallelBodies(IntegrateTransformsTask, m_nonStaticRigidBodies.size())) {
+		btSoftRigidDynamicsWorld::integrateTransforms(timeStep);
+	}
+}
@@ -0,0 +1,106 @@
+/*
+Bullet Continuous Collision Detection and Physics Library
+Copyright (c) 2003-2006 Erwin Coumans  http://continuousphysics.com/Bullet/
+
+This software is provided 'as-is', without any express or implied warranty.
+In no event will the authors be held liable for any damages arising from the use of this software.
+Permission is granted to anyone to use this software for any purpose,
+including commercial applications, and to alter it and redistribute it freely,
+subject to the following restrictions:
+
+1. The origin of this software must not be misrepresented; you must not claim that you wrote the original software. If you use this software in a product, an acknowledgment in the product documentation would be appreciated but is not required.
+2. Altered source versions must be plainly marked as such, and must not be misrepresented as being the original software.
+3. This notice may not be removed or altered from any source distribution.
+*/
+
+/** \file CcdDynamicsWorld.h
+ *  \ingroup physbullet
+ *
+ * Dynamics world solving independent simulation islands and integrating
+ * rigid bodies from the engine task scheduler.
+ */
+
+#ifndef __CCDDYNAMICSWORLD_H__
+#define __CCDDYNAMICSWORLD_H__
+
+#include "BulletSoftBody/btSoftRigidDynamicsWorld.h"
+
+class btSequentialImpulseConstraintSolver;
+struct TaskScheduler;
+struct TaskPool;
+
+class CcdDynamicsWorld : public btSoftRigidDynamicsWorld
+{
+	/// Group of islands solved in a single solveGroup() call.
+	struct Batch
+	{
+		int m_firstBody;
+		int m_numBodies;
+		int m_firstManifold;
+		int m_numManifolds;
+		int m_firstConstraint;
+		int m_numConstraints;
+		/// Touches a kinematic object, shared by several islands and written by the solver.
+		bool m_kinematic;
+	};
+
+	class IslandCollector;
+
+	TaskScheduler *m_scheduler;
+	bool m_deterministic;
+
+	/// One solver per scheduler thread plus the main thread, indexed by thread id.
+	btAlignedObjectArray<btSequentialImpulseConstraintSolver *> m_threadSolvers;
+
+	/// Bodies, manifolds and constraints of all awake islands, in island order.
+	btAlignedObjectArray<btCollisionObject *> m_islandBodies;
+	btAlignedObjectArray<btPersistentManifold *> m_islandManifolds;
+	btAlignedObjectArray<btTypedConstraint *> m_islandConstraints;
+	btAlignedObjectArray<Batch> m_islands;
+	btAlignedObjectArray<Batch> m_batches;
+	/// Indices of the batches touching kinematic objects, solved in order by a single task.
+	btAlignedObjectArray<int> m_kinematicBatches;
+
+	btContactSolverInfo *m_batchSolverInfo;
+	btScalar m_integrateTimeStep;
+
+	void FreeThreadSolvers();
+	/// Merge islands until they reach \a minBatchSize constraints, like the serial island callback.
+	void BuildBatches(int minBatchSize);
+	void SolveBatch(const Batch& batch, btSequentialImpulseConstraintSolver *solver);
+	/// Run \a func on \a numBodies non static bodies split in chunks, returns false when not worth threading.
+	bool ParallelBodies(void (*func)(TaskPool *__restrict, void *, int), int numBodies);
+
+	static void SolveBatchTask(TaskPool *__restrict pool, void *taskdata, int threadid);
+	static void SolveKinematicBatchesTask(TaskPool *__restrict pool, void *taskdata, int threadid);
+	static void PredictMotionTask(TaskPool *__restrict pool, void *taskdata, int threadid);
+	static void IntegrateTransformsTask(TaskPool *__restrict pool, void *taskdata, int threadid);
+
+protected:
+	virtual void predictUnconstraintMotion(btScalar timeStep);
+	virtual void integrateTransforms(btScalar timeStep);
+	virtual void solveConstraints(btContactSolverInfo& solverInfo);
+
+public:
+	CcdDynamicsWorld(btDispatcher *dispatcher, btBroadphaseInterface *pairCache,
+	                 btConstraintSolver *constraintSolver, btCollisionConfiguration *collisionConfiguration);
+	virtual ~CcdDynamicsWorld();
+
+	/**
+	 * Solve islands and update bodies in the threads of \a scheduler, NULL to run serially.
+	 * In deterministic mode islands are batched as by the serial solver and the solver
+	 * seed is reset for each batch, results don't depend on the number of threads.
+	 * Otherwise batches are sized to balance the load between the threads.
+	 */
+	void SetTaskScheduler(TaskScheduler *scheduler, bool deterministic);
+	TaskScheduler *GetTaskScheduler() const
+	{
+		return m_scheduler;
+	}
+	bool IsDeterministic() const
+	{
+		return m_deterministic;
+	}
+};
+
+#endif  /* __CCDDYNAMICSWORLD_H__ */
@@ -160,6 +160,7 @@ CcdPhysicsController::CcdPhysicsController (const CcdConstructionInfo& ci)
 	m_savedMass = 0.0f;
 	m_savedDyna = false;
 	m_suspended = false;
+	m_physicsSuspended = false;
 	
 	CreateRigidbody();
 }
@@ -1121,6 +1122,24 @@ void	CcdPhysicsController::RestoreDynamics()
 	}
 }
 
+void	CcdPhysicsController::SuspendPhysics()
+{
+	if (!m_physicsSuspended && GetPhysicsEnvironment()->RemoveCcdPhysicsController(this))
+		m_physicsSuspended = true;
+}
+
+void	CcdPhysicsController::RestorePhysics()
+{
+	if (m_physicsSuspended)
+	{
+		btRigidBody *body = GetRigidBody();
+		if (body)
+			body->clearForces();
+		GetPhysicsEnvironment()->AddCcdPhysicsController(this);
+		m_physicsSuspended = false;
+	}
+}
+
 void 		CcdPhysicsController::GetPosition(MT_Vector3&	pos) const
 {
 	const btTransform& xform = m_object->getWorldTransform();
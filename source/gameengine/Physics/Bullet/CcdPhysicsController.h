@@ -506,6 +506,8 @@ protected:
 	MT_Scalar m_savedMass;
 	bool m_savedDyna;
 	bool m_suspended;
+	/// Removed from the physics world by SuspendPhysics().
+	bool m_physicsSuspended;
 
 
 	void GetWorldOrientation(btMatrix3x3& mat);
@@ -644,6 +646,8 @@ protected:
 		virtual void		RefreshCollisions();
 		virtual void		SuspendDynamics(bool ghost);
 		virtual void		RestoreDynamics();
+		virtual void		SuspendPhysics();
+		virtual void		RestorePhysics();
 
 		// Shape control
 		virtual void    AddCompoundChild(PHY_IPhysicsController* child);
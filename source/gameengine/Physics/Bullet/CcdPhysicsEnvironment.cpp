@@ -22,6 +22,7 @@ subject to the following restrictions:
 #include "CcdPhysicsEnvironment.h"
 #include "CcdPhysicsController.h"
 #include "CcdGraphicController.h"
+#include "CcdDynamicsWorld.h"
 
 #include <algorithm>
 #include "btBulletDynamicsCommon.h"
@@ -455,7 +456,7 @@ m_scalingPropagated(false)
 
 	SetSolverType(1);//issues with quickstep and memory allocations
 //	m_dynamicsWorld = new btDiscreteDynamicsWorld(dispatcher,m_broadphase,m_solver,m_collisionConfiguration);
-	m_dynamicsWorld = new btSoftRigidDynamicsWorld(dispatcher,m_broadphase,m_solver,m_collisionConfiguration);
+	m_dynamicsWorld = new CcdDynamicsWorld(dispatcher,m_broadphase,m_solver,m_collisionConfiguration);
 	m_dynamicsWorld->setInternalTickCallback(&CcdPhysicsEnvironment::StaticSimulationSubtickCallback, this);
 	//m_dynamicsWorld->getSolverInfo().m_linearSlop = 0.01f;
 	//m_dynamicsWorld->getSolverInfo().m_solverMode=	SOLVER_USE_WARMSTARTING +	SOLVER_USE_2_FRICTION_DIRECTIONS +	SOLVER_RANDMIZE_ORDER +	SOLVER_USE_FRICTION_WARMSTARTING;
@@ -1034,6 +1035,11 @@ void		CcdPhysicsEnvironment::SetSolverType(int solverType)
 	m_solverType = solverType;
 }
 
+void		CcdPhysicsEnvironment::SetSolverThreads(TaskScheduler *scheduler, bool deterministic)
+{
+	static_cast<CcdDynamicsWorld *>(m_dynamicsWorld)->SetTaskScheduler(scheduler, deterministic);
+}
+
 
 
 void		CcdPhysicsEnvironment::GetGravity(MT_Vector3& grav)
@@ -122,6 +122,7 @@ protected:
 		virtual void		SetContactBreakingTreshold(float contactBreakingTreshold);
 		virtual void		SetCcdMode(int ccdMode);
 		virtual void		SetSolverType(int solverType);
+		virtual void		SetSolverThreads(struct TaskScheduler *scheduler, bool deterministic);
 		virtual void		SetSolverSorConstant(float sor);
 		virtual void		SetSolverTau(float tau);
 		virtual void		SetSolverDamping(float damping);
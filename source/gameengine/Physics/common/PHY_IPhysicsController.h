@@ -99,6 +99,9 @@ class PHY_IPhysicsController : public PHY_IController
 		virtual void		RefreshCollisions() = 0;
 		virtual void		SuspendDynamics(bool ghost=false)=0;
 		virtual void		RestoreDynamics()=0;
+		/// Remove the object from the physics world without freeing it, used by recycled objects.
+		virtual void		SuspendPhysics()=0;
+		virtual void		RestorePhysics()=0;
 
 		virtual void		SetActive(bool active)=0;
 
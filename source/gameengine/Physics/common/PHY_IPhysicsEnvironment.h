@@ -150,6 +150,8 @@ class PHY_IPhysicsEnvironment
 		virtual void		SetSolverSorConstant(float sor) {}
 		///setSolverType, internal setting, chooses solvertype, PSOR, Dantzig, impulse based, penalty based
 		virtual void		SetSolverType(int solverType) {}
+		///setSolverThreads, solve independent simulation islands in the threads of the scheduler, NULL to disable
+		virtual void		SetSolverThreads(struct TaskScheduler *scheduler, bool deterministic) {}
 		///setTau sets the spring constant of a penalty based solver
 		virtual void		SetSolverTau(float tau) {}
 		///setDamping sets the damper constant of a penalty based solver
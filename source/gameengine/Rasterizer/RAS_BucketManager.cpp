@@ -81,6 +81,19 @@ struct RAS_BucketManager::fronttoback
 	}
 };
 
+/* group the mesh slots sharing their display arrays and lit by the same lights */
+struct RAS_BucketManager::batchorder
+{
+	bool operator()(const RAS_MeshSlot *a, const RAS_MeshSlot *b)
+	{
+		if (a->GetDisplayArrays() != b->GetDisplayArrays())
+			return a->GetDisplayArrays() < b->GetDisplayArrays();
+		if (a->m_layer != b->m_layer)
+			return a->m_layer < b->m_layer;
+		return (a->m_bObjectColor < b->m_bObjectColor) || (a->m_bObjectColor == b->m_bObjectColor && a < b);
+	}
+};
+
 /* bucket manager */
 
 RAS_BucketManager::RAS_BucketManager()
@@ -176,6 +189,12 @@ void RAS_BucketManager::RenderSolidBuckets(const MT_Transform& cameratrans, RAS_
 		RAS_MeshSlot* ms;
 		// remove the mesh slot from the list, it culls them automatically for next frame
 		while ((ms = bucket->GetNextActiveMeshSlot())) {
+			// drawn after with the other objects using the same mesh
+			if (bucket->IsBatchable(rasty, *ms)) {
+				m_batchSlots.push_back(ms);
+				continue;
+			}
+
 			rasty->SetClientObject(ms->m_clientObj);
 			while (bucket->ActivateMaterial(cameratrans, rasty))
 				bucket->RenderMeshSlot(cameratrans, rasty, *ms);
@@ -184,6 +203,9 @@ void RAS_BucketManager::RenderSolidBuckets(const MT_Transform& cameratrans, RAS_
 			// it will be culled out by frustum culling
 			ms->SetCulled(true);
 		}
+
+		if (!m_batchSlots.empty())
+			RenderBatches(cameratrans, rasty, bucket);
 #else
 		list<RAS_MeshSlot>::iterator mit;
 		for (mit = (*bit)->msBegin(); mit != (*bit)->msEnd(); ++mit) {
@@ -220,6 +242,39 @@ void RAS_BucketManager::RenderSolidBuckets(const MT_Transform& cameratrans, RAS_
 #endif
 }
 
+void RAS_BucketManager::RenderBatches(const MT_Transform& cameratrans, RAS_IRasterizer* rasty, RAS_MaterialBucket* bucket)
+{
+	vector<RAS_MeshSlot *>::iterator sit, send;
+
+	sort(m_batchSlots.begin(), m_batchSlots.end(), batchorder());
+
+	for (sit = m_batchSlots.begin(); sit != m_batchSlots.end(); sit = send) {
+		RAS_MeshSlot *ms = *sit;
+
+		for (send = sit + 1; send != m_batchSlots.end() && (*send)->IsBatchableWith(ms); ++send) {
+		}
+
+		const unsigned int count = send - sit;
+		if (count == 1) {
+			rasty->SetClientObject(ms->m_clientObj);
+			while (bucket->ActivateMaterial(cameratrans, rasty))
+				bucket->RenderMeshSlot(cameratrans, rasty, *ms);
+		}
+		else {
+			// the material and the lights of the layer are activated once for all the objects
+			rasty->SetClientObject(ms->m_clientObj);
+			while (bucket->ActivateMaterial(cameratrans, rasty))
+				bucket->RenderMeshSlotBatch(rasty, &(*sit), count);
+		}
+
+		// make these mesh slots culled automatically for next frame
+		for (; sit != send; ++sit)
+			(*sit)->SetCulled(true);
+	}
+
+	m_batchSlots.clear();
+}
+
 void RAS_BucketManager::Renderbuckets(const MT_Transform& cameratrans, RAS_IRasterizer* rasty)
 {
 	/* beginning each frame, clear (texture/material) caching information */
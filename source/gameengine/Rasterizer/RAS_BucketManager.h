@@ -48,6 +48,10 @@ private:
 	struct sortedmeshslot;
 	struct backtofront;
 	struct fronttoback;
+	struct batchorder;
+
+	/* mesh slots of the bucket being rendered drawn in batches */
+	std::vector<RAS_MeshSlot *> m_batchSlots;
 
 public:
 	RAS_BucketManager();
@@ -83,6 +87,8 @@ private:
 		RAS_IRasterizer* rasty);
 	void RenderAlphaBuckets(const MT_Transform& cameratrans,
 		RAS_IRasterizer* rasty);
+	void RenderBatches(const MT_Transform& cameratrans,
+		RAS_IRasterizer* rasty, RAS_MaterialBucket* bucket);
 
 
 #ifdef WITH_CXX_GUARDEDALLOC
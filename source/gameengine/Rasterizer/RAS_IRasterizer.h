@@ -61,6 +61,29 @@ typedef vector<RAS_TexVert> KX_VertexArray;
 typedef vector<KX_VertexArray *> vecVertexArray;
 typedef vector<KX_IndexArray *> vecIndexArrays;
 
+/**
+ * Draw calls and state changes of a rasterizer since its last ResetDrawStats().
+ */
+struct RAS_DrawStats
+{
+	/// glDrawElements calls.
+	unsigned int m_drawCalls;
+	/// Vertex arrays set up for one or more draw calls.
+	unsigned int m_arrayBinds;
+	/// Material passes activated.
+	unsigned int m_materialBinds;
+	/// Mesh slots drawn by IndexPrimitivesBatch().
+	unsigned int m_batchedSlots;
+
+	RAS_DrawStats()
+		:m_drawCalls(0),
+		m_arrayBinds(0),
+		m_materialBinds(0),
+		m_batchedSlots(0)
+	{
+	}
+};
+
 /**
  * 3D rendering device context interface. 
  */
@@ -272,6 +295,20 @@ public:
 	 * IndexPrimitives_3DText will render text into the polygons.
 	 */
 	virtual void IndexPrimitives_3DText(class RAS_MeshSlot &ms, class RAS_IPolyMaterial *polymat) = 0;
+
+	/**
+	 * IndexPrimitivesBatch renders \a count mesh slots sharing the same display arrays
+	 * with \a polymat: the vertex arrays are set up once, then only the transform and the
+	 * mesh slot settings of \a polymat change between the draw calls.
+	 * This is not hardware instancing, each mesh slot is still drawn by its own draw call.
+	 */
+	virtual void IndexPrimitivesBatch(class RAS_MeshSlot **slots, unsigned int count, class RAS_IPolyMaterial *polymat) = 0;
+
+	/**
+	 * Draw calls and state changes since the last ResetDrawStats().
+	 */
+	virtual const RAS_DrawStats& GetDrawStats() const = 0;
+	virtual void ResetDrawStats() = 0;
  
 	virtual void SetProjectionMatrix(MT_CmMatrix4x4 &mat) = 0;
 
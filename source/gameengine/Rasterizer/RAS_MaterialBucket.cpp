@@ -59,6 +59,7 @@ RAS_MeshSlot::RAS_MeshSlot() : SG_QList()
 	m_bCulled = true;
 	m_bObjectColor = false;
 	m_RGBAcolor = MT_Vector4(0.0f, 0.0f, 0.0f, 0.0f);
+	m_layer = 0;
 	m_DisplayList = NULL;
 	m_bDisplayList = true;
 	m_joinSlot = NULL;
@@ -102,6 +103,7 @@ RAS_MeshSlot::RAS_MeshSlot(const RAS_MeshSlot& slot) : SG_QList()
 	m_bCulled = slot.m_bCulled;
 	m_bObjectColor = slot.m_bObjectColor;
 	m_RGBAcolor = slot.m_RGBAcolor;
+	m_layer = slot.m_layer;
 	m_DisplayList = NULL;
 	m_bDisplayList = slot.m_bDisplayList;
 	m_joinSlot = NULL;
@@ -370,6 +372,14 @@ bool RAS_MeshSlot::Equals(RAS_MeshSlot *target)
 	return true;
 }
 
+bool RAS_MeshSlot::IsBatchableWith(const RAS_MeshSlot *other) const
+{
+	return (m_displayArrays == other->m_displayArrays &&
+	        m_startarray == other->m_startarray && m_endarray == other->m_endarray &&
+	        m_startindex == other->m_startindex && m_endindex == other->m_endindex &&
+	        m_bObjectColor == other->m_bObjectColor && m_layer == other->m_layer);
+}
+
 bool RAS_MeshSlot::Join(RAS_MeshSlot *target, MT_Scalar distance)
 {
 	RAS_DisplayArrayList::iterator it;
@@ -660,6 +670,35 @@ void RAS_MaterialBucket::RenderMeshSlot(const MT_Transform& cameratrans, RAS_IRa
 	rasty->PopMatrix();
 }
 
+bool RAS_MaterialBucket::IsBatchable(RAS_IRasterizer* rasty, const RAS_MeshSlot &ms) const
+{
+	// display lists already record the whole mesh slot
+	if (rasty->QueryLists())
+		return false;
+
+	// the polygons are sorted or the transform computed for each object
+	if (IsZSort())
+		return false;
+	if (m_material->GetDrawingMode() & (RAS_IRasterizer::RAS_RENDER_3DPOLYGON_TEXT |
+	                                     RAS_IPolyMaterial::BILLBOARD_SCREENALIGNED |
+	                                     RAS_IPolyMaterial::BILLBOARD_AXISALIGNED |
+	                                     RAS_IPolyMaterial::SHADOW))
+	{
+		return false;
+	}
+
+	// the vertices are not shared with the other objects using this mesh
+	if (ms.m_pDeformer || ms.m_pDerivedMesh || ms.m_joinSlot || !ms.m_joinedSlots.empty())
+		return false;
+
+	return !ms.GetDisplayArrays().empty();
+}
+
+void RAS_MaterialBucket::RenderMeshSlotBatch(RAS_IRasterizer* rasty, RAS_MeshSlot **slots, unsigned int count)
+{
+	rasty->IndexPrimitivesBatch(slots, count, m_material);
+}
+
 void RAS_MaterialBucket::Optimize(MT_Scalar distance)
 {
 	/* TODO: still have to check before this works correct:
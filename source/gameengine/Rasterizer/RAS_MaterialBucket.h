@@ -135,6 +135,8 @@ public:
 	// object color
 	bool					m_bObjectColor;
 	MT_Vector4				m_RGBAcolor;
+	/// Layer of the client object, the lights of the mesh slot depend on it.
+	int						m_layer;
 	// display lists
 	KX_ListSlot*			m_DisplayList;
 	bool					m_bDisplayList;
@@ -175,6 +177,10 @@ public:
 	/// Update offset of each display array
 	void UpdateDisplayArraysOffset();
 
+	/* batching */
+	const RAS_DisplayArrayList& GetDisplayArrays() const { return m_displayArrays; }
+	bool IsBatchableWith(const RAS_MeshSlot *other) const;
+
 	/* optimization */
 	bool Split(bool force=false);
 	bool Join(RAS_MeshSlot *target, MT_Scalar distance);
@@ -231,6 +237,10 @@ public:
 	/* Rendering */
 	bool ActivateMaterial(const MT_Transform& cameratrans, RAS_IRasterizer* rasty);
 	void RenderMeshSlot(const MT_Transform& cameratrans, RAS_IRasterizer* rasty, RAS_MeshSlot &ms);
+
+	/* Batching: mesh slots of the same mesh drawn with a single setup of their vertex arrays */
+	bool IsBatchable(RAS_IRasterizer* rasty, const RAS_MeshSlot &ms) const;
+	void RenderMeshSlotBatch(RAS_IRasterizer* rasty, RAS_MeshSlot **slots, unsigned int count);
 	
 	/* Mesh Slot Access */
 	list<RAS_MeshSlot>::iterator msBegin();
@@ -32,7 +32,7 @@
   #include "MEM_guardedalloc.h"
 #endif
 
-class RAS_MeshSlot;
+#include "RAS_MaterialBucket.h"
 
 class RAS_IStorage
 {
@@ -45,6 +45,15 @@ public:
 
 	virtual void	IndexPrimitives(RAS_MeshSlot& ms)=0;
 
+	/**
+	 * Set up the vertex arrays of the display array \a it of \a ms, drawn by
+	 * DrawPrimitives() for \a ms or any mesh slot sharing its display arrays
+	 * until UnbindPrimitives().
+	 */
+	virtual void	BindPrimitives(RAS_MeshSlot& ms, const RAS_MeshSlot::iterator& it)=0;
+	virtual void	DrawPrimitives(RAS_MeshSlot& ms)=0;
+	virtual void	UnbindPrimitives()=0;
+
 	virtual void	SetDrawingMode(int drawingmode)=0;
 
 
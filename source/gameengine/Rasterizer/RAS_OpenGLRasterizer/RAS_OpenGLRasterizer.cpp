@@ -125,14 +125,14 @@ RAS_OpenGLRasterizer::RAS_OpenGLRasterizer(RAS_ICanvas* canvas, RAS_STORAGE_TYPE
 	m_prevafvalue = GPU_get_anisotropic();
 
 	if (m_storage_type == RAS_VBO /*|| m_storage_type == RAS_AUTO_STORAGE && GLEW_ARB_vertex_buffer_object*/) {
-		m_storage = new RAS_StorageVBO(&m_texco_num, m_texco, &m_attrib_num, m_attrib, m_attrib_layer);
+		m_storage = new RAS_StorageVBO(&m_texco_num, m_texco, &m_attrib_num, m_attrib, m_attrib_layer, &m_drawStats);
 	}
 	else if ((m_storage_type == RAS_VA) || (m_storage_type == RAS_AUTO_STORAGE)) {
-		m_storage = new RAS_StorageVA(&m_texco_num, m_texco, &m_attrib_num, m_attrib, m_attrib_layer);
+		m_storage = new RAS_StorageVA(&m_texco_num, m_texco, &m_attrib_num, m_attrib, m_attrib_layer, &m_drawStats);
 	}
 	else {
 		printf("Unknown rasterizer storage type, falling back to vertex arrays\n");
-		m_storage = new RAS_StorageVA(&m_texco_num, m_texco, &m_attrib_num, m_attrib, m_attrib_layer);
+		m_storage = new RAS_StorageVA(&m_texco_num, m_texco, &m_attrib_num, m_attrib, m_attrib_layer, &m_drawStats);
 	}
 
 	glGetIntegerv(GL_MAX_LIGHTS, (GLint *) &m_numgllights);
@@ -237,7 +237,11 @@ void RAS_OpenGLRasterizer::DisplayFog()
 
 bool RAS_OpenGLRasterizer::SetMaterial(const RAS_IPolyMaterial& mat)
 {
-	return mat.Activate(this, m_materialCachingInfo);
+	if (!mat.Activate(this, m_materialCachingInfo))
+		return false;
+
+	m_drawStats.m_materialBinds++;
+	return true;
 }
 
 
@@ -733,6 +737,36 @@ void RAS_OpenGLRasterizer::IndexPrimitives(RAS_MeshSlot& ms)
 		m_storage->IndexPrimitives(ms);
 }
 
+void RAS_OpenGLRasterizer::IndexPrimitivesBatch(RAS_MeshSlot **slots, unsigned int count, RAS_IPolyMaterial *polymat)
+{
+	RAS_MeshSlot& first = *slots[0];
+	RAS_MeshSlot::iterator it;
+	const int drawingmode = polymat->GetDrawingMode();
+
+	// All the slots share the display arrays of the first one, draw them array by array
+	// so the vertex arrays are set up only once for all the slots.
+	for (first.begin(it); !first.end(it); first.next(it)) {
+		if (it.totindex == 0)
+			continue;
+
+		m_storage->BindPrimitives(first, it);
+		for (unsigned int i = 0; i < count; i++) {
+			RAS_MeshSlot& ms = *slots[i];
+
+			SetClientObject(ms.m_clientObj);
+			polymat->ActivateMeshSlot(ms, this);
+
+			glPushMatrix();
+			applyTransform(ms.m_OpenGLMatrix, drawingmode);
+			m_storage->DrawPrimitives(ms);
+			glPopMatrix();
+		}
+		m_storage->UnbindPrimitives();
+	}
+
+	m_drawStats.m_batchedSlots += count;
+}
+
 // Code for hooking into Blender's mesh drawing for derived meshes.
 // If/when we use more of Blender's drawing code, we may be able to
 // clean this up
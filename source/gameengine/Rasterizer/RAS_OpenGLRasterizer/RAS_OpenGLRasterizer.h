@@ -139,6 +139,8 @@ protected:
 	int m_storage_type;
 	RAS_IStorage *m_storage;
 
+	RAS_DrawStats m_drawStats;
+
 public:
 	double GetTime();
 	RAS_OpenGLRasterizer(RAS_ICanvas *canv, RAS_STORAGE_TYPE storage);
@@ -185,8 +187,18 @@ public:
 
 	virtual void IndexPrimitives(class RAS_MeshSlot &ms);
 	virtual void IndexPrimitives_3DText(class RAS_MeshSlot &ms, class RAS_IPolyMaterial *polymat);
+	virtual void IndexPrimitivesBatch(class RAS_MeshSlot **slots, unsigned int count, class RAS_IPolyMaterial *polymat);
 	virtual void DrawDerivedMesh(class RAS_MeshSlot &ms);
 
+	virtual const RAS_DrawStats& GetDrawStats() const
+	{
+		return m_drawStats;
+	}
+	virtual void ResetDrawStats()
+	{
+		m_drawStats = RAS_DrawStats();
+	}
+
 	virtual void SetProjectionMatrix(MT_CmMatrix4x4 &mat);
 	virtual void SetProjectionMatrix(const MT_Matrix4x4 &mat);
 	virtual void SetViewMatrix(const MT_Matrix4x4 &mat, const MT_Matrix3x3 &ori, const MT_Point3 &pos, bool perspective);
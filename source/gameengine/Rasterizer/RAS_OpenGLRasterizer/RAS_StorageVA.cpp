@@ -29,7 +29,8 @@
 
 #include "glew-mx.h"
 
-RAS_StorageVA::RAS_StorageVA(int *texco_num, RAS_IRasterizer::TexCoGen *texco, int *attrib_num, RAS_IRasterizer::TexCoGen *attrib, int *attrib_layer) :
+RAS_StorageVA::RAS_StorageVA(int *texco_num, RAS_IRasterizer::TexCoGen *texco, int *attrib_num, RAS_IRasterizer::TexCoGen *attrib, int *attrib_layer,
+                             RAS_DrawStats *drawstats) :
 	m_drawingmode(RAS_IRasterizer::KX_TEXTURED),
 	m_texco_num(texco_num),
 	m_attrib_num(attrib_num),
@@ -37,7 +38,12 @@ RAS_StorageVA::RAS_StorageVA(int *texco_num, RAS_IRasterizer::TexCoGen *texco, i
 	m_last_attrib_num(0),
 	m_texco(texco),
 	m_attrib(attrib),
-	m_attrib_layer(attrib_layer)
+	m_attrib_layer(attrib_layer),
+	m_bound_mode(GL_TRIANGLES),
+	m_bound_index(NULL),
+	m_bound_totindex(0),
+	m_bound_objectcolor(false),
+	m_drawstats(drawstats)
 {
 }
 
@@ -58,63 +64,83 @@ void RAS_StorageVA::Exit()
 
 void RAS_StorageVA::IndexPrimitives(class RAS_MeshSlot& ms)
 {
-	static const GLsizei stride = sizeof(RAS_TexVert);
-	bool wireframe = m_drawingmode <= RAS_IRasterizer::KX_WIREFRAME, use_color_array = true;
 	RAS_MeshSlot::iterator it;
-	GLenum drawmode;
+
+	// use glDrawElements to draw each vertexarray
+	for (ms.begin(it); !ms.end(it); ms.next(it)) {
+		if (it.totindex == 0)
+			continue;
+
+		BindPrimitives(ms, it);
+		DrawPrimitives(ms);
+		UnbindPrimitives();
+	}
+}
+
+void RAS_StorageVA::BindPrimitives(RAS_MeshSlot& ms, const RAS_MeshSlot::iterator& it)
+{
+	static const GLsizei stride = sizeof(RAS_TexVert);
+	bool wireframe = m_drawingmode <= RAS_IRasterizer::KX_WIREFRAME;
 
 	if (!wireframe)
 		EnableTextures(true);
 	glEnableClientState(GL_VERTEX_ARRAY);
 	glEnableClientState(GL_NORMAL_ARRAY);
 
-	// use glDrawElements to draw each vertexarray
-	for (ms.begin(it); !ms.end(it); ms.next(it)) {
-		if (it.totindex == 0)
-			continue;
+	// drawing mode
+	if (it.array->m_type == RAS_DisplayArray::TRIANGLE)
+		m_bound_mode = GL_TRIANGLES;
+	else if (it.array->m_type == RAS_DisplayArray::QUAD)
+		m_bound_mode = GL_QUADS;
+	else
+		m_bound_mode = GL_LINES;
 
-		// drawing mode
-		if (it.array->m_type == RAS_DisplayArray::TRIANGLE)
-			drawmode = GL_TRIANGLES;
-		else if (it.array->m_type == RAS_DisplayArray::QUAD)
-			drawmode = GL_QUADS;
-		else
-			drawmode = GL_LINES;
-
-		// colors
-		if (drawmode != GL_LINES && !wireframe) {
-			if (ms.m_bObjectColor) {
-				const MT_Vector4& rgba = ms.m_RGBAcolor;
-
-				glDisableClientState(GL_COLOR_ARRAY);
-				glColor4d(rgba[0], rgba[1], rgba[2], rgba[3]);
-				use_color_array = false;
-			}
-			else {
-				glColor4f(0.0f, 0.0f, 0.0f, 1.0f);
-				glEnableClientState(GL_COLOR_ARRAY);
-				use_color_array = true;
-			}
+	// colors, the object color is set for each mesh slot in DrawPrimitives()
+	m_bound_objectcolor = false;
+	if (m_bound_mode != GL_LINES && !wireframe) {
+		if (ms.m_bObjectColor) {
+			glDisableClientState(GL_COLOR_ARRAY);
+			m_bound_objectcolor = true;
 		}
-		else
+		else {
 			glColor4f(0.0f, 0.0f, 0.0f, 1.0f);
+			glEnableClientState(GL_COLOR_ARRAY);
+		}
+	}
+	else
+		glColor4f(0.0f, 0.0f, 0.0f, 1.0f);
 
-		glVertexPointer(3, GL_FLOAT, stride, it.vertex->getXYZ());
-		glNormalPointer(GL_FLOAT, stride, it.vertex->getNormal());
+	glVertexPointer(3, GL_FLOAT, stride, it.vertex->getXYZ());
+	glNormalPointer(GL_FLOAT, stride, it.vertex->getNormal());
 
-		if (!wireframe) {
-			TexCoordPtr(it.vertex);
-			if (use_color_array)
-				glColorPointer(4, GL_UNSIGNED_BYTE, stride, it.vertex->getRGBA());
-		}
+	if (!wireframe) {
+		TexCoordPtr(it.vertex);
+		if (!m_bound_objectcolor)
+			glColorPointer(4, GL_UNSIGNED_BYTE, stride, it.vertex->getRGBA());
+	}
 
-		// here the actual drawing takes places
-		glDrawElements(drawmode, it.totindex, GL_UNSIGNED_SHORT, it.index);
+	m_bound_index = it.index;
+	m_bound_totindex = it.totindex;
+	m_drawstats->m_arrayBinds++;
+}
+
+void RAS_StorageVA::DrawPrimitives(RAS_MeshSlot& ms)
+{
+	if (m_bound_objectcolor) {
+		const MT_Vector4& rgba = ms.m_RGBAcolor;
+		glColor4d(rgba[0], rgba[1], rgba[2], rgba[3]);
 	}
-	
+
+	// here the actual drawing takes places
+	glDrawElements(m_bound_mode, m_bound_totindex, GL_UNSIGNED_SHORT, m_bound_index);
+	m_drawstats->m_drawCalls++;
+}
+
+void RAS_StorageVA::UnbindPrimitives()
+{
 	glDisableClientState(GL_VERTEX_ARRAY);
 	glDisableClientState(GL_NORMAL_ARRAY);
-	if (!wireframe) {
+	if (m_drawingmode > RAS_IRasterizer::KX_WIREFRAME) {
 		glDisableClientState(GL_COLOR_ARRAY);
 		EnableTextures(false);
 	}
@@ -37,7 +37,8 @@ class RAS_StorageVA : public RAS_IStorage
 {
 
 public:
-	RAS_StorageVA(int *texco_num, RAS_IRasterizer::TexCoGen *texco, int *attrib_num, RAS_IRasterizer::TexCoGen *attrib, int *attrib_layer);
+	RAS_StorageVA(int *texco_num, RAS_IRasterizer::TexCoGen *texco, int *attrib_num, RAS_IRasterizer::TexCoGen *attrib, int *attrib_layer,
+	              RAS_DrawStats *drawstats);
 	virtual ~RAS_StorageVA();
 
 	virtual bool	Init();
@@ -45,6 +46,10 @@ public:
 
 	virtual void	IndexPrimitives(RAS_MeshSlot& ms);
 
+	virtual void	BindPrimitives(RAS_MeshSlot& ms, const RAS_MeshSlot::iterator& it);
+	virtual void	DrawPrimitives(RAS_MeshSlot& ms);
+	virtual void	UnbindPrimitives();
+
 	virtual void	SetDrawingMode(int drawingmode){m_drawingmode=drawingmode;};
 
 protected:
@@ -63,6 +68,14 @@ protected:
 	RAS_IRasterizer::TexCoGen		m_last_texco[RAS_MAX_TEXCO];
 	RAS_IRasterizer::TexCoGen		m_last_attrib[RAS_MAX_ATTRIB];
 
+	/* display array set up by BindPrimitives() */
+	unsigned int	m_bound_mode;
+	unsigned short*	m_bound_index;
+	int				m_bound_totindex;
+	bool			m_bound_objectcolor;
+
+	RAS_DrawStats*	m_drawstats;
+
 	virtual void	EnableTextures(bool enable);
 	virtual void	TexCoordPtr(const RAS_TexVert *tv);
 
@@ -80,7 +80,7 @@ void VBO::UpdateIndices()
 					&data->m_index[0], GL_STATIC_DRAW);
 }
 
-void VBO::Draw(int texco_num, RAS_IRasterizer::TexCoGen* texco, int attrib_num, RAS_IRasterizer::TexCoGen* attrib, int *attrib_layer)
+void VBO::Bind(int texco_num, RAS_IRasterizer::TexCoGen* texco, int attrib_num, RAS_IRasterizer::TexCoGen* attrib, int *attrib_layer)
 {
 	int unit;
 
@@ -154,9 +154,15 @@ void VBO::Draw(int texco_num, RAS_IRasterizer::TexCoGen* texco, int attrib_num,
 			}
 		}
 	}
+}
 
+void VBO::Draw()
+{
 	glDrawElements(this->mode, this->indices, GL_UNSIGNED_SHORT, 0);
+}
 
+void VBO::Unbind(int attrib_num)
+{
 	glDisableClientState(GL_VERTEX_ARRAY);
 	glDisableClientState(GL_NORMAL_ARRAY);
 	glDisableClientState(GL_COLOR_ARRAY);
@@ -172,13 +178,16 @@ void VBO::Draw(int texco_num, RAS_IRasterizer::TexCoGen* texco, int attrib_num,
 	glBindBufferARB(GL_ELEMENT_ARRAY_BUFFER_ARB, 0);
 }
 
-RAS_StorageVBO::RAS_StorageVBO(int *texco_num, RAS_IRasterizer::TexCoGen *texco, int *attrib_num, RAS_IRasterizer::TexCoGen *attrib, int *attrib_layer):
+RAS_StorageVBO::RAS_StorageVBO(int *texco_num, RAS_IRasterizer::TexCoGen *texco, int *attrib_num, RAS_IRasterizer::TexCoGen *attrib, int *attrib_layer,
+                               RAS_DrawStats *drawstats):
 	m_drawingmode(RAS_IRasterizer::KX_TEXTURED),
 	m_texco_num(texco_num),
 	m_attrib_num(attrib_num),
 	m_texco(texco),
 	m_attrib(attrib),
-	m_attrib_layer(attrib_layer)
+	m_attrib_layer(attrib_layer),
+	m_bound_vbo(NULL),
+	m_drawstats(drawstats)
 {
 }
 
@@ -199,21 +208,41 @@ void RAS_StorageVBO::Exit()
 void RAS_StorageVBO::IndexPrimitives(RAS_MeshSlot& ms)
 {
 	RAS_MeshSlot::iterator it;
-	VBO *vbo;
 
 	for (ms.begin(it); !ms.end(it); ms.next(it))
 	{
-		vbo = m_vbo_lookup[it.array];
+		BindPrimitives(ms, it);
+		DrawPrimitives(ms);
+		UnbindPrimitives();
+	}
+}
 
-		if (vbo == 0)
-			m_vbo_lookup[it.array] = vbo = new VBO(it.array, it.totindex);
+void RAS_StorageVBO::BindPrimitives(RAS_MeshSlot& ms, const RAS_MeshSlot::iterator& it)
+{
+	VBO *vbo = m_vbo_lookup[it.array];
 
-		// Update the vbo
-		if (ms.m_mesh->MeshModified())
-		{
-			vbo->UpdateData();
-		}
+	if (vbo == 0)
+		m_vbo_lookup[it.array] = vbo = new VBO(it.array, it.totindex);
 
-		vbo->Draw(*m_texco_num, m_texco, *m_attrib_num, m_attrib, m_attrib_layer);
+	// Update the vbo
+	if (ms.m_mesh->MeshModified())
+	{
+		vbo->UpdateData();
 	}
+
+	vbo->Bind(*m_texco_num, m_texco, *m_attrib_num, m_attrib, m_attrib_layer);
+	m_bound_vbo = vbo;
+	m_drawstats->m_arrayBinds++;
+}
+
+void RAS_StorageVBO::DrawPrimitives(RAS_MeshSlot& /*ms*/)
+{
+	m_bound_vbo->Draw();
+	m_drawstats->m_drawCalls++;
+}
+
+void RAS_StorageVBO::UnbindPrimitives()
+{
+	m_bound_vbo->Unbind(*m_attrib_num);
+	m_bound_vbo = NULL;
 }
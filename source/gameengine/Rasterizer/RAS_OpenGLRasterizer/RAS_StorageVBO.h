@@ -42,7 +42,9 @@ public:
 	VBO(RAS_DisplayArray *data, unsigned int indices);
 	~VBO();
 
-	void	Draw(int texco_num, RAS_IRasterizer::TexCoGen* texco, int attrib_num, RAS_IRasterizer::TexCoGen* attrib, int *attrib_layer);
+	void	Bind(int texco_num, RAS_IRasterizer::TexCoGen* texco, int attrib_num, RAS_IRasterizer::TexCoGen* attrib, int *attrib_layer);
+	void	Draw();
+	void	Unbind(int attrib_num);
 
 	void	UpdateData();
 	void	UpdateIndices();
@@ -66,7 +68,8 @@ class RAS_StorageVBO : public RAS_IStorage
 {
 
 public:
-	RAS_StorageVBO(int *texco_num, RAS_IRasterizer::TexCoGen *texco, int *attrib_num, RAS_IRasterizer::TexCoGen *attrib, int *attrib_layer);
+	RAS_StorageVBO(int *texco_num, RAS_IRasterizer::TexCoGen *texco, int *attrib_num, RAS_IRasterizer::TexCoGen *attrib, int *attrib_layer,
+	               RAS_DrawStats *drawstats);
 	virtual ~RAS_StorageVBO();
 
 	virtual bool	Init();
@@ -74,6 +77,10 @@ public:
 
 	virtual void	IndexPrimitives(RAS_MeshSlot& ms);
 
+	virtual void	BindPrimitives(RAS_MeshSlot& ms, const RAS_MeshSlot::iterator& it);
+	virtual void	DrawPrimitives(RAS_MeshSlot& ms);
+	virtual void	UnbindPrimitives();
+
 	virtual void	SetDrawingMode(int drawingmode){m_drawingmode=drawingmode;};
 
 protected:
@@ -88,6 +95,11 @@ protected:
 
 	std::map<RAS_DisplayArray*, class VBO*>	m_vbo_lookup;
 
+	/* vbo set up by BindPrimitives() */
+	VBO*			m_bound_vbo;
+
+	RAS_DrawStats*	m_drawstats;
+
 #ifdef WITH_CXX_GUARDEDALLOC
 public:
 	void *operator new(size_t num_bytes) { return MEM_mallocN(num_bytes, "GE:RAS_StorageVA"); }
@@ -207,6 +207,55 @@ void SG_Node::UpdateWorldData(double time, bool parentUpdated)
 
 
 
+bool SG_Node::GetUpdateList(SG_NodeUpdateList& list)
+{
+	bool threadsafe = true;
+
+	list.push_back(SG_NodeUpdateEntry(this, -1));
+
+	// breadth first, the list may grow while we iterate over it
+	for (size_t i = list.size() - 1; i < list.size(); i++)
+	{
+		SG_Node *node = list[i].m_node;
+
+		if (!node->GetSGControllerList().empty() ||
+		    (node->m_parent_relation && !node->m_parent_relation->IsThreadSafe()))
+		{
+			threadsafe = false;
+		}
+
+		for (NodeList::iterator it = node->m_children.begin(); it != node->m_children.end(); ++it)
+		{
+			list.push_back(SG_NodeUpdateEntry(*it, (int)i));
+		}
+	}
+
+	return threadsafe;
+}
+
+void SG_Node::UpdateWorldDataList(SG_NodeUpdateList& list, size_t first, double time)
+{
+	for (size_t i = first; i < list.size(); i++)
+	{
+		SG_NodeUpdateEntry& entry = list[i];
+		bool parentUpdated = (entry.m_parent != -1) ? list[entry.m_parent].m_parentUpdated : false;
+
+		entry.m_transformUpdated = entry.m_node->UpdateSpatialData(entry.m_node->GetSGParent(), time, parentUpdated);
+		entry.m_parentUpdated = parentUpdated;
+	}
+}
+
+void SG_Node::EndUpdateWorldDataList(SG_NodeUpdateList& list)
+{
+	for (SG_NodeUpdateList::iterator it = list.begin(); it != list.end(); ++it)
+	{
+		if (it->m_transformUpdated)
+			it->m_node->ActivateUpdateTransformCallback();
+
+		it->m_node->Delink();
+	}
+}
+
 void SG_Node::SetSimulatedTime(double time,bool recurse)
 {
 
@@ -37,6 +37,29 @@
 
 typedef std::vector<SG_Node*> NodeList;
 
+/**
+ * Entry of a flattened subtree, see SG_Node::GetUpdateList().
+ */
+struct SG_NodeUpdateEntry
+{
+	SG_Node *m_node;
+	/// Index of the parent entry, -1 for the subtree root.
+	int m_parent;
+	/// Passed on to the children.
+	bool m_parentUpdated;
+	/// The update transform callback must be called for this node.
+	bool m_transformUpdated;
+
+	SG_NodeUpdateEntry(SG_Node *node, int parent)
+		:m_node(node),
+		m_parent(parent),
+		m_parentUpdated(false),
+		m_transformUpdated(false)
+	{
+	}
+};
+typedef std::vector<SG_NodeUpdateEntry> SG_NodeUpdateList;
+
 /**
  * Scenegraph node.
  */
@@ -193,6 +216,44 @@ public:
 		bool parentUpdated=false
 	);
 
+	/**
+	 * Append this node and all its children to list, parents always
+	 * come before their children. Returns false if one of the nodes
+	 * can't be updated from a thread (it has controllers, or its
+	 * parent relation isn't thread safe).
+	 */
+
+		bool
+	GetUpdateList(
+		SG_NodeUpdateList& list
+	);
+
+	/**
+	 * Same as UpdateWorldData() for all entries of list from first,
+	 * but the nodes are neither removed from the update list nor
+	 * the update transform callback called (flagged in the entries
+	 * instead), so separate hierarchies can be updated in parallel.
+	 */
+
+	static
+		void
+	UpdateWorldDataList(
+		SG_NodeUpdateList& list,
+		size_t first,
+		double time
+	);
+
+	/**
+	 * Finish UpdateWorldDataList(), call the update transform callbacks
+	 * and remove the nodes from the update list. Not thread safe.
+	 */
+
+	static
+		void
+	EndUpdateWorldDataList(
+		SG_NodeUpdateList& list
+	);
+
 	/**
 	 * Update the simulation time of this node. Iterate through
 	 * the children nodes and update their simulated time.
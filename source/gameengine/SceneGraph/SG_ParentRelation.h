@@ -110,6 +110,17 @@ public :
 	) { 
 		return false;
 	}
+
+	/**
+	 * Relations reading shared data (other than the parent
+	 * transform) can't be updated from several threads at once.
+	 */
+	virtual
+		bool
+	IsThreadSafe(
+	) {
+		return true;
+	}
 protected :
 
 	/** 
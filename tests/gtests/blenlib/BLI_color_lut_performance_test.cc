@@ -0,0 +1,133 @@
+/* Apache License, Version 2.0 */
+
+#include "testing/testing.h"
+
+extern "C" {
+#include "MEM_guardedalloc.h"
+#include "BLI_utildefines.h"
+#include "BLI_color_lut.h"
+#include "BLI_math.h"
+#include "BLI_rand.h"
+#include "PIL_time_utildefines.h"
+}
+
+/* Stand-in for an OpenColorIO display transform: a saturation matrix, a filmic like curve
+ * and the sRGB transfer function, so the channels depend on each other. */
+static void display_transform_v3(float rgb[3])
+{
+	float saturation[3][3] = {
+		{0.85f, 0.10f, 0.05f},
+		{0.08f, 0.87f, 0.05f},
+		{0.06f, 0.09f, 0.85f},
+	};
+	float tmp[3];
+
+	for (int i = 0; i < 3; i++) {
+		tmp[i] = dot_v3v3(saturation[i], rgb);
+	}
+
+	for (int i = 0; i < 3; i++) {
+		float x = max_ff(tmp[i], 0.0f);
+		x = (x * (2.51f * x + 0.03f)) / (x * (2.43f * x + 0.59f) + 0.14f);
+		rgb[i] = linearrgb_to_srgb(x);
+	}
+}
+
+static void display_transform_bake(void *UNUSED(userdata), float *rgb, size_t num_pixels)
+{
+	for (size_t i = 0; i < num_pixels; i++, rgb += 3) {
+		display_transform_v3(rgb);
+	}
+}
+
+/* Image like pixels: smooth gradients over the stops of the LUT, and some darker values, with a
+ * bit of noise. Brighter values are clamped by the LUT and wouldn't match the transform. */
+static void rng_pixels_init(float *pixels, const int pixels_num, const int channels, const int seed)
+{
+	RNG *rng = BLI_rng_new(seed);
+	for (int i = 0; i < pixels_num; i++) {
+		for (int j = 0; j < channels; j++) {
+			const float gradient = 0.5f + 0.5f * sinf((float)i * (0.0001f + 0.00003f * j));
+			const float stops = -12.0f + 17.9f * gradient + 0.1f * BLI_rng_get_float(rng);
+			pixels[(size_t)i * channels + j] = powf(2.0f, stops);
+		}
+	}
+	BLI_rng_free(rng);
+}
+
+static void color_lut_tests(const int size, const int pixels_num, const int channels, const float error_limit)
+{
+	printf("\n========== STARTING LUT size %d, %d pixels, %d channels ==========\n",
+	       size, pixels_num, channels);
+
+	const size_t buffer_len = (size_t)pixels_num * channels;
+	float *pixels = (float *)MEM_mallocN(sizeof(float) * buffer_len, __func__);
+	float *exact = (float *)MEM_mallocN(sizeof(float) * buffer_len, __func__);
+	float *baked = (float *)MEM_mallocN(sizeof(float) * buffer_len, __func__);
+	ColorLUT *lut;
+
+	rng_pixels_init(pixels, pixels_num, channels, 0);
+	memcpy(exact, pixels, sizeof(float) * buffer_len);
+	memcpy(baked, pixels, sizeof(float) * buffer_len);
+
+	{
+		TIMEIT_START(bake);
+
+		lut = BLI_color_lut_bake(size, display_transform_bake, NULL);
+
+		TIMEIT_END(bake);
+	}
+
+	{
+		TIMEIT_START(exact);
+
+		for (int i = 0; i < pixels_num; i++) {
+			display_transform_v3(exact + (size_t)i * channels);
+		}
+
+		TIMEIT_END(exact);
+	}
+
+	{
+		TIMEIT_START(lut);
+
+		BLI_color_lut_apply(lut, baked, (size_t)pixels_num, channels, false);
+
+		TIMEIT_END(lut);
+	}
+
+	/* the display buffer is 8 bit, compare with its precision */
+	double error_sum = 0.0;
+	float error_max = 0.0f;
+	for (int i = 0; i < pixels_num; i++) {
+		for (int j = 0; j < 3; j++) {
+			const size_t index = (size_t)i * channels + j;
+			const float error = fabsf(exact[index] - baked[index]) * 255.0f;
+			error_sum += error;
+			error_max = max_ff(error_max, error);
+		}
+	}
+	printf("error in 8 bit steps: mean %f, max %f\n", error_sum / (pixels_num * 3), error_max);
+
+	EXPECT_LT(error_max, error_limit);
+
+	BLI_color_lut_free(lut);
+	MEM_freeN(pixels);
+	MEM_freeN(exact);
+	MEM_freeN(baked);
+}
+
+TEST(color_lut, Size33_4Channels)
+{
+	color_lut_tests(33, 4000000, 4, 2.0f);
+}
+
+TEST(color_lut, Size65_4Channels)
+{
+	color_lut_tests(65, 4000000, 4, 1.0f);
+}
+
+TEST(color_lut, Size65_3Channels)
+{
+	color_lut_tests(65, 4000000, 3, 1.0f);
+}
@@ -0,0 +1,126 @@
+/* Apache License, Version 2.0 */
+
+#include "testing/testing.h"
+
+extern "C" {
+#include "MEM_guardedalloc.h"
+#include "BLI_utildefines.h"
+#include "BLI_color_lut.h"
+#include "BLI_math.h"
+}
+
+/* with 17 points there is one per stop, at 2^(i - 10) - 2^-10 */
+#define LUT_SIZE 17
+
+/* mixes the channels, so every corner of the lattice cells has to be looked up */
+static void transform_v3(float rgb[3])
+{
+	const float r = rgb[0], g = rgb[1], b = rgb[2];
+
+	rgb[0] = r + 0.5f * g;
+	rgb[1] = sqrtf(g);
+	rgb[2] = b - 0.25f * r;
+}
+
+static void transform_bake(void *UNUSED(userdata), float *rgb, size_t num_pixels)
+{
+	for (size_t i = 0; i < num_pixels; i++, rgb += 3) {
+		transform_v3(rgb);
+	}
+}
+
+static float lattice_value(int i)
+{
+	return ldexpf(1.0f, i - 10) - ldexpf(1.0f, -10);
+}
+
+TEST(color_lut, LatticePoints)
+{
+	const int points[] = {0, 1, 7, 10, 15, 16};
+	ColorLUT *lut = BLI_color_lut_bake(LUT_SIZE, transform_bake, NULL);
+
+	for (int r = 0; r < (int)ARRAY_SIZE(points); r++) {
+		for (int g = 0; g < (int)ARRAY_SIZE(points); g++) {
+			for (int b = 0; b < (int)ARRAY_SIZE(points); b++) {
+				float rgb[3] = {lattice_value(points[r]), lattice_value(points[g]), lattice_value(points[b])};
+				float expected[3];
+
+				copy_v3_v3(expected, rgb);
+				transform_v3(expected);
+
+				BLI_color_lut_apply_v3(lut, rgb);
+				EXPECT_V3_NEAR(expected, rgb, 1e-6f);
+			}
+		}
+	}
+
+	BLI_color_lut_free(lut);
+}
+
+TEST(color_lut, Clamping)
+{
+	ColorLUT *lut = BLI_color_lut_bake(LUT_SIZE, transform_bake, NULL);
+	float rgb[3], expected[3];
+
+	/* NaN and negative values map onto zero */
+	copy_v3_fl3(rgb, NAN_FLT, -1.0f, 0.5f);
+	copy_v3_fl3(expected, 0.0f, 0.0f, 0.5f);
+	BLI_color_lut_apply_v3(lut, rgb);
+	BLI_color_lut_apply_v3(lut, expected);
+	EXPECT_V3_NEAR(expected, rgb, 0.0f);
+
+	copy_v3_fl3(rgb, -1e10f, -FLT_MIN, -0.0f);
+	BLI_color_lut_apply_v3(lut, rgb);
+	copy_v3_fl(expected, 0.0f);
+	transform_v3(expected);
+	EXPECT_V3_NEAR(expected, rgb, 1e-6f);
+
+	/* values above 64 map onto the last lattice point */
+	copy_v3_fl3(rgb, 100.0f, 1e30f, INFINITY);
+	BLI_color_lut_apply_v3(lut, rgb);
+	copy_v3_fl(expected, lattice_value(LUT_SIZE - 1));
+	transform_v3(expected);
+	EXPECT_V3_NEAR(expected, rgb, 1e-6f);
+
+	BLI_color_lut_free(lut);
+}
+
+TEST(color_lut, Predivide)
+{
+	ColorLUT *lut = BLI_color_lut_bake(LUT_SIZE, transform_bake, NULL);
+	const float rgb[3] = {lattice_value(9), lattice_value(12), lattice_value(4)};
+	float transformed[3], expected[3];
+	float buffer[4][4];
+
+	copy_v3_v3(transformed, rgb);
+	transform_v3(transformed);
+
+	/* premultiplied pixel, and fully transparent and opaque ones which aren't divided */
+	mul_v3_v3fl(buffer[0], rgb, 0.5f);
+	buffer[0][3] = 0.5f;
+	copy_v3_v3(buffer[1], rgb);
+	buffer[1][3] = 0.0f;
+	copy_v3_v3(buffer[2], rgb);
+	buffer[2][3] = 1.0f;
+	/* straight alpha */
+	copy_v3_v3(buffer[3], rgb);
+	buffer[3][3] = 0.5f;
+
+	BLI_color_lut_apply(lut, buffer[0], 3, 4, true);
+	BLI_color_lut_apply(lut, buffer[3], 1, 4, false);
+
+	mul_v3_v3fl(expected, transformed, 0.5f);
+	EXPECT_V3_NEAR(expected, buffer[0], 1e-6f);
+	EXPECT_EQ(0.5f, buffer[0][3]);
+
+	EXPECT_V3_NEAR(transformed, buffer[1], 1e-6f);
+	EXPECT_EQ(0.0f, buffer[1][3]);
+
+	EXPECT_V3_NEAR(transformed, buffer[2], 1e-6f);
+	EXPECT_EQ(1.0f, buffer[2][3]);
+
+	EXPECT_V3_NEAR(transformed, buffer[3], 1e-6f);
+	EXPECT_EQ(0.5f, buffer[3][3]);
+
+	BLI_color_lut_free(lut);
+}
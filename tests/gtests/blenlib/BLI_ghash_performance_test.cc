@@ -9,6 +9,7 @@ extern "C" {
 #include "MEM_guardedalloc.h"
 #include "BLI_utildefines.h"
 #include "BLI_ghash.h"
+#include "BLI_ohash.h"
 #include "BLI_rand.h"
 #include "BLI_string.h"
 #include "PIL_time_utildefines.h"
@@ -32,6 +33,17 @@ extern "C" {
 	       BLI_ghash_size(_gh), q, var, lf, pempty * 100.0, poverloaded * 100.0, bigb); \
 } void (0)
 
+#define PRINTF_OHASH_STATS(_oh) \
+{ \
+	double q, lf, pmean; \
+	int pmax; \
+	q = BLI_ohash_calc_quality_ex((_oh), &lf, &pmean, &pmax); \
+	printf("OHash stats (%u entries):\n\t" \
+	       "Quality (the lower the better): %f\n\tLoad: %f\n\t" \
+	       "Mean probe length: %f (longest probe: %d)\n", \
+	       BLI_ohash_size(_oh), q, lf, pmean, pmax); \
+} void (0)
+
 
 /* Str: whole text, lines and words from a 'corpus' text. */
 
@@ -308,6 +320,218 @@ TEST(ghash, IntRandMurmur2a50000000)
 	randint_ghash_tests(ghash, "RandIntGHash - Murmur - 50000000", 50000000);
 }
 
+/* Same tests as above, using the open-addressing OHash, to compare with the chaining GHash. */
+
+static void int_ohash_tests(OHash *ohash, const char *id, const unsigned int nbr)
+{
+	printf("\n========== STARTING %s ==========\n", id);
+
+	{
+		unsigned int i = nbr;
+
+		TIMEIT_START(int_insert);
+
+#ifdef GHASH_RESERVE
+		BLI_ohash_reserve(ohash, nbr);
+#endif
+
+		while (i--) {
+			BLI_ohash_insert(ohash, SET_UINT_IN_POINTER(i), SET_UINT_IN_POINTER(i));
+		}
+
+		TIMEIT_END(int_insert);
+	}
+
+	PRINTF_OHASH_STATS(ohash);
+
+	{
+		unsigned int i = nbr;
+
+		TIMEIT_START(int_lookup);
+
+		while (i--) {
+			void *v = BLI_ohash_lookup(ohash, SET_UINT_IN_POINTER(i));
+			EXPECT_EQ(i, GET_UINT_FROM_POINTER(v));
+		}
+
+		TIMEIT_END(int_lookup);
+	}
+
+	BLI_ohash_free(ohash, NULL, NULL);
+
+	printf("========== ENDED %s ==========\n\n", id);
+}
+
+TEST(ghash, IntOHash12000)
+{
+	OHash *ohash = BLI_ohash_new(BLI_ghashutil_inthash_p, BLI_ghashutil_intcmp, __func__);
+
+	int_ohash_tests(ohash, "IntOHash - OHash - 12000", 12000);
+}
+
+TEST(ghash, IntOHash100000000)
+{
+	OHash *ohash = BLI_ohash_new(BLI_ghashutil_inthash_p, BLI_ghashutil_intcmp, __func__);
+
+	int_ohash_tests(ohash, "IntOHash - OHash - 100000000", 100000000);
+}
+
+static void randint_ohash_tests(OHash *ohash, const char *id, const unsigned int nbr)
+{
+	printf("\n========== STARTING %s ==========\n", id);
+
+	unsigned int *data = (unsigned int *)MEM_mallocN(sizeof(*data) * (size_t)nbr, __func__);
+	unsigned int *dt;
+	unsigned int i;
+
+	{
+		RNG *rng = BLI_rng_new(0);
+		for (i = nbr, dt = data; i--; dt++) {
+			*dt = BLI_rng_get_uint(rng);
+		}
+		BLI_rng_free(rng);
+	}
+
+	{
+		TIMEIT_START(int_insert);
+
+#ifdef GHASH_RESERVE
+		BLI_ohash_reserve(ohash, nbr);
+#endif
+
+		for (i = nbr, dt = data; i--; dt++) {
+			BLI_ohash_insert(ohash, SET_UINT_IN_POINTER(*dt), SET_UINT_IN_POINTER(*dt));
+		}
+
+		TIMEIT_END(int_insert);
+	}
+
+	PRINTF_OHASH_STATS(ohash);
+
+	{
+		TIMEIT_START(int_lookup);
+
+		for (i = nbr, dt = data; i--; dt++) {
+			void *v = BLI_ohash_lookup(ohash, SET_UINT_IN_POINTER(*dt));
+			EXPECT_EQ(*dt, GET_UINT_FROM_POINTER(v));
+		}
+
+		TIMEIT_END(int_lookup);
+	}
+
+	BLI_ohash_free(ohash, NULL, NULL);
+	MEM_freeN(data);
+
+	printf("========== ENDED %s ==========\n\n", id);
+}
+
+TEST(ghash, IntRandOHash12000)
+{
+	OHash *ohash = BLI_ohash_new(BLI_ghashutil_inthash_p, BLI_ghashutil_intcmp, __func__);
+
+	randint_ohash_tests(ohash, "RandIntOHash - OHash - 12000", 12000);
+}
+
+TEST(ghash, IntRandOHash50000000)
+{
+	OHash *ohash = BLI_ohash_new(BLI_ghashutil_inthash_p, BLI_ghashutil_intcmp, __func__);
+
+	randint_ohash_tests(ohash, "RandIntOHash - OHash - 50000000", 50000000);
+}
+
+
+/* Ptr: pointers into one big array, similar to BMesh elements allocated from a mempool. */
+
+static void ptr_ghash_ohash_tests(const unsigned int nbr, const char *id)
+{
+	printf("\n========== STARTING %s ==========\n", id);
+
+	/* Elements the size of a BMVert, so keys are spread like real mesh pointers. */
+	const size_t elem_size = 64;
+	char *data = (char *)MEM_mallocN(elem_size * (size_t)nbr, __func__);
+	/* Lookups and removals happen in random order, as in most BMesh operators. */
+	unsigned int *order = (unsigned int *)MEM_mallocN(sizeof(*order) * (size_t)nbr, __func__);
+	unsigned int i;
+
+	{
+		RNG *rng = BLI_rng_new(0);
+		for (i = 0; i < nbr; i++) {
+			order[i] = i;
+		}
+		BLI_rng_shuffle_array(rng, order, sizeof(*order), nbr);
+		BLI_rng_free(rng);
+	}
+
+	{
+		GHash *ghash = BLI_ghash_ptr_new(__func__);
+
+		TIMEIT_START(ghash_ptr_insert);
+		for (i = 0; i < nbr; i++) {
+			BLI_ghash_insert(ghash, data + elem_size * i, SET_UINT_IN_POINTER(i));
+		}
+		TIMEIT_END(ghash_ptr_insert);
+
+		PRINTF_GHASH_STATS(ghash);
+
+		TIMEIT_START(ghash_ptr_lookup);
+		for (i = 0; i < nbr; i++) {
+			void *v = BLI_ghash_lookup(ghash, data + elem_size * order[i]);
+			EXPECT_EQ(order[i], GET_UINT_FROM_POINTER(v));
+		}
+		TIMEIT_END(ghash_ptr_lookup);
+
+		TIMEIT_START(ghash_ptr_remove);
+		for (i = 0; i < nbr; i++) {
+			BLI_ghash_remove(ghash, data + elem_size * order[i], NULL, NULL);
+		}
+		TIMEIT_END(ghash_ptr_remove);
+
+		BLI_ghash_free(ghash, NULL, NULL);
+	}
+
+	{
+		OHash *ohash = BLI_ohash_ptr_new(__func__);
+
+		TIMEIT_START(ohash_ptr_insert);
+		for (i = 0; i < nbr; i++) {
+			BLI_ohash_insert(ohash, data + elem_size * i, SET_UINT_IN_POINTER(i));
+		}
+		TIMEIT_END(ohash_ptr_insert);
+
+		PRINTF_OHASH_STATS(ohash);
+
+		TIMEIT_START(ohash_ptr_lookup);
+		for (i = 0; i < nbr; i++) {
+			void *v = BLI_ohash_lookup(ohash, data + elem_size * order[i]);
+			EXPECT_EQ(order[i], GET_UINT_FROM_POINTER(v));
+		}
+		TIMEIT_END(ohash_ptr_lookup);
+
+		TIMEIT_START(ohash_ptr_remove);
+		for (i = 0; i < nbr; i++) {
+			BLI_ohash_remove(ohash, data + elem_size * order[i], NULL, NULL);
+		}
+		TIMEIT_END(ohash_ptr_remove);
+
+		BLI_ohash_free(ohash, NULL, NULL);
+	}
+
+	MEM_freeN(data);
+	MEM_freeN(order);
+
+	printf("========== ENDED %s ==========\n\n", id);
+}
+
+TEST(ghash, PtrGHashOHash12000)
+{
+	ptr_ghash_ohash_tests(12000, "PtrGHash - GHash vs OHash - 12000");
+}
+
+TEST(ghash, PtrGHashOHash10000000)
+{
+	ptr_ghash_ohash_tests(10000000, "PtrGHash - GHash vs OHash - 10000000");
+}
+
 static unsigned int ghashutil_tests_nohash_p(const void *p)
 {
 	return GET_UINT_FROM_POINTER(p);
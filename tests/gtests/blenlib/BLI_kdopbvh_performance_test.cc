@@ -0,0 +1,145 @@
+/* Apache License, Version 2.0 */
+
+#include "testing/testing.h"
+
+extern "C" {
+#include "MEM_guardedalloc.h"
+#include "BLI_utildefines.h"
+#include "BLI_kdopbvh.h"
+#include "BLI_math.h"
+#include "BLI_threads.h"
+#include "PIL_time_utildefines.h"
+}
+
+#include "BLI_test_points.h"
+
+/* Points, a leaf per point, with rays & nearest queries spread over the same volume. */
+
+static void kdopbvh_tests(const int points_num, const int query_num, const char tree_type, const char axis)
+{
+	printf("\n========== STARTING %d points, %d queries, tree-type %d, axis %d ==========\n",
+	       points_num, query_num, tree_type, axis);
+
+	float (*points)[3] = (float (*)[3])MEM_mallocN(sizeof(*points) * (size_t)points_num, __func__);
+	float (*co)[3] = (float (*)[3])MEM_mallocN(sizeof(*co) * (size_t)query_num, __func__);
+	float (*dir)[3] = (float (*)[3])MEM_mallocN(sizeof(*dir) * (size_t)query_num, __func__);
+	BVHTreeRayHit *hits = (BVHTreeRayHit *)MEM_mallocN(sizeof(*hits) * (size_t)query_num, __func__);
+	BVHTreeNearest *nearest = (BVHTreeNearest *)MEM_mallocN(sizeof(*nearest) * (size_t)query_num, __func__);
+	BVHTree *tree;
+
+	rng_points_init(points, points_num, 0);
+	rng_points_init(co, query_num, 1);
+	rng_points_init(dir, query_num, 2);
+	for (int i = 0; i < query_num; i++) {
+		normalize_v3(dir[i]);
+	}
+
+	{
+		TIMEIT_START(build);
+
+		tree = BLI_bvhtree_new(points_num, 0.001f, tree_type, axis);
+		for (int i = 0; i < points_num; i++) {
+			BLI_bvhtree_insert(tree, i, points[i], 1);
+		}
+		BLI_bvhtree_balance(tree);
+
+		TIMEIT_END(build);
+	}
+
+	{
+		int hits_num = 0;
+
+		TIMEIT_START(ray_cast);
+
+		for (int i = 0; i < query_num; i++) {
+			hits[i].index = -1;
+			hits[i].dist = BVH_RAYCAST_DIST_MAX;
+			if (BLI_bvhtree_ray_cast(tree, co[i], dir[i], 0.0f, &hits[i], NULL, NULL) != -1) {
+				hits_num++;
+			}
+		}
+
+		TIMEIT_END(ray_cast);
+
+		printf("%d rays hit\n", hits_num);
+	}
+
+	{
+		int hits_num;
+
+		TIMEIT_START(ray_cast_batch);
+
+		for (int i = 0; i < query_num; i++) {
+			hits[i].index = -1;
+			hits[i].dist = BVH_RAYCAST_DIST_MAX;
+		}
+		hits_num = BLI_bvhtree_ray_cast_batch(tree, co, dir, query_num, 0.0f, hits, NULL, NULL, BVH_RAYCAST_DEFAULT);
+
+		TIMEIT_END(ray_cast_batch);
+
+		printf("%d rays hit\n", hits_num);
+	}
+
+	{
+		TIMEIT_START(find_nearest);
+
+		for (int i = 0; i < query_num; i++) {
+			nearest[i].index = -1;
+			nearest[i].dist_sq = FLT_MAX;
+			BLI_bvhtree_find_nearest(tree, co[i], &nearest[i], NULL, NULL);
+		}
+
+		TIMEIT_END(find_nearest);
+	}
+
+	{
+		TIMEIT_START(find_nearest_batch);
+
+		for (int i = 0; i < query_num; i++) {
+			nearest[i].index = -1;
+			nearest[i].dist_sq = FLT_MAX;
+		}
+		BLI_bvhtree_find_nearest_batch(tree, co, query_num, nearest, NULL, NULL);
+
+		TIMEIT_END(find_nearest_batch);
+	}
+
+	{
+		unsigned int overlap_num;
+		BVHTreeOverlap *overlap;
+
+		TIMEIT_START(overlap);
+
+		overlap = BLI_bvhtree_overlap(tree, tree, &overlap_num, NULL, NULL);
+
+		TIMEIT_END(overlap);
+
+		printf("%u overlapping pairs\n", overlap_num);
+		MEM_SAFE_FREE(overlap);
+	}
+
+	BLI_bvhtree_free(tree);
+
+	MEM_freeN(points);
+	MEM_freeN(co);
+	MEM_freeN(dir);
+	MEM_freeN(hits);
+	MEM_freeN(nearest);
+
+	printf("========== ENDED ==========\n\n");
+}
+
+TEST(kdopbvh, Points100000)
+{
+	BLI_threadapi_init();
+	kdopbvh_tests(100000, 100000, 2, 6);
+	kdopbvh_tests(100000, 100000, 4, 8);
+	kdopbvh_tests(100000, 100000, 8, 26);
+}
+
+TEST(kdopbvh, Points5000000)
+{
+	BLI_threadapi_init();
+	kdopbvh_tests(5000000, 1000000, 2, 6);
+	kdopbvh_tests(5000000, 1000000, 4, 8);
+}
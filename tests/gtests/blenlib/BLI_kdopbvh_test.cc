@@ -0,0 +1,271 @@
+/* Apache License, Version 2.0 */
+
+#include "testing/testing.h"
+
+extern "C" {
+#include "MEM_guardedalloc.h"
+#include "BLI_utildefines.h"
+#include "BLI_kdopbvh.h"
+#include "BLI_math.h"
+#include "BLI_threads.h"
+}
+
+#include "BLI_test_points.h"
+
+#define POINTS_NUM 10000
+#define QUERY_NUM 2000
+#define SPHERE_RADIUS 0.01f
+
+/* Leafs are spheres of SPHERE_RADIUS around each point (bounded by a cube for any k-DOP). */
+static BVHTree *bvhtree_spheres_new(const float (*points)[3], const int points_num, const char tree_type, const char axis)
+{
+	BVHTree *tree = BLI_bvhtree_new(points_num, 0.0f, tree_type, axis);
+	for (int i = 0; i < points_num; i++) {
+		float co[8][3];
+		for (int j = 0; j < 8; j++) {
+			co[j][0] = points[i][0] + ((j & 1) ? SPHERE_RADIUS : -SPHERE_RADIUS);
+			co[j][1] = points[i][1] + ((j & 2) ? SPHERE_RADIUS : -SPHERE_RADIUS);
+			co[j][2] = points[i][2] + ((j & 4) ? SPHERE_RADIUS : -SPHERE_RADIUS);
+		}
+		BLI_bvhtree_insert(tree, i, co[0], 8);
+	}
+	BLI_bvhtree_balance(tree);
+	return tree;
+}
+
+static void nearest_point_cb(void *userdata, int index, const float co[3], BVHTreeNearest *nearest)
+{
+	const float (*points)[3] = (const float (*)[3])userdata;
+	const float dist_sq = len_squared_v3v3(co, points[index]);
+	if (dist_sq < nearest->dist_sq) {
+		nearest->index = index;
+		nearest->dist_sq = dist_sq;
+		copy_v3_v3(nearest->co, points[index]);
+	}
+}
+
+static float ray_sphere_dist(const BVHTreeRay *ray, const float center[3])
+{
+	float offset[3], dist_ray, dist_sq;
+	sub_v3_v3v3(offset, center, ray->origin);
+	dist_ray = dot_v3v3(offset, ray->direction);
+	dist_sq = len_squared_v3(offset) - (dist_ray * dist_ray);
+	if (dist_sq > SPHERE_RADIUS * SPHERE_RADIUS) {
+		return FLT_MAX;
+	}
+	dist_ray -= sqrtf(SPHERE_RADIUS * SPHERE_RADIUS - dist_sq);
+	return (dist_ray >= 0.0f) ? dist_ray : FLT_MAX;
+}
+
+static void raycast_sphere_cb(void *userdata, int index, const BVHTreeRay *ray, BVHTreeRayHit *hit)
+{
+	const float (*points)[3] = (const float (*)[3])userdata;
+	const float dist = ray_sphere_dist(ray, points[index]);
+	if (dist < hit->dist) {
+		hit->index = index;
+		hit->dist = dist;
+	}
+}
+
+static void find_nearest_test(const char tree_type, const char axis)
+{
+	float (*points)[3] = (float (*)[3])MEM_mallocN(sizeof(*points) * POINTS_NUM, __func__);
+	float (*co)[3] = (float (*)[3])MEM_mallocN(sizeof(*co) * QUERY_NUM, __func__);
+	BVHTreeNearest *nearest = (BVHTreeNearest *)MEM_mallocN(sizeof(*nearest) * QUERY_NUM, __func__);
+
+	rng_points_init(points, POINTS_NUM, 0);
+	rng_points_init(co, QUERY_NUM, 1);
+
+	BVHTree *tree = bvhtree_spheres_new(points, POINTS_NUM, tree_type, axis);
+
+	for (int i = 0; i < QUERY_NUM; i++) {
+		nearest[i].index = -1;
+		nearest[i].dist_sq = FLT_MAX;
+	}
+	EXPECT_EQ(QUERY_NUM, BLI_bvhtree_find_nearest_batch(tree, co, QUERY_NUM, nearest, nearest_point_cb, points));
+
+	for (int i = 0; i < QUERY_NUM; i++) {
+		/* Brute force. */
+		float dist_sq_best = FLT_MAX;
+		for (int j = 0; j < POINTS_NUM; j++) {
+			dist_sq_best = min_ff(dist_sq_best, len_squared_v3v3(co[i], points[j]));
+		}
+		EXPECT_EQ(dist_sq_best, nearest[i].dist_sq);
+
+		/* Single query. */
+		BVHTreeNearest nearest_single;
+		nearest_single.index = -1;
+		nearest_single.dist_sq = FLT_MAX;
+		BLI_bvhtree_find_nearest(tree, co[i], &nearest_single, nearest_point_cb, points);
+		EXPECT_EQ(nearest_single.index, nearest[i].index);
+	}
+
+	BLI_bvhtree_free(tree);
+	MEM_freeN(points);
+	MEM_freeN(co);
+	MEM_freeN(nearest);
+}
+
+static void ray_cast_test(const char tree_type, const char axis)
+{
+	float (*points)[3] = (float (*)[3])MEM_mallocN(sizeof(*points) * POINTS_NUM, __func__);
+	float (*co)[3] = (float (*)[3])MEM_mallocN(sizeof(*co) * QUERY_NUM, __func__);
+	float (*dir)[3] = (float (*)[3])MEM_mallocN(sizeof(*dir) * QUERY_NUM, __func__);
+	BVHTreeRayHit *hits = (BVHTreeRayHit *)MEM_mallocN(sizeof(*hits) * QUERY_NUM, __func__);
+	int hits_num = 0;
+
+	rng_points_init(points, POINTS_NUM, 2);
+	rng_points_init(co, QUERY_NUM, 3);
+
+	/* Rays from outside the points bounds, toward a random point inside. */
+	for (int i = 0; i < QUERY_NUM; i++) {
+		mul_v3_v3fl(dir[i], co[i], -1.0f);
+		normalize_v3(co[i]);
+		mul_v3_fl(co[i], 2.0f);
+		sub_v3_v3(dir[i], co[i]);
+		normalize_v3(dir[i]);
+		/* Some axis aligned rays too. */
+		if (i % 10 == 0) {
+			zero_v3(dir[i]);
+			dir[i][i % 3] = (i % 20) ? 1.0f : -1.0f;
+			co[i][i % 3] = (i % 20) ? -2.0f : 2.0f;
+		}
+
+		hits[i].index = -1;
+		hits[i].dist = BVH_RAYCAST_DIST_MAX;
+	}
+
+	BVHTree *tree = bvhtree_spheres_new(points, POINTS_NUM, tree_type, axis);
+
+	const int hits_batch_num = BLI_bvhtree_ray_cast_batch(
+	        tree, co, dir, QUERY_NUM, 0.0f, hits, raycast_sphere_cb, points, BVH_RAYCAST_DEFAULT);
+
+	for (int i = 0; i < QUERY_NUM; i++) {
+		BVHTreeRay ray;
+		copy_v3_v3(ray.origin, co[i]);
+		copy_v3_v3(ray.direction, dir[i]);
+
+		/* Brute force. */
+		float dist_best = FLT_MAX;
+		int index_best = -1;
+		for (int j = 0; j < POINTS_NUM; j++) {
+			const float dist = ray_sphere_dist(&ray, points[j]);
+			if (dist < dist_best) {
+				dist_best = dist;
+				index_best = j;
+			}
+		}
+		EXPECT_EQ(index_best, hits[i].index);
+		if (index_best != -1) {
+			EXPECT_EQ(dist_best, hits[i].dist);
+			hits_num++;
+		}
+	}
+	EXPECT_EQ(hits_num, hits_batch_num);
+	/* Ensure the test isn't trivially passing. */
+	EXPECT_LT(QUERY_NUM / 2, hits_num);
+
+	BLI_bvhtree_free(tree);
+	MEM_freeN(points);
+	MEM_freeN(co);
+	MEM_freeN(dir);
+	MEM_freeN(hits);
+}
+
+/* Axis aligned rays starting on a plane of the bounds (inflated by FLT_EPSILON), where the ray and
+ * the plane offsets along that axis are both zero. Without a callback the bounds are hit directly. */
+static void ray_cast_on_plane_test(const char tree_type, const char axis)
+{
+	const float co[8][3] = {
+	    {0, 0, 0}, {1, 0, 0}, {0, 1, 0}, {1, 1, 0},
+	    {0, 0, 1}, {1, 0, 1}, {0, 1, 1}, {1, 1, 1}};
+	const float plane_min = -FLT_EPSILON, plane_max = 1.0f + FLT_EPSILON;
+	const float origins[][3] = {
+	    {-1.0f, 0.5f, plane_min}, {-1.0f, 0.5f, plane_max},
+	    {-1.0f, plane_min, plane_min}, {-1.0f, plane_max, 0.5f}};
+	const float origin_miss[3] = {-1.0f, 2.0f, plane_min};
+	const float dir[3] = {1.0f, 0.0f, 0.0f};
+	BVHTreeRayHit hit;
+
+	BVHTree *tree = BLI_bvhtree_new(1, 0.0f, tree_type, axis);
+	BLI_bvhtree_insert(tree, 0, co[0], 8);
+	BLI_bvhtree_balance(tree);
+
+	for (int i = 0; i < (int)ARRAY_SIZE(origins); i++) {
+		hit.index = -1;
+		hit.dist = BVH_RAYCAST_DIST_MAX;
+		EXPECT_EQ(0, BLI_bvhtree_ray_cast(tree, origins[i], dir, 0.0f, &hit, NULL, NULL));
+		EXPECT_NEAR(1.0f, hit.dist, 1e-6f);
+	}
+
+	hit.index = -1;
+	hit.dist = BVH_RAYCAST_DIST_MAX;
+	EXPECT_EQ(-1, BLI_bvhtree_ray_cast(tree, origin_miss, dir, 0.0f, &hit, NULL, NULL));
+
+	BLI_bvhtree_free(tree);
+}
+
+static bool overlap_sphere_cb(void *userdata, int index_a, int index_b, int UNUSED(thread))
+{
+	const float (*points)[3] = (const float (*)[3])userdata;
+	return len_squared_v3v3(points[index_a], points[index_b]) < (4.0f * SPHERE_RADIUS * SPHERE_RADIUS);
+}
+
+static void overlap_test(const char tree_type, const char axis)
+{
+	float (*points)[3] = (float (*)[3])MEM_mallocN(sizeof(*points) * POINTS_NUM, __func__);
+	unsigned int overlap_num, overlap_num_brute = 0;
+
+	rng_points_init(points, POINTS_NUM, 4);
+
+	BVHTree *tree = bvhtree_spheres_new(points, POINTS_NUM, tree_type, axis);
+	BVHTreeOverlap *overlap = BLI_bvhtree_overlap(tree, tree, &overlap_num, overlap_sphere_cb, points);
+
+	for (int i = 0; i < POINTS_NUM; i++) {
+		for (int j = 0; j < POINTS_NUM; j++) {
+			if (i != j && overlap_sphere_cb(points, i, j, 0)) {
+				overlap_num_brute++;
+			}
+		}
+	}
+	EXPECT_EQ(overlap_num_brute, overlap_num);
+	EXPECT_LT(0, overlap_num);
+
+	MEM_SAFE_FREE(overlap);
+	BLI_bvhtree_free(tree);
+	MEM_freeN(points);
+}
+
+/* Batch queries and large builds use the task scheduler,
+ * thread API is initialized by each test (never freed, so any order works). */
+
+TEST(kdopbvh, FindNearestBatch)
+{
+	BLI_threadapi_init();
+	find_nearest_test(2, 6);
+	find_nearest_test(4, 8);
+	find_nearest_test(8, 26);
+}
+
+TEST(kdopbvh, RayCastBatch)
+{
+	BLI_threadapi_init();
+	ray_cast_test(2, 6);
+	ray_cast_test(4, 8);
+	ray_cast_test(8, 26);
+}
+
+TEST(kdopbvh, RayCastOnPlane)
+{
+	ray_cast_on_plane_test(2, 6);
+	ray_cast_on_plane_test(4, 8);
+	ray_cast_on_plane_test(8, 26);
+}
+
+TEST(kdopbvh, Overlap)
+{
+	BLI_threadapi_init();
+	overlap_test(2, 6);
+	overlap_test(4, 8);
+	overlap_test(8, 26);
+}
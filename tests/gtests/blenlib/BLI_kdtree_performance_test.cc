@@ -0,0 +1,91 @@
+/* Apache License, Version 2.0 */
+
+#include "testing/testing.h"
+
+extern "C" {
+#include "MEM_guardedalloc.h"
+#include "BLI_utildefines.h"
+#include "BLI_kdtree.h"
+#include "BLI_math.h"
+#include "BLI_threads.h"
+#include "PIL_time_utildefines.h"
+}
+
+#include "BLI_test_points.h"
+
+static void kdtree_tests(const int points_num, const int query_num, const unsigned int nearest_num)
+{
+	printf("\n========== STARTING %d points, %d queries, %u nearest ==========\n",
+	       points_num, query_num, nearest_num);
+
+	float (*points)[3] = (float (*)[3])MEM_mallocN(sizeof(*points) * (size_t)points_num, __func__);
+	float (*co)[3] = (float (*)[3])MEM_mallocN(sizeof(*co) * (size_t)query_num, __func__);
+	KDTreeNearest *nearest = (KDTreeNearest *)MEM_mallocN(
+	        sizeof(*nearest) * (size_t)query_num * nearest_num, __func__);
+	KDTree *tree;
+
+	rng_points_init(points, points_num, 0);
+	rng_points_init(co, query_num, 1);
+
+	{
+		TIMEIT_START(balance);
+
+		tree = BLI_kdtree_new((unsigned int)points_num);
+		for (int i = 0; i < points_num; i++) {
+			BLI_kdtree_insert(tree, i, points[i]);
+		}
+		BLI_kdtree_balance(tree);
+
+		TIMEIT_END(balance);
+	}
+
+	{
+		TIMEIT_START(find_nearest);
+
+		for (int i = 0; i < query_num; i++) {
+			BLI_kdtree_find_nearest(tree, co[i], &nearest[i]);
+		}
+
+		TIMEIT_END(find_nearest);
+	}
+
+	{
+		TIMEIT_START(find_nearest_n);
+
+		for (int i = 0; i < query_num; i++) {
+			BLI_kdtree_find_nearest_n(tree, co[i], &nearest[(size_t)i * nearest_num], nearest_num);
+		}
+
+		TIMEIT_END(find_nearest_n);
+	}
+
+	{
+		TIMEIT_START(find_nearest_n_batch);
+
+		BLI_kdtree_find_nearest_n_batch(tree, co, (unsigned int)query_num, nearest, NULL, nearest_num);
+
+		TIMEIT_END(find_nearest_n_batch);
+	}
+
+	BLI_kdtree_free(tree);
+
+	MEM_freeN(points);
+	MEM_freeN(co);
+	MEM_freeN(nearest);
+
+	printf("========== ENDED ==========\n\n");
+}
+
+TEST(kdtree, Points100000)
+{
+	BLI_threadapi_init();
+	kdtree_tests(100000, 100000, 1);
+	kdtree_tests(100000, 100000, 10);
+}
+
+TEST(kdtree, Points10000000)
+{
+	BLI_threadapi_init();
+	kdtree_tests(10000000, 1000000, 1);
+	kdtree_tests(10000000, 1000000, 10);
+}
@@ -0,0 +1,165 @@
+/* Apache License, Version 2.0 */
+
+#include "testing/testing.h"
+
+#include <algorithm>
+
+extern "C" {
+#include "MEM_guardedalloc.h"
+#include "BLI_utildefines.h"
+#include "BLI_kdtree.h"
+#include "BLI_math.h"
+#include "BLI_threads.h"
+}
+
+#include "BLI_test_points.h"
+
+#define POINTS_NUM 10000
+/* above KD_THREAD_THRESHOLD, balanced in parallel and copied into depth first order */
+#define POINTS_THREADED_NUM 50000
+#define QUERY_NUM 1000
+#define QUERY_BRUTE_FORCE_NUM 100
+#define NEAREST_NUM 8
+
+static KDTree *kdtree_points_new(const float (*points)[3], const int points_num)
+{
+	KDTree *tree = BLI_kdtree_new((unsigned int)points_num);
+	for (int i = 0; i < points_num; i++) {
+		BLI_kdtree_insert(tree, i, points[i]);
+	}
+	BLI_kdtree_balance(tree);
+	return tree;
+}
+
+/* Sorted squared distances from co to all points (brute force). */
+static void points_dist_sq_sorted(const float (*points)[3], const int points_num, const float co[3], float *r_dist_sq)
+{
+	for (int i = 0; i < points_num; i++) {
+		r_dist_sq[i] = len_squared_v3v3(points[i], co);
+	}
+	std::sort(r_dist_sq, r_dist_sq + points_num);
+}
+
+static void kdtree_find_nearest_test(const int points_num)
+{
+	float (*points)[3] = (float (*)[3])MEM_mallocN(sizeof(*points) * (size_t)max_ii(points_num, 1), __func__);
+	float (*co)[3] = (float (*)[3])MEM_mallocN(sizeof(*co) * QUERY_BRUTE_FORCE_NUM, __func__);
+	float *dist_sq = (float *)MEM_mallocN(sizeof(*dist_sq) * (size_t)max_ii(points_num, 1), __func__);
+
+	rng_points_init(points, points_num, 0);
+	rng_points_init(co, QUERY_BRUTE_FORCE_NUM, 1);
+
+	KDTree *tree = kdtree_points_new(points, points_num);
+
+	for (int i = 0; i < QUERY_BRUTE_FORCE_NUM; i++) {
+		KDTreeNearest nearest[NEAREST_NUM];
+		const int found = BLI_kdtree_find_nearest_n(tree, co[i], nearest, NEAREST_NUM);
+		const int found_expect = min_ii(points_num, NEAREST_NUM);
+
+		points_dist_sq_sorted(points, points_num, co[i], dist_sq);
+
+		EXPECT_EQ(found_expect, found);
+		for (int j = 0; j < found; j++) {
+			EXPECT_FLOAT_EQ(sqrtf(dist_sq[j]), nearest[j].dist);
+			EXPECT_V3_NEAR(points[nearest[j].index], nearest[j].co, 0.0f);
+		}
+
+		if (points_num != 0) {
+			KDTreeNearest nearest_single;
+			EXPECT_EQ(nearest[0].index, BLI_kdtree_find_nearest(tree, co[i], &nearest_single));
+			EXPECT_FLOAT_EQ(nearest[0].dist, nearest_single.dist);
+		}
+		else {
+			EXPECT_EQ(-1, BLI_kdtree_find_nearest(tree, co[i], NULL));
+		}
+	}
+
+	BLI_kdtree_free(tree);
+	MEM_freeN(points);
+	MEM_freeN(co);
+	MEM_freeN(dist_sq);
+}
+
+TEST(kdtree, FindNearest)
+{
+	BLI_threadapi_init();
+	kdtree_find_nearest_test(0);
+	kdtree_find_nearest_test(1);
+	kdtree_find_nearest_test(7);
+	kdtree_find_nearest_test(100);
+	kdtree_find_nearest_test(POINTS_NUM);
+}
+
+TEST(kdtree, FindNearestThreadedBalance)
+{
+	BLI_threadapi_init();
+	kdtree_find_nearest_test(POINTS_THREADED_NUM);
+}
+
+TEST(kdtree, FindNearestBatch)
+{
+	float (*points)[3] = (float (*)[3])MEM_mallocN(sizeof(*points) * POINTS_NUM, __func__);
+	float (*co)[3] = (float (*)[3])MEM_mallocN(sizeof(*co) * QUERY_NUM, __func__);
+	KDTreeNearest *nearest = (KDTreeNearest *)MEM_mallocN(sizeof(*nearest) * QUERY_NUM * NEAREST_NUM, __func__);
+	unsigned int *found = (unsigned int *)MEM_mallocN(sizeof(*found) * QUERY_NUM, __func__);
+
+	BLI_threadapi_init();
+
+	rng_points_init(points, POINTS_NUM, 2);
+	rng_points_init(co, QUERY_NUM, 3);
+
+	KDTree *tree = kdtree_points_new(points, POINTS_NUM);
+
+	BLI_kdtree_find_nearest_n_batch(tree, co, QUERY_NUM, nearest, found, NEAREST_NUM);
+
+	for (int i = 0; i < QUERY_NUM; i++) {
+		KDTreeNearest nearest_single[NEAREST_NUM];
+		EXPECT_EQ(NEAREST_NUM, found[i]);
+		EXPECT_EQ(NEAREST_NUM, BLI_kdtree_find_nearest_n(tree, co[i], nearest_single, NEAREST_NUM));
+		for (int j = 0; j < NEAREST_NUM; j++) {
+			EXPECT_EQ(nearest_single[j].index, nearest[i * NEAREST_NUM + j].index);
+		}
+	}
+
+	BLI_kdtree_free(tree);
+	MEM_freeN(points);
+	MEM_freeN(co);
+	MEM_freeN(nearest);
+	MEM_freeN(found);
+}
+
+TEST(kdtree, RangeSearch)
+{
+	float (*points)[3] = (float (*)[3])MEM_mallocN(sizeof(*points) * POINTS_NUM, __func__);
+	float (*co)[3] = (float (*)[3])MEM_mallocN(sizeof(*co) * QUERY_BRUTE_FORCE_NUM, __func__);
+	const float range = 0.1f;
+
+	BLI_threadapi_init();
+
+	rng_points_init(points, POINTS_NUM, 4);
+	rng_points_init(co, QUERY_BRUTE_FORCE_NUM, 5);
+
+	KDTree *tree = kdtree_points_new(points, POINTS_NUM);
+
+	for (int i = 0; i < QUERY_BRUTE_FORCE_NUM; i++) {
+		KDTreeNearest *nearest = NULL;
+		const int found = BLI_kdtree_range_search(tree, co[i], &nearest, range);
+		int found_expect = 0;
+
+		for (int j = 0; j < POINTS_NUM; j++) {
+			if (len_squared_v3v3(points[j], co[i]) <= range * range) {
+				found_expect++;
+			}
+		}
+		EXPECT_EQ(found_expect, found);
+		for (int j = 1; j < found; j++) {
+			EXPECT_LE(nearest[j - 1].dist, nearest[j].dist);
+		}
+
+		MEM_SAFE_FREE(nearest);
+	}
+
+	BLI_kdtree_free(tree);
+	MEM_freeN(points);
+	MEM_freeN(co);
+}
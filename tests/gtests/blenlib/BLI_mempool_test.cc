@@ -0,0 +1,91 @@
+/* Apache License, Version 2.0 */
+
+#include "testing/testing.h"
+
+extern "C" {
+#include "MEM_guardedalloc.h"
+#include "BLI_utildefines.h"
+#include "BLI_mempool.h"
+#include "BLI_task.h"
+#include "BLI_threads.h"
+}
+
+#define TESTCASE_SIZE 100000
+
+typedef struct TestElem {
+	int index;
+	int pad[7];
+} TestElem;
+
+typedef struct ThreadedData {
+	BLI_mempool *pool;
+	TestElem **elems;
+} ThreadedData;
+
+static void mempool_alloc_cb(void *userdata, void *UNUSED(userdata_chunk), const int iter, const int thread_id)
+{
+	ThreadedData *data = (ThreadedData *)userdata;
+	TestElem *elem = (TestElem *)BLI_mempool_alloc_thread(data->pool, thread_id);
+	elem->index = iter;
+	data->elems[iter] = elem;
+}
+
+static void mempool_free_odd_cb(void *userdata, void *UNUSED(userdata_chunk), const int iter, const int thread_id)
+{
+	ThreadedData *data = (ThreadedData *)userdata;
+	if (iter % 2) {
+		BLI_mempool_free_thread(data->pool, data->elems[iter], thread_id);
+		data->elems[iter] = NULL;
+	}
+}
+
+static void mempool_threaded_test(const unsigned int totelem_reserve)
+{
+	ThreadedData data;
+	data.pool = BLI_mempool_create(sizeof(TestElem), totelem_reserve, 512,
+	                               BLI_MEMPOOL_ALLOW_ITER | BLI_MEMPOOL_THREADED);
+	data.elems = (TestElem **)MEM_callocN(sizeof(*data.elems) * TESTCASE_SIZE, __func__);
+
+	BLI_task_parallel_range_ex(0, TESTCASE_SIZE, &data, NULL, 0, mempool_alloc_cb, true, false);
+	BLI_task_parallel_range_ex(0, TESTCASE_SIZE, &data, NULL, 0, mempool_free_odd_cb, true, false);
+	BLI_mempool_thread_caches_flush(data.pool);
+
+	EXPECT_EQ(TESTCASE_SIZE / 2, BLI_mempool_count(data.pool));
+
+	/* All remaining elements are found by iteration, untouched by other threads. */
+	{
+		BLI_mempool_iter iter;
+		TestElem *elem;
+		int count = 0;
+
+		BLI_mempool_iternew(data.pool, &iter);
+		while ((elem = (TestElem *)BLI_mempool_iterstep(&iter))) {
+			EXPECT_EQ(0, elem->index % 2);
+			EXPECT_EQ(elem, data.elems[elem->index]);
+			count++;
+		}
+		EXPECT_EQ(TESTCASE_SIZE / 2, count);
+	}
+
+	/* Freed elements are reused by regular allocation once flushed. */
+	for (int i = 1; i < TESTCASE_SIZE; i += 2) {
+		data.elems[i] = (TestElem *)BLI_mempool_alloc(data.pool);
+		data.elems[i]->index = i;
+	}
+	EXPECT_EQ(TESTCASE_SIZE, BLI_mempool_count(data.pool));
+
+	MEM_freeN(data.elems);
+	BLI_mempool_destroy(data.pool);
+}
+
+TEST(mempool, ThreadedAllocFree)
+{
+	BLI_threadapi_init();
+
+	/* Elements only coming from thread private chunks. */
+	mempool_threaded_test(0);
+	/* Elements coming from the shared free list first. */
+	mempool_threaded_test(TESTCASE_SIZE / 2);
+
+	BLI_threadapi_exit();
+}
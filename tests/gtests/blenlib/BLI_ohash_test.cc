@@ -0,0 +1,196 @@
+/* Apache License, Version 2.0 */
+
+#include "testing/testing.h"
+
+#define GHASH_INTERNAL_API
+
+extern "C" {
+#include "BLI_utildefines.h"
+#include "BLI_ohash.h"
+#include "BLI_rand.h"
+}
+
+#define TESTCASE_SIZE 10000
+
+/* Random keys, made unique by shuffling the first TESTCASE_SIZE integers (scaled to spread them). */
+static void init_keys(unsigned int keys[TESTCASE_SIZE], const int seed)
+{
+	RNG *rng = BLI_rng_new(seed);
+	int i;
+
+	for (i = 0; i < TESTCASE_SIZE; i++) {
+		keys[i] = (unsigned int)i * 2654435761u;
+	}
+	BLI_rng_shuffle_array(rng, keys, sizeof(*keys), TESTCASE_SIZE);
+	BLI_rng_free(rng);
+}
+
+/* Here we simply insert and then lookup all keys, ensuring we do get back the expected stored 'data'. */
+TEST(ohash, InsertLookup)
+{
+	OHash *ohash = BLI_ohash_new(BLI_ghashutil_inthash_p, BLI_ghashutil_intcmp, __func__);
+	unsigned int keys[TESTCASE_SIZE], *k;
+	int i;
+
+	init_keys(keys, 0);
+
+	for (i = TESTCASE_SIZE, k = keys; i--; k++) {
+		BLI_ohash_insert(ohash, SET_UINT_IN_POINTER(*k), SET_UINT_IN_POINTER(*k));
+	}
+
+	EXPECT_EQ(TESTCASE_SIZE, BLI_ohash_size(ohash));
+
+	for (i = TESTCASE_SIZE, k = keys; i--; k++) {
+		void *v = BLI_ohash_lookup(ohash, SET_UINT_IN_POINTER(*k));
+		EXPECT_EQ(*k, GET_UINT_FROM_POINTER(v));
+	}
+
+	EXPECT_FALSE(BLI_ohash_haskey(ohash, SET_UINT_IN_POINTER(1)));
+
+	BLI_ohash_free(ohash, NULL, NULL);
+}
+
+/* Here we remove half of the keys, ensuring the remaining ones are still found after the backward shifts. */
+TEST(ohash, InsertRemoveLookup)
+{
+	OHash *ohash = BLI_ohash_new(BLI_ghashutil_inthash_p, BLI_ghashutil_intcmp, __func__);
+	unsigned int keys[TESTCASE_SIZE];
+	int i, slots_size;
+
+	init_keys(keys, 10);
+
+	for (i = 0; i < TESTCASE_SIZE; i++) {
+		BLI_ohash_insert(ohash, SET_UINT_IN_POINTER(keys[i]), SET_UINT_IN_POINTER(keys[i]));
+	}
+	slots_size = BLI_ohash_slots_size(ohash);
+
+	for (i = 0; i < TESTCASE_SIZE; i += 2) {
+		void *v = BLI_ohash_popkey(ohash, SET_UINT_IN_POINTER(keys[i]), NULL);
+		EXPECT_EQ(keys[i], GET_UINT_FROM_POINTER(v));
+	}
+
+	EXPECT_EQ(TESTCASE_SIZE / 2, BLI_ohash_size(ohash));
+	EXPECT_EQ(slots_size, BLI_ohash_slots_size(ohash));
+
+	for (i = 0; i < TESTCASE_SIZE; i++) {
+		EXPECT_EQ((i % 2) != 0, BLI_ohash_haskey(ohash, SET_UINT_IN_POINTER(keys[i])));
+	}
+
+	BLI_ohash_free(ohash, NULL, NULL);
+}
+
+/* Same as above, but this time we allow ohash to shrink. */
+TEST(ohash, InsertRemoveShrink)
+{
+	OHash *ohash = BLI_ohash_new(BLI_ghashutil_inthash_p, BLI_ghashutil_intcmp, __func__);
+	unsigned int keys[TESTCASE_SIZE], *k;
+	int i, slots_size;
+
+	BLI_ohash_flag_set(ohash, GHASH_FLAG_ALLOW_SHRINK);
+	init_keys(keys, 20);
+
+	for (i = TESTCASE_SIZE, k = keys; i--; k++) {
+		BLI_ohash_insert(ohash, SET_UINT_IN_POINTER(*k), SET_UINT_IN_POINTER(*k));
+	}
+
+	EXPECT_EQ(TESTCASE_SIZE, BLI_ohash_size(ohash));
+	slots_size = BLI_ohash_slots_size(ohash);
+
+	for (i = TESTCASE_SIZE, k = keys; i--; k++) {
+		void *v = BLI_ohash_popkey(ohash, SET_UINT_IN_POINTER(*k), NULL);
+		EXPECT_EQ(*k, GET_UINT_FROM_POINTER(v));
+	}
+
+	EXPECT_EQ(0, BLI_ohash_size(ohash));
+	EXPECT_LT(BLI_ohash_slots_size(ohash), slots_size);
+
+	BLI_ohash_free(ohash, NULL, NULL);
+}
+
+/* Check ensure_p, and that iteration visits each entry exactly once. */
+TEST(ohash, EnsureIter)
+{
+	OHash *ohash = BLI_ohash_ptr_new(__func__);
+	OHashIterator ohi;
+	unsigned int keys[TESTCASE_SIZE];
+	unsigned int sum = 0, sum_iter = 0;
+	int i, count = 0;
+
+	init_keys(keys, 30);
+
+	for (i = 0; i < TESTCASE_SIZE; i++) {
+		void **val_p;
+		EXPECT_FALSE(BLI_ohash_ensure_p(ohash, SET_UINT_IN_POINTER(keys[i]), &val_p));
+		*val_p = SET_UINT_IN_POINTER(keys[i]);
+		sum += keys[i];
+	}
+	for (i = 0; i < TESTCASE_SIZE; i++) {
+		void **val_p;
+		EXPECT_TRUE(BLI_ohash_ensure_p(ohash, SET_UINT_IN_POINTER(keys[i]), &val_p));
+		EXPECT_EQ(keys[i], GET_UINT_FROM_POINTER(*val_p));
+	}
+
+	OHASH_ITER (ohi, ohash) {
+		EXPECT_EQ(BLI_ohashIterator_getKey(&ohi), BLI_ohashIterator_getValue(&ohi));
+		sum_iter += GET_UINT_FROM_POINTER(BLI_ohashIterator_getKey(&ohi));
+		count++;
+	}
+
+	EXPECT_EQ(TESTCASE_SIZE, count);
+	EXPECT_EQ(sum, sum_iter);
+
+	BLI_ohash_free(ohash, NULL, NULL);
+}
+
+/* Check copy. */
+TEST(ohash, Copy)
+{
+	OHash *ohash = BLI_ohash_new(BLI_ghashutil_inthash_p, BLI_ghashutil_intcmp, __func__);
+	OHash *ohash_copy;
+	unsigned int keys[TESTCASE_SIZE], *k;
+	int i;
+
+	init_keys(keys, 40);
+
+	for (i = TESTCASE_SIZE, k = keys; i--; k++) {
+		BLI_ohash_insert(ohash, SET_UINT_IN_POINTER(*k), SET_UINT_IN_POINTER(*k));
+	}
+
+	ohash_copy = BLI_ohash_copy(ohash, NULL, NULL);
+
+	EXPECT_EQ(TESTCASE_SIZE, BLI_ohash_size(ohash_copy));
+	EXPECT_EQ(BLI_ohash_slots_size(ohash), BLI_ohash_slots_size(ohash_copy));
+
+	for (i = TESTCASE_SIZE, k = keys; i--; k++) {
+		void *v = BLI_ohash_lookup(ohash_copy, SET_UINT_IN_POINTER(*k));
+		EXPECT_EQ(*k, GET_UINT_FROM_POINTER(v));
+	}
+
+	BLI_ohash_free(ohash, NULL, NULL);
+	BLI_ohash_free(ohash_copy, NULL, NULL);
+}
+
+/* OSet add/remove. */
+TEST(ohash, SetAddRemove)
+{
+	OSet *oset = BLI_oset_int_new(__func__);
+	unsigned int keys[TESTCASE_SIZE];
+	int i;
+
+	init_keys(keys, 50);
+
+	for (i = 0; i < TESTCASE_SIZE; i++) {
+		EXPECT_TRUE(BLI_oset_add(oset, SET_UINT_IN_POINTER(keys[i])));
+	}
+	for (i = 0; i < TESTCASE_SIZE; i++) {
+		EXPECT_FALSE(BLI_oset_add(oset, SET_UINT_IN_POINTER(keys[i])));
+	}
+	EXPECT_EQ(TESTCASE_SIZE, BLI_oset_size(oset));
+
+	for (i = 0; i < TESTCASE_SIZE; i++) {
+		EXPECT_TRUE(BLI_oset_remove(oset, SET_UINT_IN_POINTER(keys[i]), NULL));
+	}
+	EXPECT_EQ(0, BLI_oset_size(oset));
+
+	BLI_oset_free(oset, NULL);
+}
@@ -0,0 +1,24 @@
+/* Apache License, Version 2.0 */
+
+#ifndef __BLENDER_TESTING_BLI_TEST_POINTS_H__
+#define __BLENDER_TESTING_BLI_TEST_POINTS_H__
+
+/* Random points shared by the spatial structure tests (kd-tree, BVH-tree). */
+
+extern "C" {
+#include "BLI_math.h"
+#include "BLI_rand.h"
+}
+
+/* Points inside the unit sphere, more dense toward its center. */
+static void rng_points_init(float (*points)[3], const int points_num, const int seed)
+{
+	RNG *rng = BLI_rng_new(seed);
+	for (int i = 0; i < points_num; i++) {
+		BLI_rng_get_float_unit_v3(rng, points[i]);
+		mul_v3_fl(points[i], BLI_rng_get_float(rng));
+	}
+	BLI_rng_free(rng);
+}
+
+#endif  /* __BLENDER_TESTING_BLI_TEST_POINTS_H__ */
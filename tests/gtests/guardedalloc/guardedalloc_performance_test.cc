@@ -0,0 +1,161 @@
+/* Apache License, Version 2.0 */
+
+#include "testing/testing.h"
+
+#include "MEM_guardedalloc.h"
+
+extern "C" {
+#include "BLI_utildefines.h"
+#include "BLI_rand.h"
+#include "BLI_task.h"
+#include "BLI_threads.h"
+#include "PIL_time_utildefines.h"
+}
+
+/* Allocation patterns roughly matching what BMesh operators and depsgraph evaluation do,
+ * run with the default lock-free allocator first, then with the small block cache enabled. */
+
+#define TASKS_NUM 64
+
+/* BMesh: elements and their custom-data blocks, freed in random order. */
+#define BMESH_ELEM_NUM 20000
+#define BMESH_ITER_NUM 4
+
+/* Depsgraph: nodes & relations built by one task and freed by another,
+ * many short lived allocations while evaluating. */
+#define DEPSGRAPH_NODE_NUM 10000
+#define DEPSGRAPH_EVAL_NUM 16
+
+static const size_t bmesh_elem_sizes[] = {
+	64,  /* BMVert */
+	80,  /* BMEdge */
+	56,  /* BMLoop */
+	72,  /* BMFace */
+	24,  /* custom-data */
+	40,
+};
+
+typedef struct AllocTaskData {
+	void **blocks;
+	int pass;
+} AllocTaskData;
+
+static void bmesh_task_cb(TaskPool *__restrict UNUSED(pool), void *taskdata, int UNUSED(threadid))
+{
+	const int task = (int)(intptr_t)taskdata;
+	void **elems = (void **)MEM_mallocN(sizeof(*elems) * BMESH_ELEM_NUM, __func__);
+	RNG *rng = BLI_rng_new((unsigned int)task);
+
+	for (int iter = 0; iter < BMESH_ITER_NUM; iter++) {
+		for (int i = 0; i < BMESH_ELEM_NUM; i++) {
+			elems[i] = MEM_mallocN(bmesh_elem_sizes[i % ARRAY_SIZE(bmesh_elem_sizes)], __func__);
+		}
+		BLI_rng_shuffle_array(rng, elems, sizeof(*elems), BMESH_ELEM_NUM);
+		for (int i = 0; i < BMESH_ELEM_NUM; i++) {
+			MEM_freeN(elems[i]);
+		}
+	}
+
+	BLI_rng_free(rng);
+	MEM_freeN(elems);
+}
+
+static void depsgraph_task_cb(TaskPool *__restrict pool, void *taskdata, int UNUSED(threadid))
+{
+	AllocTaskData *data = (AllocTaskData *)BLI_task_pool_userdata(pool);
+	const int task = (int)(intptr_t)taskdata;
+	void **blocks = &data->blocks[task * DEPSGRAPH_NODE_NUM * 2];
+
+	switch (data->pass) {
+		case 0:
+			/* Build. */
+			for (int i = 0; i < DEPSGRAPH_NODE_NUM; i++) {
+				blocks[i * 2] = MEM_callocN((size_t)(128 + (i % 9) * 32), __func__);
+				blocks[i * 2 + 1] = MEM_callocN((size_t)(32 + (i % 2) * 16), __func__);
+			}
+			break;
+		case 1:
+			/* Evaluate. */
+			for (int eval = 0; eval < DEPSGRAPH_EVAL_NUM; eval++) {
+				for (int i = 0; i < DEPSGRAPH_NODE_NUM; i++) {
+					void *temp = MEM_mallocN((size_t)(16 + (i % 16) * 16), __func__);
+					MEM_freeN(temp);
+				}
+			}
+			break;
+		case 2:
+		{
+			/* Free blocks built by another task. */
+			blocks = &data->blocks[((task + 1) % TASKS_NUM) * DEPSGRAPH_NODE_NUM * 2];
+			for (int i = 0; i < DEPSGRAPH_NODE_NUM * 2; i++) {
+				MEM_freeN(blocks[i]);
+			}
+			break;
+		}
+	}
+}
+
+static void alloc_tests(const int threads_num)
+{
+	printf("\n========== STARTING %d threads, %d tasks ==========\n", threads_num, TASKS_NUM);
+
+	TaskScheduler *scheduler = BLI_task_scheduler_create(threads_num);
+	AllocTaskData data;
+
+	data.blocks = (void **)MEM_mallocN(sizeof(*data.blocks) * TASKS_NUM * DEPSGRAPH_NODE_NUM * 2, __func__);
+	data.pass = 0;
+
+	{
+		TaskPool *pool = BLI_task_pool_create(scheduler, &data);
+
+		TIMEIT_START(bmesh);
+
+		for (int task = 0; task < TASKS_NUM; task++) {
+			BLI_task_pool_push(pool, bmesh_task_cb, (void *)(intptr_t)task, false, TASK_PRIORITY_HIGH);
+		}
+		BLI_task_pool_work_and_wait(pool);
+
+		TIMEIT_END(bmesh);
+
+		BLI_task_pool_free(pool);
+	}
+
+	{
+		TaskPool *pool = BLI_task_pool_create(scheduler, &data);
+
+		TIMEIT_START(depsgraph);
+
+		for (data.pass = 0; data.pass < 3; data.pass++) {
+			for (int task = 0; task < TASKS_NUM; task++) {
+				BLI_task_pool_push(pool, depsgraph_task_cb, (void *)(intptr_t)task, false, TASK_PRIORITY_HIGH);
+			}
+			BLI_task_pool_work_and_wait(pool);
+		}
+
+		TIMEIT_END(depsgraph);
+
+		BLI_task_pool_free(pool);
+	}
+
+	MEM_freeN(data.blocks);
+	BLI_task_scheduler_free(scheduler);
+
+	printf("========== ENDED ==========\n\n");
+}
+
+TEST(guardedalloc, LockfreeAllocPatterns)
+{
+	BLI_threadapi_init();
+	alloc_tests(1);
+	alloc_tests(8);
+}
+
+/* Must run last, the cache can't be disabled again. */
+TEST(guardedalloc, LockfreeSmallCacheAllocPatterns)
+{
+	BLI_threadapi_init();
+	MEM_use_lockfree_small_cache();
+	alloc_tests(1);
+	alloc_tests(8);
+	MEM_printmemlist_stats();
+}
@@ -0,0 +1,162 @@
+/* Apache License, Version 2.0 */
+
+#include "testing/testing.h"
+
+#include <string.h>
+
+#include "MEM_guardedalloc.h"
+
+extern "C" {
+#include "BLI_utildefines.h"
+#include "BLI_task.h"
+#include "BLI_threads.h"
+}
+
+#define BLOCKS_NUM 10000
+#define THREADS_NUM 4
+
+#define CHECK_ALIGNMENT(ptr, align) EXPECT_EQ(0, (size_t)ptr % align)
+
+/* Cache is enabled once for the whole binary, blocks allocated before stay valid. */
+static void small_cache_init(void)
+{
+	static bool is_init = false;
+	if (!is_init) {
+		BLI_threadapi_init();
+		MEM_use_lockfree_small_cache();
+		is_init = true;
+	}
+}
+
+TEST(guardedalloc, SmallCacheSizes)
+{
+	small_cache_init();
+
+	const unsigned int blocks_in_use = MEM_get_memory_blocks_in_use();
+	const size_t mem_in_use = MEM_get_memory_in_use();
+	void *blocks[600];
+
+	for (int i = 0; i < ARRAY_SIZE(blocks); i++) {
+		blocks[i] = MEM_mallocN((size_t)i, __func__);
+		CHECK_ALIGNMENT(blocks[i], sizeof(void *));
+		EXPECT_EQ(((size_t)i + 3) & ~(size_t)3, MEM_allocN_len(blocks[i]));
+		memset(blocks[i], i & 0xff, (size_t)i);
+	}
+	for (int i = 0; i < ARRAY_SIZE(blocks); i++) {
+		for (int j = 0; j < i; j++) {
+			EXPECT_EQ(i & 0xff, ((unsigned char *)blocks[i])[j]);
+		}
+	}
+	EXPECT_EQ(blocks_in_use + ARRAY_SIZE(blocks), MEM_get_memory_blocks_in_use());
+
+	for (int i = 0; i < ARRAY_SIZE(blocks); i++) {
+		MEM_freeN(blocks[i]);
+	}
+	EXPECT_EQ(blocks_in_use, MEM_get_memory_blocks_in_use());
+	EXPECT_EQ(mem_in_use, MEM_get_memory_in_use());
+}
+
+TEST(guardedalloc, SmallCacheCallocRealloc)
+{
+	small_cache_init();
+
+	/* Freed slot is reused, calloc must clear it. */
+	for (int i = 0; i < 8; i++) {
+		unsigned char *data = (unsigned char *)MEM_mallocN(64, __func__);
+		memset(data, 0xff, 64);
+		MEM_freeN(data);
+
+		data = (unsigned char *)MEM_callocN(64, __func__);
+		for (int j = 0; j < 64; j++) {
+			EXPECT_EQ(0, data[j]);
+		}
+		MEM_freeN(data);
+	}
+
+	/* Grow from small to large block and back. */
+	int *data = (int *)MEM_mallocN(sizeof(int) * 16, __func__);
+	for (int i = 0; i < 16; i++) {
+		data[i] = i;
+	}
+	data = (int *)MEM_recallocN(data, sizeof(int) * 1024);
+	for (int i = 0; i < 1024; i++) {
+		EXPECT_EQ((i < 16) ? i : 0, data[i]);
+	}
+	data = (int *)MEM_reallocN(data, sizeof(int) * 8);
+	EXPECT_EQ(sizeof(int) * 8, MEM_allocN_len(data));
+	for (int i = 0; i < 8; i++) {
+		EXPECT_EQ(i, data[i]);
+	}
+
+	int *data_dup = (int *)MEM_dupallocN(data);
+	EXPECT_EQ(0, memcmp(data, data_dup, sizeof(int) * 8));
+	MEM_freeN(data_dup);
+	MEM_freeN(data);
+
+	/* Aligned blocks don't use the cache, but must still be freed properly. */
+	data = (int *)MEM_mallocN_aligned(sizeof(int) * 4, 16, __func__);
+	CHECK_ALIGNMENT(data, 16);
+	MEM_freeN(data);
+}
+
+/* Each task allocates its own range, then frees a range allocated by another task. */
+
+typedef struct SmallCacheTaskData {
+	void **blocks;
+	int pass;
+} SmallCacheTaskData;
+
+static void small_cache_task_cb(TaskPool *__restrict pool, void *taskdata, int UNUSED(threadid))
+{
+	SmallCacheTaskData *data = (SmallCacheTaskData *)BLI_task_pool_userdata(pool);
+	const int task = (int)(intptr_t)taskdata;
+
+	if (data->pass == 0) {
+		for (int i = task; i < BLOCKS_NUM; i += THREADS_NUM) {
+			data->blocks[i] = MEM_mallocN((size_t)(i % 500), __func__);
+			memset(data->blocks[i], i & 0xff, (size_t)(i % 500));
+		}
+	}
+	else {
+		for (int i = (task + 1) % THREADS_NUM; i < BLOCKS_NUM; i += THREADS_NUM) {
+			MEM_freeN(data->blocks[i]);
+		}
+	}
+}
+
+TEST(guardedalloc, SmallCacheThreads)
+{
+	small_cache_init();
+
+	const unsigned int blocks_in_use = MEM_get_memory_blocks_in_use();
+	const size_t mem_in_use = MEM_get_memory_in_use();
+	void **blocks = (void **)MEM_mallocN(sizeof(*blocks) * BLOCKS_NUM, __func__);
+	SmallCacheTaskData data = {blocks, 0};
+
+	TaskScheduler *scheduler = BLI_task_scheduler_create(THREADS_NUM);
+	TaskPool *pool = BLI_task_pool_create(scheduler, &data);
+
+	for (data.pass = 0; data.pass < 2; data.pass++) {
+		for (int task = 0; task < THREADS_NUM; task++) {
+			BLI_task_pool_push(pool, small_cache_task_cb, (void *)(intptr_t)task, false, TASK_PRIORITY_HIGH);
+		}
+		BLI_task_pool_work_and_wait(pool);
+
+		if (data.pass == 0) {
+			for (int i = 0; i < BLOCKS_NUM; i++) {
+				EXPECT_EQ((size_t)(i % 500 + 3) & ~(size_t)3, MEM_allocN_len(blocks[i]));
+				if (i % 500) {
+					EXPECT_EQ(i & 0xff, ((unsigned char *)blocks[i])[i % 500 - 1]);
+				}
+			}
+		}
+	}
+
+	BLI_task_pool_free(pool);
+	/* Worker threads exit here, their caches are merged into the global counters. */
+	BLI_task_scheduler_free(scheduler);
+	MEM_freeN(blocks);
+
+	EXPECT_EQ(blocks_in_use, MEM_get_memory_blocks_in_use());
+	EXPECT_EQ(mem_in_use, MEM_get_memory_in_use());
+}
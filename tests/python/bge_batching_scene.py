@@ -0,0 +1,117 @@
+# ##### BEGIN GPL LICENSE BLOCK #####
+#
+#  This program is free software; you can redistribute it and/or
+#  modify it under the terms of the GNU General Public License
+#  as published by the Free Software Foundation; either version 2
+#  of the License, or (at your option) any later version.
+#
+#  This program is distributed in the hope that it will be useful,
+#  but WITHOUT ANY WARRANTY; without even the implied warranty of
+#  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+#  GNU General Public License for more details.
+#
+#  You should have received a copy of the GNU General Public License
+#  along with this program; if not, write to the Free Software Foundation,
+#  Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+#
+# ##### END GPL LICENSE BLOCK #####
+
+# <pep8 compliant>
+
+"""
+Write a game engine scene with a forest of objects sharing one mesh and material,
+the profile overlay shows the draw calls and the mesh slots drawn in batches.
+
+Example Usage:
+
+./blender.bin --background --factory-startup --python tests/python/bge_batching_scene.py -- \
+    --save_path=/tmp/batching.blend --objects=2500
+
+LIBGL_ALWAYS_SOFTWARE=1 ./blenderplayer -w 800 600 /tmp/batching.blend
+"""
+
+import sys
+
+
+def clear_scene(scene):
+    import bpy
+    for obj in scene.objects[:]:
+        scene.objects.unlink(obj)
+        bpy.data.objects.remove(obj)
+
+
+def write_scene(save_path, objects, display_lists):
+    import bpy
+    import bmesh
+    import math
+
+    scene = bpy.context.scene
+    clear_scene(scene)
+    scene.render.engine = 'BLENDER_GAME'
+    scene.game_settings.show_framerate_profile = True
+    scene.game_settings.use_display_lists = display_lists
+
+    mesh = bpy.data.meshes.new("Tree")
+    bm = bmesh.new()
+    bmesh.ops.create_cone(bm, cap_ends=True, segments=8, diameter1=0.5, diameter2=0.0, depth=2.0)
+    bm.to_mesh(mesh)
+    bm.free()
+    mesh.materials.append(bpy.data.materials.new("Leaves"))
+
+    columns = int(math.ceil(math.sqrt(objects)))
+    spacing = 1.5
+    extent = columns * spacing
+
+    for i in range(objects):
+        obj = bpy.data.objects.new("Tree.%d" % i, mesh)
+        obj.location = ((i % columns) * spacing, (i // columns) * spacing, 0.0)
+        obj.rotation_euler = (0.0, 0.0, i * 0.7)
+        obj.game.physics_type = 'NO_COLLISION'
+        scene.objects.link(obj)
+
+    camera = bpy.data.objects.new("Camera", bpy.data.cameras.new("Camera"))
+    camera.location = (extent / 2.0, -extent / 3.0, extent / 2.0)
+    camera.rotation_euler = (math.radians(55.0), 0.0, 0.0)
+    camera.data.clip_end = extent * 4.0
+    scene.objects.link(camera)
+    scene.camera = camera
+
+    lamp = bpy.data.objects.new("Sun", bpy.data.lamps.new("Sun", 'SUN'))
+    lamp.location = (0.0, 0.0, 10.0)
+    scene.objects.link(lamp)
+
+    bpy.ops.wm.save_as_mainfile(filepath=save_path)
+    print("Saved %d objects to %r" % (objects, save_path))
+
+
+def main():
+    import optparse
+
+    argv = sys.argv
+
+    if "--" not in argv:
+        argv = []  # as if no args are passed
+    else:
+        argv = argv[argv.index("--") + 1:]  # get all args after "--"
+
+    usage_text = "Run blender in background mode with this script:"
+    usage_text += "  blender --background --python " + __file__ + " -- [options]"
+
+    parser = optparse.OptionParser(usage=usage_text)
+    parser.add_option("-s", "--save_path", dest="save_path", help="Path of the blend file to write", metavar='string')
+    parser.add_option("-n", "--objects", dest="objects", help="Number of objects using the mesh", type='int', default=2500)
+    parser.add_option("-l", "--display_lists", dest="display_lists", action="store_true", default=False,
+                      help="Use display lists, which disable batching")
+
+    options, args = parser.parse_args(argv)
+
+    if not options.save_path:
+        print("Error: --save_path argument not given, aborting.")
+        parser.print_help()
+        return
+
+    write_scene(options.save_path, options.objects, options.display_lists)
+
+
+if __name__ == "__main__":
+    main()
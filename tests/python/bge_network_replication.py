@@ -0,0 +1,159 @@
+# ##### BEGIN GPL LICENSE BLOCK #####
+#
+#  This program is free software; you can redistribute it and/or
+#  modify it under the terms of the GNU General Public License
+#  as published by the Free Software Foundation; either version 2
+#  of the License, or (at your option) any later version.
+#
+#  This program is distributed in the hope that it will be useful,
+#  but WITHOUT ANY WARRANTY; without even the implied warranty of
+#  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+#  GNU General Public License for more details.
+#
+#  You should have received a copy of the GNU General Public License
+#  along with this program; if not, write to the Free Software Foundation,
+#  Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+#
+# ##### END GPL LICENSE BLOCK #####
+
+# <pep8 compliant>
+
+"""
+Write a game engine scene with a grid of cubes, moved by the player started with
+the "sender" argument and replicated in the other player through the UDP network device.
+
+Example Usage:
+
+./blender.bin --background --factory-startup --python tests/python/bge_network_replication.py -- \
+    --save_path=/tmp/replication.blend --cubes=64
+
+./blenderplayer -w 640 480 -g net_port = 7001 -g net_localport = 7000 /tmp/replication.blend - sender &
+./blenderplayer -w 640 480 -g net_port = 7000 -g net_localport = 7001 -g net_address = localhost \
+    /tmp/replication.blend
+"""
+
+import sys
+
+SETUP_SCRIPT = """\
+import sys
+import bge
+
+scene = bge.logic.getCurrentScene()
+sender = "sender" in sys.argv
+for obj in scene.objects:
+    if obj.name.startswith("Cube."):
+        obj.replicated = sender
+        obj["sender"] = sender
+"""
+
+MOVE_SCRIPT = """\
+import math
+import bge
+
+cont = bge.logic.getCurrentController()
+own = cont.owner
+if own.get("sender"):
+    own["time"] = own.get("time", 0.0) + 1.0 / bge.logic.getLogicTicRate()
+    own.localPosition.z = math.sin(own["time"] * 2.0 + own["phase"])
+    own.applyRotation((0.0, 0.0, 0.02), True)
+"""
+
+
+def clear_scene(scene):
+    import bpy
+    for obj in scene.objects[:]:
+        scene.objects.unlink(obj)
+        bpy.data.objects.remove(obj)
+
+
+def add_python_logic(obj, text, name):
+    import bpy
+    bpy.ops.logic.sensor_add(type='ALWAYS', name=name, object=obj.name)
+    bpy.ops.logic.controller_add(type='PYTHON', name=name, object=obj.name)
+    sensor = obj.game.sensors[name]
+    controller = obj.game.controllers[name]
+    controller.text = text
+    sensor.link(controller)
+    return sensor
+
+
+def write_scene(save_path, cubes):
+    import bpy
+    import bmesh
+    import math
+
+    scene = bpy.context.scene
+    clear_scene(scene)
+    scene.render.engine = 'BLENDER_GAME'
+
+    mesh = bpy.data.meshes.new("Cube")
+    bm = bmesh.new()
+    bmesh.ops.create_cube(bm, size=1.0)
+    bm.to_mesh(mesh)
+    bm.free()
+
+    move_text = bpy.data.texts.new("move_cube.py")
+    move_text.write(MOVE_SCRIPT)
+
+    columns = int(math.ceil(math.sqrt(cubes)))
+    spacing = 2.0
+    extent = columns * spacing
+
+    for i in range(cubes):
+        obj = bpy.data.objects.new("Cube.%d" % i, mesh)
+        obj.location = ((i % columns) * spacing, (i // columns) * spacing, 0.0)
+        obj.game.physics_type = 'NO_COLLISION'
+        scene.objects.link(obj)
+        bpy.context.scene.objects.active = obj
+        bpy.ops.object.game_property_new(type='FLOAT', name="phase")
+        obj.game.properties["phase"].value = i * 0.3
+        sensor = add_python_logic(obj, move_text, "Move")
+        sensor.use_pulse_true_level = True
+
+    camera = bpy.data.objects.new("Camera", bpy.data.cameras.new("Camera"))
+    camera.location = (extent / 2.0, -extent / 2.0, extent)
+    camera.rotation_euler = (math.radians(45.0), 0.0, 0.0)
+    scene.objects.link(camera)
+    scene.camera = camera
+
+    # Flag the cubes as replicated from a python controller run on the first frame.
+    setup_text = bpy.data.texts.new("setup_replication.py")
+    setup_text.write(SETUP_SCRIPT)
+
+    setup = bpy.data.objects.new("Setup", None)
+    scene.objects.link(setup)
+    add_python_logic(setup, setup_text, "Setup")
+
+    bpy.ops.wm.save_as_mainfile(filepath=save_path)
+    print("Saved %d cubes to %r" % (cubes, save_path))
+
+
+def main():
+    import optparse
+
+    argv = sys.argv
+
+    if "--" not in argv:
+        argv = []  # as if no args are passed
+    else:
+        argv = argv[argv.index("--") + 1:]  # get all args after "--"
+
+    usage_text = "Run blender in background mode with this script:"
+    usage_text += "  blender --background --python " + __file__ + " -- [options]"
+
+    parser = optparse.OptionParser(usage=usage_text)
+    parser.add_option("-s", "--save_path", dest="save_path", help="Path of the blend file to write", metavar='string')
+    parser.add_option("-n", "--cubes", dest="cubes", help="Number of replicated cubes", type='int', default=64)
+
+    options, args = parser.parse_args(argv)
+
+    if not options.save_path:
+        print("Error: --save_path argument not given, aborting.")
+        parser.print_help()
+        return
+
+    write_scene(options.save_path, options.cubes)
+
+
+if __name__ == "__main__":
+    main()
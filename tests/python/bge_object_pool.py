@@ -0,0 +1,168 @@
+# ##### BEGIN GPL LICENSE BLOCK #####
+#
+#  This program is free software; you can redistribute it and/or
+#  modify it under the terms of the GNU General Public License
+#  as published by the Free Software Foundation; either version 2
+#  of the License, or (at your option) any later version.
+#
+#  This program is distributed in the hope that it will be useful,
+#  but WITHOUT ANY WARRANTY; without even the implied warranty of
+#  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+#  GNU General Public License for more details.
+#
+#  You should have received a copy of the GNU General Public License
+#  along with this program; if not, write to the Free Software Foundation,
+#  Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+#
+# ##### END GPL LICENSE BLOCK #####
+
+# <pep8 compliant>
+
+"""
+Write a game engine scene adding, ending and adding again an object kept in an object pool,
+the player prints whether the logic bricks of the new and of the reused replica run.
+
+Example Usage:
+
+./blender.bin --background --factory-startup --python tests/python/bge_object_pool.py -- \
+    --save_path=/tmp/object_pool.blend
+
+./blenderplayer -w 320 240 /tmp/object_pool.blend
+"""
+
+import sys
+
+# Run every frame by the pooled object, "fired" is reset from the template on reuse.
+COUNT_SCRIPT = """\
+import bge
+
+bge.logic.getCurrentController().owner["fired"] += 1
+"""
+
+TEST_SCRIPT = """\
+import bge
+
+own = bge.logic.getCurrentController().owner
+scene = bge.logic.getCurrentScene()
+state = bge.logic.globalDict
+frame = own["frame"]
+own["frame"] = frame + 1
+
+
+def check(name, obj):
+    ok = obj["fired"] > 0
+    print("bge_object_pool: %s replica logic %s" % (name, "OK" if ok else "FAILED"))
+    state["failed"] = state.get("failed", False) or not ok
+
+
+if frame == 0:
+    scene.setObjectPool("Pooled", 1)
+    state["obj"] = scene.addObject("Pooled", own)
+elif frame == 3:
+    check("new", state["obj"])
+    state["obj"].endObject()
+elif frame == 4:
+    # The replica ended in the previous frame is reused.
+    state["obj"] = scene.addObject("Pooled", own)
+elif frame == 7:
+    check("reused", state["obj"])
+    print("bge_object_pool: %s" % ("FAILED" if state["failed"] else "OK"))
+    bge.logic.endGame()
+"""
+
+
+def clear_scene(scene):
+    import bpy
+    for obj in scene.objects[:]:
+        scene.objects.unlink(obj)
+        bpy.data.objects.remove(obj)
+
+
+def add_python_logic(obj, text, name):
+    import bpy
+    bpy.ops.logic.sensor_add(type='ALWAYS', name=name, object=obj.name)
+    bpy.ops.logic.controller_add(type='PYTHON', name=name, object=obj.name)
+    sensor = obj.game.sensors[name]
+    controller = obj.game.controllers[name]
+    controller.text = text
+    sensor.link(controller)
+    sensor.use_pulse_true_level = True
+    return sensor
+
+
+def add_int_property(obj, name):
+    import bpy
+    bpy.context.scene.objects.active = obj
+    bpy.ops.object.game_property_new(type='INT', name=name)
+
+
+def write_scene(save_path):
+    import bpy
+    import bmesh
+
+    scene = bpy.context.scene
+    clear_scene(scene)
+    scene.render.engine = 'BLENDER_GAME'
+    scene.layers = [i == 0 for i in range(20)]
+
+    mesh = bpy.data.meshes.new("Cube")
+    bm = bmesh.new()
+    bmesh.ops.create_cube(bm, size=1.0)
+    bm.to_mesh(mesh)
+    bm.free()
+
+    # The pooled object must be in an inactive layer.
+    pooled = bpy.data.objects.new("Pooled", mesh)
+    pooled.game.physics_type = 'NO_COLLISION'
+    scene.objects.link(pooled)
+    pooled.layers = [i == 1 for i in range(20)]
+    add_int_property(pooled, "fired")
+    count_text = bpy.data.texts.new("count_frames.py")
+    count_text.write(COUNT_SCRIPT)
+    add_python_logic(pooled, count_text, "Count")
+
+    spawner = bpy.data.objects.new("Spawner", None)
+    scene.objects.link(spawner)
+    add_int_property(spawner, "frame")
+    test_text = bpy.data.texts.new("test_object_pool.py")
+    test_text.write(TEST_SCRIPT)
+    add_python_logic(spawner, test_text, "Test")
+
+    camera = bpy.data.objects.new("Camera", bpy.data.cameras.new("Camera"))
+    camera.location = (0.0, -10.0, 0.0)
+    camera.rotation_euler = (1.5708, 0.0, 0.0)
+    scene.objects.link(camera)
+    scene.camera = camera
+
+    bpy.ops.wm.save_as_mainfile(filepath=save_path)
+    print("Saved object pool test to %r" % save_path)
+
+
+def main():
+    import optparse
+
+    argv = sys.argv
+
+    if "--" not in argv:
+        argv = []  # as if no args are passed
+    else:
+        argv = argv[argv.index("--") + 1:]  # get all args after "--"
+
+    usage_text = "Run blender in background mode with this script:"
+    usage_text += "  blender --background --python " + __file__ + " -- [options]"
+
+    parser = optparse.OptionParser(usage=usage_text)
+    parser.add_option("-s", "--save_path", dest="save_path", help="Path of the blend file to write", metavar='string')
+
+    options, args = parser.parse_args(argv)
+
+    if not options.save_path:
+        print("Error: --save_path argument not given, aborting.")
+        parser.print_help()
+        return
+
+    write_scene(options.save_path)
+
+
+if __name__ == "__main__":
+    main()
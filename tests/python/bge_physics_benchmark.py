@@ -0,0 +1,138 @@
+# ##### BEGIN GPL LICENSE BLOCK #####
+#
+#  This program is free software; you can redistribute it and/or
+#  modify it under the terms of the GNU General Public License
+#  as published by the Free Software Foundation; either version 2
+#  of the License, or (at your option) any later version.
+#
+#  This program is distributed in the hope that it will be useful,
+#  but WITHOUT ANY WARRANTY; without even the implied warranty of
+#  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+#  GNU General Public License for more details.
+#
+#  You should have received a copy of the GNU General Public License
+#  along with this program; if not, write to the Free Software Foundation,
+#  Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+#
+# ##### END GPL LICENSE BLOCK #####
+
+# <pep8 compliant>
+
+"""
+Write a game engine scene made of many independent box stacks, each stack
+being its own simulation island, to compare the serial and threaded solvers.
+
+Example Usage:
+
+./blender.bin --background --factory-startup --python tests/python/bge_physics_benchmark.py -- \
+    --save_path=/tmp/physics_mt.blend \
+    --stacks=400 --height=8 --threads --deterministic
+
+./blenderplayer -b 600 /tmp/physics_mt.json /tmp/physics_mt.blend
+"""
+
+import sys
+
+SETUP_SCRIPT = """\
+import bge
+bge.constraints.setSolverThreads(%r, deterministic=%r)
+"""
+
+
+def clear_scene(scene):
+    import bpy
+    for obj in scene.objects[:]:
+        scene.objects.unlink(obj)
+        bpy.data.objects.remove(obj)
+
+
+def write_scene(save_path, stacks, height, threads, deterministic):
+    import bpy
+    import bmesh
+    import math
+
+    scene = bpy.context.scene
+    clear_scene(scene)
+    scene.render.engine = 'BLENDER_GAME'
+
+    mesh = bpy.data.meshes.new("Box")
+    bm = bmesh.new()
+    bmesh.ops.create_cube(bm, size=1.0)
+    bm.to_mesh(mesh)
+    bm.free()
+
+    columns = int(math.ceil(math.sqrt(stacks)))
+    spacing = 3.0
+    extent = columns * spacing
+
+    ground = bpy.data.objects.new("Ground", mesh)
+    ground.location = (extent / 2.0, extent / 2.0, -0.5)
+    ground.scale = (extent, extent, 1.0)
+    ground.game.physics_type = 'STATIC'
+    scene.objects.link(ground)
+
+    for i in range(stacks):
+        x, y = (i % columns) * spacing, (i // columns) * spacing
+        for z in range(height):
+            obj = bpy.data.objects.new("Box.%d.%d" % (i, z), mesh)
+            obj.location = (x, y, 0.5 + z * 1.01)
+            obj.game.physics_type = 'RIGID_BODY'
+            scene.objects.link(obj)
+
+    camera = bpy.data.objects.new("Camera", bpy.data.cameras.new("Camera"))
+    camera.location = (extent / 2.0, -extent / 2.0, extent)
+    camera.rotation_euler = (math.radians(45.0), 0.0, 0.0)
+    scene.objects.link(camera)
+    scene.camera = camera
+
+    # Enable the threaded solver from a python controller run on the first frame.
+    text = bpy.data.texts.new("setup_physics.py")
+    text.write(SETUP_SCRIPT % (threads, deterministic))
+
+    setup = bpy.data.objects.new("Setup", None)
+    scene.objects.link(setup)
+    bpy.ops.logic.sensor_add(type='ALWAYS', name="Start", object=setup.name)
+    bpy.ops.logic.controller_add(type='PYTHON', name="Setup", object=setup.name)
+    sensor = setup.game.sensors["Start"]
+    controller = setup.game.controllers["Setup"]
+    controller.text = text
+    sensor.link(controller)
+
+    bpy.ops.wm.save_as_mainfile(filepath=save_path)
+    print("Saved %d boxes in %d stacks to %r" % (stacks * height, stacks, save_path))
+
+
+def main():
+    import optparse
+
+    argv = sys.argv
+
+    if "--" not in argv:
+        argv = []  # as if no args are passed
+    else:
+        argv = argv[argv.index("--") + 1:]  # get all args after "--"
+
+    usage_text = "Run blender in background mode with this script:"
+    usage_text += "  blender --background --python " + __file__ + " -- [options]"
+
+    parser = optparse.OptionParser(usage=usage_text)
+    parser.add_option("-s", "--save_path", dest="save_path", help="Path of the blend file to write", metavar='string')
+    parser.add_option("-n", "--stacks", dest="stacks", help="Number of box stacks", type='int', default=400)
+    parser.add_option("-H", "--height", dest="height", help="Number of boxes per stack", type='int', default=8)
+    parser.add_option("-t", "--threads", dest="threads", help="Solve islands in the engine threads",
+                      action="store_true", default=False)
+    parser.add_option("-d", "--deterministic", dest="deterministic", help="Use the deterministic threaded solver",
+                      action="store_true", default=False)
+
+    options, args = parser.parse_args(argv)
+
+    if not options.save_path:
+        print("Error: --save_path argument not given, aborting.")
+        parser.print_help()
+        return
+
+    write_scene(options.save_path, options.stacks, options.height, options.threads, options.deterministic)
+
+
+if __name__ == "__main__":
+    main()
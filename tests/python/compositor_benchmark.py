@@ -0,0 +1,196 @@
+# ##### BEGIN GPL LICENSE BLOCK #####
+#
+#  This program is free software; you can redistribute it and/or
+#  modify it under the terms of the GNU General Public License
+#  as published by the Free Software Foundation; either version 2
+#  of the License, or (at your option) any later version.
+#
+#  This program is distributed in the hope that it will be useful,
+#  but WITHOUT ANY WARRANTY; without even the implied warranty of
+#  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+#  GNU General Public License for more details.
+#
+#  You should have received a copy of the GNU General Public License
+#  along with this program; if not, write to the Free Software Foundation,
+#  Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+#
+# ##### END GPL LICENSE BLOCK #####
+
+# <pep8 compliant>
+
+"""
+Build compositor node trees from a generated image and time their execution
+at given resolutions and thread counts, without rendering the 3D scene.
+
+With --report the compositor prints the time spent in every execution group
+and the memory of every buffer after each execution.
+
+Example Usage:
+
+./blender.bin --background --factory-startup --python tests/python/compositor_benchmark.py -- \
+    --trees=blur,glare --resolutions=1920x1080,3840x2160 --threads=1,8 --repeat=3
+"""
+
+import sys
+import time
+
+
+def new_node(tree, idname, location, **settings):
+    node = tree.nodes.new(idname)
+    node.location = location
+    for key, value in settings.items():
+        setattr(node, key, value)
+    return node
+
+
+def link(tree, from_node, to_node, from_socket=0, to_socket=0):
+    tree.links.new(from_node.outputs[from_socket], to_node.inputs[to_socket])
+
+
+def tree_blur(tree, image):
+    gauss = new_node(tree, "CompositorNodeBlur", (200, 0), filter_type='GAUSS', size_x=40, size_y=40)
+    fast = new_node(tree, "CompositorNodeBlur", (400, 0), filter_type='FAST_GAUSS', size_x=80, size_y=80)
+    link(tree, image, gauss)
+    link(tree, gauss, fast)
+    return fast
+
+
+def tree_glare(tree, image):
+    glare = new_node(tree, "CompositorNodeGlare", (200, 0), glare_type='FOG_GLOW', quality='HIGH', size=8)
+    link(tree, image, glare)
+    return glare
+
+
+def tree_color(tree, image):
+    gamma = new_node(tree, "CompositorNodeGamma", (200, 0))
+    invert = new_node(tree, "CompositorNodeInvert", (400, 0))
+    mix = new_node(tree, "CompositorNodeMixRGB", (600, 0), blend_type='MULTIPLY')
+    bw = new_node(tree, "CompositorNodeRGBToBW", (600, -200))
+    math = new_node(tree, "CompositorNodeMath", (800, -200), operation='POWER')
+    math.inputs[1].default_value = 2.0
+    link(tree, image, gamma)
+    link(tree, gamma, invert, 0, 1)
+    link(tree, invert, mix, 0, 1)
+    link(tree, image, mix, 0, 2)
+    link(tree, mix, bw)
+    link(tree, bw, math)
+    return math
+
+
+def tree_tonemap(tree, image):
+    tonemap = new_node(tree, "CompositorNodeTonemap", (200, 0), tonemap_type='RD_PHOTORECEPTOR')
+    link(tree, image, tonemap)
+    return tonemap
+
+
+TREES = {
+    "blur": tree_blur,
+    "glare": tree_glare,
+    "color": tree_color,
+    "tonemap": tree_tonemap,
+}
+
+
+def build_tree(scene, name, width, height):
+    import bpy
+
+    scene.use_nodes = True
+    tree = scene.node_tree
+    tree.nodes.clear()
+
+    image = bpy.data.images.new("Benchmark %dx%d" % (width, height), width, height, float_buffer=True)
+    image.generated_type = 'COLOR_GRID'
+
+    image_node = new_node(tree, "CompositorNodeImage", (0, 0), image=image)
+    result = TREES[name](tree, image_node)
+    composite = new_node(tree, "CompositorNodeComposite", (1000, 0))
+    link(tree, result, composite)
+    return image
+
+
+def run(trees, resolutions, threads, repeat, use_cache):
+    import bpy
+
+    scene = bpy.context.scene
+    scene.render.use_compositing = True
+    scene.render.use_sequencer = False
+    scene.render.resolution_percentage = 100
+
+    results = []
+    for name in trees:
+        for width, height in resolutions:
+            scene.render.resolution_x = width
+            scene.render.resolution_y = height
+            image = build_tree(scene, name, width, height)
+            scene.node_tree.use_result_cache = use_cache
+
+            for num_threads in threads:
+                # 0 uses all processors
+                if num_threads:
+                    scene.render.threads_mode = 'FIXED'
+                    scene.render.threads = num_threads
+                else:
+                    scene.render.threads_mode = 'AUTO'
+                timings = []
+                for _ in range(repeat):
+                    start = time.time()
+                    bpy.ops.render.render()
+                    timings.append(time.time() - start)
+                results.append((name, width, height, num_threads, min(timings), sum(timings) / len(timings)))
+
+            # the image node still uses the image, free it first
+            scene.node_tree.nodes.clear()
+            bpy.data.images.remove(image)
+
+    print("\n%-10s %11s %7s %10s %10s" % ("tree", "resolution", "threads", "min (s)", "avg (s)"))
+    for name, width, height, num_threads, best, average in results:
+        print("%-10s %11s %7d %10.3f %10.3f" % (name, "%dx%d" % (width, height), num_threads, best, average))
+
+
+def main():
+    import optparse
+
+    argv = sys.argv
+
+    if "--" not in argv:
+        argv = []  # as if no args are passed
+    else:
+        argv = argv[argv.index("--") + 1:]  # get all args after "--"
+
+    usage_text = "Run blender in background mode with this script:"
+    usage_text += "  blender --background --factory-startup --python " + __file__ + " -- [options]"
+
+    parser = optparse.OptionParser(usage=usage_text)
+    parser.add_option("-t", "--trees", dest="trees", help="Comma separated trees to run: " + ", ".join(sorted(TREES)),
+                      metavar='string', default=",".join(sorted(TREES)))
+    parser.add_option("-r", "--resolutions", dest="resolutions", help="Comma separated WIDTHxHEIGHT resolutions",
+                      metavar='string', default="1920x1080")
+    parser.add_option("-j", "--threads", dest="threads", help="Comma separated thread counts, 0 for all processors",
+                      metavar='string', default="0")
+    parser.add_option("-n", "--repeat", dest="repeat", help="Executions per configuration", type='int', default=3)
+    parser.add_option("-c", "--cache", dest="cache", help="Keep node results between executions",
+                      action="store_true", default=False)
+    parser.add_option("-R", "--report", dest="report", help="Print group timings and buffer memory per execution",
+                      action="store_true", default=False)
+
+    options, args = parser.parse_args(argv)
+
+    trees = options.trees.split(",")
+    for name in trees:
+        if name not in TREES:
+            print("Error: unknown tree %r, aborting." % name)
+            parser.print_help()
+            return
+
+    resolutions = [tuple(int(size) for size in resolution.split("x")) for resolution in options.resolutions.split(",")]
+    threads = [int(num_threads) for num_threads in options.threads.split(",")]
+
+    if options.report:
+        import bpy
+        bpy.app.debug = True
+
+    run(trees, resolutions, threads, options.repeat, options.cache)
+
+
+if __name__ == "__main__":
+    main()